@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2015, 2016, 2017, 2020, 2021  Dirk Stolle
+    Copyright (C) 2015, 2016, 2017, 2020, 2021, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -41,6 +41,9 @@ size_t writeCallbackString(char *ptr, size_t size, size_t nmemb, void *userdata)
   return actualSize;
 }
 
+// shared pool of connections, or nullptr, if requests do not share anything
+static CURLSH* sharedPool = nullptr;
+
 #ifdef CURLY_READ_CALLBACK_STRING
 struct StringData
 {
@@ -277,6 +280,19 @@ bool Curly::perform(std::string& response)
     return false;
   }
 
+  //use shared connections, if enabled
+  if (sharedPool != nullptr)
+  {
+    retCode = curl_easy_setopt(handle, CURLOPT_SHARE, sharedPool);
+    if (retCode != CURLE_OK)
+    {
+      std::cerr << "cURL error: setting shared connection pool failed!" << std::endl;
+      std::cerr << curl_easy_strerror(retCode) << std::endl;
+      curl_easy_cleanup(handle);
+      return false;
+    }
+  }
+
   //set header read function
   #ifdef DEBUG_MODE
   std::clog << "curl_easy_setopt(..., CURLOPT_HEADERFUNCTION, ...)..." << std::endl;
@@ -719,6 +735,36 @@ Curly::VersionData Curly::curlVersion()
   return vd;
 }
 
+bool Curly::shareConnections()
+{
+  if (sharedPool != nullptr)
+    return true;
+  CURLSH* pool = curl_share_init();
+  if (nullptr == pool)
+  {
+    std::cerr << "cURL share init failed!" << std::endl;
+    return false;
+  }
+  if ((curl_share_setopt(pool, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS) != CURLSHE_OK)
+      || (curl_share_setopt(pool, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION) != CURLSHE_OK))
+  {
+    std::cerr << "cURL error: sharing DNS lookups and TLS sessions failed!" << std::endl;
+    curl_share_cleanup(pool);
+    return false;
+  }
+  #if CURL_AT_LEAST_VERSION(7, 57, 0)
+  if (curl_share_setopt(pool, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT) != CURLSHE_OK)
+  {
+    std::cerr << "cURL error: sharing connections failed!" << std::endl;
+    curl_share_cleanup(pool);
+    return false;
+  }
+  #endif
+  // The pool is used until the program ends, so it is never cleaned up.
+  sharedPool = pool;
+  return true;
+}
+
 size_t Curly::headerCallback(char* buffer, size_t size, size_t nitems, void* userdata)
 {
   const size_t actualSize = size * nitems;
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2015, 2016, 2017  Dirk Stolle
+    Copyright (C) 2015, 2016, 2017, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -256,6 +256,20 @@ class Curly
     static VersionData curlVersion();
 
 
+    /** \brief lets all following requests share one pool of connections,
+     *         DNS lookups and TLS sessions
+     *
+     * \return Returns true, if sharing is enabled. Returns false otherwise.
+     * \remarks Connections to a host are kept open after a request and are
+     *          reused by later requests to the same host, which saves the
+     *          TCP and TLS handshakes. The pool is not locked, so only one
+     *          thread may perform requests after sharing has been enabled.
+     *          Connections are only shared with cURL 7.57.0 or later, older
+     *          versions just share DNS lookups and TLS sessions.
+     */
+    static bool shareConnections();
+
+
     /** \brief gets the list of header lines that were returned by the request
      *
      * \return Returns a vector of strings, one string for each header line.
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2015, 2016  Dirk Stolle
+    Copyright (C) 2015, 2016, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -19,8 +19,10 @@
 */
 
 #include "Scanner.hpp"
+#include <algorithm>
 #include <iostream>
 #include <thread>
+#include <utility>
 
 namespace scantool
 {
@@ -28,6 +30,7 @@ namespace scantool
 Scanner::Scanner(const bool honourTimeLimits, const bool _silent)
 : m_HonourLimit(honourTimeLimits),
   m_Silent(_silent),
+  m_WaitHandler(),
   // We assume that time limits will not be higher than 24 hours.
   m_LastScanRequest(std::chrono::steady_clock::now() - std::chrono::hours(24)),
   m_LastHashLookup(std::chrono::steady_clock::now() - std::chrono::hours(24))
@@ -73,6 +76,12 @@ void Scanner::hashLookupWasNow()
   m_LastHashLookup = std::chrono::steady_clock::now();
 }
 
+bool Scanner::scanLimitExpired() const
+{
+  return !honoursTimeLimit()
+      || (m_LastScanRequest + timeBetweenConsecutiveScanRequests() <= std::chrono::steady_clock::now());
+}
+
 void Scanner::waitForScanLimitExpiration()
 {
   // If time limit is not honoured, we can exit here.
@@ -93,7 +102,7 @@ void Scanner::waitForScanLimitExpiration()
         std::clog << std::chrono::duration_cast<std::chrono::milliseconds>(duration).count()
                   << " millisecond(s) for time limit to expire..." << std::endl;
     } // if not silent
-    std::this_thread::sleep_for(duration);
+    sleepFor(duration);
   } // if waiting is required
 }
 
@@ -117,8 +126,30 @@ void Scanner::waitForHashLookupLimitExpiration()
         std::clog << std::chrono::duration_cast<std::chrono::milliseconds>(duration).count()
                   << " millisecond(s) for time limit to expire..." << std::endl;
     } // if not silent
-    std::this_thread::sleep_for(duration);
+    sleepFor(duration);
   } // if waiting is required
 }
 
+void Scanner::setWaitHandler(std::function<void()> handler)
+{
+  m_WaitHandler = std::move(handler);
+}
+
+void Scanner::sleepFor(const std::chrono::steady_clock::duration duration)
+{
+  if (!m_WaitHandler)
+  {
+    std::this_thread::sleep_for(duration);
+    return;
+  }
+  // Wait in slices of at most one second, so the handler is called often.
+  const auto wakeUp = std::chrono::steady_clock::now() + duration;
+  while (std::chrono::steady_clock::now() < wakeUp)
+  {
+    std::this_thread::sleep_until(std::min(wakeUp,
+        std::chrono::steady_clock::now() + std::chrono::seconds(1)));
+    m_WaitHandler();
+  }
+}
+
 } // namespace
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2015, 2016  Dirk Stolle
+    Copyright (C) 2015, 2016, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -23,6 +23,7 @@
 
 #include <chrono>
 #include <cstdint>
+#include <functional>
 
 namespace scantool
 {
@@ -113,6 +114,14 @@ class Scanner
     virtual void hashLookupWasNow();
 
 
+    /** \brief Checks whether a file scan request could be sent right now
+     *         without waiting for the time limit.
+     *
+     * \return Returns true, if no waiting is required.
+     */
+    bool scanLimitExpired() const;
+
+
     /** \brief Waits until the time limit for file scans has expired, if the
      *         scanner honours a time limit.
      */
@@ -125,6 +134,15 @@ class Scanner
     void waitForHashLookupLimitExpiration();
 
 
+    /** \brief Sets a function that is called repeatedly while the scanner
+     *         waits for a time limit to expire.
+     *
+     * \param handler  the function, e.g. to act on signals; may be empty
+     * \remarks The handler is called at least once per second of waiting.
+     */
+    void setWaitHandler(std::function<void()> handler);
+
+
      /** \brief Returns the maximum file size that is allowed to be scanned.
       *
       * \return maximum size in bytes that can still be scanned
@@ -133,7 +151,16 @@ class Scanner
   private:
     bool m_HonourLimit; /**< whether to honour time limits */
     bool m_Silent; /**< whether to be silent */
+    std::function<void()> m_WaitHandler; /**< called while waiting, may be empty */
   protected:
+    /** \brief Waits for the given duration, but calls the wait handler in
+     *         between, so that long waits do not delay it.
+     *
+     * \param duration  the time to wait
+     */
+    void sleepFor(const std::chrono::steady_clock::duration duration);
+
+
     /* Both time points are protected and not private, because descendants might
        need to modify them directly in overridden scanRequestWasNow() or
        hashLookupWasNow() methods. */
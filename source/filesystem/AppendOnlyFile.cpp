@@ -0,0 +1,303 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "AppendOnlyFile.hpp"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include "../../libstriezel/filesystem/file.hpp"
+#if defined(__linux__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace scantool::filesystem
+{
+
+#if defined(__linux__)
+/// permissions of new files, before the umask is applied
+const mode_t cFileMode = S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH;
+
+/** \brief Opens a file for appending and locks it.
+ *
+ * \param fileName  path of the file
+ * \return Returns the locked file descriptor, or -1 if an error occurred.
+ */
+static int openLocked(const std::string& fileName)
+{
+  while (true)
+  {
+    const int fd = ::open(fileName.c_str(), O_RDWR | O_APPEND | O_CREAT | O_CLOEXEC, cFileMode);
+    if (fd < 0)
+      return -1;
+    int locked;
+    do
+    {
+      locked = flock(fd, LOCK_EX);
+    } while ((locked != 0) && (errno == EINTR));
+    struct stat opened;
+    if ((locked != 0) || (fstat(fd, &opened) != 0))
+    {
+      close(fd);
+      return -1;
+    }
+    // A rewrite may have replaced the file while waiting for the lock.
+    struct stat current;
+    if ((stat(fileName.c_str(), &current) == 0) && (current.st_dev == opened.st_dev)
+        && (current.st_ino == opened.st_ino))
+      return fd;
+    flock(fd, LOCK_UN);
+    close(fd);
+  } // while
+}
+
+/** \brief Removes an incomplete last line that an interrupted write left.
+ *
+ * \param fd  the locked file descriptor
+ * \return Returns true, if the file ends with a complete line now.
+ */
+static bool dropIncompleteLine(const int fd)
+{
+  struct stat status;
+  if (fstat(fd, &status) != 0)
+    return false;
+  off_t end = status.st_size;
+  char buffer[4096];
+  while (end > 0)
+  {
+    const off_t start = (end > static_cast<off_t>(sizeof(buffer))) ? end - sizeof(buffer) : 0;
+    const ssize_t length = pread(fd, buffer, end - start, start);
+    if (length != end - start)
+      return false;
+    for (ssize_t i = length - 1; i >= 0; --i)
+    {
+      if (buffer[i] == '\n')
+        return (start + i + 1 == status.st_size) || (ftruncate(fd, start + i + 1) == 0);
+    }
+    end = start;
+  } // while
+  return (status.st_size == 0) || (ftruncate(fd, 0) == 0);
+}
+
+/** \brief Writes a string to a file descriptor.
+ *
+ * \param fd       the file descriptor
+ * \param content  the string to write
+ * \param synced   whether to wait until the data is on the disk
+ * \return Returns true, if the whole string was written.
+ */
+static bool writeAll(const int fd, const std::string& content, const bool synced)
+{
+  std::size_t offset = 0;
+  while (offset < content.size())
+  {
+    const ssize_t written = write(fd, content.data() + offset, content.size() - offset);
+    if (written < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    offset += static_cast<std::size_t>(written);
+  } // while
+  return !synced || (fdatasync(fd) == 0);
+}
+#else
+/** \brief Checks whether a file ends with an incomplete line that an
+ *         interrupted write left.
+ *
+ * \param fileName  path of the file
+ * \param complete  string that will hold the complete lines of the file,
+ *                  if the last line is incomplete
+ * \return Returns true, if the last line is incomplete.
+ */
+static bool endsIncomplete(const std::string& fileName, std::string& complete)
+{
+  std::ifstream input(fileName, std::ios::in | std::ios::binary);
+  char lastChar = '\n';
+  if (!input || !input.seekg(-1, std::ios::end) || !input.get(lastChar) || (lastChar == '\n'))
+    return false;
+  input.seekg(0, std::ios::beg);
+  complete.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+  const std::string::size_type lineEnd = complete.rfind('\n');
+  complete.resize(lineEnd == std::string::npos ? 0 : lineEnd + 1);
+  return true;
+}
+#endif
+
+AppendOnlyFile::AppendOnlyFile(const std::string& fileName, const bool synced)
+: m_FileName(fileName),
+  m_Synced(synced),
+  m_Lines(0),
+  m_Lock(-1)
+{
+}
+
+AppendOnlyFile::~AppendOnlyFile()
+{
+  unlock();
+}
+
+const std::string& AppendOnlyFile::fileName() const noexcept
+{
+  return m_FileName;
+}
+
+bool AppendOnlyFile::read(const LineHandler& handler)
+{
+  m_Lines = 0;
+  if (!libstriezel::filesystem::file::exists(m_FileName))
+    return true;
+
+  std::ifstream input(m_FileName, std::ios::in | std::ios::binary);
+  if (!input)
+    return false;
+
+  std::string line;
+  while (std::getline(input, line))
+  {
+    // An interrupted write may have left an incomplete last line.
+    if (input.eof())
+      break;
+    if (!line.empty() && (line[0] != '#'))
+      ++m_Lines;
+    handler(line);
+  } // while
+  return !input.bad();
+}
+
+bool AppendOnlyFile::append(const std::string& lines)
+{
+  if (lines.empty())
+    return true;
+  #if defined(__linux__)
+  const int fd = (m_Lock >= 0) ? m_Lock : openLocked(m_FileName);
+  if (fd < 0)
+    return false;
+  const bool written = dropIncompleteLine(fd) && writeAll(fd, lines, m_Synced);
+  if (fd != m_Lock)
+  {
+    flock(fd, LOCK_UN);
+    close(fd);
+  }
+  if (!written)
+    return false;
+  #else
+  // Without truncation the complete lines are written to a new file.
+  std::string complete;
+  if (endsIncomplete(m_FileName, complete))
+    return rewrite(complete + lines);
+  std::ofstream output(m_FileName, std::ios::out | std::ios::binary | std::ios::app);
+  if (!output.good())
+    return false;
+  output.write(lines.data(), lines.size());
+  output.close();
+  if (!output.good())
+    return false;
+  #endif
+  m_Lines += countLines(lines);
+  return true;
+}
+
+bool AppendOnlyFile::worthRewriting(const std::size_t entries, const std::size_t slack) const noexcept
+{
+  return m_Lines > 2 * static_cast<uint64_t>(entries) + slack;
+}
+
+bool AppendOnlyFile::rewrite(const std::string& content)
+{
+  const std::string tempName = m_FileName + ".tmp";
+  #if defined(__linux__)
+  const int fd = ::open(tempName.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, cFileMode);
+  if (fd < 0)
+    return false;
+  // The new file has to be complete before it replaces the old one.
+  const bool written = writeAll(fd, content, m_Synced);
+  const bool closed = (close(fd) == 0);
+  const bool success = written && closed;
+  #else
+  std::ofstream output(tempName, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!output.good())
+    return false;
+  output.write(content.data(), content.size());
+  output.close();
+  const bool success = output.good();
+  #if defined(_WIN32)
+  // rename() does not replace existing files on Windows.
+  if (success)
+    std::remove(m_FileName.c_str());
+  #endif
+  #endif
+  if (!success || (std::rename(tempName.c_str(), m_FileName.c_str()) != 0))
+  {
+    std::remove(tempName.c_str());
+    return false;
+  }
+  m_Lines = countLines(content);
+  return true;
+}
+
+bool AppendOnlyFile::lock()
+{
+  #if defined(__linux__)
+  if (m_Lock < 0)
+    m_Lock = openLocked(m_FileName);
+  return m_Lock >= 0;
+  #else
+  return true;
+  #endif
+}
+
+void AppendOnlyFile::unlock()
+{
+  #if defined(__linux__)
+  if (m_Lock < 0)
+    return;
+  flock(m_Lock, LOCK_UN);
+  close(m_Lock);
+  m_Lock = -1;
+  #endif
+}
+
+uint64_t AppendOnlyFile::lines() const noexcept
+{
+  return m_Lines;
+}
+
+uint64_t AppendOnlyFile::countLines(const std::string& content)
+{
+  uint64_t count = 0;
+  std::string::size_type start = 0;
+  while (start < content.size())
+  {
+    std::string::size_type end = content.find('\n', start);
+    if (end == std::string::npos)
+      end = content.size();
+    if ((end > start) && (content[start] != '#'))
+      ++count;
+    start = end + 1;
+  } // while
+  return count;
+}
+
+} // namespace
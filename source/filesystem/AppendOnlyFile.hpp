@@ -0,0 +1,156 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_FILESYSTEM_APPENDONLYFILE_HPP
+#define SCANTOOL_FILESYSTEM_APPENDONLYFILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace scantool::filesystem
+{
+
+/** \brief Text file where lines are only appended, e.g. caches and journals.
+ *
+ * Later lines usually replace earlier ones, so the file is rewritten from
+ * time to time to get rid of obsolete lines. An interrupted write may leave
+ * an incomplete last line. Such a line is never passed to the reader, and it
+ * is removed before the next lines are appended, so that it cannot turn into
+ * a complete line with truncated content.
+ *
+ * On Linux all processes that append to the file lock it exclusively, so
+ * the incomplete line of one process does not swallow the lines of another
+ * process.
+ */
+class AppendOnlyFile
+{
+  public:
+    /** function that gets each complete line without the line break */
+    typedef std::function<void(const std::string& line)> LineHandler;
+
+
+    /** \brief Constructor.
+     *
+     * \param fileName  path of the file
+     * \param synced    whether writes on Linux shall wait until the data is on
+     *                  the disk
+     */
+    explicit AppendOnlyFile(const std::string& fileName, const bool synced = false);
+
+
+    /** \brief Destructor, releases the lock, if it is still held.
+     */
+    ~AppendOnlyFile();
+
+
+    AppendOnlyFile(const AppendOnlyFile& other) = delete;
+    AppendOnlyFile& operator=(const AppendOnlyFile& other) = delete;
+
+
+    /** \brief Gets the path of the file.
+     *
+     * \return Returns the path of the file.
+     */
+    const std::string& fileName() const noexcept;
+
+
+    /** \brief Reads all complete lines of the file.
+     *
+     * \param handler  function that gets each complete line
+     * \return Returns true, if the file was read or did not exist.
+     *         Returns false, if the file could not be read.
+     * \remarks An incomplete last line is not passed to the handler.
+     */
+    bool read(const LineHandler& handler);
+
+
+    /** \brief Appends lines to the file.
+     *
+     * \param lines  the lines, each one ended by a line break
+     * \return Returns true, if all lines were written.
+     * \remarks An incomplete last line of an interrupted write is removed
+     *          first.
+     */
+    bool append(const std::string& lines);
+
+
+    /** \brief Checks whether rewriting the file is worth it, i.e. whether
+     *         most of its lines are obsolete.
+     *
+     * \param entries  number of lines that are still required
+     * \param slack    number of obsolete lines that are always tolerated
+     * \return Returns true, if there are more than twice as many lines as
+     *         required, plus slack.
+     */
+    bool worthRewriting(const std::size_t entries, const std::size_t slack) const noexcept;
+
+
+    /** \brief Replaces the content of the file.
+     *
+     * \param content  the new content, each line ended by a line break
+     * \return Returns true, if the file was replaced.
+     * \remarks The content is written to a temporary file first, which then
+     *          replaces the file, so that an interruption keeps the old file.
+     */
+    bool rewrite(const std::string& content);
+
+
+    /** \brief Locks the file exclusively, so that no other process appends
+     *         to it, e.g. between reading and rewriting the file.
+     *
+     * \return Returns true, if the file is locked.
+     * \remarks Locks are only available on Linux. On other systems this
+     *          function does nothing and returns true.
+     */
+    bool lock();
+
+
+    /** \brief Releases the lock of lock().
+     */
+    void unlock();
+
+
+    /** \brief Gets the number of lines in the file, without empty lines and
+     *         comments.
+     *
+     * \return Returns the number of lines, as far as they were read or
+     *         written by this instance.
+     */
+    uint64_t lines() const noexcept;
+  private:
+    /** \brief Counts the lines of a string, without empty lines and comments.
+     *
+     * \param content  the string
+     * \return Returns the number of lines.
+     */
+    static uint64_t countLines(const std::string& content);
+
+
+    std::string m_FileName; /**< path of the file */
+    bool m_Synced; /**< whether writes wait until the data is on the disk */
+    uint64_t m_Lines; /**< number of lines in the file, without empty lines and comments */
+    int m_Lock; /**< descriptor of the locked file, or -1 */
+}; // class
+
+} // namespace
+
+#endif // SCANTOOL_FILESYSTEM_APPENDONLYFILE_HPP
@@ -0,0 +1,438 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "DirectoryWalker.hpp"
+#include <algorithm>
+#include <cstring>
+#include "Glob.hpp"
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+namespace scantool::filesystem
+{
+
+WalkOptions::WalkOptions()
+: include(std::vector<std::string>()),
+  exclude(std::vector<std::string>()),
+  oneFileSystem(false),
+  minSize(-1),
+  maxSize(-1),
+  threads(0)
+{
+}
+
+/** \brief Checks whether an entry matches one of the patterns.
+ *
+ * \param patterns      the glob patterns
+ * \param relativePath  path of the entry relative to the start directory
+ * \param name          name of the entry
+ * \return Returns true, if at least one pattern matches.
+ */
+static bool matchesAny(const std::vector<std::string>& patterns,
+                       const std::string& relativePath, const std::string& name)
+{
+  for (const auto& pattern : patterns)
+  {
+    const bool withPath = pattern.find('/') != std::string::npos;
+    if (globMatch(pattern, withPath ? relativePath : name))
+      return true;
+  }
+  return false;
+}
+
+bool WalkOptions::excludes(const std::string& relativePath, const std::string& name) const
+{
+  return matchesAny(exclude, relativePath, name);
+}
+
+bool WalkOptions::includes(const std::string& relativePath, const std::string& name) const
+{
+  if (!include.empty() && !matchesAny(include, relativePath, name))
+    return false;
+  return !excludes(relativePath, name);
+}
+
+bool WalkOptions::needsSize() const noexcept
+{
+  return (minSize >= 0) || (maxSize >= 0);
+}
+
+bool WalkOptions::sizeMatches(const int64_t size) const noexcept
+{
+  return ((minSize < 0) || (size >= minSize))
+      && ((maxSize < 0) || (size <= maxSize));
+}
+
+
+const std::size_t DirectoryWalker::cQueueLimit = 65536;
+
+/// number of directory entries after which found files are published
+static const std::size_t cPublishThreshold = 1024;
+
+#if defined(_WIN32)
+/// path separator of the operating system
+static const char cSeparator = '\\';
+#else
+/// path separator of the operating system
+static const char cSeparator = '/';
+#endif
+
+DirectoryWalker::DirectoryWalker(const WalkOptions& options)
+: m_Options(options),
+  m_Mutex(),
+  m_WorkChanged(),
+  m_FilesChanged(),
+  m_Pending(std::vector<Directory>()),
+  m_Active(0),
+  m_Files(std::deque<std::string>()),
+  m_Failed(std::vector<std::string>()),
+  m_Stop(false),
+  m_Threads(std::vector<std::thread>())
+{
+}
+
+DirectoryWalker::~DirectoryWalker()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Stop = true;
+  }
+  m_WorkChanged.notify_all();
+  m_FilesChanged.notify_all();
+  for (auto& thread : m_Threads)
+  {
+    thread.join();
+  }
+}
+
+bool DirectoryWalker::start(const std::vector<std::string>& directories)
+{
+  if (!m_Threads.empty())
+    return false;
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    // Reverse order, because the last pending directory is read first.
+    for (auto iter = directories.rbegin(); iter != directories.rend(); ++iter)
+    {
+      Directory dir{ *iter, std::string(), 0 };
+      #if !defined(_WIN32)
+      struct stat status;
+      if (stat(iter->c_str(), &status) == 0)
+        dir.device = static_cast<uint64_t>(status.st_dev);
+      #endif
+      m_Pending.push_back(std::move(dir));
+    }
+  }
+  unsigned int threads = m_Options.threads;
+  if (threads == 0)
+  {
+    // Reading directories mostly waits for the disk, so even single core
+    // systems benefit from some parallel reads.
+    threads = std::min(16u, std::max(4u, std::thread::hardware_concurrency()));
+  }
+  for (unsigned int i = 0; i < threads; ++i)
+  {
+    m_Threads.emplace_back(&DirectoryWalker::work, this);
+  }
+  return true;
+}
+
+bool DirectoryWalker::next(std::vector<std::string>& files, const std::size_t maxCount)
+{
+  files.clear();
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  m_FilesChanged.wait(lock, [this]
+      { return !m_Files.empty() || m_Stop || (m_Pending.empty() && (m_Active == 0)); });
+  while (!m_Files.empty() && (files.size() < maxCount))
+  {
+    files.push_back(std::move(m_Files.front()));
+    m_Files.pop_front();
+  }
+  lock.unlock();
+  // There is space in the queue again.
+  m_FilesChanged.notify_all();
+  return !files.empty();
+}
+
+std::vector<std::string> DirectoryWalker::failedDirectories() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Failed;
+}
+
+void DirectoryWalker::work()
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  while (true)
+  {
+    m_WorkChanged.wait(lock, [this]
+        { return m_Stop || !m_Pending.empty() || (m_Active == 0); });
+    // No pending and no active directories means that the walk is complete.
+    if (m_Stop || m_Pending.empty())
+      break;
+    const Directory dir = std::move(m_Pending.back());
+    m_Pending.pop_back();
+    ++m_Active;
+    lock.unlock();
+    const bool success = readDirectory(dir);
+    lock.lock();
+    if (!success)
+      m_Failed.push_back(dir.path);
+    --m_Active;
+    if ((m_Active == 0) && m_Pending.empty())
+    {
+      m_WorkChanged.notify_all();
+      m_FilesChanged.notify_all();
+    }
+  }
+}
+
+bool DirectoryWalker::publish(std::vector<std::string>& files, std::vector<Directory>& directories)
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  if (!directories.empty())
+  {
+    for (auto& dir : directories)
+    {
+      m_Pending.push_back(std::move(dir));
+    }
+    directories.clear();
+    m_WorkChanged.notify_all();
+  }
+  for (auto& file : files)
+  {
+    if (m_Files.size() >= cQueueLimit)
+    {
+      m_FilesChanged.notify_all();
+      m_FilesChanged.wait(lock, [this] { return m_Stop || (m_Files.size() < cQueueLimit); });
+    }
+    if (m_Stop)
+      break;
+    m_Files.push_back(std::move(file));
+  }
+  files.clear();
+  const bool stopped = m_Stop;
+  lock.unlock();
+  m_FilesChanged.notify_all();
+  return !stopped;
+}
+
+#if defined(_WIN32)
+bool DirectoryWalker::readDirectory(const Directory& dir)
+{
+  std::string prefix = dir.path;
+  if (!prefix.empty() && (prefix.back() != '\\') && (prefix.back() != '/'))
+    prefix += cSeparator;
+  WIN32_FIND_DATAA data;
+  HANDLE handle = FindFirstFileA((prefix + "*").c_str(), &data);
+  if (handle == INVALID_HANDLE_VALUE)
+    return false;
+  std::vector<std::string> files;
+  std::vector<Directory> directories;
+  bool proceed = true;
+  do
+  {
+    const std::string name = data.cFileName;
+    if ((name == ".") || (name == ".."))
+      continue;
+    // Reparse points like symbolic links and junctions are not followed.
+    if ((data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0)
+      continue;
+    const std::string relativePath = dir.relativePath.empty() ? name : dir.relativePath + "/" + name;
+    if ((data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0)
+    {
+      if (!m_Options.excludes(relativePath, name))
+        directories.push_back(Directory{ prefix + name, relativePath, dir.device });
+    }
+    else if (m_Options.includes(relativePath, name))
+    {
+      const int64_t size = (static_cast<int64_t>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+      if (m_Options.sizeMatches(size))
+        files.push_back(prefix + name);
+    }
+    if (files.size() + directories.size() >= cPublishThreshold)
+      proceed = publish(files, directories);
+  } while (proceed && (FindNextFileA(handle, &data) != 0));
+  FindClose(handle);
+  if (proceed)
+    publish(files, directories);
+  return true;
+}
+#else
+/// types of directory entries
+enum class EntryType { File, Directory, Other, Unknown };
+
+/** \brief Gets the type of a directory entry from its status.
+ *
+ * \param dirFd  descriptor of the directory
+ * \param name   name of the entry
+ * \param size   variable that will hold the size of the entry
+ * \return Returns the type of the entry.
+ */
+static EntryType typeFromStatus(const int dirFd, const char* name, int64_t& size)
+{
+  struct stat status;
+  if (fstatat(dirFd, name, &status, AT_SYMLINK_NOFOLLOW) != 0)
+    return EntryType::Unknown;
+  size = static_cast<int64_t>(status.st_size);
+  if (S_ISREG(status.st_mode))
+    return EntryType::File;
+  if (S_ISDIR(status.st_mode))
+    return EntryType::Directory;
+  return EntryType::Other;
+}
+
+/** \brief Gets the type of a directory entry from the type in the directory.
+ *
+ * \param type  value of d_type
+ * \return Returns the type of the entry.
+ */
+static EntryType typeFromDirectory(const unsigned char type)
+{
+  switch (type)
+  {
+    case DT_REG:
+         return EntryType::File;
+    case DT_DIR:
+         return EntryType::Directory;
+    case DT_UNKNOWN:
+         return EntryType::Unknown;
+    default:
+         return EntryType::Other;
+  }
+}
+
+bool DirectoryWalker::readDirectory(const Directory& dir)
+{
+  int flags = O_RDONLY | O_DIRECTORY | O_CLOEXEC;
+  // Only the start directories may be symbolic links.
+  if (!dir.relativePath.empty())
+    flags |= O_NOFOLLOW;
+  const int fd = open(dir.path.c_str(), flags);
+  if (fd < 0)
+    return false;
+  if (m_Options.oneFileSystem && !dir.relativePath.empty())
+  {
+    struct stat status;
+    if ((fstat(fd, &status) != 0) || (static_cast<uint64_t>(status.st_dev) != dir.device))
+    {
+      close(fd);
+      return true;
+    }
+  }
+
+  std::string prefix = dir.path;
+  if (!prefix.empty() && (prefix.back() != cSeparator))
+    prefix += cSeparator;
+  std::vector<std::string> files;
+  std::vector<Directory> directories;
+  const bool hasPatterns = !m_Options.include.empty() || !m_Options.exclude.empty();
+  const auto handleEntry = [&](const char* entryName, const unsigned char type)
+  {
+    const std::string name = entryName;
+    if ((name == ".") || (name == ".."))
+      return;
+    int64_t size = -1;
+    EntryType entryType = typeFromDirectory(type);
+    if (entryType == EntryType::Unknown)
+      entryType = typeFromStatus(fd, entryName, size);
+    if ((entryType != EntryType::File) && (entryType != EntryType::Directory))
+      return;
+    // Without patterns the relative path is not needed for files.
+    if ((entryType == EntryType::Directory) || hasPatterns)
+    {
+      const std::string relativePath = dir.relativePath.empty() ? name : dir.relativePath + "/" + name;
+      if (entryType == EntryType::Directory)
+      {
+        if (!m_Options.excludes(relativePath, name))
+          directories.push_back(Directory{ prefix + name, relativePath, dir.device });
+        return;
+      }
+      if (!m_Options.includes(relativePath, name))
+        return;
+    }
+    if (m_Options.needsSize())
+    {
+      if ((size < 0) && (typeFromStatus(fd, entryName, size) != EntryType::File))
+        return;
+      if (!m_Options.sizeMatches(size))
+        return;
+    }
+    files.push_back(prefix + name);
+  };
+
+  bool success = true;
+  bool proceed = true;
+  #if defined(__linux__)
+  // getdents64 fills a large buffer at once, readdir would use 32 KiB.
+  static thread_local std::vector<char> buffer(128 * 1024);
+  while (proceed)
+  {
+    const long count = syscall(SYS_getdents64, fd, buffer.data(), buffer.size());
+    if (count <= 0)
+    {
+      success = (count == 0);
+      break;
+    }
+    // struct linux_dirent64: d_ino (8), d_off (8), d_reclen (2), d_type (1), d_name
+    for (long pos = 0; pos < count; )
+    {
+      unsigned short recordLength = 0;
+      std::memcpy(&recordLength, buffer.data() + pos + 16, sizeof(recordLength));
+      const unsigned char type = static_cast<unsigned char>(buffer[pos + 18]);
+      handleEntry(buffer.data() + pos + 19, type);
+      pos += recordLength;
+    }
+    proceed = publish(files, directories);
+  }
+  close(fd);
+  #else
+  DIR* stream = fdopendir(fd);
+  if (stream == nullptr)
+  {
+    close(fd);
+    return false;
+  }
+  const struct dirent* entry = nullptr;
+  while (proceed && ((entry = readdir(stream)) != nullptr))
+  {
+    handleEntry(entry->d_name, entry->d_type);
+    if (files.size() + directories.size() >= cPublishThreshold)
+      proceed = publish(files, directories);
+  }
+  // closedir() also closes the descriptor.
+  closedir(stream);
+  if (proceed)
+    publish(files, directories);
+  #endif
+  return success;
+}
+#endif
+
+} // namespace
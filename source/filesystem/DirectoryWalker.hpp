@@ -0,0 +1,203 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_FILESYSTEM_DIRECTORYWALKER_HPP
+#define SCANTOOL_FILESYSTEM_DIRECTORYWALKER_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "FileFeed.hpp"
+
+namespace scantool::filesystem
+{
+
+/** \brief Settings that decide which files a DirectoryWalker finds.
+ */
+struct WalkOptions
+{
+  /** \brief Default constructor, finds all regular files.
+   */
+  WalkOptions();
+
+
+  /** \brief Patterns of files to include, see globMatch(). If the list is
+   *  not empty, only files that match at least one pattern are found.
+   *  Patterns without "/" are matched against the file name, others against
+   *  the path relative to the directory where the walk started.
+   */
+  std::vector<std::string> include;
+
+  /** \brief Patterns of files and directories to exclude, matched like the
+   *  include patterns. Excluded directories are not entered at all.
+   */
+  std::vector<std::string> exclude;
+
+  bool oneFileSystem; /**< whether to skip directories on other file systems */
+  int64_t minSize; /**< minimum size of files in octets, or -1 for no limit */
+  int64_t maxSize; /**< maximum size of files in octets, or -1 for no limit */
+  unsigned int threads; /**< number of threads, or zero to choose automatically */
+
+
+  /** \brief Checks whether an entry is excluded.
+   *
+   * \param relativePath  path of the entry relative to the start directory
+   * \param name          name of the entry
+   * \return Returns true, if the entry matches an exclude pattern.
+   */
+  bool excludes(const std::string& relativePath, const std::string& name) const;
+
+
+  /** \brief Checks whether a file is included.
+   *
+   * \param relativePath  path of the file relative to the start directory
+   * \param name          name of the file
+   * \return Returns true, if the file matches an include pattern or if
+   *         there are no include patterns, and it is not excluded.
+   */
+  bool includes(const std::string& relativePath, const std::string& name) const;
+
+
+  /** \brief Checks whether the size filters require the size of each file.
+   *
+   * \return Returns true, if a minimum or maximum size is set.
+   */
+  bool needsSize() const noexcept;
+
+
+  /** \brief Checks whether a file size is within the limits.
+   *
+   * \param size  size of the file in octets
+   * \return Returns true, if the size is within the limits.
+   */
+  bool sizeMatches(const int64_t size) const noexcept;
+}; // struct
+
+
+/** \brief Finds the regular files in directory trees with several threads.
+ *
+ * The threads take directories from a shared stack, read their entries in
+ * large blocks (getdents64 on Linux) and use the entry types from the
+ * directory instead of getting the status of each entry. Found files are
+ * passed to the consumer through a bounded queue, so that the consumer can
+ * process the first files while the walk goes on. Symbolic links are never
+ * followed.
+ */
+class DirectoryWalker: public FileFeed
+{
+  public:
+    /** \brief Constructor.
+     *
+     * \param options  settings for the walk
+     */
+    explicit DirectoryWalker(const WalkOptions& options);
+
+
+    /** \brief Destructor, stops the walk.
+     */
+    ~DirectoryWalker();
+
+
+    DirectoryWalker(const DirectoryWalker& other) = delete;
+    DirectoryWalker& operator=(const DirectoryWalker& other) = delete;
+
+
+    /// maximum number of found files that wait for the consumer
+    static const std::size_t cQueueLimit;
+
+
+    /** \brief Starts the walk in the background.
+     *
+     * \param directories  the directories where the walk starts
+     * \return Returns true, if the walk was started. Returns false, if it
+     *         was already started.
+     */
+    bool start(const std::vector<std::string>& directories);
+
+
+    /** \brief Gets the next found files, waiting until there are some.
+     *
+     * \param files     vector that will hold the file names
+     * \param maxCount  maximum number of files to get
+     * \return Returns true, if files were found. Returns false, if the walk
+     *         is complete and all found files have been returned.
+     */
+    virtual bool next(std::vector<std::string>& files, const std::size_t maxCount) override;
+
+
+    /** \brief Gets the directories that could not be read.
+     *
+     * \return Returns the names of the directories that could not be opened
+     *         or read so far.
+     */
+    std::vector<std::string> failedDirectories() const;
+  private:
+    /// directory that waits to be read
+    struct Directory
+    {
+      std::string path; /**< path of the directory */
+      std::string relativePath; /**< path relative to the start directory, "/" as separator; empty for the start directory */
+      uint64_t device; /**< device of the start directory */
+    };
+
+
+    /** \brief Main function of the walker threads.
+     */
+    void work();
+
+
+    /** \brief Reads the entries of a directory.
+     *
+     * \param dir  the directory
+     * \return Returns true, if the directory could be read.
+     */
+    bool readDirectory(const Directory& dir);
+
+
+    /** \brief Passes found files and directories to the consumer and the
+     *         other threads.
+     *
+     * \param files        found files; will be cleared
+     * \param directories  found directories; will be cleared
+     * \return Returns false, if the walk was stopped.
+     */
+    bool publish(std::vector<std::string>& files, std::vector<Directory>& directories);
+
+
+    WalkOptions m_Options; /**< settings for the walk */
+    mutable std::mutex m_Mutex; /**< protects the members below */
+    std::condition_variable m_WorkChanged; /**< signals new directories or the end of the walk */
+    std::condition_variable m_FilesChanged; /**< signals new files for the consumer or free space in the queue */
+    std::vector<Directory> m_Pending; /**< directories that have to be read */
+    unsigned int m_Active; /**< number of directories that are currently read */
+    std::deque<std::string> m_Files; /**< found files that wait for the consumer */
+    std::vector<std::string> m_Failed; /**< directories that could not be read */
+    bool m_Stop; /**< whether the walk shall stop */
+    std::vector<std::thread> m_Threads; /**< walker threads */
+}; // class
+
+} // namespace
+
+#endif // SCANTOOL_FILESYSTEM_DIRECTORYWALKER_HPP
@@ -0,0 +1,331 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "DirectoryWatcher.hpp"
+#include <algorithm>
+#include <cerrno>
+#if defined(__linux__)
+#include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace scantool::filesystem
+{
+
+#if defined(__linux__)
+/// events that are watched in each directory
+static const uint32_t cWatchMask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MODIFY | IN_CREATE
+                                 | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR | IN_DONT_FOLLOW
+                                 | IN_EXCL_UNLINK;
+#endif
+
+DirectoryWatcher::DirectoryWatcher(const WalkOptions& options, const std::chrono::milliseconds quietPeriod)
+: m_Options(options),
+  m_QuietPeriod(quietPeriod),
+  m_Fd(-1),
+  m_Roots(std::vector<Directory>()),
+  m_Watches(std::unordered_map<int, Directory>()),
+  m_Changed(std::unordered_map<std::string, std::chrono::steady_clock::time_point>()),
+  m_Failed(std::vector<std::string>()),
+  m_EventsLost(false)
+{
+}
+
+DirectoryWatcher::~DirectoryWatcher()
+{
+  #if defined(__linux__)
+  // Closing the descriptor removes all watches.
+  if (m_Fd >= 0)
+    close(m_Fd);
+  #endif
+}
+
+bool DirectoryWatcher::supported() noexcept
+{
+  #if defined(__linux__)
+  return true;
+  #else
+  return false;
+  #endif
+}
+
+bool DirectoryWatcher::start(const std::vector<std::string>& directories)
+{
+  #if defined(__linux__)
+  if (m_Fd >= 0)
+    return false;
+  m_Fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (m_Fd < 0)
+    return false;
+  bool success = true;
+  for (const auto& path : directories)
+  {
+    Directory root{ path, std::string(), 0 };
+    struct stat status;
+    if (stat(path.c_str(), &status) == 0)
+      root.device = static_cast<uint64_t>(status.st_dev);
+    m_Roots.push_back(root);
+    // Existing files are not reported, only the ones that change later.
+    success = watchTree(root, false) && success;
+  }
+  return success;
+  #else
+  (void) directories;
+  return false;
+  #endif
+}
+
+bool DirectoryWatcher::watchTree(const Directory& root, const bool reportFiles)
+{
+  #if defined(__linux__)
+  std::vector<Directory> pending = { root };
+  bool rootWatched = false;
+  bool isRoot = true;
+  while (!pending.empty())
+  {
+    const Directory dir = std::move(pending.back());
+    pending.pop_back();
+    const bool wasRoot = isRoot;
+    isRoot = false;
+    // Start directories may be symbolic links, all others are not followed.
+    struct stat status;
+    const int statResult = dir.relativePath.empty() ? stat(dir.path.c_str(), &status)
+                                                    : lstat(dir.path.c_str(), &status);
+    if ((statResult != 0) || !S_ISDIR(status.st_mode))
+    {
+      // A missing start directory is an error, a vanished subdirectory is not.
+      if (wasRoot)
+        m_Failed.push_back(dir.path);
+      continue;
+    }
+    if (m_Options.oneFileSystem && !dir.relativePath.empty()
+        && (static_cast<uint64_t>(status.st_dev) != dir.device))
+      continue;
+    /* The watch is added before the entries are read, so files that are
+       created in between are not missed. */
+    const uint32_t mask = dir.relativePath.empty() ? (cWatchMask & ~IN_DONT_FOLLOW) : cWatchMask;
+    const int wd = inotify_add_watch(m_Fd, dir.path.c_str(), mask);
+    if (wd < 0)
+    {
+      m_Failed.push_back(dir.path);
+      continue;
+    }
+    m_Watches[wd] = dir;
+    rootWatched = rootWatched || wasRoot;
+
+    DIR* handle = opendir(dir.path.c_str());
+    if (handle == nullptr)
+      continue;
+    const std::string prefix = (dir.path.back() == '/') ? dir.path : dir.path + "/";
+    while (const struct dirent* entry = readdir(handle))
+    {
+      const std::string name = entry->d_name;
+      if ((name == ".") || (name == ".."))
+        continue;
+      unsigned char type = entry->d_type;
+      if (type == DT_UNKNOWN)
+      {
+        struct stat entryStatus;
+        if (fstatat(dirfd(handle), entry->d_name, &entryStatus, AT_SYMLINK_NOFOLLOW) != 0)
+          continue;
+        type = S_ISDIR(entryStatus.st_mode) ? DT_DIR : (S_ISREG(entryStatus.st_mode) ? DT_REG : DT_UNKNOWN);
+      }
+      if (type == DT_DIR)
+      {
+        const std::string relativePath = dir.relativePath.empty() ? name : dir.relativePath + "/" + name;
+        if (!m_Options.excludes(relativePath, name))
+          pending.push_back(Directory{ prefix + name, relativePath, dir.device });
+      }
+      else if ((type == DT_REG) && reportFiles)
+      {
+        fileChanged(dir, name);
+      }
+    } // while
+    closedir(handle);
+  } // while
+  return rootWatched;
+  #else
+  (void) root;
+  (void) reportFiles;
+  return false;
+  #endif
+}
+
+void DirectoryWatcher::fileChanged(const Directory& dir, const std::string& name)
+{
+  const std::string relativePath = dir.relativePath.empty() ? name : dir.relativePath + "/" + name;
+  if (!m_Options.includes(relativePath, name))
+    return;
+  const std::string path = (dir.path.back() == '/') ? dir.path + name : dir.path + "/" + name;
+  m_Changed[path] = std::chrono::steady_clock::now();
+}
+
+bool DirectoryWatcher::readEvents()
+{
+  #if defined(__linux__)
+  alignas(struct inotify_event) char buffer[65536];
+  while (true)
+  {
+    const ssize_t length = read(m_Fd, buffer, sizeof(buffer));
+    if (length < 0)
+      return (errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR);
+    if (length == 0)
+      return true;
+    std::size_t offset = 0;
+    while (offset + sizeof(struct inotify_event) <= static_cast<std::size_t>(length))
+    {
+      const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+      offset += sizeof(struct inotify_event) + event->len;
+      if ((event->mask & IN_Q_OVERFLOW) != 0)
+      {
+        // Events were dropped, so every file may have changed.
+        m_EventsLost = true;
+        for (const auto& root : m_Roots)
+        {
+          watchTree(root, true);
+        }
+        continue;
+      }
+      const auto watch = m_Watches.find(event->wd);
+      if (watch == m_Watches.end())
+        continue;
+      if ((event->mask & IN_IGNORED) != 0)
+      {
+        m_Watches.erase(watch);
+        continue;
+      }
+      if ((event->mask & IN_MOVE_SELF) != 0)
+      {
+        // The stored path is wrong now. A move within a watched directory
+        // is noticed by the new parent directory.
+        inotify_rm_watch(m_Fd, event->wd);
+        continue;
+      }
+      if (event->len == 0)
+        continue;
+      const Directory& dir = watch->second;
+      const std::string name = event->name;
+      if ((event->mask & IN_ISDIR) != 0)
+      {
+        if ((event->mask & (IN_CREATE | IN_MOVED_TO)) == 0)
+          continue;
+        const std::string relativePath = dir.relativePath.empty() ? name : dir.relativePath + "/" + name;
+        if (m_Options.excludes(relativePath, name))
+          continue;
+        const std::string prefix = (dir.path.back() == '/') ? dir.path : dir.path + "/";
+        // Files may have been added before the watch exists.
+        watchTree(Directory{ prefix + name, relativePath, dir.device }, true);
+      }
+      else if ((event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) != 0)
+      {
+        fileChanged(dir, name);
+      }
+      else if ((event->mask & IN_MODIFY) != 0)
+      {
+        // Files that are still written wait for another quiet period.
+        const std::string path = (dir.path.back() == '/') ? dir.path + name : dir.path + "/" + name;
+        const auto changed = m_Changed.find(path);
+        if (changed != m_Changed.end())
+          changed->second = std::chrono::steady_clock::now();
+      }
+    } // while
+  } // while
+  #else
+  return false;
+  #endif
+}
+
+bool DirectoryWatcher::wait(std::vector<std::string>& files, const std::size_t maxCount,
+                            const std::chrono::milliseconds timeout)
+{
+  files.clear();
+  #if defined(__linux__)
+  if (m_Fd < 0)
+    return false;
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (true)
+  {
+    // Report the files that had no events during the quiet period.
+    auto now = std::chrono::steady_clock::now();
+    auto wakeUp = deadline;
+    auto iter = m_Changed.begin();
+    while ((iter != m_Changed.end()) && (files.size() < maxCount))
+    {
+      const auto due = iter->second + m_QuietPeriod;
+      if (due > now)
+      {
+        wakeUp = std::min(wakeUp, due);
+        ++iter;
+        continue;
+      }
+      // Deleted files, symbolic links and files outside the size limits are skipped.
+      struct stat status;
+      if ((lstat(iter->first.c_str(), &status) == 0) && S_ISREG(status.st_mode)
+          && m_Options.sizeMatches(static_cast<int64_t>(status.st_size)))
+        files.push_back(iter->first);
+      iter = m_Changed.erase(iter);
+    }
+    if (!files.empty())
+      return true;
+    if (m_Watches.empty() && m_Changed.empty())
+      return false;
+    if (now >= deadline)
+      return true;
+
+    const auto waitTime = std::chrono::duration_cast<std::chrono::milliseconds>(wakeUp - now).count() + 1;
+    struct pollfd descriptor = { m_Fd, POLLIN, 0 };
+    const int ready = poll(&descriptor, 1, static_cast<int>(std::min<int64_t>(waitTime, 60000)));
+    // Signals end the wait, so that the caller can handle them.
+    if (ready < 0)
+      return errno == EINTR;
+    if ((ready > 0) && !readEvents())
+      return false;
+  } // while
+  #else
+  (void) maxCount;
+  (void) timeout;
+  return false;
+  #endif
+}
+
+std::size_t DirectoryWatcher::directoryCount() const noexcept
+{
+  return m_Watches.size();
+}
+
+std::vector<std::string> DirectoryWatcher::takeFailedDirectories()
+{
+  std::vector<std::string> result;
+  result.swap(m_Failed);
+  return result;
+}
+
+bool DirectoryWatcher::takeEventsLost() noexcept
+{
+  const bool lost = m_EventsLost;
+  m_EventsLost = false;
+  return lost;
+}
+
+} // namespace
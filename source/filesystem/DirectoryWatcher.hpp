@@ -0,0 +1,166 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_FILESYSTEM_DIRECTORYWATCHER_HPP
+#define SCANTOOL_FILESYSTEM_DIRECTORYWATCHER_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "DirectoryWalker.hpp"
+
+namespace scantool::filesystem
+{
+
+/** \brief Watches directory trees for new and changed files via inotify.
+ *
+ * Files are reported after they were closed after writing or moved into a
+ * watched directory, and no further event occurred for them during the
+ * quiet period. So a file that is written in several steps is only
+ * reported once. New subdirectories are watched, too, and the files they
+ * already contain are reported. Symbolic links are not followed.
+ *
+ * Watching is only supported on Linux.
+ */
+class DirectoryWatcher
+{
+  public:
+    /** \brief Constructor.
+     *
+     * \param options      filters for the reported files; the number of
+     *                     threads is not used
+     * \param quietPeriod  time without events after which a file is reported
+     */
+    DirectoryWatcher(const WalkOptions& options, const std::chrono::milliseconds quietPeriod);
+
+
+    /** \brief Destructor, stops watching.
+     */
+    ~DirectoryWatcher();
+
+
+    DirectoryWatcher(const DirectoryWatcher& other) = delete;
+    DirectoryWatcher& operator=(const DirectoryWatcher& other) = delete;
+
+
+    /** \brief Checks whether watching directories is supported on the
+     *         current system.
+     *
+     * \return Returns true, if watching is supported.
+     */
+    static bool supported() noexcept;
+
+
+    /** \brief Starts watching the given directories and their subdirectories.
+     *
+     * \param directories  the directories to watch
+     * \return Returns true, if all given directories are watched.
+     *         Returns false, if watching is not supported or failed.
+     */
+    bool start(const std::vector<std::string>& directories);
+
+
+    /** \brief Waits for new or changed files.
+     *
+     * \param files     vector that will hold the names of the files
+     * \param maxCount  maximum number of files to get
+     * \param timeout   maximum time to wait for files
+     * \return Returns true, if watching goes on, even if no files were
+     *         reported within the timeout or the wait was interrupted by a
+     *         signal. Returns false, if there is nothing to watch anymore,
+     *         e.g. because all watched directories were deleted.
+     */
+    bool wait(std::vector<std::string>& files, const std::size_t maxCount,
+              const std::chrono::milliseconds timeout);
+
+
+    /** \brief Gets the number of watched directories.
+     *
+     * \return Returns the number of directories that are watched.
+     */
+    std::size_t directoryCount() const noexcept;
+
+
+    /** \brief Gets the directories that could not be watched since the last
+     *         call of this method.
+     *
+     * \return Returns the names of the directories that could not be
+     *         watched, e.g. because the limit of inotify watches was reached.
+     */
+    std::vector<std::string> takeFailedDirectories();
+
+
+    /** \brief Checks whether events were lost since the last call of this
+     *         method, because the event queue of the kernel overflowed.
+     *
+     * \return Returns true, if events were lost. All files of the watched
+     *         directories are reported again in that case.
+     */
+    bool takeEventsLost() noexcept;
+  private:
+    /// watched directory
+    struct Directory
+    {
+      std::string path; /**< path of the directory */
+      std::string relativePath; /**< path relative to the start directory, "/" as separator; empty for the start directory */
+      uint64_t device; /**< device of the start directory */
+    };
+
+
+    /** \brief Watches a directory and its subdirectories.
+     *
+     * \param root         the directory
+     * \param reportFiles  whether the files that already exist are reported
+     * \return Returns true, if the directory itself is watched.
+     */
+    bool watchTree(const Directory& root, const bool reportFiles);
+
+
+    /** \brief Notes an event for a file.
+     *
+     * \param dir   the directory that contains the file
+     * \param name  name of the file
+     */
+    void fileChanged(const Directory& dir, const std::string& name);
+
+
+    /** \brief Reads and handles the available events.
+     *
+     * \return Returns false, if the events could not be read.
+     */
+    bool readEvents();
+
+
+    WalkOptions m_Options; /**< filters for the reported files */
+    std::chrono::milliseconds m_QuietPeriod; /**< time without events before a file is reported */
+    int m_Fd; /**< inotify file descriptor, or -1 */
+    std::vector<Directory> m_Roots; /**< directories where watching started */
+    std::unordered_map<int, Directory> m_Watches; /**< watched directories by watch descriptor */
+    std::unordered_map<std::string, std::chrono::steady_clock::time_point> m_Changed; /**< changed files and the time of their last event */
+    std::vector<std::string> m_Failed; /**< directories that could not be watched */
+    bool m_EventsLost; /**< whether the kernel dropped events */
+}; // class
+
+} // namespace
+
+#endif // SCANTOOL_FILESYSTEM_DIRECTORYWATCHER_HPP
@@ -0,0 +1,53 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_FILESYSTEM_FILEFEED_HPP
+#define SCANTOOL_FILESYSTEM_FILEFEED_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace scantool::filesystem
+{
+
+/** \brief Interface for sources that provide the files to scan bit by bit,
+ *         e.g. directory walks or file lists.
+ */
+class FileFeed
+{
+  public:
+    ///virtual destructor
+    virtual ~FileFeed() {}
+
+
+    /** \brief Gets the next files, waiting until there are some.
+     *
+     * \param files     vector that will hold the file names
+     * \param maxCount  maximum number of files to get
+     * \return Returns true, if files were found. Returns false, if there
+     *         are no more files.
+     */
+    virtual bool next(std::vector<std::string>& files, const std::size_t maxCount) = 0;
+}; // class
+
+} // namespace
+
+#endif // SCANTOOL_FILESYSTEM_FILEFEED_HPP
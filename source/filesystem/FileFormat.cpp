@@ -0,0 +1,113 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "FileFormat.hpp"
+#include <cstring>
+
+namespace scantool::filesystem
+{
+
+// The volume descriptor of an ISO 9660 image starts at 32768 and has the
+// identifier "CD001" after the type octet.
+const std::size_t cIsoDescriptorOffset = 32768;
+
+const std::size_t cSniffSize = cIsoDescriptorOffset + 6;
+
+/** \brief Checks whether data contains the given magic bytes at an offset.
+ *
+ * \param data    the data
+ * \param length  length of data in octets
+ * \param offset  offset of the magic bytes
+ * \param magic   the magic bytes
+ * \param size    number of magic bytes
+ * \return Returns true, if the magic bytes are found at the offset.
+ */
+static bool hasMagic(const uint8_t* data, const std::size_t length, const std::size_t offset,
+                     const char* magic, const std::size_t size)
+{
+  return (length >= offset + size) && (std::memcmp(data + offset, magic, size) == 0);
+}
+
+/** \brief Checks whether data starts with a tar header with a valid checksum.
+ *
+ * \param data    the data
+ * \param length  length of data in octets
+ * \return Returns true, if a valid header was found.
+ * \remarks This also detects old tar archives without the "ustar" magic.
+ */
+static bool hasTarHeader(const uint8_t* data, const std::size_t length)
+{
+  const std::size_t cHeaderSize = 512;
+  const std::size_t cChecksumOffset = 148;
+  const std::size_t cChecksumSize = 8;
+  if (length < cHeaderSize)
+    return false;
+  // The checksum is an octal number, followed by NUL or space.
+  unsigned int recorded = 0;
+  std::size_t digits = 0;
+  std::size_t pos = cChecksumOffset;
+  while ((pos < cChecksumOffset + cChecksumSize) && (data[pos] == ' '))
+    ++pos;
+  while ((pos < cChecksumOffset + cChecksumSize) && (data[pos] >= '0') && (data[pos] <= '7'))
+  {
+    recorded = recorded * 8 + (data[pos] - '0');
+    ++digits;
+    ++pos;
+  }
+  if ((digits == 0) || ((pos < cChecksumOffset + cChecksumSize) && (data[pos] != ' ') && (data[pos] != '\0')))
+    return false;
+  // The checksum field itself counts as eight spaces.
+  unsigned int computed = cChecksumSize * ' ';
+  for (std::size_t i = 0; i < cHeaderSize; ++i)
+  {
+    if ((i < cChecksumOffset) || (i >= cChecksumOffset + cChecksumSize))
+      computed += data[i];
+  }
+  // An all-zero header would match, too, but it is not a tar file.
+  return (computed == recorded) && (computed != cChecksumSize * ' ');
+}
+
+FileFormat sniffFormat(const uint8_t* data, const std::size_t length)
+{
+  if (hasMagic(data, length, 0, "PK\x03\x04", 4) || hasMagic(data, length, 0, "PK\x05\x06", 4)
+      || hasMagic(data, length, 0, "PK\x07\x08", 4))
+    return FileFormat::Zip;
+  if (hasMagic(data, length, 0, "7z\xBC\xAF\x27\x1C", 6))
+    return FileFormat::SevenZip;
+  if (hasMagic(data, length, 0, "\x1F\x8B", 2))
+    return FileFormat::Gzip;
+  if (hasMagic(data, length, 0, "\xFD" "7zXZ\x00", 6))
+    return FileFormat::Xz;
+  if (hasMagic(data, length, 0, "!<arch>\n", 8))
+    return FileFormat::Ar;
+  if (hasMagic(data, length, 0, "MSCF\x00\x00\x00\x00", 8))
+    return FileFormat::Cab;
+  if (hasMagic(data, length, 0, "ISc(", 4))
+    return FileFormat::InstallShield;
+  if (hasMagic(data, length, 0, "Rar!\x1A\x07", 6))
+    return FileFormat::Rar;
+  if (hasMagic(data, length, 257, "ustar", 5) || hasTarHeader(data, length))
+    return FileFormat::Tar;
+  if (hasMagic(data, length, cIsoDescriptorOffset + 1, "CD001", 5))
+    return FileFormat::ISO9660;
+  return FileFormat::Unknown;
+}
+
+} // namespace
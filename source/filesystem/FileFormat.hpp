@@ -0,0 +1,85 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_FILESYSTEM_FILEFORMAT_HPP
+#define SCANTOOL_FILESYSTEM_FILEFORMAT_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace scantool::filesystem
+{
+
+/** enumeration of file formats that can be handled by scan-tool */
+enum class FileFormat
+{
+  /** none of the formats below */
+  Unknown,
+
+  /** ZIP archive */
+  Zip,
+
+  /** 7-Zip archive */
+  SevenZip,
+
+  /** tar archive */
+  Tar,
+
+  /** gzip compressed file */
+  Gzip,
+
+  /** Ar archive, e.g. Debian packages */
+  Ar,
+
+  /** XZ compressed file */
+  Xz,
+
+  /** ISO 9660 disk image */
+  ISO9660,
+
+  /** Microsoft Cabinet archive */
+  Cab,
+
+  /** InstallShield Cabinet archive */
+  InstallShield,
+
+  /** Roshal archive */
+  Rar
+};
+
+
+/// number of octets at the start of a file that are needed to detect all formats
+extern const std::size_t cSniffSize;
+
+
+/** \brief Detects the format of a file by the magic bytes at its start.
+ *
+ * \param data    the start of the file
+ * \param length  length of data in octets; should be at least cSniffSize,
+ *                unless the file is shorter
+ * \return Returns the detected format.
+ * \remarks ISO 9660 images are only detected, if data contains the first
+ *          volume descriptor at offset 32768.
+ */
+FileFormat sniffFormat(const uint8_t* data, const std::size_t length);
+
+} // namespace
+
+#endif // SCANTOOL_FILESYSTEM_FILEFORMAT_HPP
@@ -0,0 +1,150 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "Glob.hpp"
+
+namespace scantool::filesystem
+{
+
+/** \brief Matches a character against a set like "[a-z]".
+ *
+ * \param pattern  the glob pattern
+ * \param pos      position of the opening bracket; will be set to the
+ *                 position after the closing bracket
+ * \param c        the character to match
+ * \param matched  variable that will be set to true, if c is in the set
+ * \return Returns false, if the set is not terminated by "]".
+ */
+static bool matchSet(const std::string& pattern, std::string::size_type& pos, const char c, bool& matched)
+{
+  std::string::size_type i = pos + 1;
+  bool negated = false;
+  if ((i < pattern.size()) && ((pattern[i] == '!') || (pattern[i] == '^')))
+  {
+    negated = true;
+    ++i;
+  }
+  matched = false;
+  bool first = true;
+  while (i < pattern.size())
+  {
+    // A closing bracket right at the start is part of the set.
+    if ((pattern[i] == ']') && !first)
+    {
+      pos = i + 1;
+      matched = (matched != negated) && (c != '/');
+      return true;
+    }
+    first = false;
+    char low = pattern[i];
+    if ((low == '\\') && (i + 1 < pattern.size()))
+      low = pattern[++i];
+    char high = low;
+    if ((i + 2 < pattern.size()) && (pattern[i + 1] == '-') && (pattern[i + 2] != ']'))
+    {
+      i += 2;
+      high = pattern[i];
+      if ((high == '\\') && (i + 1 < pattern.size()))
+        high = pattern[++i];
+    }
+    if ((static_cast<unsigned char>(c) >= static_cast<unsigned char>(low))
+        && (static_cast<unsigned char>(c) <= static_cast<unsigned char>(high)))
+      matched = true;
+    ++i;
+  }
+  return false;
+}
+
+/** \brief Matches the remaining part of a path against the remaining part
+ *         of a pattern.
+ *
+ * \param pattern  the glob pattern
+ * \param p        position in the pattern
+ * \param path     the path
+ * \param t        position in the path
+ * \return Returns true, if the rest of the path matches the rest of the
+ *         pattern.
+ */
+static bool matchFrom(const std::string& pattern, std::string::size_type p,
+                      const std::string& path, std::string::size_type t)
+{
+  while (p < pattern.size())
+  {
+    const char c = pattern[p];
+    if (c == '*')
+    {
+      const bool deep = (p + 1 < pattern.size()) && (pattern[p + 1] == '*');
+      while ((p < pattern.size()) && (pattern[p] == '*'))
+        ++p;
+      if (p == pattern.size())
+        return deep || (path.find('/', t) == std::string::npos);
+      // "**/" also matches no directory at all.
+      if (deep && (pattern[p] == '/') && matchFrom(pattern, p + 1, path, t))
+        return true;
+      for (std::string::size_type k = t; k <= path.size(); ++k)
+      {
+        if (matchFrom(pattern, p, path, k))
+          return true;
+        if (!deep && (k < path.size()) && (path[k] == '/'))
+          return false;
+      }
+      return false;
+    }
+    if (t == path.size())
+      return false;
+    if (c == '?')
+    {
+      if (path[t] == '/')
+        return false;
+      ++p;
+      ++t;
+      continue;
+    }
+    if (c == '[')
+    {
+      std::string::size_type next = p;
+      bool matched = false;
+      if (matchSet(pattern, next, path[t], matched))
+      {
+        if (!matched)
+          return false;
+        p = next;
+        ++t;
+        continue;
+      }
+      // Unterminated sets are taken literally.
+    }
+    char literal = c;
+    if ((c == '\\') && (p + 1 < pattern.size()))
+      literal = pattern[++p];
+    if (literal != path[t])
+      return false;
+    ++p;
+    ++t;
+  }
+  return t == path.size();
+}
+
+bool globMatch(const std::string& pattern, const std::string& path)
+{
+  return matchFrom(pattern, 0, path, 0);
+}
+
+} // namespace
@@ -0,0 +1,46 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_FILESYSTEM_GLOB_HPP
+#define SCANTOOL_FILESYSTEM_GLOB_HPP
+
+#include <string>
+
+namespace scantool::filesystem
+{
+
+/** \brief Checks whether a path matches a glob pattern.
+ *
+ * Supported wildcards are "?" for any single character, "*" for any
+ * sequence of characters and "[...]" for one character of a set, where the
+ * set may contain ranges like "a-z" and may be negated by a leading "!" or
+ * "^". None of them matches the path separator "/". "**" matches any
+ * sequence including "/", and "**" followed by "/" also matches zero
+ * directories. A backslash escapes the following character.
+ *
+ * \param pattern  the glob pattern
+ * \param path     the path, with "/" as separator
+ * \return Returns true, if the whole path matches the pattern.
+ */
+bool globMatch(const std::string& pattern, const std::string& path);
+
+} // namespace
+
+#endif // SCANTOOL_FILESYSTEM_GLOB_HPP
@@ -0,0 +1,119 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "ListReader.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <iostream>
+
+namespace scantool::filesystem
+{
+
+ListReader::ListReader(const std::string& fileName, const char delimiter)
+: m_FileName(fileName),
+  m_File(),
+  m_Stream(nullptr),
+  m_Delimiter(delimiter),
+  m_Failed(false)
+{
+  if (fileName == "-")
+  {
+    m_Stream = &std::cin;
+    return;
+  }
+  m_File.open(fileName, std::ios_base::in | std::ios_base::binary);
+  if (m_File.good() && m_File.is_open())
+    m_Stream = &m_File;
+}
+
+ListReader::ListReader(std::istream& stream, const char delimiter)
+: m_FileName(std::string()),
+  m_File(),
+  m_Stream(&stream),
+  m_Delimiter(delimiter),
+  m_Failed(false)
+{
+}
+
+bool ListReader::isOpen() const
+{
+  return m_Stream != nullptr;
+}
+
+bool ListReader::next(std::vector<std::string>& files, const std::size_t maxCount)
+{
+  files.clear();
+  if (m_Stream == nullptr)
+    return false;
+  std::string nextFile;
+  while ((files.size() < maxCount) && readName(nextFile))
+  {
+    if (!nextFile.empty())
+      files.push_back(nextFile);
+  }
+  return !files.empty();
+}
+
+bool ListReader::readName(std::string& name)
+{
+  name.clear();
+  std::string part;
+  while (true)
+  {
+    errno = 0;
+    const bool complete = std::getline(*m_Stream, part, m_Delimiter) && !m_Stream->eof();
+    name += part;
+    if (complete)
+      return true;
+    // A signal ends the read early, but the list goes on. The part of the
+    // name that was read so far is continued by the next read.
+    if (interrupted())
+    {
+      std::clearerr(stdin);
+      m_Stream->clear();
+      continue;
+    }
+    if (m_Stream->bad() || ((m_Stream == &std::cin) && std::ferror(stdin)))
+    {
+      m_Failed = true;
+      return false;
+    }
+    // The last name may lack the delimiter.
+    return !name.empty();
+  }
+}
+
+bool ListReader::interrupted() const
+{
+  return (m_Stream == &std::cin) && !m_Stream->bad() && (errno == EINTR)
+      && std::ferror(stdin) && !std::feof(stdin);
+}
+
+const std::string& ListReader::fileName() const noexcept
+{
+  return m_FileName;
+}
+
+bool ListReader::failed() const noexcept
+{
+  return m_Failed;
+}
+
+} // namespace
@@ -0,0 +1,123 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_FILESYSTEM_LISTREADER_HPP
+#define SCANTOOL_FILESYSTEM_LISTREADER_HPP
+
+#include <fstream>
+#include <istream>
+#include <string>
+#include "FileFeed.hpp"
+
+namespace scantool::filesystem
+{
+
+/** \brief Reads the names of the files to scan from a list, as far as they
+ *         are requested.
+ *
+ * The list is not read completely in advance, so scans can start while the
+ * list is still written by another program, e.g. "find ... -print0". The
+ * existence of the listed files is not checked.
+ */
+class ListReader: public FileFeed
+{
+  public:
+    /** \brief Constructor for lists from files.
+     *
+     * \param fileName   name of the list file, or "-" for standard input
+     * \param delimiter  character that separates the file names, usually a
+     *                   line break or a NUL character
+     */
+    ListReader(const std::string& fileName, const char delimiter);
+
+
+    /** \brief Constructor for lists from streams.
+     *
+     * \param stream     the stream; it must outlive this instance
+     * \param delimiter  character that separates the file names
+     */
+    ListReader(std::istream& stream, const char delimiter);
+
+
+    ListReader(const ListReader& other) = delete;
+    ListReader& operator=(const ListReader& other) = delete;
+
+
+    /** \brief Checks whether the list could be opened.
+     *
+     * \return Returns true, if the list is open.
+     */
+    bool isOpen() const;
+
+
+    /** \brief Gets the next file names from the list. Empty names are
+     *         skipped.
+     *
+     * \param files     vector that will hold the file names
+     * \param maxCount  maximum number of file names to get
+     * \return Returns true, if file names were read. Returns false at the
+     *         end of the list or if the list could not be read.
+     * \remarks Reads from standard input that are interrupted by a signal
+     *          are continued.
+     */
+    virtual bool next(std::vector<std::string>& files, const std::size_t maxCount) override;
+
+
+    /** \brief Gets the name of the list.
+     *
+     * \return Returns the name of the list file, "-" for standard input, or
+     *         an empty string for other streams.
+     */
+    const std::string& fileName() const noexcept;
+
+
+    /** \brief Checks whether reading the list failed before its end.
+     *
+     * \return Returns true, if a read error occurred.
+     */
+    bool failed() const noexcept;
+  private:
+    /** \brief Reads the next file name from the list.
+     *
+     * \param name  string that will hold the file name
+     * \return Returns true, if a name was read, which may be empty.
+     *         Returns false at the end of the list or on a read error.
+     */
+    bool readName(std::string& name);
+
+
+    /** \brief Checks whether the last read from standard input was
+     *         interrupted by a signal.
+     *
+     * \return Returns true, if the read can be continued.
+     */
+    bool interrupted() const;
+
+
+    std::string m_FileName; /**< name of the list file */
+    std::ifstream m_File; /**< list file, unless a stream is read */
+    std::istream* m_Stream; /**< stream that is read, may be nullptr */
+    char m_Delimiter; /**< separator of the file names */
+    bool m_Failed; /**< whether a read error occurred */
+}; // class
+
+} // namespace
+
+#endif // SCANTOOL_FILESYSTEM_LISTREADER_HPP
@@ -0,0 +1,132 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "PathSet.hpp"
+#include <cstring>
+
+namespace scantool::filesystem
+{
+
+/// initial number of slots
+static const std::size_t cInitialSlots = 1024;
+
+/** \brief Final mixing step of MurmurHash3, spreads all input bits.
+ *
+ * \param x  the value to mix
+ * \return Returns the mixed value.
+ */
+static uint64_t mix(uint64_t x)
+{
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return x;
+}
+
+/** \brief Hashes a string with a seed.
+ *
+ * \param data  the string
+ * \param seed  seed of the hash
+ * \return Returns the 64 bit hash value.
+ */
+static uint64_t hash(const std::string& data, const uint64_t seed)
+{
+  uint64_t h = seed ^ (data.size() * 0x9e3779b97f4a7c15ULL);
+  std::size_t i = 0;
+  for ( ; i + 8 <= data.size(); i += 8)
+  {
+    uint64_t block = 0;
+    std::memcpy(&block, data.data() + i, 8);
+    h = mix(h ^ mix(block + seed));
+  }
+  uint64_t tail = 0;
+  std::memcpy(&tail, data.data() + i, data.size() - i);
+  return mix(h ^ mix(tail + seed + (data.size() - i)));
+}
+
+PathSet::PathSet()
+: m_Slots(std::vector<Fingerprint>(cInitialSlots, Fingerprint{ 0, 0 })),
+  m_Count(0)
+{
+}
+
+PathSet::Fingerprint PathSet::fingerprint(const std::string& path)
+{
+  Fingerprint print{ hash(path, 0x243f6a8885a308d3ULL), hash(path, 0x13198a2e03707344ULL) };
+  // zero is reserved for empty slots
+  if ((print.first == 0) && (print.second == 0))
+    print.second = 1;
+  return print;
+}
+
+std::size_t PathSet::find(const Fingerprint& print) const
+{
+  const std::size_t mask = m_Slots.size() - 1;
+  std::size_t index = static_cast<std::size_t>(print.first) & mask;
+  while (true)
+  {
+    const Fingerprint& slot = m_Slots[index];
+    if (((slot.first == print.first) && (slot.second == print.second))
+        || ((slot.first == 0) && (slot.second == 0)))
+      return index;
+    index = (index + 1) & mask;
+  }
+}
+
+void PathSet::grow()
+{
+  std::vector<Fingerprint> old(m_Slots.size() * 2, Fingerprint{ 0, 0 });
+  old.swap(m_Slots);
+  for (const auto& print : old)
+  {
+    if ((print.first != 0) || (print.second != 0))
+      m_Slots[find(print)] = print;
+  }
+}
+
+bool PathSet::insert(const std::string& path)
+{
+  // Keep the load factor below 3/4, so that probe sequences stay short.
+  if (4 * (m_Count + 1) > 3 * m_Slots.size())
+    grow();
+  const Fingerprint print = fingerprint(path);
+  Fingerprint& slot = m_Slots[find(print)];
+  if ((slot.first != 0) || (slot.second != 0))
+    return false;
+  slot = print;
+  ++m_Count;
+  return true;
+}
+
+bool PathSet::contains(const std::string& path) const
+{
+  const Fingerprint print = fingerprint(path);
+  const Fingerprint& slot = m_Slots[find(print)];
+  return (slot.first != 0) || (slot.second != 0);
+}
+
+std::size_t PathSet::size() const noexcept
+{
+  return m_Count;
+}
+
+} // namespace
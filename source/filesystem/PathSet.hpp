@@ -0,0 +1,106 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_FILESYSTEM_PATHSET_HPP
+#define SCANTOOL_FILESYSTEM_PATHSET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace scantool::filesystem
+{
+
+/** \brief Compact set of paths to detect duplicates in long file lists.
+ *
+ * Only a 128 bit fingerprint of each path is kept in an open addressing
+ * table, which takes about 20 to 45 octets per path instead of a complete
+ * string plus a tree node. The chance that two different paths are seen as
+ * equal is negligible, about 10^-24 for 20 million paths.
+ */
+class PathSet
+{
+  public:
+    /** \brief Default constructor, creates an empty set.
+     */
+    PathSet();
+
+
+    /** \brief Adds a path to the set.
+     *
+     * \param path  the path
+     * \return Returns true, if the path was added. Returns false, if the
+     *         path was already in the set.
+     */
+    bool insert(const std::string& path);
+
+
+    /** \brief Checks whether a path is in the set.
+     *
+     * \param path  the path
+     * \return Returns true, if the path is in the set.
+     */
+    bool contains(const std::string& path) const;
+
+
+    /** \brief Gets the number of paths in the set.
+     *
+     * \return Returns the number of paths.
+     */
+    std::size_t size() const noexcept;
+  private:
+    /// fingerprint of a path, both parts zero marks an empty slot
+    struct Fingerprint
+    {
+      uint64_t first;
+      uint64_t second;
+    };
+
+
+    /** \brief Computes the fingerprint of a path.
+     *
+     * \param path  the path
+     * \return Returns the fingerprint, which is never zero.
+     */
+    static Fingerprint fingerprint(const std::string& path);
+
+
+    /** \brief Finds the slot of a fingerprint.
+     *
+     * \param print  the fingerprint
+     * \return Returns the index of the slot that contains the fingerprint,
+     *         or of the empty slot where it belongs.
+     */
+    std::size_t find(const Fingerprint& print) const;
+
+
+    /** \brief Doubles the number of slots.
+     */
+    void grow();
+
+
+    std::vector<Fingerprint> m_Slots; /**< table of fingerprints, size is a power of two */
+    std::size_t m_Count; /**< number of used slots */
+}; // class
+
+} // namespace
+
+#endif // SCANTOOL_FILESYSTEM_PATHSET_HPP
@@ -0,0 +1,389 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "FileReader.hpp"
+#include <atomic>
+#if !defined(_WIN32)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) || defined(__FreeBSD__) || defined(__NetBSD__)
+#define SCANTOOL_HAS_FADVISE
+#endif
+
+namespace scantool::hash
+{
+
+/// current read mode for hashing
+static std::atomic<ReadMode> currentReadMode(ReadMode::Cached);
+
+/// alignment of the chunk buffers, suitable for O_DIRECT
+static const std::size_t cBufferAlignment = 4096;
+
+std::string readModeName(const ReadMode mode)
+{
+  switch (mode)
+  {
+    case ReadMode::Cached:
+         return "cached";
+    case ReadMode::NoCache:
+         return "nocache";
+    case ReadMode::Direct:
+         return "direct";
+  }
+  return "unknown";
+}
+
+bool parseReadMode(const std::string& name, ReadMode& mode)
+{
+  for (const ReadMode candidate : { ReadMode::Cached, ReadMode::NoCache, ReadMode::Direct })
+  {
+    if (name == readModeName(candidate))
+    {
+      mode = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+ReadMode readMode() noexcept
+{
+  return currentReadMode.load();
+}
+
+void setReadMode(const ReadMode mode) noexcept
+{
+  currentReadMode.store(mode);
+}
+
+#if !defined(_WIN32)
+/** \brief Opens a file for reading.
+ *
+ * \param fileName  name of the file
+ * \param mode      the read mode
+ * \param direct    whether to try O_DIRECT; set to false, if it was not used
+ * \return Returns the file descriptor, or -1 if the file could not be opened.
+ */
+static int openForReading(const std::string& fileName, const ReadMode mode, bool& direct)
+{
+  int flags = O_RDONLY;
+  #if defined(O_CLOEXEC)
+  flags |= O_CLOEXEC;
+  #endif
+  int descriptor = -1;
+  #if defined(O_DIRECT)
+  if (direct)
+    descriptor = open(fileName.c_str(), flags | O_DIRECT);
+  #endif
+  if (descriptor < 0)
+  {
+    direct = false;
+    descriptor = open(fileName.c_str(), flags);
+  }
+  if (descriptor < 0)
+    return -1;
+  #if defined(__APPLE__)
+  // macOS has no posix_fadvise(), but it can disable caching per descriptor.
+  if (mode != ReadMode::Cached)
+    fcntl(descriptor, F_NOCACHE, 1);
+  #else
+  (void) mode;
+  #endif
+  return descriptor;
+}
+
+/** \brief Tells the kernel that a range of a file is not needed anymore, so
+ *         that its pages do not push other data out of the page cache.
+ *
+ * \param descriptor  descriptor of the file
+ * \param offset      start of the range
+ * \param length      length of the range, zero means up to the end of the file
+ */
+static void dropFromPageCache(const int descriptor, const uint64_t offset, const std::size_t length)
+{
+  #if defined(SCANTOOL_HAS_FADVISE)
+  posix_fadvise(descriptor, static_cast<off_t>(offset), static_cast<off_t>(length), POSIX_FADV_DONTNEED);
+  #else
+  (void) descriptor;
+  (void) offset;
+  (void) length;
+  #endif
+}
+#endif
+
+const std::size_t FileReader::cChunkSize = 1024 * 1024;
+
+FileReader::FileReader(const std::string& fileName, const ReadMode mode)
+:
+  #if defined(_WIN32)
+  m_File(nullptr),
+  #else
+  m_Descriptor(-1),
+  #endif
+  m_Mode(mode),
+  m_Direct(mode == ReadMode::Direct),
+  m_Offset(0),
+  m_Dropped(0),
+  m_Storage(nullptr),
+  m_Buffers{ nullptr, nullptr },
+  m_Lengths{ 0, 0 },
+  m_Filled{ false, false },
+  m_Current(0),
+  m_Holding(false),
+  m_Failed(false),
+  m_Stop(false),
+  m_Mutex(),
+  m_Condition(),
+  m_Thread()
+{
+  bool large = false;
+  #if defined(_WIN32)
+  m_Direct = false;
+  m_File = std::fopen(fileName.c_str(), "rb");
+  if (m_File == nullptr)
+  {
+    m_Failed = true;
+    return;
+  }
+  if ((_fseeki64(m_File, 0, SEEK_END) == 0) && (_ftelli64(m_File) > static_cast<long long>(cChunkSize)))
+    large = true;
+  std::rewind(m_File);
+  #else
+  m_Descriptor = openForReading(fileName, mode, m_Direct);
+  if (m_Descriptor < 0)
+  {
+    m_Failed = true;
+    return;
+  }
+  struct stat status;
+  if (fstat(m_Descriptor, &status) == 0)
+    large = static_cast<uint64_t>(status.st_size) > cChunkSize;
+    #if defined(SCANTOOL_HAS_FADVISE)
+  // larger read-ahead window of the kernel
+  posix_fadvise(m_Descriptor, 0, 0, POSIX_FADV_SEQUENTIAL);
+    #endif
+  #endif
+
+  m_Storage.reset(new uint8_t[2 * cChunkSize + cBufferAlignment]);
+  const uintptr_t address = reinterpret_cast<uintptr_t>(m_Storage.get());
+  const uintptr_t aligned = (address + cBufferAlignment - 1) & ~static_cast<uintptr_t>(cBufferAlignment - 1);
+  m_Buffers[0] = m_Storage.get() + (aligned - address);
+  m_Buffers[1] = m_Buffers[0] + cChunkSize;
+  // Reading ahead only pays off, if there is more than one chunk.
+  if (large)
+    m_Thread = std::thread(&FileReader::readAhead, this);
+}
+
+FileReader::~FileReader()
+{
+  if (m_Thread.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_Stop = true;
+    }
+    m_Condition.notify_all();
+    m_Thread.join();
+  }
+  #if defined(_WIN32)
+  if (m_File != nullptr)
+    std::fclose(m_File);
+  #else
+  if (m_Descriptor >= 0)
+  {
+    if (m_Mode != ReadMode::Cached)
+      dropFromPageCache(m_Descriptor, 0, 0);
+    close(m_Descriptor);
+  }
+  #endif
+}
+
+bool FileReader::isOpen() const noexcept
+{
+  #if defined(_WIN32)
+  return m_File != nullptr;
+  #else
+  return m_Descriptor >= 0;
+  #endif
+}
+
+bool FileReader::failed() const noexcept
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Failed;
+}
+
+bool FileReader::readChunk(uint8_t* buffer, std::size_t& length)
+{
+  length = 0;
+  #if defined(_WIN32)
+  length = std::fread(buffer, 1, cChunkSize, m_File);
+  if (std::ferror(m_File) != 0)
+    return false;
+  #else
+  while (length < cChunkSize)
+  {
+    const ssize_t bytesRead = pread(m_Descriptor, buffer + length, cChunkSize - length,
+                                    static_cast<off_t>(m_Offset + length));
+    if (bytesRead < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      #if defined(O_DIRECT)
+      // Some file systems only refuse direct I/O when reading.
+      if (m_Direct && (errno == EINVAL))
+      {
+        const int flags = fcntl(m_Descriptor, F_GETFL);
+        if ((flags != -1) && (fcntl(m_Descriptor, F_SETFL, flags & ~O_DIRECT) == 0))
+        {
+          m_Direct = false;
+          continue;
+        }
+      }
+      #endif
+      return false;
+    }
+    if (bytesRead == 0)
+      break;
+    length += static_cast<std::size_t>(bytesRead);
+  }
+  #endif
+  m_Offset += length;
+  #if !defined(_WIN32)
+  /* Pages that were just read are often not dropped yet, so the dropped range
+     lags behind the current position. The rest is dropped in the destructor. */
+  const uint64_t cDropLag = 2 * cChunkSize;
+  if ((m_Mode != ReadMode::Cached) && !m_Direct && (m_Offset > m_Dropped + cDropLag))
+  {
+    dropFromPageCache(m_Descriptor, m_Dropped, m_Offset - cDropLag - m_Dropped);
+    m_Dropped = m_Offset - cDropLag;
+  }
+  #endif
+  return true;
+}
+
+void FileReader::readAhead()
+{
+  unsigned int index = 0;
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(m_Mutex);
+      m_Condition.wait(lock, [this, index] { return m_Stop || !m_Filled[index]; });
+      if (m_Stop)
+        return;
+    }
+    std::size_t length = 0;
+    const bool success = readChunk(m_Buffers[index], length);
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_Lengths[index] = success ? length : 0;
+      m_Filled[index] = true;
+      if (!success)
+        m_Failed = true;
+    }
+    m_Condition.notify_all();
+    if (!success || (length == 0))
+      return;
+    index ^= 1;
+  } // while
+}
+
+bool FileReader::next(const uint8_t*& data, std::size_t& length)
+{
+  if (!isOpen())
+    return false;
+
+  if (!m_Thread.joinable())
+  {
+    if (m_Failed)
+      return false;
+    if (!readChunk(m_Buffers[0], length))
+    {
+      m_Failed = true;
+      return false;
+    }
+    data = m_Buffers[0];
+    return length > 0;
+  }
+
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  if (m_Holding)
+  {
+    // The previous chunk is done, so its buffer can be filled again.
+    m_Filled[m_Current] = false;
+    m_Current ^= 1;
+    m_Holding = false;
+    m_Condition.notify_all();
+  }
+  m_Condition.wait(lock, [this] { return m_Filled[m_Current]; });
+  if (m_Lengths[m_Current] == 0)
+    return false;
+  data = m_Buffers[m_Current];
+  length = m_Lengths[m_Current];
+  m_Holding = true;
+  return true;
+}
+
+bool readFileStart(const std::string& fileName, uint8_t* buffer, const std::size_t size, std::size_t& length)
+{
+  length = 0;
+  const ReadMode mode = readMode();
+  #if defined(_WIN32)
+  (void) mode;
+  std::FILE* file = std::fopen(fileName.c_str(), "rb");
+  if (file == nullptr)
+    return false;
+  length = std::fread(buffer, 1, size, file);
+  const bool failed = std::ferror(file) != 0;
+  std::fclose(file);
+  return !failed;
+  #else
+  bool direct = false;
+  const int descriptor = openForReading(fileName, mode, direct);
+  if (descriptor < 0)
+    return false;
+  bool failed = false;
+  while (length < size)
+  {
+    const ssize_t bytesRead = read(descriptor, buffer + length, size - length);
+    if (bytesRead < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      failed = true;
+      break;
+    }
+    if (bytesRead == 0)
+      break;
+    length += static_cast<std::size_t>(bytesRead);
+  }
+  if (!failed && (mode != ReadMode::Cached))
+    dropFromPageCache(descriptor, 0, 0);
+  close(descriptor);
+  return !failed;
+  #endif
+}
+
+} // namespace
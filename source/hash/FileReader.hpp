@@ -0,0 +1,189 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_HASH_FILEREADER_HPP
+#define SCANTOOL_HASH_FILEREADER_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace scantool::hash
+{
+
+/** enumeration for the ways files are read for hashing */
+enum class ReadMode
+{
+  /** normal reads through the page cache */
+  Cached,
+
+  /** reads through the page cache, but read pages are dropped afterwards */
+  NoCache,
+
+  /** direct reads that bypass the page cache (O_DIRECT), if the file system
+      supports them; falls back to NoCache otherwise */
+  Direct
+};
+
+
+/** \brief Gets the name of a read mode.
+ *
+ * \param mode  the read mode
+ * \return Returns the name of the read mode, as used by parseReadMode().
+ */
+std::string readModeName(const ReadMode mode);
+
+
+/** \brief Parses the name of a read mode.
+ *
+ * \param name  name of the read mode: "cached", "nocache" or "direct"
+ * \param mode  variable that will hold the read mode
+ * \return Returns true, if the name is a valid read mode.
+ */
+bool parseReadMode(const std::string& name, ReadMode& mode);
+
+
+/** \brief Gets the read mode that is used for hashing files.
+ *
+ * \return Returns the current read mode. Default is ReadMode::Cached.
+ */
+ReadMode readMode() noexcept;
+
+
+/** \brief Sets the read mode that is used for hashing files.
+ *
+ * \param mode  the new read mode
+ */
+void setReadMode(const ReadMode mode) noexcept;
+
+
+/** \brief Reads a file in chunks with read-ahead in a background thread.
+ *
+ * Two aligned buffers are used alternately: while the caller processes one
+ * chunk, the next chunk is read into the other buffer. Files that fit into a
+ * single chunk are read without the background thread. The kernel is told
+ * that the file is read sequentially, and depending on the read mode the
+ * read pages are dropped from the page cache or not cached at all.
+ */
+class FileReader
+{
+  public:
+    /** \brief Constructor, opens the file.
+     *
+     * \param fileName  name of the file
+     * \param mode      the read mode
+     */
+    FileReader(const std::string& fileName, const ReadMode mode = readMode());
+
+
+    /** \brief Destructor, stops reading and closes the file.
+     */
+    ~FileReader();
+
+
+    FileReader(const FileReader& other) = delete;
+    FileReader& operator=(const FileReader& other) = delete;
+
+
+    /// size of the chunks that are read at once
+    static const std::size_t cChunkSize;
+
+
+    /** \brief Checks whether the file could be opened.
+     *
+     * \return Returns true, if the file is open.
+     */
+    bool isOpen() const noexcept;
+
+
+    /** \brief Gets the next chunk of the file.
+     *
+     * \param data    variable that will point to the data of the chunk; the
+     *                data is valid until the next call
+     * \param length  variable that will hold the length of the chunk
+     * \return Returns true, if a chunk was read. Returns false at the end of
+     *         the file or if an error occurred, see failed().
+     */
+    bool next(const uint8_t*& data, std::size_t& length);
+
+
+    /** \brief Checks whether a read error occurred.
+     *
+     * \return Returns true, if the file could not be opened or read.
+     */
+    bool failed() const noexcept;
+  private:
+    /** \brief Reads the next chunk at the current position.
+     *
+     * \param buffer  aligned buffer of cChunkSize bytes
+     * \param length  variable that will hold the number of bytes read; zero
+     *                at the end of the file
+     * \return Returns true, if the read succeeded.
+     */
+    bool readChunk(uint8_t* buffer, std::size_t& length);
+
+
+    /** \brief Reads chunks ahead of the consumer, runs in the background thread.
+     */
+    void readAhead();
+
+
+    #if defined(_WIN32)
+    std::FILE* m_File; /**< the opened file */
+    #else
+    int m_Descriptor; /**< descriptor of the opened file, -1 if not open */
+    #endif
+    ReadMode m_Mode; /**< the read mode */
+    bool m_Direct; /**< whether the file was opened with O_DIRECT */
+    uint64_t m_Offset; /**< file offset of the next read in the reading thread */
+    uint64_t m_Dropped; /**< end of the range that was dropped from the page cache */
+    std::unique_ptr<uint8_t[]> m_Storage; /**< memory for both buffers, including alignment */
+    uint8_t* m_Buffers[2]; /**< aligned chunk buffers */
+    std::size_t m_Lengths[2]; /**< number of bytes in each buffer */
+    bool m_Filled[2]; /**< whether a buffer holds a chunk for the consumer */
+    unsigned int m_Current; /**< index of the buffer that is next handed to the consumer */
+    bool m_Holding; /**< whether the consumer holds the current buffer */
+    bool m_Failed; /**< whether a read error occurred */
+    bool m_Stop; /**< whether the reading thread shall stop */
+    mutable std::mutex m_Mutex; /**< protects buffer states and flags */
+    std::condition_variable m_Condition; /**< signals changed buffer states */
+    std::thread m_Thread; /**< reading thread, not joinable for small files */
+}; // class
+
+
+/** \brief Reads the beginning of a file in one go, using the current read mode.
+ *
+ * \param fileName  name of the file
+ * \param buffer    buffer for the content
+ * \param size      size of the buffer in bytes
+ * \param length    variable that will hold the number of bytes read
+ * \return Returns true, if the file could be read. Returns false otherwise.
+ * \remarks This is meant for small files, so O_DIRECT is never used here.
+ */
+bool readFileStart(const std::string& fileName, uint8_t* buffer, const std::size_t size, std::size_t& length);
+
+} // namespace
+
+#endif // SCANTOOL_HASH_FILEREADER_HPP
@@ -0,0 +1,207 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "HashCache.hpp"
+#include <charconv>
+#include <chrono>
+#include <sys/stat.h>
+
+namespace scantool::hash
+{
+
+bool FileStatus::get(const std::string& fileName, FileStatus& status)
+{
+  #if defined(_WIN32)
+  struct _stat64 buffer;
+  if (_stat64(fileName.c_str(), &buffer) != 0)
+    return false;
+  // Windows has no inode numbers and only full seconds here.
+  status.device = static_cast<uint64_t>(buffer.st_dev);
+  status.inode = 0;
+  status.size = static_cast<uint64_t>(buffer.st_size);
+  status.mtime_ns = static_cast<int64_t>(buffer.st_mtime) * 1000000000;
+  status.ctime_ns = static_cast<int64_t>(buffer.st_ctime) * 1000000000;
+  #else
+  struct stat buffer;
+  if (stat(fileName.c_str(), &buffer) != 0)
+    return false;
+  if (!S_ISREG(buffer.st_mode))
+    return false;
+  status.device = static_cast<uint64_t>(buffer.st_dev);
+  status.inode = static_cast<uint64_t>(buffer.st_ino);
+  status.size = static_cast<uint64_t>(buffer.st_size);
+    #if defined(__APPLE__)
+  status.mtime_ns = static_cast<int64_t>(buffer.st_mtimespec.tv_sec) * 1000000000 + buffer.st_mtimespec.tv_nsec;
+  status.ctime_ns = static_cast<int64_t>(buffer.st_ctimespec.tv_sec) * 1000000000 + buffer.st_ctimespec.tv_nsec;
+    #else
+  status.mtime_ns = static_cast<int64_t>(buffer.st_mtim.tv_sec) * 1000000000 + buffer.st_mtim.tv_nsec;
+  status.ctime_ns = static_cast<int64_t>(buffer.st_ctim.tv_sec) * 1000000000 + buffer.st_ctim.tv_nsec;
+    #endif
+  #endif
+  return true;
+}
+
+bool FileStatus::operator==(const FileStatus& other) const noexcept
+{
+  return (device == other.device) && (inode == other.inode)
+      && (size == other.size) && (mtime_ns == other.mtime_ns)
+      && (ctime_ns == other.ctime_ns);
+}
+
+/** \brief Parses the next space-separated number of a cache line.
+ *
+ * \param first  pointer to the first character, will be moved behind the number
+ * \param last   pointer behind the last character of the line
+ * \param value  variable that will hold the number
+ * \return Returns true, if a number followed by a space was found.
+ */
+template<typename T>
+bool parseField(const char*& first, const char* last, T& value)
+{
+  const auto result = std::from_chars(first, last, value);
+  if ((result.ec != std::errc()) || (result.ptr == last) || (*result.ptr != ' '))
+    return false;
+  first = result.ptr + 1;
+  return true;
+}
+
+HashCache::HashCache(const std::string& fileName)
+: m_File(fileName),
+  m_Entries(std::unordered_map<std::string, Entry>()),
+  m_Pending(std::string()),
+  m_Hits(0),
+  m_Misses(0)
+{
+}
+
+bool HashCache::load()
+{
+  m_Entries.clear();
+  m_Pending.clear();
+  return m_File.read([this](const std::string& line)
+  {
+    if (line.empty() || (line[0] == '#'))
+      return;
+    // line format: SHA-256 device inode size mtime_ns ctime_ns path
+    if ((line.size() < 66) || (line[64] != ' '))
+      return;
+    Entry entry;
+    if (!entry.digest.fromHexString(line.substr(0, 64)))
+      return;
+    const char* first = line.data() + 65;
+    const char* last = line.data() + line.size();
+    if (!parseField(first, last, entry.status.device)
+        || !parseField(first, last, entry.status.inode)
+        || !parseField(first, last, entry.status.size)
+        || !parseField(first, last, entry.status.mtime_ns)
+        || !parseField(first, last, entry.status.ctime_ns)
+        || (first == last))
+      return;
+    m_Entries[std::string(first, last)] = entry;
+  });
+}
+
+bool HashCache::lookup(const std::string& fileName, const FileStatus& status, SHA256::MessageDigest& digest)
+{
+  const auto iter = m_Entries.find(fileName);
+  if ((iter == m_Entries.end()) || !(iter->second.status == status))
+  {
+    ++m_Misses;
+    return false;
+  }
+  digest = iter->second.digest;
+  ++m_Hits;
+  return true;
+}
+
+void HashCache::store(const std::string& fileName, const FileStatus& status, const SHA256::MessageDigest& digest)
+{
+  if (digest.isNull() || fileName.empty()
+      || (fileName.find('\n') != std::string::npos))
+    return;
+  /* A file that is modified again within the resolution of the time stamps
+     would keep its time stamps, so recently changed files are not cached. */
+  const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+  const int64_t cRacyInterval = static_cast<int64_t>(2) * 1000000000;
+  if ((status.mtime_ns > now - cRacyInterval) || (status.ctime_ns > now - cRacyInterval))
+    return;
+
+  const Entry entry{ status, digest };
+  const auto iter = m_Entries.find(fileName);
+  if (iter != m_Entries.end())
+  {
+    if ((iter->second.status == status) && (iter->second.digest == digest))
+      return;
+    iter->second = entry;
+  }
+  else
+  {
+    m_Entries.emplace(fileName, entry);
+  }
+  appendLine(fileName, entry, m_Pending);
+}
+
+void HashCache::appendLine(const std::string& fileName, const Entry& entry, std::string& output)
+{
+  output.append(entry.digest.toHexString()).append(" ")
+        .append(std::to_string(entry.status.device)).append(" ")
+        .append(std::to_string(entry.status.inode)).append(" ")
+        .append(std::to_string(entry.status.size)).append(" ")
+        .append(std::to_string(entry.status.mtime_ns)).append(" ")
+        .append(std::to_string(entry.status.ctime_ns)).append(" ")
+        .append(fileName).append("\n");
+}
+
+bool HashCache::flush()
+{
+  if (!m_File.append(m_Pending))
+    return false;
+  m_Pending.clear();
+  return true;
+}
+
+bool HashCache::compact()
+{
+  if (!flush())
+    return false;
+  // Rewriting is only worth it, if at least half of the lines are replaced.
+  if (!m_File.worthRewriting(m_Entries.size(), 1000))
+    return true;
+
+  std::string content = "# scan-tool hash cache\n";
+  for (const auto& [fileName, entry] : m_Entries)
+  {
+    appendLine(fileName, entry, content);
+  }
+  return m_File.rewrite(content);
+}
+
+uint64_t HashCache::hits() const noexcept
+{
+  return m_Hits;
+}
+
+uint64_t HashCache::misses() const noexcept
+{
+  return m_Misses;
+}
+
+} // namespace
@@ -0,0 +1,167 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_HASH_HASHCACHE_HPP
+#define SCANTOOL_HASH_HASHCACHE_HPP
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include "../../libstriezel/hash/sha256/sha256.hpp"
+#include "../filesystem/AppendOnlyFile.hpp"
+
+namespace scantool::hash
+{
+
+/** Status of a file that decides whether a cached digest is still valid. */
+struct FileStatus
+{
+  uint64_t device; /**< ID of the device that contains the file */
+  uint64_t inode; /**< inode number of the file */
+  uint64_t size; /**< size of the file in bytes */
+  int64_t mtime_ns; /**< time of last modification in nanoseconds since the epoch */
+  int64_t ctime_ns; /**< time of last status change in nanoseconds since the epoch */
+
+  /** \brief Gets the status of a file.
+   *
+   * \param fileName  name of the file
+   * \param status    variable that will hold the status
+   * \return Returns true, if the status could be determined.
+   */
+  static bool get(const std::string& fileName, FileStatus& status);
+
+
+  /** \brief Checks for equality.
+   *
+   * \param other  the other status
+   * \return Returns true, if both states are equal.
+   */
+  bool operator==(const FileStatus& other) const noexcept;
+}; // struct
+
+
+/** \brief Persistent cache of file digests.
+ *
+ * The cache maps file names to the SHA-256 digest of the file's content. A
+ * cached digest is only used, if device, inode, size, modification time and
+ * status change time of the file did not change since the digest was
+ * computed. So unchanged files do not have to be read again.
+ *
+ * The cache file is a text file, where new entries are appended to, so that
+ * nothing gets lost when the program is terminated. Later entries for the
+ * same file replace earlier ones. Use compact() to remove replaced entries.
+ */
+class HashCache
+{
+  public:
+    /** \brief Constructor.
+     *
+     * \param fileName  path of the cache file
+     */
+    explicit HashCache(const std::string& fileName);
+
+
+    /** \brief Loads the cache from its file.
+     *
+     * \return Returns true, if the cache file was loaded or did not exist.
+     *         Returns false, if the cache file could not be read.
+     * \remarks Malformed lines, e.g. an incomplete last line, are skipped.
+     */
+    bool load();
+
+
+    /** \brief Gets the cached digest of a file.
+     *
+     * \param fileName  name of the file
+     * \param status    current status of the file
+     * \param digest    variable that will hold the digest
+     * \return Returns true, if there is a digest for the file with the given
+     *         status. Returns false otherwise.
+     */
+    bool lookup(const std::string& fileName, const FileStatus& status, SHA256::MessageDigest& digest);
+
+
+    /** \brief Adds the digest of a file to the cache.
+     *
+     * \param fileName  name of the file
+     * \param status    status of the file before its content was read
+     * \param digest    digest of the file's content
+     * \remarks Files that were changed in the last seconds are not added,
+     *          because a change within the same time stamp would not be
+     *          noticed later. Call flush() to write new entries to the file.
+     */
+    void store(const std::string& fileName, const FileStatus& status, const SHA256::MessageDigest& digest);
+
+
+    /** \brief Appends new entries to the cache file.
+     *
+     * \return Returns true, if all new entries were written.
+     */
+    bool flush();
+
+
+    /** \brief Rewrites the cache file without replaced entries, if there are
+     *         many of them.
+     *
+     * \return Returns true, if the cache file is compact or was compacted.
+     *         Returns false, if the cache file could not be rewritten.
+     */
+    bool compact();
+
+
+    /** \brief Gets the number of digests that were taken from the cache.
+     *
+     * \return Returns the number of successful lookups.
+     */
+    uint64_t hits() const noexcept;
+
+
+    /** \brief Gets the number of digests that were not in the cache.
+     *
+     * \return Returns the number of failed lookups.
+     */
+    uint64_t misses() const noexcept;
+  private:
+    /** cached digest and the file status it belongs to */
+    struct Entry
+    {
+      FileStatus status; /**< status of the file */
+      SHA256::MessageDigest digest; /**< digest of the file's content */
+    };
+
+    /** \brief Appends the line for an entry to a string.
+     *
+     * \param fileName  name of the file
+     * \param entry     the entry
+     * \param output    string that gets the line
+     */
+    static void appendLine(const std::string& fileName, const Entry& entry, std::string& output);
+
+
+    scantool::filesystem::AppendOnlyFile m_File; /**< the cache file */
+    std::unordered_map<std::string, Entry> m_Entries; /**< cached entries by file name */
+    std::string m_Pending; /**< lines of new entries that were not written yet */
+    uint64_t m_Hits; /**< number of successful lookups */
+    uint64_t m_Misses; /**< number of failed lookups */
+}; // class
+
+} // namespace
+
+#endif // SCANTOOL_HASH_HASHCACHE_HPP
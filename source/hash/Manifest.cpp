@@ -0,0 +1,151 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "Manifest.hpp"
+#include <iostream>
+
+namespace scantool::hash
+{
+
+/** \brief Parses the hexadecimal representation of a SHA-256 digest.
+ *
+ * \param text    the hexadecimal digits, in lower or upper case
+ * \param digest  variable that will hold the digest
+ * \return Returns true, if the text is a valid digest.
+ */
+static bool parseDigest(std::string text, SHA256::MessageDigest& digest)
+{
+  if (text.size() != 64)
+    return false;
+  for (char& c : text)
+  {
+    if ((c >= 'A') && (c <= 'F'))
+      c = static_cast<char>(c - 'A' + 'a');
+    else if (!(((c >= '0') && (c <= '9')) || ((c >= 'a') && (c <= 'f'))))
+      return false;
+  }
+  return digest.fromHexString(text);
+}
+
+/** \brief Reverts the escaping of a file name in the format of GNU coreutils.
+ *
+ * \param escaped   the escaped file name
+ * \param fileName  variable that will hold the file name
+ * \return Returns true, if the escaped name is valid.
+ */
+static bool unescape(const std::string& escaped, std::string& fileName)
+{
+  fileName.clear();
+  for (std::string::size_type i = 0; i < escaped.size(); ++i)
+  {
+    if (escaped[i] != '\\')
+    {
+      fileName.push_back(escaped[i]);
+      continue;
+    }
+    if (i + 1 == escaped.size())
+      return false;
+    ++i;
+    switch (escaped[i])
+    {
+      case '\\':
+           fileName.push_back('\\');
+           break;
+      case 'n':
+           fileName.push_back('\n');
+           break;
+      case 'r':
+           fileName.push_back('\r');
+           break;
+      default:
+           return false;
+    }
+  }
+  return true;
+}
+
+bool parseManifestLine(const std::string& line, std::string& fileName, SHA256::MessageDigest& digest)
+{
+  const bool escaped = !line.empty() && (line[0] == '\\');
+  const std::string content = escaped ? line.substr(1) : line;
+  std::string name;
+
+  const std::string tagStart = "SHA256 (";
+  if (content.compare(0, tagStart.size(), tagStart) == 0)
+  {
+    // BSD format: SHA256 (FILE) = HASH
+    const std::string tagEnd = ") = ";
+    const auto endPos = content.rfind(tagEnd);
+    if ((endPos == std::string::npos) || (endPos < tagStart.size()))
+      return false;
+    if (!parseDigest(content.substr(endPos + tagEnd.size()), digest))
+      return false;
+    name = content.substr(tagStart.size(), endPos - tagStart.size());
+  }
+  else
+  {
+    // default format: HASH, space, space or asterisk, FILE
+    if ((content.size() < 67) || (content[64] != ' ')
+        || ((content[65] != ' ') && (content[65] != '*')))
+      return false;
+    if (!parseDigest(content.substr(0, 64), digest))
+      return false;
+    name = content.substr(66);
+  }
+  if (escaped)
+    return unescape(name, fileName) && !fileName.empty();
+  fileName = name;
+  return !fileName.empty();
+}
+
+bool readManifest(std::istream& stream, const std::string& name, std::map<std::string, SHA256::MessageDigest>& digests)
+{
+  std::string line;
+  unsigned int lineNumber = 0;
+  while (std::getline(stream, line))
+  {
+    ++lineNumber;
+    // check for possible carriage return at end (happens on Windows systems)
+    if (!line.empty() && (line.back() == '\r'))
+      line.erase(line.length() - 1);
+    if (line.empty())
+      continue;
+    std::string fileName;
+    SHA256::MessageDigest digest;
+    if (!parseManifestLine(line, fileName, digest))
+    {
+      std::cerr << "Error: Line " << lineNumber << " of manifest " << name
+                << " is not a valid SHA-256 checksum line." << std::endl;
+      return false;
+    }
+    const auto iter = digests.find(fileName);
+    if (iter == digests.end())
+      digests[fileName] = digest;
+    else if (iter->second != digest)
+    {
+      std::cerr << "Error: Manifest " << name << " lists file " << fileName
+                << " with different SHA-256 hashes." << std::endl;
+      return false;
+    }
+  } // while
+  return !stream.bad();
+}
+
+} // namespace
@@ -0,0 +1,60 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_HASH_MANIFEST_HPP
+#define SCANTOOL_HASH_MANIFEST_HPP
+
+#include <istream>
+#include <map>
+#include <string>
+#include "../../libstriezel/hash/sha256/sha256.hpp"
+
+namespace scantool::hash
+{
+
+/** \brief Parses a line of a manifest in the format of sha256sum.
+ *
+ * \param line      the line, without line break
+ * \param fileName  variable that will hold the file name
+ * \param digest    variable that will hold the digest
+ * \return Returns true, if the line could be parsed. Returns false otherwise.
+ * \remarks Supported are the default format "HASH  FILE" (or "HASH *FILE" for
+ *          binary mode) and the BSD format "SHA256 (FILE) = HASH" that is
+ *          written by sha256sum --tag. Lines that start with a backslash
+ *          contain escaped file names, as written by GNU coreutils.
+ */
+bool parseManifestLine(const std::string& line, std::string& fileName, SHA256::MessageDigest& digest);
+
+
+/** \brief Reads the SHA-256 digests of files from a manifest in the format of
+ *         sha256sum.
+ *
+ * \param stream   the stream to read from
+ * \param name     name of the manifest, used in error messages
+ * \param digests  map that gets the digests; key = file name, value = digest
+ * \return Returns true, if the manifest could be read. Returns false, if it
+ *         contains an invalid line or lists a file with two different digests.
+ * \remarks Empty lines are skipped.
+ */
+bool readManifest(std::istream& stream, const std::string& name, std::map<std::string, SHA256::MessageDigest>& digests);
+
+} // namespace
+
+#endif // SCANTOOL_HASH_MANIFEST_HPP
@@ -0,0 +1,134 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "Sha256.hpp"
+#include <algorithm>
+#include <cstring>
+#include "FileReader.hpp"
+
+namespace scantool::hash
+{
+
+Sha256::Sha256()
+: Sha256(bestKernel())
+{
+}
+
+Sha256::Sha256(const Sha256Kernel kernel)
+: m_Compress(compressFunction(kernel)),
+  m_State{ 0, 0, 0, 0, 0, 0, 0, 0 },
+  m_Buffer{ },
+  m_Buffered(0),
+  m_Length(0)
+{
+  reset();
+}
+
+void Sha256::reset() noexcept
+{
+  m_State[0] = 0x6a09e667;
+  m_State[1] = 0xbb67ae85;
+  m_State[2] = 0x3c6ef372;
+  m_State[3] = 0xa54ff53a;
+  m_State[4] = 0x510e527f;
+  m_State[5] = 0x9b05688c;
+  m_State[6] = 0x1f83d9ab;
+  m_State[7] = 0x5be0cd19;
+  m_Buffered = 0;
+  m_Length = 0;
+}
+
+void Sha256::update(const uint8_t* data, std::size_t length)
+{
+  m_Length += length;
+  // complete a partially filled block first
+  if (m_Buffered > 0)
+  {
+    const std::size_t count = std::min(length, sizeof(m_Buffer) - m_Buffered);
+    std::memcpy(m_Buffer + m_Buffered, data, count);
+    m_Buffered += count;
+    data += count;
+    length -= count;
+    if (m_Buffered < sizeof(m_Buffer))
+      return;
+    m_Compress(m_State, m_Buffer, 1);
+    m_Buffered = 0;
+  }
+  // full blocks are processed directly from the input
+  const std::size_t blocks = length / 64;
+  if (blocks > 0)
+  {
+    m_Compress(m_State, data, blocks);
+    data += blocks * 64;
+    length -= blocks * 64;
+  }
+  if (length > 0)
+  {
+    std::memcpy(m_Buffer, data, length);
+    m_Buffered = length;
+  }
+}
+
+SHA256::MessageDigest Sha256::finish()
+{
+  const uint64_t bits = m_Length * 8;
+  m_Buffer[m_Buffered++] = 0x80;
+  if (m_Buffered > 56)
+  {
+    std::memset(m_Buffer + m_Buffered, 0, sizeof(m_Buffer) - m_Buffered);
+    m_Compress(m_State, m_Buffer, 1);
+    m_Buffered = 0;
+  }
+  std::memset(m_Buffer + m_Buffered, 0, 56 - m_Buffered);
+  for (unsigned int i = 0; i < 8; ++i)
+  {
+    m_Buffer[63 - i] = static_cast<uint8_t>(bits >> (8 * i));
+  }
+  m_Compress(m_State, m_Buffer, 1);
+  m_Buffered = 0;
+
+  SHA256::MessageDigest digest;
+  for (unsigned int i = 0; i < 8; ++i)
+  {
+    digest.hash[i] = m_State[i];
+  }
+  return digest;
+}
+
+SHA256::MessageDigest computeFromFile(const std::string& fileName)
+{
+  // The next chunk is read while the current one is hashed.
+  FileReader reader(fileName);
+  if (!reader.isOpen())
+    return SHA256::MessageDigest();
+
+  Sha256 sha;
+  const uint8_t* data = nullptr;
+  std::size_t length = 0;
+  while (reader.next(data, length))
+  {
+    sha.update(data, length);
+  }
+  if (reader.failed())
+    return SHA256::MessageDigest();
+  return sha.finish();
+}
+
+} // namespace
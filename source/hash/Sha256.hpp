@@ -0,0 +1,97 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_HASH_SHA256_HPP
+#define SCANTOOL_HASH_SHA256_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "../../libstriezel/hash/sha256/sha256.hpp"
+#include "Sha256Kernels.hpp"
+
+namespace scantool::hash
+{
+
+/** \brief Computes SHA-256 message digests incrementally.
+ *
+ * The compression function is taken from the fastest kernel that is available
+ * on the current CPU, unless a kernel is given explicitly. All kernels produce
+ * the same digests as libstriezel's SHA256::computeFromFile().
+ */
+class Sha256
+{
+  public:
+    /** \brief Constructor, uses the fastest available kernel.
+     */
+    Sha256();
+
+
+    /** \brief Constructor with explicit kernel.
+     *
+     * \param kernel  the kernel to use; unavailable kernels are replaced by
+     *                the scalar kernel
+     */
+    explicit Sha256(const Sha256Kernel kernel);
+
+
+    /** \brief Resets the state, so that a new message can be hashed.
+     */
+    void reset() noexcept;
+
+
+    /** \brief Adds data to the message.
+     *
+     * \param data    pointer to the data
+     * \param length  length of the data in bytes
+     */
+    void update(const uint8_t* data, std::size_t length);
+
+
+    /** \brief Finishes the message and gets its digest.
+     *
+     * \return Returns the message digest.
+     * \remarks Call reset() before hashing another message.
+     */
+    SHA256::MessageDigest finish();
+  private:
+    Sha256CompressFunction m_Compress; /**< compression function of the kernel */
+    uint32_t m_State[8]; /**< current hash state */
+    uint8_t m_Buffer[64]; /**< incomplete message block */
+    std::size_t m_Buffered; /**< number of bytes in m_Buffer */
+    uint64_t m_Length; /**< total message length in bytes */
+}; // class
+
+
+/** \brief Computes the SHA-256 message digest of a file.
+ *
+ * \param fileName  name of the file
+ * \return Returns the message digest of the file's content.
+ *         Returns a null digest (see SHA256::MessageDigest::isNull()), if the
+ *         file could not be read.
+ * \remarks This is a faster replacement for SHA256::computeFromFile(). It
+ *          reads the file in large chunks and uses hardware acceleration, if
+ *          the CPU supports it.
+ */
+SHA256::MessageDigest computeFromFile(const std::string& fileName);
+
+} // namespace
+
+#endif // SCANTOOL_HASH_SHA256_HPP
@@ -0,0 +1,345 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "Sha256Kernels.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+  #define SCANTOOL_SHA256_X86
+  #include <immintrin.h>
+  #if defined(_MSC_VER)
+    #include <intrin.h>
+    // MSVC allows intrinsics without special compiler options.
+    #define SCANTOOL_TARGET_SHANI
+  #else
+    #include <cpuid.h>
+    #define SCANTOOL_TARGET_SHANI __attribute__((target("sha,sse4.1")))
+  #endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+  #define SCANTOOL_SHA256_ARMV8
+  #include <arm_neon.h>
+  #if defined(_MSC_VER)
+    #include <windows.h>
+    #define SCANTOOL_TARGET_ARMV8
+  #elif defined(__clang__)
+    #define SCANTOOL_TARGET_ARMV8 __attribute__((target("crypto")))
+  #else
+    #define SCANTOOL_TARGET_ARMV8 __attribute__((target("+crypto")))
+  #endif
+  #if defined(__linux__)
+    #include <sys/auxv.h>
+    #include <asm/hwcap.h>
+  #endif
+#endif
+
+namespace scantool::hash
+{
+
+alignas(64) const uint32_t cRoundConstants[64] = {
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+namespace
+{
+
+inline uint32_t rotr(const uint32_t x, const unsigned int n)
+{
+  return (x >> n) | (x << (32 - n));
+}
+
+void compressScalar(uint32_t state[8], const uint8_t* data, std::size_t blocks)
+{
+  uint32_t w[64];
+  while (blocks > 0)
+  {
+    for (unsigned int t = 0; t < 16; ++t)
+    {
+      w[t] = (static_cast<uint32_t>(data[4 * t]) << 24)
+           | (static_cast<uint32_t>(data[4 * t + 1]) << 16)
+           | (static_cast<uint32_t>(data[4 * t + 2]) << 8)
+           | static_cast<uint32_t>(data[4 * t + 3]);
+    }
+    for (unsigned int t = 16; t < 64; ++t)
+    {
+      const uint32_t s0 = rotr(w[t - 15], 7) ^ rotr(w[t - 15], 18) ^ (w[t - 15] >> 3);
+      const uint32_t s1 = rotr(w[t - 2], 17) ^ rotr(w[t - 2], 19) ^ (w[t - 2] >> 10);
+      w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+    }
+
+    uint32_t a = state[0];
+    uint32_t b = state[1];
+    uint32_t c = state[2];
+    uint32_t d = state[3];
+    uint32_t e = state[4];
+    uint32_t f = state[5];
+    uint32_t g = state[6];
+    uint32_t h = state[7];
+    for (unsigned int t = 0; t < 64; ++t)
+    {
+      const uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25))
+                        + ((e & f) ^ (~e & g)) + cRoundConstants[t] + w[t];
+      const uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22))
+                        + ((a & b) ^ (a & c) ^ (b & c));
+      h = g;
+      g = f;
+      f = e;
+      e = d + t1;
+      d = c;
+      c = b;
+      b = a;
+      a = t1 + t2;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+
+    data += 64;
+    --blocks;
+  } // while
+}
+
+#if defined(SCANTOOL_SHA256_X86)
+bool cpuHasShaNi()
+{
+  #if defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7)
+    return false;
+  __cpuid(info, 1);
+  const bool ssse3_sse41 = ((info[2] & (1 << 9)) != 0) && ((info[2] & (1 << 19)) != 0);
+  __cpuidex(info, 7, 0);
+  return ssse3_sse41 && ((info[1] & (1 << 29)) != 0);
+  #else
+  unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    return false;
+  const bool ssse3_sse41 = ((ecx & bit_SSSE3) != 0) && ((ecx & bit_SSE4_1) != 0);
+  if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+    return false;
+  return ssse3_sse41 && ((ebx & (1u << 29)) != 0);
+  #endif
+}
+
+SCANTOOL_TARGET_SHANI
+void compressShaNi(uint32_t state[8], const uint8_t* data, std::size_t blocks)
+{
+  const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+  // The SHA instructions expect the state as ABEF and CDGH.
+  __m128i tmp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0]));
+  __m128i state1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4]));
+  tmp = _mm_shuffle_epi32(tmp, 0xB1); // CDAB
+  state1 = _mm_shuffle_epi32(state1, 0x1B); // EFGH
+  __m128i state0 = _mm_alignr_epi8(tmp, state1, 8); // ABEF
+  state1 = _mm_blend_epi16(state1, tmp, 0xF0); // CDGH
+
+  while (blocks > 0)
+  {
+    const __m128i abefSave = state0;
+    const __m128i cdghSave = state1;
+
+    __m128i msg[4];
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+      msg[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16 * i)), byteSwap);
+    }
+
+    // Each iteration performs four rounds and extends the message schedule.
+    #if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC unroll 16
+    #endif
+    for (unsigned int i = 0; i < 16; ++i)
+    {
+      __m128i rk = _mm_add_epi32(msg[i % 4], _mm_load_si128(reinterpret_cast<const __m128i*>(&cRoundConstants[4 * i])));
+      state1 = _mm_sha256rnds2_epu32(state1, state0, rk);
+      if ((i >= 3) && (i < 15))
+      {
+        const __m128i next = _mm_add_epi32(msg[(i + 1) % 4], _mm_alignr_epi8(msg[i % 4], msg[(i + 3) % 4], 4));
+        msg[(i + 1) % 4] = _mm_sha256msg2_epu32(next, msg[i % 4]);
+      }
+      rk = _mm_shuffle_epi32(rk, 0x0E);
+      state0 = _mm_sha256rnds2_epu32(state0, state1, rk);
+      if ((i >= 1) && (i < 13))
+      {
+        msg[(i + 3) % 4] = _mm_sha256msg1_epu32(msg[(i + 3) % 4], msg[i % 4]);
+      }
+    } // for
+
+    state0 = _mm_add_epi32(state0, abefSave);
+    state1 = _mm_add_epi32(state1, cdghSave);
+
+    data += 64;
+    --blocks;
+  } // while
+
+  // back to ABCD and EFGH
+  tmp = _mm_shuffle_epi32(state0, 0x1B); // FEBA
+  state1 = _mm_shuffle_epi32(state1, 0xB1); // DCHG
+  state0 = _mm_blend_epi16(tmp, state1, 0xF0); // DCBA
+  state1 = _mm_alignr_epi8(state1, tmp, 8); // HGFE
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), state0);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), state1);
+}
+#endif // x86
+
+#if defined(SCANTOOL_SHA256_ARMV8)
+bool cpuHasArmV8Sha2()
+{
+  #if defined(__APPLE__)
+  // All 64 bit ARM CPUs used by Apple have the cryptographic extensions.
+  return true;
+  #elif defined(_MSC_VER)
+  return IsProcessorFeaturePresent(PF_ARM_V8_CRYPTO_INSTRUCTIONS_AVAILABLE) != 0;
+  #elif defined(__linux__)
+  return (getauxval(AT_HWCAP) & HWCAP_SHA2) != 0;
+  #else
+  return false;
+  #endif
+}
+
+SCANTOOL_TARGET_ARMV8
+void compressArmV8(uint32_t state[8], const uint8_t* data, std::size_t blocks)
+{
+  uint32x4_t state0 = vld1q_u32(&state[0]);
+  uint32x4_t state1 = vld1q_u32(&state[4]);
+
+  while (blocks > 0)
+  {
+    const uint32x4_t abcdSave = state0;
+    const uint32x4_t efghSave = state1;
+
+    uint32x4_t msg[4];
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+      msg[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16 * i)));
+    }
+
+    // Each iteration performs four rounds and extends the message schedule.
+    for (unsigned int i = 0; i < 16; ++i)
+    {
+      const uint32x4_t wk = vaddq_u32(msg[i % 4], vld1q_u32(&cRoundConstants[4 * i]));
+      if (i < 12)
+      {
+        msg[i % 4] = vsha256su1q_u32(vsha256su0q_u32(msg[i % 4], msg[(i + 1) % 4]),
+                                     msg[(i + 2) % 4], msg[(i + 3) % 4]);
+      }
+      const uint32x4_t abcd = state0;
+      state0 = vsha256hq_u32(state0, state1, wk);
+      state1 = vsha256h2q_u32(state1, abcd, wk);
+    } // for
+
+    state0 = vaddq_u32(state0, abcdSave);
+    state1 = vaddq_u32(state1, efghSave);
+
+    data += 64;
+    --blocks;
+  } // while
+
+  vst1q_u32(&state[0], state0);
+  vst1q_u32(&state[4], state1);
+}
+#endif // ARMv8
+
+} // anonymous namespace
+
+std::string kernelName(const Sha256Kernel kernel)
+{
+  switch (kernel)
+  {
+    case Sha256Kernel::ShaNi:
+         return "SHA-NI";
+    case Sha256Kernel::ArmV8:
+         return "ARMv8 crypto extensions";
+    case Sha256Kernel::Scalar:
+    default:
+         return "scalar";
+  }
+}
+
+bool kernelAvailable(const Sha256Kernel kernel)
+{
+  switch (kernel)
+  {
+    case Sha256Kernel::Scalar:
+         return true;
+    case Sha256Kernel::ShaNi:
+         #if defined(SCANTOOL_SHA256_X86)
+         {
+           static const bool available = cpuHasShaNi();
+           return available;
+         }
+         #else
+         return false;
+         #endif
+    case Sha256Kernel::ArmV8:
+         #if defined(SCANTOOL_SHA256_ARMV8)
+         {
+           static const bool available = cpuHasArmV8Sha2();
+           return available;
+         }
+         #else
+         return false;
+         #endif
+    default:
+         return false;
+  }
+}
+
+Sha256Kernel bestKernel()
+{
+  if (kernelAvailable(Sha256Kernel::ShaNi))
+    return Sha256Kernel::ShaNi;
+  if (kernelAvailable(Sha256Kernel::ArmV8))
+    return Sha256Kernel::ArmV8;
+  return Sha256Kernel::Scalar;
+}
+
+Sha256CompressFunction compressFunction(const Sha256Kernel kernel)
+{
+  if (!kernelAvailable(kernel))
+    return compressScalar;
+  switch (kernel)
+  {
+    #if defined(SCANTOOL_SHA256_X86)
+    case Sha256Kernel::ShaNi:
+         return compressShaNi;
+    #endif
+    #if defined(SCANTOOL_SHA256_ARMV8)
+    case Sha256Kernel::ArmV8:
+         return compressArmV8;
+    #endif
+    default:
+         return compressScalar;
+  }
+}
+
+} // namespace
@@ -0,0 +1,95 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_HASH_SHA256KERNELS_HPP
+#define SCANTOOL_HASH_SHA256KERNELS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace scantool::hash
+{
+
+/** enumeration of implementations of the SHA-256 compression function */
+enum class Sha256Kernel
+{
+  /** portable implementation, works on every CPU */
+  Scalar,
+
+  /** implementation using the SHA extensions of x86 CPUs (SHA-NI) */
+  ShaNi,
+
+  /** implementation using the cryptographic extensions of ARMv8 CPUs */
+  ArmV8
+};
+
+
+/// round constants of SHA-256, as used by all kernels
+extern const uint32_t cRoundConstants[64];
+
+
+/** \brief Signature of a function that applies the SHA-256 compression
+ *         function to one or more consecutive message blocks.
+ *
+ * \param state   the current hash state (eight words), will be updated
+ * \param data    pointer to the message blocks, 64 bytes per block
+ * \param blocks  number of message blocks
+ */
+typedef void (*Sha256CompressFunction)(uint32_t state[8], const uint8_t* data, std::size_t blocks);
+
+
+/** \brief Gets the name of a kernel.
+ *
+ * \param kernel  the kernel
+ * \return Returns a human-readable name of the kernel, e.g. "SHA-NI".
+ */
+std::string kernelName(const Sha256Kernel kernel);
+
+
+/** \brief Checks whether a kernel can be used on the current CPU.
+ *
+ * \param kernel  the kernel
+ * \return Returns true, if the kernel was compiled into the program and the
+ *         CPU supports the required instructions.
+ */
+bool kernelAvailable(const Sha256Kernel kernel);
+
+
+/** \brief Gets the fastest kernel that is available on the current CPU.
+ *
+ * \return Returns the fastest available kernel. This is Sha256Kernel::Scalar,
+ *         if the CPU has no SHA-256 instructions.
+ * \remarks CPU detection only happens during the first call.
+ */
+Sha256Kernel bestKernel();
+
+
+/** \brief Gets the compression function of a kernel.
+ *
+ * \param kernel  the kernel
+ * \return Returns the compression function of the kernel. If the kernel is
+ *         not available, the function of the scalar kernel is returned.
+ */
+Sha256CompressFunction compressFunction(const Sha256Kernel kernel);
+
+} // namespace
+
+#endif // SCANTOOL_HASH_SHA256KERNELS_HPP
@@ -0,0 +1,579 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "Sha256MultiBuffer.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include "FileReader.hpp"
+#include "Sha256.hpp"
+#include "UringReader.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+  #define SCANTOOL_SHA256_MULTIBUFFER
+  #include <immintrin.h>
+  #if defined(_MSC_VER)
+    #include <intrin.h>
+    // MSVC allows intrinsics without special compiler options.
+    #define SCANTOOL_TARGET_AVX2
+    #define SCANTOOL_TARGET_AVX512
+  #else
+    #define SCANTOOL_TARGET_AVX2 __attribute__((target("avx2")))
+    #define SCANTOOL_TARGET_AVX512 __attribute__((target("avx2,avx512f")))
+  #endif
+#endif
+
+namespace scantool::hash
+{
+
+const std::size_t cMaxMultiBufferFileSize = 64 * 1024;
+
+namespace
+{
+
+/// maximum number of lanes of all kernels
+const unsigned int cMaxLanes = 16;
+
+/** \brief Signature of a function that applies the SHA-256 compression
+ *         function to one block of each lane.
+ *
+ * \param state   the hash states, transposed: state[word][lane]
+ * \param blocks  pointers to one message block per lane
+ */
+typedef void (*MultiBufferCompressFunction)(uint32_t state[8][cMaxLanes], const uint8_t* const blocks[cMaxLanes]);
+
+#if defined(SCANTOOL_SHA256_MULTIBUFFER)
+bool cpuHasAvx2()
+{
+  #if defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7)
+    return false;
+  __cpuid(info, 1);
+  // OSXSAVE is required to check whether the OS saves the YMM registers.
+  if ((info[2] & (1 << 27)) == 0)
+    return false;
+  if ((_xgetbv(0) & 0x6) != 0x6)
+    return false;
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+  #else
+  return __builtin_cpu_supports("avx2");
+  #endif
+}
+
+bool cpuHasAvx512()
+{
+  #if defined(_MSC_VER)
+  if (!cpuHasAvx2())
+    return false;
+  // The OS has to save the opmask and ZMM registers, too.
+  if ((_xgetbv(0) & 0xE6) != 0xE6)
+    return false;
+  int info[4];
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 16)) != 0;
+  #else
+  return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("avx512f");
+  #endif
+}
+
+/* Rotations need immediate values, so these are macros instead of functions. */
+#define SCANTOOL_ROTR256(x, n) _mm256_or_si256(_mm256_srli_epi32((x), (n)), _mm256_slli_epi32((x), 32 - (n)))
+/* The zero-masking variants avoid false warnings about uninitialized values
+   from the unmasked variants in some GCC versions. */
+#define SCANTOOL_ROTR512(x, n) _mm512_maskz_ror_epi32(0xFFFF, (x), (n))
+#define SCANTOOL_SHR512(x, n) _mm512_maskz_srli_epi32(0xFFFF, (x), (n))
+
+/** \brief Loads eight consecutive big endian words of eight blocks and
+ *         transposes them, so that words[i] contains word i of all blocks.
+ */
+SCANTOOL_TARGET_AVX2
+inline void loadTransposed8(const uint8_t* const blocks[8], const unsigned int offset, __m256i words[8])
+{
+  const __m256i byteSwap = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+                                           12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+  __m256i r[8];
+  for (unsigned int lane = 0; lane < 8; ++lane)
+  {
+    r[lane] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(blocks[lane] + offset));
+  }
+  const __m256i t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+  const __m256i t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+  const __m256i t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+  const __m256i t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+  const __m256i t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+  const __m256i t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+  const __m256i t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+  const __m256i t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+  const __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+  const __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+  const __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+  const __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+  const __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+  const __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+  const __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+  const __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+  words[0] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u0, u4, 0x20), byteSwap);
+  words[1] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u1, u5, 0x20), byteSwap);
+  words[2] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u2, u6, 0x20), byteSwap);
+  words[3] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u3, u7, 0x20), byteSwap);
+  words[4] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u0, u4, 0x31), byteSwap);
+  words[5] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u1, u5, 0x31), byteSwap);
+  words[6] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u2, u6, 0x31), byteSwap);
+  words[7] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u3, u7, 0x31), byteSwap);
+}
+
+SCANTOOL_TARGET_AVX2
+void compressAvx2(uint32_t state[8][cMaxLanes], const uint8_t* const blocks[cMaxLanes])
+{
+  __m256i w[16];
+  loadTransposed8(blocks, 0, &w[0]);
+  loadTransposed8(blocks, 32, &w[8]);
+
+  __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state[0]));
+  __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state[1]));
+  __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state[2]));
+  __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state[3]));
+  __m256i e = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state[4]));
+  __m256i f = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state[5]));
+  __m256i g = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state[6]));
+  __m256i h = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state[7]));
+
+  for (unsigned int t = 0; t < 64; ++t)
+  {
+    if (t >= 16)
+    {
+      const __m256i w15 = w[(t - 15) & 15];
+      const __m256i w2 = w[(t - 2) & 15];
+      const __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(SCANTOOL_ROTR256(w15, 7), SCANTOOL_ROTR256(w15, 18)), _mm256_srli_epi32(w15, 3));
+      const __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(SCANTOOL_ROTR256(w2, 17), SCANTOOL_ROTR256(w2, 19)), _mm256_srli_epi32(w2, 10));
+      w[t & 15] = _mm256_add_epi32(_mm256_add_epi32(w[t & 15], s0), _mm256_add_epi32(w[(t - 7) & 15], s1));
+    }
+    const __m256i sum1 = _mm256_xor_si256(_mm256_xor_si256(SCANTOOL_ROTR256(e, 6), SCANTOOL_ROTR256(e, 11)), SCANTOOL_ROTR256(e, 25));
+    const __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+    const __m256i t1 = _mm256_add_epi32(_mm256_add_epi32(_mm256_add_epi32(h, sum1), _mm256_add_epi32(ch, w[t & 15])),
+                                        _mm256_set1_epi32(static_cast<int>(cRoundConstants[t])));
+    const __m256i sum0 = _mm256_xor_si256(_mm256_xor_si256(SCANTOOL_ROTR256(a, 2), SCANTOOL_ROTR256(a, 13)), SCANTOOL_ROTR256(a, 22));
+    const __m256i maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+    const __m256i t2 = _mm256_add_epi32(sum0, maj);
+    h = g;
+    g = f;
+    f = e;
+    e = _mm256_add_epi32(d, t1);
+    d = c;
+    c = b;
+    b = a;
+    a = _mm256_add_epi32(t1, t2);
+  } // for
+
+  const __m256i result[8] = { a, b, c, d, e, f, g, h };
+  for (unsigned int i = 0; i < 8; ++i)
+  {
+    __m256i* ptr = reinterpret_cast<__m256i*>(state[i]);
+    _mm256_storeu_si256(ptr, _mm256_add_epi32(_mm256_loadu_si256(ptr), result[i]));
+  }
+}
+
+SCANTOOL_TARGET_AVX512
+void compressAvx512(uint32_t state[8][cMaxLanes], const uint8_t* const blocks[cMaxLanes])
+{
+  __m512i w[16];
+  {
+    __m256i low[16];
+    __m256i high[16];
+    loadTransposed8(blocks, 0, &low[0]);
+    loadTransposed8(blocks, 32, &low[8]);
+    loadTransposed8(blocks + 8, 0, &high[0]);
+    loadTransposed8(blocks + 8, 32, &high[8]);
+    for (unsigned int i = 0; i < 16; ++i)
+    {
+      w[i] = _mm512_maskz_inserti64x4(0xFF, _mm512_maskz_inserti64x4(0xFF, _mm512_setzero_si512(), low[i], 0), high[i], 1);
+    }
+  }
+
+  __m512i a = _mm512_loadu_si512(state[0]);
+  __m512i b = _mm512_loadu_si512(state[1]);
+  __m512i c = _mm512_loadu_si512(state[2]);
+  __m512i d = _mm512_loadu_si512(state[3]);
+  __m512i e = _mm512_loadu_si512(state[4]);
+  __m512i f = _mm512_loadu_si512(state[5]);
+  __m512i g = _mm512_loadu_si512(state[6]);
+  __m512i h = _mm512_loadu_si512(state[7]);
+
+  // 0x96 is a ^ b ^ c, 0xCA is the choice and 0xE8 the majority function.
+  for (unsigned int t = 0; t < 64; ++t)
+  {
+    if (t >= 16)
+    {
+      const __m512i w15 = w[(t - 15) & 15];
+      const __m512i w2 = w[(t - 2) & 15];
+      const __m512i s0 = _mm512_ternarylogic_epi32(SCANTOOL_ROTR512(w15, 7), SCANTOOL_ROTR512(w15, 18), SCANTOOL_SHR512(w15, 3), 0x96);
+      const __m512i s1 = _mm512_ternarylogic_epi32(SCANTOOL_ROTR512(w2, 17), SCANTOOL_ROTR512(w2, 19), SCANTOOL_SHR512(w2, 10), 0x96);
+      w[t & 15] = _mm512_add_epi32(_mm512_add_epi32(w[t & 15], s0), _mm512_add_epi32(w[(t - 7) & 15], s1));
+    }
+    const __m512i sum1 = _mm512_ternarylogic_epi32(SCANTOOL_ROTR512(e, 6), SCANTOOL_ROTR512(e, 11), SCANTOOL_ROTR512(e, 25), 0x96);
+    const __m512i ch = _mm512_ternarylogic_epi32(e, f, g, 0xCA);
+    const __m512i t1 = _mm512_add_epi32(_mm512_add_epi32(_mm512_add_epi32(h, sum1), _mm512_add_epi32(ch, w[t & 15])),
+                                        _mm512_set1_epi32(static_cast<int>(cRoundConstants[t])));
+    const __m512i sum0 = _mm512_ternarylogic_epi32(SCANTOOL_ROTR512(a, 2), SCANTOOL_ROTR512(a, 13), SCANTOOL_ROTR512(a, 22), 0x96);
+    const __m512i maj = _mm512_ternarylogic_epi32(a, b, c, 0xE8);
+    const __m512i t2 = _mm512_add_epi32(sum0, maj);
+    h = g;
+    g = f;
+    f = e;
+    e = _mm512_add_epi32(d, t1);
+    d = c;
+    c = b;
+    b = a;
+    a = _mm512_add_epi32(t1, t2);
+  } // for
+
+  const __m512i result[8] = { a, b, c, d, e, f, g, h };
+  for (unsigned int i = 0; i < 8; ++i)
+  {
+    _mm512_storeu_si512(state[i], _mm512_add_epi32(_mm512_loadu_si512(state[i]), result[i]));
+  }
+}
+
+#undef SCANTOOL_ROTR256
+#undef SCANTOOL_ROTR512
+#undef SCANTOOL_SHR512
+#endif // SCANTOOL_SHA256_MULTIBUFFER
+
+/// initial hash values of SHA-256
+const uint32_t cInitialState[8] = {
+  0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+  0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+/** Progress of the message that is currently hashed in one lane. */
+struct Lane
+{
+  std::size_t message; /**< index of the message */
+  const uint8_t* data; /**< next full block of the message */
+  std::size_t fullBlocks; /**< number of remaining full blocks */
+  uint8_t tail[128]; /**< padded last block(s) of the message */
+  std::size_t tailBlocks; /**< number of padded blocks in tail */
+  std::size_t tailPosition; /**< number of padded blocks that were used */
+};
+
+/** \brief Prepares a lane for a new message.
+ *
+ * \param lane     the lane
+ * \param index    index of the message
+ * \param message  the message
+ */
+void startMessage(Lane& lane, const std::size_t index, const std::string_view& message)
+{
+  const std::size_t length = message.size();
+  const std::size_t remainder = length % 64;
+  lane.message = index;
+  lane.data = reinterpret_cast<const uint8_t*>(message.data());
+  lane.fullBlocks = length / 64;
+  // padding: 0x80, zeros, message length in bits as 64 bit big endian value
+  lane.tailBlocks = (remainder < 56) ? 1 : 2;
+  lane.tailPosition = 0;
+  std::memset(lane.tail, 0, sizeof(lane.tail));
+  if (remainder > 0)
+    std::memcpy(lane.tail, lane.data + lane.fullBlocks * 64, remainder);
+  lane.tail[remainder] = 0x80;
+  const uint64_t bits = static_cast<uint64_t>(length) * 8;
+  uint8_t* end = lane.tail + lane.tailBlocks * 64;
+  for (unsigned int i = 0; i < 8; ++i)
+  {
+    end[-1 - static_cast<int>(i)] = static_cast<uint8_t>(bits >> (8 * i));
+  }
+}
+
+/** \brief Gets the next block of a lane's message.
+ *
+ * \param lane  the lane
+ * \return Returns a pointer to the next block, or nullptr if the message is
+ *         complete.
+ */
+const uint8_t* nextBlock(Lane& lane)
+{
+  if (lane.fullBlocks > 0)
+  {
+    const uint8_t* block = lane.data;
+    lane.data += 64;
+    --lane.fullBlocks;
+    return block;
+  }
+  if (lane.tailPosition < lane.tailBlocks)
+    return lane.tail + 64 * lane.tailPosition++;
+  return nullptr;
+}
+
+} // anonymous namespace
+
+std::string kernelName(const MultiBufferKernel kernel)
+{
+  switch (kernel)
+  {
+    case MultiBufferKernel::Avx2:
+         return "AVX2";
+    case MultiBufferKernel::Avx512:
+         return "AVX-512";
+    case MultiBufferKernel::None:
+    default:
+         return "none";
+  }
+}
+
+unsigned int lanes(const MultiBufferKernel kernel) noexcept
+{
+  switch (kernel)
+  {
+    case MultiBufferKernel::Avx2:
+         return 8;
+    case MultiBufferKernel::Avx512:
+         return 16;
+    case MultiBufferKernel::None:
+    default:
+         return 1;
+  }
+}
+
+bool kernelAvailable(const MultiBufferKernel kernel)
+{
+  switch (kernel)
+  {
+    case MultiBufferKernel::None:
+         return true;
+    #if defined(SCANTOOL_SHA256_MULTIBUFFER)
+    case MultiBufferKernel::Avx2:
+         {
+           static const bool available = cpuHasAvx2();
+           return available;
+         }
+    case MultiBufferKernel::Avx512:
+         {
+           static const bool available = cpuHasAvx512();
+           return available;
+         }
+    #endif
+    default:
+         return false;
+  }
+}
+
+MultiBufferKernel bestMultiBufferKernel()
+{
+  if (kernelAvailable(MultiBufferKernel::Avx512))
+    return MultiBufferKernel::Avx512;
+  /* Eight lanes of AVX2 are faster than the scalar kernel, but slower than
+     hashing one message after another with the SHA extensions. */
+  if (kernelAvailable(MultiBufferKernel::Avx2) && (bestKernel() == Sha256Kernel::Scalar))
+    return MultiBufferKernel::Avx2;
+  return MultiBufferKernel::None;
+}
+
+std::vector<SHA256::MessageDigest> computeFromBuffers(const std::vector<std::string_view>& messages, const MultiBufferKernel kernel)
+{
+  std::vector<SHA256::MessageDigest> digests(messages.size());
+  MultiBufferCompressFunction compress = nullptr;
+  #if defined(SCANTOOL_SHA256_MULTIBUFFER)
+  if (kernelAvailable(kernel))
+  {
+    if (kernel == MultiBufferKernel::Avx2)
+      compress = compressAvx2;
+    else if (kernel == MultiBufferKernel::Avx512)
+      compress = compressAvx512;
+  }
+  #endif
+  // Without multi-buffer kernel, hash one message after another.
+  if ((compress == nullptr) || (messages.size() < 2))
+  {
+    Sha256 sha;
+    for (std::size_t i = 0; i < messages.size(); ++i)
+    {
+      sha.reset();
+      sha.update(reinterpret_cast<const uint8_t*>(messages[i].data()), messages[i].size());
+      digests[i] = sha.finish();
+    }
+    return digests;
+  }
+
+  const unsigned int laneCount = lanes(kernel);
+  // Idle lanes hash this block, their results are discarded.
+  const uint8_t idleBlock[64] = { };
+  Lane lane[cMaxLanes];
+  bool active[cMaxLanes];
+  alignas(64) uint32_t state[8][cMaxLanes];
+  const uint8_t* blocks[cMaxLanes];
+  std::size_t nextMessage = 0;
+
+  for (unsigned int l = 0; l < cMaxLanes; ++l)
+  {
+    active[l] = (l < laneCount) && (nextMessage < messages.size());
+    if (active[l])
+    {
+      startMessage(lane[l], nextMessage, messages[nextMessage]);
+      ++nextMessage;
+    }
+    for (unsigned int i = 0; i < 8; ++i)
+    {
+      state[i][l] = cInitialState[i];
+    }
+    blocks[l] = idleBlock;
+  }
+
+  unsigned int activeLanes = std::min<std::size_t>(laneCount, messages.size());
+  while (activeLanes > 0)
+  {
+    for (unsigned int l = 0; l < laneCount; ++l)
+    {
+      if (active[l])
+        blocks[l] = nextBlock(lane[l]);
+    }
+    compress(state, blocks);
+    for (unsigned int l = 0; l < laneCount; ++l)
+    {
+      // Is the lane's message complete?
+      if (!active[l] || (lane[l].fullBlocks > 0) || (lane[l].tailPosition < lane[l].tailBlocks))
+        continue;
+      SHA256::MessageDigest& digest = digests[lane[l].message];
+      for (unsigned int i = 0; i < 8; ++i)
+      {
+        digest.hash[i] = state[i][l];
+        state[i][l] = cInitialState[i];
+      }
+      if (nextMessage < messages.size())
+      {
+        startMessage(lane[l], nextMessage, messages[nextMessage]);
+        ++nextMessage;
+      }
+      else
+      {
+        active[l] = false;
+        blocks[l] = idleBlock;
+        --activeLanes;
+      }
+    } // for
+  } // while
+  return digests;
+}
+
+std::vector<SHA256::MessageDigest> computeFromFiles(const std::vector<std::string>& fileNames, const bool useRing,
+                                                    const ContentObserver& observer)
+{
+  std::vector<SHA256::MessageDigest> digests(fileNames.size());
+  // contents of all small files, one after another
+  std::vector<uint8_t> contents;
+  // offset and size of the content of each small file
+  std::vector<std::pair<std::size_t, std::size_t> > ranges;
+  // index of the file for each element in ranges
+  std::vector<std::size_t> smallFiles;
+  // One more byte than the limit tells whether the file is too large.
+  const std::size_t readSize = cMaxMultiBufferFileSize + 1;
+
+  // Reads groups of files with a few system calls, if io_uring is available.
+  // Setting up the ring does not pay off for very few files.
+  std::size_t next = 0;
+  // files that the ring could not read, they get another try below
+  std::vector<std::size_t> retry;
+  const std::size_t cMinimumFilesForRing = 8;
+  if (useRing && (fileNames.size() >= cMinimumFilesForRing))
+  {
+    UringReader ring;
+    if (ring.available())
+    {
+      const std::unique_ptr<uint8_t[]> buffer(new uint8_t[ring.entries() * readSize]);
+      std::vector<const std::string*> group;
+      std::vector<int64_t> lengths;
+      while (next < fileNames.size())
+      {
+        group.clear();
+        for (std::size_t i = next; (i < fileNames.size()) && (group.size() < ring.entries()); ++i)
+        {
+          group.push_back(&fileNames[i]);
+        }
+        if (!ring.read(group, buffer.get(), readSize, lengths))
+          break;
+        for (std::size_t j = 0; j < group.size(); ++j)
+        {
+          if (lengths[j] < 0)
+          {
+            retry.push_back(next + j);
+            continue;
+          }
+          const std::size_t size = static_cast<std::size_t>(lengths[j]);
+          const uint8_t* content = buffer.get() + j * readSize;
+          if (observer)
+            observer(next + j, content, size);
+          if (size > cMaxMultiBufferFileSize)
+          {
+            digests[next + j] = computeFromFile(fileNames[next + j]);
+            continue;
+          }
+          ranges.push_back(std::make_pair(contents.size(), size));
+          contents.insert(contents.end(), content, content + size);
+          smallFiles.push_back(next + j);
+        }
+        next += group.size();
+      } // while
+    }
+  }
+
+  // remaining files, if io_uring is not available or failed
+  for (std::size_t i = next; i < fileNames.size(); ++i)
+  {
+    retry.push_back(i);
+  }
+  for (const std::size_t i : retry)
+  {
+    const std::size_t offset = contents.size();
+    contents.resize(offset + readSize);
+    std::size_t size = 0;
+    const bool success = readFileStart(fileNames[i], contents.data() + offset, readSize, size);
+    if (success && observer)
+      observer(i, contents.data() + offset, size);
+    if (!success || (size > cMaxMultiBufferFileSize))
+    {
+      contents.resize(offset);
+      if (success)
+        digests[i] = computeFromFile(fileNames[i]);
+      continue;
+    }
+    contents.resize(offset + size);
+    ranges.push_back(std::make_pair(offset, size));
+    smallFiles.push_back(i);
+  } // for
+
+  // The content does not move anymore, so the views stay valid.
+  std::vector<std::string_view> messages;
+  messages.reserve(ranges.size());
+  for (const auto& range : ranges)
+  {
+    messages.push_back(std::string_view(reinterpret_cast<const char*>(contents.data()) + range.first, range.second));
+  }
+  const auto smallDigests = computeFromBuffers(messages);
+  for (std::size_t i = 0; i < smallDigests.size(); ++i)
+  {
+    digests[smallFiles[i]] = smallDigests[i];
+  }
+  return digests;
+}
+
+} // namespace
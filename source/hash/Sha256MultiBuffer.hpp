@@ -0,0 +1,128 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_HASH_SHA256MULTIBUFFER_HPP
+#define SCANTOOL_HASH_SHA256MULTIBUFFER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../../libstriezel/hash/sha256/sha256.hpp"
+
+namespace scantool::hash
+{
+
+/** enumeration of multi-buffer implementations of SHA-256 */
+enum class MultiBufferKernel
+{
+  /** no multi-buffer hashing, messages are hashed one after another */
+  None,
+
+  /** eight messages at once, using AVX2 */
+  Avx2,
+
+  /** sixteen messages at once, using AVX-512 */
+  Avx512
+};
+
+
+/** \brief Gets the name of a multi-buffer kernel.
+ *
+ * \param kernel  the kernel
+ * \return Returns a human-readable name of the kernel, e.g. "AVX2".
+ */
+std::string kernelName(const MultiBufferKernel kernel);
+
+
+/** \brief Gets the number of messages that a kernel hashes at once.
+ *
+ * \param kernel  the kernel
+ * \return Returns the number of lanes of the kernel, e.g. 8 for AVX2.
+ */
+unsigned int lanes(const MultiBufferKernel kernel) noexcept;
+
+
+/** \brief Checks whether a multi-buffer kernel can be used on the current CPU.
+ *
+ * \param kernel  the kernel
+ * \return Returns true, if the kernel was compiled into the program and the
+ *         CPU and operating system support the required instructions.
+ */
+bool kernelAvailable(const MultiBufferKernel kernel);
+
+
+/** \brief Gets the multi-buffer kernel that is used for batches of messages.
+ *
+ * \return Returns the fastest multi-buffer kernel that is available on the
+ *         current CPU. Returns MultiBufferKernel::None, if there is none or if
+ *         hashing one message after another with the SHA extensions of the
+ *         CPU is faster.
+ */
+MultiBufferKernel bestMultiBufferKernel();
+
+
+/** \brief Computes the SHA-256 message digests of several messages at once.
+ *
+ * \param messages  the messages
+ * \param kernel    the multi-buffer kernel to use; unavailable kernels are
+ *                  replaced by MultiBufferKernel::None
+ * \return Returns the message digests in the same order as the messages.
+ */
+std::vector<SHA256::MessageDigest> computeFromBuffers(const std::vector<std::string_view>& messages, const MultiBufferKernel kernel = bestMultiBufferKernel());
+
+
+/// maximum size of files that are hashed in lockstep by computeFromFiles()
+extern const std::size_t cMaxMultiBufferFileSize;
+
+
+/** \brief Function that gets the start of the content of a file read by
+ *         computeFromFiles().
+ *
+ * The parameters are the index of the file in the list of file names, the
+ * data and its length in octets. The data is only valid during the call.
+ */
+typedef std::function<void(const std::size_t, const uint8_t*, const std::size_t)> ContentObserver;
+
+
+/** \brief Computes the SHA-256 message digests of several files.
+ *
+ * \param fileNames  names of the files
+ * \param useRing    whether files may be read via io_uring, if available
+ * \param observer   function that gets the start of each file that could be
+ *                   read, i.e. the complete content of small files and the
+ *                   first cMaxMultiBufferFileSize + 1 octets of larger files;
+ *                   may be empty
+ * \return Returns the message digests in the same order as the files.
+ *         Digests of files that could not be read are null.
+ * \remarks Files that are not larger than cMaxMultiBufferFileSize are read
+ *          into memory and hashed in lockstep by the multi-buffer kernel.
+ *          Larger files are hashed one after another by computeFromFile().
+ *          On Linux the small files are read in groups via io_uring, which
+ *          needs far fewer system calls than reading one file after another.
+ */
+std::vector<SHA256::MessageDigest> computeFromFiles(const std::vector<std::string>& fileNames, const bool useRing = true,
+                                                    const ContentObserver& observer = ContentObserver());
+
+} // namespace
+
+#endif // SCANTOOL_HASH_SHA256MULTIBUFFER_HPP
@@ -0,0 +1,99 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "Shard.hpp"
+#include <charconv>
+
+namespace scantool::hash
+{
+
+/// maximum number of shards
+const uint32_t cMaximumShards = 65536;
+
+Shard::Shard()
+: m_Index(0),
+  m_Count(1)
+{
+}
+
+bool Shard::fromString(const std::string& text, Shard& shard)
+{
+  const auto slash = text.find('/');
+  if ((slash == std::string::npos) || (slash == 0) || (slash + 1 == text.size()))
+    return false;
+  uint32_t index = 0;
+  uint32_t count = 0;
+  const char* last = text.data() + text.size();
+  const auto indexResult = std::from_chars(text.data(), text.data() + slash, index);
+  if ((indexResult.ec != std::errc()) || (indexResult.ptr != text.data() + slash))
+    return false;
+  const auto countResult = std::from_chars(text.data() + slash + 1, last, count);
+  if ((countResult.ec != std::errc()) || (countResult.ptr != last))
+    return false;
+  if ((index < 1) || (count < 1) || (index > count) || (count > cMaximumShards))
+    return false;
+  shard.m_Index = index - 1;
+  shard.m_Count = count;
+  return true;
+}
+
+std::string Shard::toString() const
+{
+  return std::to_string(m_Index + 1) + "/" + std::to_string(m_Count);
+}
+
+bool Shard::all() const noexcept
+{
+  return m_Count == 1;
+}
+
+bool Shard::containsDigest(const std::string& sha256) const
+{
+  if (m_Count == 1)
+    return true;
+  // The digest is uniformly distributed already, its first 64 bits suffice.
+  uint64_t value = 0;
+  if ((sha256.size() < 16)
+      || (std::from_chars(sha256.data(), sha256.data() + 16, value, 16).ptr != sha256.data() + 16))
+    return m_Index == 0;
+  return value % m_Count == m_Index;
+}
+
+bool Shard::containsPath(const std::string& path) const
+{
+  if (m_Count == 1)
+    return true;
+  // FNV-1a hash, followed by the final mixing step of MurmurHash3, so that
+  // similar paths are spread over all shards.
+  uint64_t hash = 14695981039346656037ULL;
+  for (const char c : path)
+  {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ULL;
+  }
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash % m_Count == m_Index;
+}
+
+} // namespace
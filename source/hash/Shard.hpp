@@ -0,0 +1,94 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_HASH_SHARD_HPP
+#define SCANTOOL_HASH_SHARD_HPP
+
+#include <cstdint>
+#include <string>
+
+namespace scantool::hash
+{
+
+/** \brief Deterministic slice of the work for runs on several nodes.
+ *
+ * Shard I of N contains every file whose hash modulo N is I - 1. So N
+ * nodes with the same shard count and different indices process disjoint
+ * slices that cover all files together, without any coordination. Files are
+ * assigned either by the SHA-256 digest of their content, which puts
+ * duplicates into the same shard, or by a hash of their path, which works
+ * before the file is read.
+ */
+class Shard
+{
+  public:
+    /** \brief Default constructor, creates the single shard 1/1 that
+     *         contains all files.
+     */
+    Shard();
+
+
+    /** \brief Parses a shard given as "I/N".
+     *
+     * \param text   the text, e.g. "2/4" for the second of four shards
+     * \param shard  variable that will hold the parsed shard
+     * \return Returns true, if the text is a valid shard with 1 <= I <= N.
+     *         Returns false otherwise.
+     */
+    static bool fromString(const std::string& text, Shard& shard);
+
+
+    /** \brief Gets the shard as text.
+     *
+     * \return Returns the shard in the form "I/N".
+     */
+    std::string toString() const;
+
+
+    /** \brief Checks whether this shard contains all files.
+     *
+     * \return Returns true, if the shard count is one.
+     */
+    bool all() const noexcept;
+
+
+    /** \brief Checks whether a file belongs to this shard by its content.
+     *
+     * \param sha256  SHA-256 digest of the file's content as hexadecimal string
+     * \return Returns true, if the file belongs to this shard.
+     * \remarks Invalid digests belong to the first shard.
+     */
+    bool containsDigest(const std::string& sha256) const;
+
+
+    /** \brief Checks whether a file belongs to this shard by its path.
+     *
+     * \param path  path of the file, exactly as it was given
+     * \return Returns true, if the file belongs to this shard.
+     */
+    bool containsPath(const std::string& path) const;
+  private:
+    uint32_t m_Index; /**< zero-based index of the shard */
+    uint32_t m_Count; /**< total number of shards */
+}; // class
+
+} // namespace
+
+#endif // SCANTOOL_HASH_SHARD_HPP
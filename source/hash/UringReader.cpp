@@ -0,0 +1,376 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "UringReader.hpp"
+#include <algorithm>
+#include <climits>
+#include "FileReader.hpp"
+
+#if defined(__linux__) && defined(__has_include)
+  #if __has_include(<linux/io_uring.h>)
+    #include <cerrno>
+    #include <cstring>
+    #include <fcntl.h>
+    #include <linux/io_uring.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+    // IORING_FEAT_RW_CUR_POS marks the headers of Linux 5.6, which added the
+    // open, read, close and fadvise operations.
+    #if defined(IORING_FEAT_RW_CUR_POS) && defined(__NR_io_uring_setup)
+      #define SCANTOOL_HAS_IO_URING
+    #endif
+  #endif
+#endif
+
+namespace scantool::hash
+{
+
+const unsigned int UringReader::cDefaultEntries = 64;
+
+/// result value of entries that did not complete
+static const int cNotCompleted = INT_MIN;
+
+#if defined(SCANTOOL_HAS_IO_URING)
+static int uringSetup(const unsigned int entries, io_uring_params* params)
+{
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+static int uringEnter(const int ring, const unsigned int toSubmit, const unsigned int minComplete, const unsigned int flags)
+{
+  return static_cast<int>(syscall(__NR_io_uring_enter, ring, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+/** \brief Completes a read that returned less than requested.
+ *
+ * Network and FUSE file systems may return less data than requested, even
+ * if the file is longer.
+ * \param descriptor  descriptor of the file
+ * \param buffer      buffer for the content
+ * \param size        number of bytes to read
+ * \param length      number of bytes that were read so far, will be updated
+ * \return Returns true, if the file was read up to its end or up to size.
+ */
+static bool completeRead(const int descriptor, uint8_t* buffer, const std::size_t size, std::size_t& length)
+{
+  struct stat status;
+  if (fstat(descriptor, &status) != 0)
+    return false;
+  // Most reads are complete, and then no further read is needed.
+  if ((status.st_size >= 0) && (static_cast<uint64_t>(status.st_size) <= length))
+    return true;
+  while (length < size)
+  {
+    const ssize_t bytesRead = pread(descriptor, buffer + length, size - length, length);
+    if (bytesRead < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    if (bytesRead == 0)
+      break;
+    length += static_cast<std::size_t>(bytesRead);
+  }
+  return true;
+}
+
+static int uringRegister(const int ring, const unsigned int opcode, void* arg, const unsigned int count)
+{
+  return static_cast<int>(syscall(__NR_io_uring_register, ring, opcode, arg, count));
+}
+#endif
+
+UringReader::UringReader(const unsigned int entries)
+: m_Ring(-1),
+  m_Entries(entries > 0 ? entries : 1),
+  m_CanAdvise(false),
+  m_SqMemory(nullptr),
+  m_SqSize(0),
+  m_CqMemory(nullptr),
+  m_CqSize(0),
+  m_SqeMemory(nullptr),
+  m_SqeSize(0),
+  m_SqTail(nullptr),
+  m_SqMask(0),
+  m_SqArray(nullptr),
+  m_CqHead(nullptr),
+  m_CqTail(nullptr),
+  m_CqMask(0),
+  m_Cqes(nullptr),
+  m_Pending(0)
+{
+  #if defined(SCANTOOL_HAS_IO_URING)
+  // The last phase needs two entries per file, fadvise and close.
+  io_uring_params params;
+  std::memset(&params, 0, sizeof(params));
+  const int ring = uringSetup(2 * m_Entries, &params);
+  if (ring < 0)
+    return;
+  m_Ring = ring;
+
+  // The kernel may support io_uring, but not all needed operations.
+  const unsigned int probeOps = 256;
+  std::vector<uint8_t> probeMemory(sizeof(io_uring_probe) + probeOps * sizeof(io_uring_probe_op), 0);
+  io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(probeMemory.data());
+  if (uringRegister(m_Ring, IORING_REGISTER_PROBE, probe, probeOps) < 0)
+  {
+    close(m_Ring);
+    m_Ring = -1;
+    return;
+  }
+  const auto supported = [probe](const unsigned int op)
+  {
+    return (op <= probe->last_op) && ((probe->ops[op].flags & IO_URING_OP_SUPPORTED) != 0);
+  };
+  if (!supported(IORING_OP_OPENAT) || !supported(IORING_OP_READ) || !supported(IORING_OP_CLOSE))
+  {
+    close(m_Ring);
+    m_Ring = -1;
+    return;
+  }
+  m_CanAdvise = supported(IORING_OP_FADVISE);
+
+  m_SqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+  m_CqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (singleMap)
+  {
+    m_SqSize = std::max(m_SqSize, m_CqSize);
+    m_CqSize = 0;
+  }
+  m_SqeSize = params.sq_entries * sizeof(io_uring_sqe);
+  m_SqMemory = mmap(nullptr, m_SqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_Ring, IORING_OFF_SQ_RING);
+  if (m_SqMemory == MAP_FAILED)
+    m_SqMemory = nullptr;
+  if (!singleMap)
+  {
+    m_CqMemory = mmap(nullptr, m_CqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_Ring, IORING_OFF_CQ_RING);
+    if (m_CqMemory == MAP_FAILED)
+      m_CqMemory = nullptr;
+  }
+  m_SqeMemory = mmap(nullptr, m_SqeSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_Ring, IORING_OFF_SQES);
+  if (m_SqeMemory == MAP_FAILED)
+    m_SqeMemory = nullptr;
+  if ((m_SqMemory == nullptr) || (m_SqeMemory == nullptr) || (!singleMap && (m_CqMemory == nullptr)))
+  {
+    // The destructor unmaps whatever was mapped.
+    close(m_Ring);
+    m_Ring = -1;
+    return;
+  }
+
+  uint8_t* sq = static_cast<uint8_t*>(m_SqMemory);
+  uint8_t* cq = singleMap ? sq : static_cast<uint8_t*>(m_CqMemory);
+  m_SqTail = reinterpret_cast<unsigned int*>(sq + params.sq_off.tail);
+  m_SqMask = *reinterpret_cast<unsigned int*>(sq + params.sq_off.ring_mask);
+  m_SqArray = reinterpret_cast<unsigned int*>(sq + params.sq_off.array);
+  m_CqHead = reinterpret_cast<unsigned int*>(cq + params.cq_off.head);
+  m_CqTail = reinterpret_cast<unsigned int*>(cq + params.cq_off.tail);
+  m_CqMask = *reinterpret_cast<unsigned int*>(cq + params.cq_off.ring_mask);
+  m_Cqes = cq + params.cq_off.cqes;
+  #endif
+}
+
+UringReader::~UringReader()
+{
+  #if defined(SCANTOOL_HAS_IO_URING)
+  if (m_SqeMemory != nullptr)
+    munmap(m_SqeMemory, m_SqeSize);
+  if (m_CqMemory != nullptr)
+    munmap(m_CqMemory, m_CqSize);
+  if (m_SqMemory != nullptr)
+    munmap(m_SqMemory, m_SqSize);
+  if (m_Ring >= 0)
+    close(m_Ring);
+  #endif
+}
+
+bool UringReader::available() const noexcept
+{
+  return m_Ring >= 0;
+}
+
+unsigned int UringReader::entries() const noexcept
+{
+  return m_Entries;
+}
+
+void* UringReader::nextEntry(const uint64_t userData)
+{
+  #if defined(SCANTOOL_HAS_IO_URING)
+  // Only this thread writes the tail, so it can be read without atomics.
+  const unsigned int index = (*m_SqTail + m_Pending) & m_SqMask;
+  io_uring_sqe* entry = static_cast<io_uring_sqe*>(m_SqeMemory) + index;
+  std::memset(entry, 0, sizeof(io_uring_sqe));
+  entry->user_data = userData;
+  m_SqArray[index] = index;
+  ++m_Pending;
+  return entry;
+  #else
+  (void) userData;
+  return nullptr;
+  #endif
+}
+
+bool UringReader::run(const unsigned int count, std::vector<int>& results)
+{
+  results.assign(2 * m_Entries, cNotCompleted);
+  #if defined(SCANTOOL_HAS_IO_URING)
+  __atomic_store_n(m_SqTail, *m_SqTail + m_Pending, __ATOMIC_RELEASE);
+  m_Pending = 0;
+  unsigned int submitted = 0;
+  unsigned int completed = 0;
+  while (completed < count)
+  {
+    const int ret = uringEnter(m_Ring, count - submitted, count - completed, IORING_ENTER_GETEVENTS);
+    if (ret < 0)
+    {
+      if ((errno != EINTR) && (errno != EAGAIN) && (errno != EBUSY))
+        return false;
+    }
+    else
+      submitted += static_cast<unsigned int>(ret);
+
+    unsigned int head = *m_CqHead;
+    const unsigned int tail = __atomic_load_n(m_CqTail, __ATOMIC_ACQUIRE);
+    while (head != tail)
+    {
+      const io_uring_cqe* cqe = static_cast<const io_uring_cqe*>(m_Cqes) + (head & m_CqMask);
+      if (cqe->user_data < results.size())
+        results[cqe->user_data] = cqe->res;
+      ++completed;
+      ++head;
+    }
+    __atomic_store_n(m_CqHead, head, __ATOMIC_RELEASE);
+  } // while
+  return true;
+  #else
+  (void) count;
+  return false;
+  #endif
+}
+
+bool UringReader::read(const std::vector<const std::string*>& fileNames, uint8_t* buffer, const std::size_t size, std::vector<int64_t>& lengths)
+{
+  const unsigned int count = static_cast<unsigned int>(fileNames.size());
+  lengths.assign(count, -1);
+  if (!available() || (count > m_Entries))
+    return false;
+  #if defined(SCANTOOL_HAS_IO_URING)
+  std::vector<int> results;
+  // first phase: open all files
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    io_uring_sqe* entry = static_cast<io_uring_sqe*>(nextEntry(i));
+    entry->opcode = IORING_OP_OPENAT;
+    entry->fd = AT_FDCWD;
+    entry->addr = reinterpret_cast<uintptr_t>(fileNames[i]->c_str());
+    entry->open_flags = O_RDONLY | O_CLOEXEC;
+  }
+  const bool opened = run(count, results);
+  const std::vector<int> descriptors(results.begin(), results.begin() + count);
+  const auto closeAll = [&descriptors]()
+  {
+    for (const int descriptor : descriptors)
+    {
+      if (descriptor >= 0)
+        close(descriptor);
+    }
+  };
+  if (!opened)
+  {
+    closeAll();
+    return false;
+  }
+
+  // second phase: read the opened files
+  unsigned int pending = 0;
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    if (descriptors[i] < 0)
+      continue;
+    io_uring_sqe* entry = static_cast<io_uring_sqe*>(nextEntry(i));
+    entry->opcode = IORING_OP_READ;
+    entry->fd = descriptors[i];
+    entry->addr = reinterpret_cast<uintptr_t>(buffer + i * size);
+    entry->len = static_cast<uint32_t>(size);
+    entry->off = 0;
+    ++pending;
+  }
+  if (!run(pending, results))
+  {
+    closeAll();
+    return false;
+  }
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    if ((descriptors[i] < 0) || (results[i] < 0))
+      continue;
+    std::size_t length = static_cast<std::size_t>(results[i]);
+    if ((length >= size) || completeRead(descriptors[i], buffer + i * size, size, length))
+      lengths[i] = static_cast<int64_t>(length);
+  }
+
+  // third phase: drop the pages, if requested, and close the files
+  const bool drop = readMode() != ReadMode::Cached;
+  pending = 0;
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    if (descriptors[i] < 0)
+      continue;
+    if (drop && m_CanAdvise)
+    {
+      io_uring_sqe* advice = static_cast<io_uring_sqe*>(nextEntry(m_Entries + i));
+      advice->opcode = IORING_OP_FADVISE;
+      advice->fd = descriptors[i];
+      advice->off = 0;
+      advice->len = 0;
+      advice->fadvise_advice = POSIX_FADV_DONTNEED;
+      // A hard link closes the file even when the advice fails.
+      advice->flags = IOSQE_IO_HARDLINK;
+      ++pending;
+    }
+    else if (drop)
+      posix_fadvise(descriptors[i], 0, 0, POSIX_FADV_DONTNEED);
+    io_uring_sqe* entry = static_cast<io_uring_sqe*>(nextEntry(i));
+    entry->opcode = IORING_OP_CLOSE;
+    entry->fd = descriptors[i];
+    ++pending;
+  }
+  // The contents are complete, even if the ring fails to close the files.
+  // Files that were not closed by the ring are closed here.
+  run(pending, results);
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    if ((descriptors[i] >= 0) && (results[i] == cNotCompleted))
+      close(descriptors[i]);
+  }
+  return true;
+  #else
+  (void) buffer;
+  (void) size;
+  return false;
+  #endif
+}
+
+} // namespace
@@ -0,0 +1,131 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_HASH_URINGREADER_HPP
+#define SCANTOOL_HASH_URINGREADER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace scantool::hash
+{
+
+/** \brief Reads the beginning of many files with few system calls.
+ *
+ * On Linux the reader uses io_uring: the opens, reads and closes of a group
+ * of files are submitted at once, which needs three system calls per group
+ * instead of three per file. If io_uring is not available, e.g. because the
+ * kernel is too old or io_uring is disabled, available() returns false and
+ * the caller has to read the files in the usual way.
+ */
+class UringReader
+{
+  public:
+    /** \brief Constructor, sets up the submission and completion queues.
+     *
+     * \param entries  maximum number of files that are read at once
+     */
+    explicit UringReader(const unsigned int entries = cDefaultEntries);
+
+
+    /** \brief Destructor, releases the queues.
+     */
+    ~UringReader();
+
+
+    UringReader(const UringReader& other) = delete;
+    UringReader& operator=(const UringReader& other) = delete;
+
+
+    /// default number of files that are read at once
+    static const unsigned int cDefaultEntries;
+
+
+    /** \brief Checks whether io_uring can be used.
+     *
+     * \return Returns true, if the reader can read files.
+     */
+    bool available() const noexcept;
+
+
+    /** \brief Gets the maximum number of files per call of read().
+     *
+     * \return Returns the number of files that can be read at once.
+     */
+    unsigned int entries() const noexcept;
+
+
+    /** \brief Reads the beginning of a group of files.
+     *
+     * \param fileNames  names of the files, at most entries() names
+     * \param buffer     buffer for the contents, the content of the i-th file
+     *                   starts at buffer + i * size
+     * \param size       number of bytes to read per file
+     * \param lengths    will hold the number of bytes read for each file, or
+     *                   -1, if the file could not be opened or read; a length
+     *                   below size means that the whole file was read
+     * \return Returns true, if the group was processed. Returns false, if the
+     *         reader failed; the files have to be read otherwise then.
+     * \remarks In the modes ReadMode::NoCache and ReadMode::Direct the pages
+     *          of the files are dropped from the page cache after reading.
+     */
+    bool read(const std::vector<const std::string*>& fileNames, uint8_t* buffer, const std::size_t size, std::vector<int64_t>& lengths);
+  private:
+    /** \brief Submits the prepared entries and waits for their completion.
+     *
+     * \param count    number of prepared submission queue entries
+     * \param results  will hold the result of each entry, indexed by user data
+     * \return Returns true, if all entries were completed.
+     */
+    bool run(const unsigned int count, std::vector<int>& results);
+
+
+    /** \brief Gets the next free submission queue entry and clears it.
+     *
+     * \param userData  value that identifies the entry on completion
+     * \return Returns a pointer to the io_uring_sqe structure.
+     */
+    void* nextEntry(const uint64_t userData);
+
+
+    int m_Ring; /**< file descriptor of the ring, -1 if not available */
+    unsigned int m_Entries; /**< number of submission queue entries */
+    bool m_CanAdvise; /**< whether the ring supports fadvise operations */
+    void* m_SqMemory; /**< mapped memory of the submission queue ring */
+    std::size_t m_SqSize; /**< size of m_SqMemory */
+    void* m_CqMemory; /**< mapped memory of the completion queue ring */
+    std::size_t m_CqSize; /**< size of m_CqMemory */
+    void* m_SqeMemory; /**< mapped memory of the submission queue entries */
+    std::size_t m_SqeSize; /**< size of m_SqeMemory */
+    unsigned int* m_SqTail; /**< tail of the submission queue */
+    unsigned int m_SqMask; /**< index mask of the submission queue */
+    unsigned int* m_SqArray; /**< index array of the submission queue */
+    unsigned int* m_CqHead; /**< head of the completion queue */
+    unsigned int* m_CqTail; /**< tail of the completion queue */
+    unsigned int m_CqMask; /**< index mask of the completion queue */
+    void* m_Cqes; /**< completion queue entries */
+    unsigned int m_Pending; /**< number of prepared, but not submitted entries */
+}; // class
+
+} // namespace
+
+#endif // SCANTOOL_HASH_URINGREADER_HPP
@@ -0,0 +1,338 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "CacheImport.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <zlib.h>
+#include "../../libstriezel/common/StringUtils.hpp"
+#include "../../libstriezel/filesystem/file.hpp"
+#include "../../libstriezel/hash/sha256/sha256.hpp"
+#include "CacheIteration.hpp"
+#include "../virustotal/CacheManagerV2.hpp"
+#include "../virustotal/ReportV2.hpp"
+
+namespace scantool::virustotal
+{
+
+/// number of lines that are processed together
+const std::vector<std::string>::size_type cBatchSize = 4096;
+
+/// maximum length of a line, longer lines cannot be proper reports
+const std::string::size_type cMaximumLineLength = 1024 * 1024 * 2;
+
+CacheImport::CacheImport(const std::string& cacheRoot, const unsigned int threads)
+: m_CacheRoot(cacheRoot),
+  m_Threads(threads),
+  m_Imported(0),
+  m_Kept(0),
+  m_Rejected(0),
+  m_Failed(0)
+{
+  if (m_Threads == 0)
+    m_Threads = std::thread::hardware_concurrency();
+  // hardware_concurrency() may return zero, if the value is not computable.
+  if (m_Threads == 0)
+    m_Threads = 1;
+}
+
+bool CacheImport::importBundle(const std::string& bundleFile)
+{
+  // gzread() also reads uncompressed files, so plain NDJSON works, too.
+  gzFile bundle = gzopen(bundleFile.c_str(), "rb");
+  if (bundle == nullptr)
+  {
+    std::cerr << "Error: Could not open bundle file " << bundleFile << "!"
+              << std::endl;
+    return false;
+  }
+  gzbuffer(bundle, 256 * 1024);
+
+  std::vector<char> chunk(1024 * 1024);
+  std::string pending;
+  std::vector<std::string> batch;
+  batch.reserve(cBatchSize);
+  bool success = true;
+  while (true)
+  {
+    const int bytesRead = gzread(bundle, chunk.data(), static_cast<unsigned int>(chunk.size()));
+    if (bytesRead < 0)
+    {
+      int errorNumber = Z_OK;
+      std::cerr << "Error: Could not read from bundle file " << bundleFile
+                << ": " << gzerror(bundle, &errorNumber) << std::endl;
+      success = false;
+      break;
+    }
+    if (bytesRead == 0)
+      break;
+
+    std::string::size_type start = 0;
+    const char * data = chunk.data();
+    for (int i = 0; i < bytesRead; ++i)
+    {
+      if (data[i] != '\n')
+        continue;
+      pending.append(data + start, i - start);
+      start = i + 1;
+      // check for possible carriage return at end (happens on Windows systems)
+      if (!pending.empty() && (pending.back() == '\r'))
+        pending.pop_back();
+      if (!pending.empty())
+      {
+        batch.push_back(std::move(pending));
+        if (batch.size() >= cBatchSize)
+        {
+          processBatch(batch);
+          batch.clear();
+        }
+      }
+      pending.clear();
+    } // for
+    pending.append(data + start, bytesRead - start);
+  } // while
+  gzclose(bundle);
+
+  // The last line does not need to end with a line break.
+  if (success)
+  {
+    if (!pending.empty() && (pending.back() == '\r'))
+      pending.pop_back();
+    if (!pending.empty())
+      batch.push_back(std::move(pending));
+  }
+  if (!batch.empty())
+    processBatch(batch);
+  return success;
+}
+
+bool CacheImport::importCache(const std::string& otherCacheRoot)
+{
+  // collects the reports of the other cache into batches
+  class CollectOperation: public IterationOperation
+  {
+    public:
+      explicit CollectOperation(CacheImport& importer)
+      : m_Importer(importer),
+        m_Batch(std::vector<std::string>())
+      {
+        m_Batch.reserve(cBatchSize);
+      }
+
+      void process(const std::string& fileName) override
+      {
+        std::string content;
+        if (!libstriezel::filesystem::file::readIntoString(fileName, content))
+        {
+          ++m_Importer.m_Rejected;
+          return;
+        }
+        m_Batch.push_back(std::move(content));
+        if (m_Batch.size() >= cBatchSize)
+          flush();
+      }
+
+      void flush()
+      {
+        if (!m_Batch.empty())
+          m_Importer.processBatch(m_Batch);
+        m_Batch.clear();
+      }
+    private:
+      CacheImport& m_Importer; /**< importer that gets the reports */
+      std::vector<std::string> m_Batch; /**< reports that were not processed yet */
+  }; // class
+
+  CollectOperation collect(*this);
+  CacheIteration iteration;
+  const bool iterated = iteration.iterate(otherCacheRoot, collect);
+  collect.flush();
+  return iterated;
+}
+
+void CacheImport::processBatch(const std::vector<std::string>& lines)
+{
+  std::vector<ParsedLine> parsed(lines.size());
+  const unsigned int threadCount = std::min(static_cast<std::vector<std::string>::size_type>(m_Threads),
+                                            lines.size());
+  if (threadCount <= 1)
+  {
+    for (std::vector<std::string>::size_type i = 0; i < lines.size(); ++i)
+    {
+      parseLine(lines[i], parsed[i]);
+      if (parsed[i].resourceID.empty())
+        ++m_Rejected;
+      else
+        insert(lines[i], parsed[i]);
+    }
+    return;
+  }
+
+  // Parsing is independent for each line, so lines are just interleaved.
+  std::vector<std::thread> workers;
+  workers.reserve(threadCount);
+  for (unsigned int t = 0; t < threadCount; ++t)
+  {
+    workers.emplace_back([&lines, &parsed, t, threadCount]()
+    {
+      for (auto i = t; i < lines.size(); i += threadCount)
+      {
+        parseLine(lines[i], parsed[i]);
+      }
+    });
+  }
+  for (auto & worker : workers)
+  {
+    worker.join();
+  }
+  workers.clear();
+
+  /* Reports for the same resource have to be inserted by the same thread and
+     in the order of the bundle, so the work is split by resource ID. */
+  for (unsigned int t = 0; t < threadCount; ++t)
+  {
+    workers.emplace_back([this, &lines, &parsed, t, threadCount]()
+    {
+      for (std::vector<std::string>::size_type i = 0; i < lines.size(); ++i)
+      {
+        const std::string& id = parsed[i].resourceID;
+        if (id.empty())
+          continue;
+        const unsigned int bucket = (static_cast<unsigned char>(id[0]) << 8)
+                                  | static_cast<unsigned char>(id[1]);
+        if (bucket % threadCount == t)
+          insert(lines[i], parsed[i]);
+      }
+    });
+  }
+  for (auto & worker : workers)
+  {
+    worker.join();
+  }
+  // Rejected lines have not been counted by any insertion thread yet.
+  for (const auto & item : parsed)
+  {
+    if (item.resourceID.empty())
+      ++m_Rejected;
+  }
+}
+
+void CacheImport::parseLine(const std::string& line, ParsedLine& parsed)
+{
+  parsed.resourceID.clear();
+  parsed.scanDate = static_cast<std::time_t>(-1);
+  parsed.known = false;
+  if (line.size() > cMaximumLineLength)
+    return;
+
+  ReportV2 report;
+  if (!report.fromJsonString(line))
+    return;
+  std::string id;
+  if (report.successfulRetrieval())
+  {
+    id = report.sha256;
+    parsed.known = true;
+    if (report.hasTime_t())
+      parsed.scanDate = report.scan_date_t;
+  }
+  else if (report.notFound())
+  {
+    // Reports of unknown files only contain the requested resource.
+    id = report.resource;
+  }
+  // Reports of queued scans or failed requests are not cached at all.
+  if ((id.size() == 64) && SHA256::isValidHash(id))
+    parsed.resourceID = toLowerString(id);
+}
+
+void CacheImport::insert(const std::string& line, const ParsedLine& parsed)
+{
+  if (parsed.resourceID.empty())
+    return;
+
+  const std::string path = CacheManagerV2::getPathForCachedElement(parsed.resourceID, m_CacheRoot);
+  if (libstriezel::filesystem::file::exists(path))
+  {
+    std::string content;
+    ReportV2 cached;
+    if (libstriezel::filesystem::file::readIntoString(path, content)
+        && cached.fromJsonString(content))
+    {
+      bool keepCached = false;
+      if (cached.successfulRetrieval())
+      {
+        // Never replace information about a file with "file is unknown".
+        keepCached = !parsed.known
+            || (cached.hasTime_t() && ((parsed.scanDate == static_cast<std::time_t>(-1))
+                                       || (cached.scan_date_t >= parsed.scanDate)));
+      }
+      else
+      {
+        // Unknown files only get replaced by actual reports.
+        keepCached = !parsed.known;
+      }
+      if (keepCached)
+      {
+        ++m_Kept;
+        return;
+      }
+    } // if cached report could be parsed
+  } // if file exists
+
+  if (!CacheManagerV2::createDirectoryForCachedElement(parsed.resourceID, m_CacheRoot))
+  {
+    ++m_Failed;
+    return;
+  }
+  std::ofstream output(path, std::ios::out | std::ios::binary | std::ios::trunc);
+  output.write(line.data(), line.size());
+  output.close();
+  if (!output.good())
+  {
+    ++m_Failed;
+    return;
+  }
+  ++m_Imported;
+}
+
+uint_least32_t CacheImport::imported() const
+{
+  return m_Imported;
+}
+
+uint_least32_t CacheImport::kept() const
+{
+  return m_Kept;
+}
+
+uint_least32_t CacheImport::rejected() const
+{
+  return m_Rejected;
+}
+
+uint_least32_t CacheImport::failed() const
+{
+  return m_Failed;
+}
+
+} // namespace
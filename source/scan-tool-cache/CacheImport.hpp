@@ -0,0 +1,125 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_VT_CACHE_CACHEIMPORT_HPP
+#define SCANTOOL_VT_CACHE_CACHEIMPORT_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace scantool::virustotal
+{
+
+/** \brief Imports reports from an NDJSON bundle into the request cache.
+ *
+ * A bundle contains one JSON report per line, like the reports returned by
+ * the VirusTotal API and stored in the request cache. It may be compressed
+ * with gzip. Bundles are created by the export operation of scan-tool-cache,
+ * but dumps of reports from other sources can be imported as well.
+ */
+class CacheImport
+{
+  public:
+    /** \brief Constructor.
+     *
+     * \param cacheRoot  root directory of the request cache
+     * \param threads    number of threads that parse and insert reports;
+     *                   zero means one thread per available CPU core
+     */
+    CacheImport(const std::string& cacheRoot, const unsigned int threads = 0);
+
+
+    /** \brief Imports all reports from a bundle.
+     *
+     * \param bundleFile  path of the bundle file
+     * \return Returns true, if the bundle could be read completely.
+     *         Returns false, if a read error occurred.
+     * \remarks Reports that are older than an already cached report for the
+     *          same resource do not replace the cached report. Lines that do
+     *          not contain a valid report are counted as rejected.
+     */
+    bool importBundle(const std::string& bundleFile);
+
+
+    /** \brief Imports all reports from another request cache, e.g. the
+     *         cache of another node.
+     *
+     * \param otherCacheRoot  root directory of the other request cache
+     * \return Returns true, if the other cache could be iterated.
+     *         Returns false otherwise.
+     * \remarks Reports are handled like lines of a bundle, so newer reports
+     *          win. Files that cannot be read are counted as rejected.
+     */
+    bool importCache(const std::string& otherCacheRoot);
+
+
+    /// functions to return gathered information
+    uint_least32_t imported() const;
+    uint_least32_t kept() const;
+    uint_least32_t rejected() const;
+    uint_least32_t failed() const;
+  private:
+    /** \brief Result of parsing a single line of the bundle. */
+    struct ParsedLine
+    {
+      std::string resourceID; /**< resource ID; empty, if line was rejected */
+      std::time_t scanDate; /**< scan date of report, or -1 if unknown */
+      bool known; /**< whether the resource is known to VirusTotal */
+    }; // struct
+
+
+    /** \brief Parses and inserts a batch of lines from the bundle.
+     *
+     * \param lines  the lines of the batch
+     */
+    void processBatch(const std::vector<std::string>& lines);
+
+
+    /** \brief Parses a single line and validates the report.
+     *
+     * \param line    the line
+     * \param parsed  receives the result
+     */
+    static void parseLine(const std::string& line, ParsedLine& parsed);
+
+
+    /** \brief Writes a parsed report into the cache, unless a newer report
+     *         is cached already.
+     *
+     * \param line    the line containing the report
+     * \param parsed  the parsing result for that line
+     */
+    void insert(const std::string& line, const ParsedLine& parsed);
+
+
+    std::string m_CacheRoot; /**< root directory of the request cache */
+    unsigned int m_Threads; /**< number of worker threads */
+    std::atomic<uint_least32_t> m_Imported; /**< number of imported reports */
+    std::atomic<uint_least32_t> m_Kept; /**< number of reports where the cached report was newer */
+    std::atomic<uint_least32_t> m_Rejected; /**< number of invalid lines */
+    std::atomic<uint_least32_t> m_Failed; /**< number of reports that could not be written */
+}; // class
+
+} // namespace
+
+#endif // SCANTOOL_VT_CACHE_CACHEIMPORT_HPP
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2016, 2025  Dirk Stolle
+    Copyright (C) 2016, 2025, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -27,6 +27,16 @@
 namespace scantool::virustotal
 {
 
+CacheIteration::CacheIteration()
+: m_Shard(scantool::hash::Shard())
+{
+}
+
+void CacheIteration::setShard(const scantool::hash::Shard& shard)
+{
+  m_Shard = shard;
+}
+
 bool CacheIteration::iterate(const std::string& cacheDir, IterationOperation& op)
 {
   if (cacheDir.empty())
@@ -36,38 +46,28 @@ bool CacheIteration::iterate(const std::string& cacheDir, IterationOperation& op
   if (!libstriezel::filesystem::directory::exists(cacheDir))
     return true;
 
-  /* Note:
-     The current iteration via loops should later be replaced by
-     std::experimental::filesystem::directory_iterator, as soon as it is
-     supported by most relevant compilers.
-  */
-
-  const std::vector<char> subChars = { '0', '1', '2', '3', '4', '5', '6', '7',
-                                       '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'};
-  for (const auto firstChar : subChars)
+  /* Only directories that exist and match the cache's layout are visited,
+     so iteration stays cheap even for layouts with several levels. */
+  const CacheLayout layout = CacheManagerV2::getLayoutForCacheRoot(cacheDir);
+  layout.forEachLeafDirectory(cacheDir,
+      [this, &op](const std::string& currentSubDirectory)
   {
-    for (const auto secondChar : subChars)
+    const auto files = libstriezel::filesystem::getDirectoryFileList(currentSubDirectory);
+    #ifdef SCAN_TOOL_DEBUG
+    std::clog << "Debug: Found " << files.size() << " files in "
+              << currentSubDirectory << "." << std::endl;
+    #endif // SCAN_TOOL_DEBUG
+    for (auto const & file : files)
     {
-      const std::string currentSubDirectory = libstriezel::filesystem::slashify(cacheDir)
-                      + std::string(1, firstChar) + std::string(1, secondChar);
-      if (libstriezel::filesystem::directory::exists(currentSubDirectory))
+      // Names of cached reports start with the SHA-256 hash of the file.
+      if (!file.isDirectory && CacheManagerV2::isCachedElementName(file.fileName)
+          && m_Shard.containsDigest(file.fileName.substr(0, 64)))
       {
-        const auto files = libstriezel::filesystem::getDirectoryFileList(currentSubDirectory);
-        #ifdef SCAN_TOOL_DEBUG
-        std::clog << "Debug: Found " << files.size() << " files in "
-                  << currentSubDirectory << "." << std::endl;
-        #endif // SCAN_TOOL_DEBUG
-        for (auto const & file : files)
-        {
-          if (!file.isDirectory && CacheManagerV2::isCachedElementName(file.fileName))
-          {
-            // process file
-            op.process(currentSubDirectory + libstriezel::filesystem::pathDelimiter + file.fileName);
-          } // if file is a cached report
-        } // for
-      } // if subdirectory exists
-    } // for (second char)
-  } // for (first char)
+        // process file
+        op.process(currentSubDirectory + libstriezel::filesystem::pathDelimiter + file.fileName);
+      } // if file is a cached report
+    } // for
+  }); // lambda for each leaf directory
   return true;
 }
 
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2016, 2025  Dirk Stolle
+    Copyright (C) 2016, 2025, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -23,6 +23,7 @@
 
 #include <string>
 #include "IterationOperation.hpp"
+#include "../hash/Shard.hpp"
 
 namespace scantool::virustotal
 {
@@ -30,6 +31,18 @@ namespace scantool::virustotal
 class CacheIteration
 {
   public:
+    /** \brief Default constructor, iteration visits all files.
+     */
+    CacheIteration();
+
+
+    /** \brief Restricts the iteration to the reports of one shard.
+     *
+     * \param shard  the shard whose reports are visited
+     */
+    void setShard(const scantool::hash::Shard& shard);
+
+
     /** \brief Iterates over all files in the request cache.
      *
      * \param cacheDir  the root directory of the request cache
@@ -38,6 +51,8 @@ class CacheIteration
      *         Returns false, if not (error occurred).
      */
     bool iterate(const std::string& cacheDir, IterationOperation& op);
+  private:
+    scantool::hash::Shard m_Shard; /**< shard whose reports are visited */
 }; // class
 
 } // namespace
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2016, 2025  Dirk Stolle
+    Copyright (C) 2016, 2025, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -29,7 +29,11 @@ enum class CacheOperation { None, //none yet
                             ExistenceCheck, //check existence of cache directory
                             IntegrityCheck, //integrity check for cached files
                             Statistics, //cache statistics
-                            Update //update existing files
+                            Update, //update existing files
+                            Relayout, //change directory layout of cache
+                            Export, //export reports into a bundle
+                            Import, //import reports from a bundle
+                            Merge //merge reports from another cache
                           };
 
 } //namespace
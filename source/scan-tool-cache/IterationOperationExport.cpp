@@ -0,0 +1,104 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "IterationOperationExport.hpp"
+#include <string>
+#include "../../libstriezel/filesystem/file.hpp"
+#include "../../third-party/simdjson/simdjson.h"
+
+namespace scantool::virustotal
+{
+
+IterationOperationExport::IterationOperationExport(gzFile bundle)
+: m_Bundle(bundle),
+  m_Buffer(std::vector<char>()),
+  m_Exported(0),
+  m_Skipped(0),
+  m_WriteError(false)
+{
+}
+
+void IterationOperationExport::process(const std::string& fileName)
+{
+  // There is no point in writing more data after the first error.
+  if (m_WriteError)
+    return;
+
+  // check, if file is way too large for a proper cache file
+  const auto fileSize = libstriezel::filesystem::file::getSize64(fileName);
+  if (fileSize >= 1024 * 1024 * 2)
+  {
+    ++m_Skipped;
+    return;
+  }
+
+  std::string content;
+  if (!libstriezel::filesystem::file::readIntoString(fileName, content)
+      || content.empty())
+  {
+    ++m_Skipped;
+    return;
+  }
+
+  /* Minified JSON never contains a line break, because line breaks within
+     strings have to be escaped. So each report fits into a single line. */
+  if (m_Buffer.size() < content.size() + 1)
+    m_Buffer.resize(content.size() + 1);
+  std::size_t length = 0;
+  if (simdjson::minify(content.data(), content.size(), m_Buffer.data(), length)
+      != simdjson::SUCCESS)
+  {
+    ++m_Skipped;
+    return;
+  }
+  if ((length == 0) || (m_Buffer[0] != '{'))
+  {
+    // Not a JSON object, so it cannot be a report.
+    ++m_Skipped;
+    return;
+  }
+  m_Buffer[length] = '\n';
+  ++length;
+
+  if (gzwrite(m_Bundle, m_Buffer.data(), static_cast<unsigned int>(length))
+      != static_cast<int>(length))
+  {
+    m_WriteError = true;
+    return;
+  }
+  ++m_Exported;
+}
+
+uint_least32_t IterationOperationExport::exported() const
+{
+  return m_Exported;
+}
+
+uint_least32_t IterationOperationExport::skipped() const
+{
+  return m_Skipped;
+}
+
+bool IterationOperationExport::writeError() const
+{
+  return m_WriteError;
+}
+
+} // namespace
@@ -0,0 +1,64 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_VT_CACHE_ITERATIONOPERATIONEXPORT_HPP
+#define SCANTOOL_VT_CACHE_ITERATIONOPERATIONEXPORT_HPP
+
+#include "IterationOperation.hpp"
+#include <cstdint>
+#include <vector>
+#include <zlib.h>
+
+namespace scantool::virustotal
+{
+
+/** Writes each cached report as one line of a (compressed) NDJSON bundle. */
+class IterationOperationExport: public IterationOperation
+{
+  public:
+    /** \brief Constructor.
+     *
+     * \param bundle  opened handle of the bundle file, must stay open while
+     *                the operation is used
+     */
+    IterationOperationExport(gzFile bundle);
+
+
+    /** \brief Performs the operation for a single cached element.
+     *
+     * \param fileName   file name of the cached element
+     */
+    virtual void process(const std::string& fileName) override;
+
+    /// functions to return gathered information
+    uint_least32_t exported() const;
+    uint_least32_t skipped() const;
+    bool writeError() const;
+  private:
+    gzFile m_Bundle; /**< handle of the bundle file */
+    std::vector<char> m_Buffer; /**< buffer for minified JSON, reused for all files */
+    uint_least32_t m_Exported; /**< number of exported reports */
+    uint_least32_t m_Skipped; /**< number of files that could not be exported */
+    bool m_WriteError; /**< whether writing to the bundle failed */
+}; // class
+
+} // namespace
+
+#endif // SCANTOOL_VT_CACHE_ITERATIONOPERATIONEXPORT_HPP
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2016, 2019, 2025  Dirk Stolle
+    Copyright (C) 2016, 2019, 2025, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -25,11 +25,11 @@
 namespace scantool::virustotal
 {
 
-IterationOperationUpdate::IterationOperationUpdate(const std::string& apikey, const bool silent, const std::chrono::system_clock::time_point& ageLimit, const std::string& cacheDir)
+IterationOperationUpdate::IterationOperationUpdate(const std::string& apikey, const bool silent, const FreshnessPolicy& freshness, const std::string& cacheDir)
 : IterationOperation(),
   scannerVT(ScannerV2(apikey, true, silent)),
   m_silent(silent),
-  m_ageLimit(ageLimit),
+  m_freshness(freshness),
   m_cacheMgr(CacheManagerV2(cacheDir)),
   m_pendingRescans(std::vector<std::string>())
 {
@@ -51,8 +51,7 @@ void IterationOperationUpdate::process(const std::string& fileName)
     return;
 
   //check if update is required
-  if (report.hasTime_t()
-      && (std::chrono::system_clock::from_time_t(report.scan_date_t) < m_ageLimit))
+  if (m_freshness.isOutdated(report))
   {
     const std::string currentSHA256 = report.sha256;
     // get current report
@@ -61,8 +60,7 @@ void IterationOperationUpdate::process(const std::string& fileName)
       if (report.successfulRetrieval())
       {
         // Rescan required, because current report is still too old?
-        if(report.hasTime_t()
-           && (std::chrono::system_clock::from_time_t(report.scan_date_t) < m_ageLimit))
+        if (m_freshness.isOutdated(report))
         {
           std::string scan_id = "";
           if (scannerVT.rescan(currentSHA256, scan_id))
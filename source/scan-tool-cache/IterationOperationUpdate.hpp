@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2016, 2025  Dirk Stolle
+    Copyright (C) 2016, 2025, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -24,6 +24,7 @@
 #include <vector>
 #include "IterationOperation.hpp"
 #include "../virustotal/CacheManagerV2.hpp"
+#include "../virustotal/FreshnessPolicy.hpp"
 #include "../virustotal/ScannerV2.hpp"
 
 namespace scantool::virustotal
@@ -37,10 +38,10 @@ class IterationOperationUpdate: public IterationOperation
      *
      * \param apikey  the VirusTotal API key used for scanning/updating
      * \param silent  whether or not output to the standard output should be reduced
-     * \param ageLimit the maximum age of reports (older reports will get an update)
+     * \param freshness  policy that decides which reports are outdated (outdated reports will get an update)
      * \param cacheDir   root directory of the scan tool cache
      */
-    IterationOperationUpdate(const std::string& apikey, const bool silent, const std::chrono::system_clock::time_point& ageLimit, const std::string& cacheDir);
+    IterationOperationUpdate(const std::string& apikey, const bool silent, const FreshnessPolicy& freshness, const std::string& cacheDir);
 
 
     /** \brief Performs the operation for a single cached element.
@@ -65,7 +66,7 @@ class IterationOperationUpdate: public IterationOperation
   private:
     ScannerV2 scannerVT; /**< scanner that will be used for update */
     bool m_silent; /**< silence flag */
-    std::chrono::system_clock::time_point m_ageLimit; /**< limit for updates */
+    FreshnessPolicy m_freshness; /**< policy for updates */
     CacheManagerV2 m_cacheMgr; /**< cache manager instance */
     std::vector<std::string> m_pendingRescans; /**< list of pending rescans */
 }; // class
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2016, 2021  Dirk Stolle
+    Copyright (C) 2016, 2021, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -21,16 +21,23 @@
 #include <chrono>
 #include <iostream>
 #include <string>
+#include <vector>
+#include <zlib.h>
 #include "../../libstriezel/common/StringUtils.hpp"
 #include "../../libstriezel/filesystem/directory.hpp"
 #include "../../libstriezel/filesystem/file.hpp"
+#include "../hash/Shard.hpp"
 #include "../virustotal/CacheManagerV2.hpp"
+#include "../virustotal/PendingScans.hpp"
+#include "../virustotal/QuotaLease.hpp"
 #include "../Configuration.hpp"
 #include "../Constants.hpp"
 #include "../ReturnCodes.hpp"
 #include "../scan-tool/Version.hpp"
+#include "CacheImport.hpp"
 #include "CacheIteration.hpp"
 #include "CacheOperation.hpp"
+#include "IterationOperationExport.hpp"
 #include "IterationOperationStatistics.hpp"
 #include "IterationOperationUpdate.hpp"
 
@@ -54,10 +61,32 @@ void showHelp()
             << "                     cache files can be used by the current version of the\n"
             << "                     program.\n"
             << "                     The program exits after the transition.\n"
+            << "  --relayout LxW   - moves all cached reports into a directory layout with L\n"
+            << "                     levels of subdirectories, where each directory name has\n"
+            << "                     W characters. The default layout is 1x2, i.e. one level\n"
+            << "                     with 256 subdirectories. Larger caches may benefit from\n"
+            << "                     layouts like 2x2. The program exits after the operation.\n"
             << "  --statistics     - show some statistics about the request cache.\n"
+            << "  --export FILE    - writes all cached reports into the bundle file FILE,\n"
+            << "                     one JSON report per line. If the file name ends with\n"
+            << "                     \".gz\", the bundle will be compressed with gzip.\n"
+            << "  --import FILE    - imports all reports from the bundle file FILE into the\n"
+            << "                     cache. The bundle may be compressed with gzip and can\n"
+            << "                     also be a dump of reports from other sources, as long as\n"
+            << "                     it contains one JSON report per line. Cached reports are\n"
+            << "                     only replaced by newer reports.\n"
+            << "  --merge DIR      - merges all reports from the request cache in directory\n"
+            << "                     DIR, e.g. the cache of another node, into the cache.\n"
+            << "                     Cached reports are only replaced by newer reports.\n"
             << "  --update | -u    - updates old cached reports by retrieving the current\n"
-            << "                     report or initiating a rescan. This operation requires an\n"
+            << "                     report or initiating a rescan. Reports of scans that\n"
+            << "                     scan-tool submitted, but did not retrieve, are added to\n"
+            << "                     the cache, too. This operation requires an\n"
             << "                     VirusTotal API key. (Use --apikey parameter.)\n"
+            << "  --shard I/N      - restricts --statistics, --export and --update to the\n"
+            << "                     I-th of N slices of the cached reports, so that N nodes\n"
+            << "                     with their own API keys can update the cache together.\n"
+            << "                     Reports are assigned like with --shard in scan-tool.\n"
             << "  --apikey KEY     - sets the API key for VirusTotal\n"
             << "  --keyfile FILE   - read the API key for VirusTotal from the file FILE.\n"
             << "                     This way the API key will not appear in the process list\n"
@@ -68,6 +97,18 @@ void showHelp()
             << "                     reports are older than N days will be updated during the\n"
             << "                     update operation (see --update).\n"
             << "                     Default value is " << cDefaultMaxAge << " days.\n"
+            << "  --max-age-clean N\n"
+            << "                   - sets the maximum age for clean reports, i.e. reports\n"
+            << "                     without positives from at least "
+            << scantool::virustotal::FreshnessPolicy::cMinimumEnginesForClean << " engines, to N days.\n"
+            << "                     Default is the value of --max-age.\n"
+            << "  --max-age-maybe N\n"
+            << "                   - sets the maximum age for reports with at least one\n"
+            << "                     positive, but not more than the limit set by --maybe, to\n"
+            << "                     N days. Default is the value of --max-age.\n"
+            << "  --maybe N        - sets the limit for false positives to N. N must be an\n"
+            << "                     unsigned integer value. Default is 3. Only used for\n"
+            << "                     --max-age-maybe.\n"
             << "  --silent         - produce less text on the standard output\n"
             << "  --cache-dir DIR  - uses DIR as cache directory. If no cache directory is\n"
             << "                     specified, the program will try to use a preset directory\n"
@@ -89,8 +130,23 @@ int main(int argc, char ** argv)
   bool silent = false;
   // maximum age of scan reports in days where no update is required
   int maxAgeInDays = 0;
+  // maximum age of clean reports in days, zero means general maximum age
+  int maxAgeClean = 0;
+  // maximum age of "maybe infected" reports in days, zero means general maximum age
+  int maxAgeMaybe = 0;
+  // limit for "maybe infected"; higher count means infected
+  int maybeLimit = 0;
   // custom cache directory path
   std::string requestCacheDirVT = "";
+  // new directory layout for relayout operation
+  scantool::virustotal::CacheLayout newLayout;
+  // bundle file for export or import operation
+  std::string bundleFile = "";
+  // other cache directory for merge operation
+  std::string mergeDir = "";
+  // slice of the cached reports for iterating operations
+  scantool::hash::Shard shard;
+  bool shardSet = false;
 
   if ((argc > 1) && (argv != nullptr))
   {
@@ -180,6 +236,110 @@ int main(int argc, char ** argv)
           scantool::virustotal::CacheManagerV2 cacheMgr;
           return cacheMgr.performTransition();
         }
+        // change of the cache's directory layout
+        else if (param == "--relayout")
+        {
+          if (op != scantool::virustotal::CacheOperation::None)
+          {
+            std::cerr << "Error: Operation must not be specified more than once!" << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+          // enough parameters?
+          if ((i+1 < argc) && (argv[i+1] != nullptr))
+          {
+            const std::string layoutText = std::string(argv[i+1]);
+            if (!scantool::virustotal::CacheLayout::fromString(layoutText, newLayout))
+            {
+              std::cerr << "Error: \"" << layoutText << "\" is not a valid cache "
+                        << "layout! Use LEVELSxWIDTH with 1 to 4 levels and a "
+                        << "width of 1 to 3 characters, e.g. 2x2." << std::endl;
+              return scantool::rcInvalidParameter;
+            }
+            // operation: change layout
+            op = scantool::virustotal::CacheOperation::Relayout;
+            ++i; // Skip next parameter, because it's used as layout already.
+          }
+          else
+          {
+            std::cerr << "Error: You have to enter a layout like 2x2 after \""
+                      << param << "\"." << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+        }
+        // export or import of a bundle
+        else if ((param == "--export") || (param == "--import"))
+        {
+          if (op != scantool::virustotal::CacheOperation::None)
+          {
+            std::cerr << "Error: Operation must not be specified more than once!" << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+          // enough parameters?
+          if ((i+1 < argc) && (argv[i+1] != nullptr))
+          {
+            bundleFile = std::string(argv[i+1]);
+            op = (param == "--export") ? scantool::virustotal::CacheOperation::Export
+                                       : scantool::virustotal::CacheOperation::Import;
+            ++i; // Skip next parameter, because it's used as file name already.
+          }
+          else
+          {
+            std::cerr << "Error: You have to enter a file name after \""
+                      << param << "\"." << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+        }
+        // merge of another cache
+        else if (param == "--merge")
+        {
+          if (op != scantool::virustotal::CacheOperation::None)
+          {
+            std::cerr << "Error: Operation must not be specified more than once!" << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+          // enough parameters?
+          if ((i+1 < argc) && (argv[i+1] != nullptr))
+          {
+            mergeDir = libstriezel::filesystem::unslashify(std::string(argv[i+1]));
+            op = scantool::virustotal::CacheOperation::Merge;
+            ++i; // Skip next parameter, because it's used as directory already.
+          }
+          else
+          {
+            std::cerr << "Error: You have to enter a directory path after \""
+                      << param << "\"." << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+        }
+        // slice of the cached reports
+        else if (param == "--shard")
+        {
+          if (shardSet)
+          {
+            std::cerr << "Error: Parameter " << param << " must not occur more than once!"
+                      << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+          // enough parameters?
+          if ((i+1 < argc) && (argv[i+1] != nullptr))
+          {
+            const std::string shardText = std::string(argv[i+1]);
+            if (!scantool::hash::Shard::fromString(shardText, shard))
+            {
+              std::cerr << "Error: \"" << shardText << "\" is not a valid shard! "
+                        << "Use I/N with 1 <= I <= N, e.g. 2/4." << std::endl;
+              return scantool::rcInvalidParameter;
+            }
+            shardSet = true;
+            ++i; // Skip next parameter, because it's used as shard already.
+          }
+          else
+          {
+            std::cerr << "Error: You have to enter a shard like 2/4 after \""
+                      << param << "\"." << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+        }
         // API key
         else if ((param == "--key") || (param == "--apikey"))
         {
@@ -255,10 +415,41 @@ int main(int argc, char ** argv)
             return scantool::rcInvalidParameter;
           }
         } // API key from file
+        else if ((param == "--maybe") || (param == "--limit"))
+        {
+          // enough parameters?
+          if ((i+1 < argc) && (argv[i+1] != nullptr))
+          {
+            const std::string integer = std::string(argv[i+1]);
+            int limit = -1;
+            if (!stringToInt(integer, limit))
+            {
+              std::cerr << "Error: \"" << integer << "\" is not an integer!" << std::endl;
+              return scantool::rcInvalidParameter;
+            }
+            if (limit < 0)
+            {
+              std::cerr << "Error: " << limit << " is negative, but only"
+                        << " non-negative values are allowed here." << std::endl;
+              return scantool::rcInvalidParameter;
+            }
+            maybeLimit = limit;
+            ++i; // Skip next parameter, because it's used as limit already.
+          }
+          else
+          {
+            std::cerr << "Error: You have to enter an integer value after \""
+                      << param <<"\"." << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+        } // "maybe" limit
         // age limit for update of reports
-        else if ((param == "--max-age") || (param == "--age-limit"))
+        else if ((param == "--max-age") || (param == "--age-limit")
+                 || (param == "--max-age-clean") || (param == "--max-age-maybe"))
         {
-          if (maxAgeInDays > 0)
+          int& maxAge = (param == "--max-age-clean") ? maxAgeClean
+                      : ((param == "--max-age-maybe") ? maxAgeMaybe : maxAgeInDays);
+          if (maxAge > 0)
           {
             std::cerr << "Error: Report age has been specified multiple times." << std::endl;
             return scantool::rcInvalidParameter;
@@ -286,7 +477,7 @@ int main(int argc, char ** argv)
               limit = 36500;
             }
             // Assign the parameter value.
-            maxAgeInDays = limit;
+            maxAge = limit;
             ++i; // Skip next parameter, because it's used as limit already.
           }
           else
@@ -342,6 +533,14 @@ int main(int argc, char ** argv)
     std::cerr << "Error: No operation parameter was specified!" << std::endl;
     return scantool::rcInvalidParameter;
   }
+  if (shardSet && (op != scantool::virustotal::CacheOperation::Statistics)
+      && (op != scantool::virustotal::CacheOperation::Export)
+      && (op != scantool::virustotal::CacheOperation::Update))
+  {
+    std::cerr << "Error: --shard can only be used with --statistics, --export "
+              << "and --update." << std::endl;
+    return scantool::rcInvalidParameter;
+  }
 
   // existence check
   if (op == scantool::virustotal::CacheOperation::ExistenceCheck)
@@ -377,6 +576,126 @@ int main(int argc, char ** argv)
     return 0;
   } // if integrity check
 
+  // change of directory layout
+  if (op == scantool::virustotal::CacheOperation::Relayout)
+  {
+    scantool::virustotal::CacheManagerV2 cacheMgr(requestCacheDirVT);
+    if (!libstriezel::filesystem::directory::exists(cacheMgr.getCacheDirectory()))
+    {
+      std::cerr << "Error: The cache directory " << cacheMgr.getCacheDirectory()
+                << " does not exist!" << std::endl;
+      return scantool::rcCacheDirectoryMissing;
+    }
+    return cacheMgr.changeLayout(newLayout);
+  } // if relayout
+
+  // export into bundle
+  if (op == scantool::virustotal::CacheOperation::Export)
+  {
+    scantool::virustotal::CacheManagerV2 cacheMgr(requestCacheDirVT);
+    if (!libstriezel::filesystem::directory::exists(cacheMgr.getCacheDirectory()))
+    {
+      std::cerr << "Error: The cache directory " << cacheMgr.getCacheDirectory()
+                << " does not exist!" << std::endl;
+      return scantool::rcCacheDirectoryMissing;
+    }
+    // Mode "T" writes without compression.
+    const bool compress = stringEndsWith(bundleFile, ".gz");
+    gzFile bundle = gzopen(bundleFile.c_str(), compress ? "wb" : "wbT");
+    if (bundle == nullptr)
+    {
+      std::cerr << "Error: Could not create bundle file " << bundleFile << "!"
+                << std::endl;
+      return scantool::rcFileError;
+    }
+    gzbuffer(bundle, 256 * 1024);
+    scantool::virustotal::CacheIteration ci;
+    ci.setShard(shard);
+    scantool::virustotal::IterationOperationExport opExport(bundle);
+    std::cout << "Exporting cached reports, this may take a while ..." << std::endl;
+    const bool iterated = ci.iterate(cacheMgr.getCacheDirectory(), opExport);
+    const bool closed = (gzclose(bundle) == Z_OK);
+    if (!iterated)
+    {
+      std::cerr << "Error: Could not iterate over the cache!" << std::endl;
+      return scantool::rcIterationError;
+    }
+    if (opExport.writeError() || !closed)
+    {
+      std::cerr << "Error: Could not write to bundle file " << bundleFile << "!"
+                << std::endl;
+      return scantool::rcFileError;
+    }
+    std::cout << "Exported reports: " << opExport.exported() << std::endl
+              << "Skipped files: " << opExport.skipped() << std::endl;
+    return 0;
+  } // if export
+
+  // import from bundle
+  if (op == scantool::virustotal::CacheOperation::Import)
+  {
+    scantool::virustotal::CacheManagerV2 cacheMgr(requestCacheDirVT);
+    if (!cacheMgr.createCacheDirectory())
+    {
+      std::cerr << "Error: The cache directory " << cacheMgr.getCacheDirectory()
+                << " could not be created!" << std::endl;
+      return scantool::rcFileError;
+    }
+    scantool::virustotal::CacheImport importer(cacheMgr.getCacheDirectory());
+    std::cout << "Importing reports, this may take a while ..." << std::endl;
+    const bool success = importer.importBundle(bundleFile);
+    std::cout << "Imported reports: " << importer.imported() << std::endl
+              << "Reports not newer than cached reports: " << importer.kept() << std::endl
+              << "Rejected lines: " << importer.rejected() << std::endl;
+    if (importer.failed() > 0)
+    {
+      std::cerr << "Error: " << importer.failed() << " report(s) could not be "
+                << "written to the cache!" << std::endl;
+      return scantool::rcFileError;
+    }
+    return success ? 0 : scantool::rcFileError;
+  } // if import
+
+  // merge with another cache
+  if (op == scantool::virustotal::CacheOperation::Merge)
+  {
+    scantool::virustotal::CacheManagerV2 cacheMgr(requestCacheDirVT);
+    if (!libstriezel::filesystem::directory::exists(mergeDir))
+    {
+      std::cerr << "Error: The directory " << mergeDir << " does not exist!" << std::endl;
+      return scantool::rcCacheDirectoryMissing;
+    }
+    if (!cacheMgr.createCacheDirectory())
+    {
+      std::cerr << "Error: The cache directory " << cacheMgr.getCacheDirectory()
+                << " could not be created!" << std::endl;
+      return scantool::rcFileError;
+    }
+    if (libstriezel::filesystem::unslashify(cacheMgr.getCacheDirectory()) == mergeDir)
+    {
+      std::cerr << "Error: A cache cannot be merged with itself!" << std::endl;
+      return scantool::rcInvalidParameter;
+    }
+    scantool::virustotal::CacheImport importer(cacheMgr.getCacheDirectory());
+    std::cout << "Merging reports, this may take a while ..." << std::endl;
+    if (!importer.importCache(mergeDir))
+    {
+      std::cerr << "Error: Could not iterate over the cache in " << mergeDir
+                << "!" << std::endl;
+      return scantool::rcIterationError;
+    }
+    std::cout << "Merged reports: " << importer.imported() << std::endl
+              << "Reports not newer than cached reports: " << importer.kept() << std::endl
+              << "Rejected files: " << importer.rejected() << std::endl;
+    if (importer.failed() > 0)
+    {
+      std::cerr << "Error: " << importer.failed() << " report(s) could not be "
+                << "written to the cache!" << std::endl;
+      return scantool::rcFileError;
+    }
+    return 0;
+  } // if merge
+
   // statistics
   if (op == scantool::virustotal::CacheOperation::Statistics)
   {
@@ -392,6 +711,7 @@ int main(int argc, char ** argv)
 
     scantool::virustotal::CacheManagerV2 cacheMgr(requestCacheDirVT);
     scantool::virustotal::CacheIteration ci;
+    ci.setShard(shard);
     scantool::virustotal::IterationOperationStatistics opStats(ageLimit);
     std::cout << "Collecting information, this may take a while ..." << std::endl;
     if (!ci.iterate(cacheMgr.getCacheDirectory(), opStats))
@@ -399,11 +719,19 @@ int main(int argc, char ** argv)
       std::cout << "Error: Could not collect cache information!" << std::endl;
       return scantool::rcIterationError;
     }
+    // scans that were submitted by scan-tool, but not retrieved yet
+    scantool::virustotal::PendingScans pendingScans(
+        scantool::virustotal::PendingScans::defaultFileName(cacheMgr.getCacheDirectory()));
+    if (!pendingScans.load())
+      std::cerr << "Warning: Could not read file of pending scans "
+                << pendingScans.fileName() << "." << std::endl;
     std::cout << std::endl << "Cache statistics:" << std::endl
+              << "Directory layout: " << cacheMgr.getLayout().toString() << std::endl
               << "Total number of files: " << opStats.total() << std::endl
               << "Files that failed to parse: " << opStats.unparsable() << std::endl
               << "Files not found by VirusTotal: " << opStats.unknown() << std::endl
               << "Old reports (>" << maxAgeInDays << " days): " << opStats.oldReports() << std::endl
+              << "Pending scans: " << pendingScans.size() << std::endl
               << "Oldest cached scan's date: ";
     if (opStats.oldest() != static_cast<std::time_t>(-1))
     {
@@ -450,11 +778,26 @@ int main(int argc, char ** argv)
                   << " days." << std::endl;
     }
 
-    const auto ageLimit = std::chrono::system_clock::now() - std::chrono::hours(24*maxAgeInDays);
+    // set "false positive" limit, if it was not set
+    if (maybeLimit <= 0)
+      maybeLimit = 3;
+    // age limits that depend on the verdict of the report
+    scantool::virustotal::FreshnessPolicy freshness(maxAgeInDays, maybeLimit);
+    freshness.setMaxAgeClean(maxAgeClean);
+    freshness.setMaxAgeMaybe(maxAgeMaybe);
 
     scantool::virustotal::CacheIteration ci;
+    ci.setShard(shard);
     scantool::virustotal::CacheManagerV2 cacheMgr(requestCacheDirVT);
-    scantool::virustotal::IterationOperationUpdate opUpdate(key, silent, ageLimit, cacheMgr.getCacheDirectory());
+    scantool::virustotal::IterationOperationUpdate opUpdate(key, silent, freshness, cacheMgr.getCacheDirectory());
+    // Other processes with the same API key share its rate limit.
+    scantool::virustotal::QuotaLease quotaLease(scantool::virustotal::QuotaLease::defaultFileName(key),
+        opUpdate.scanner().timeBetweenConsecutiveHashLookups());
+    if (quotaLease.open())
+      opUpdate.scanner().setQuotaLease(&quotaLease);
+    else
+      std::cerr << "Warning: Could not open quota lease file " << quotaLease.fileName()
+                << ", the rate limit is not shared with other processes." << std::endl;
     std::cout << "Updating cache information, this may take a while ..." << std::endl;
     if (!ci.iterate(cacheMgr.getCacheDirectory(), opUpdate))
     {
@@ -482,7 +825,7 @@ int main(int argc, char ** argv)
         {
           if (dummy.hasTime_t())
           {
-            if (std::chrono::system_clock::from_time_t(dummy.scan_date_t) > ageLimit)
+            if (!freshness.isOutdated(dummy))
               std::cout << "Cached file for resource " << resID
                         << " was updated after rescan." << std::endl;
             else
@@ -494,6 +837,63 @@ int main(int argc, char ** argv)
       } // for (range-based)
     } // if pending rescans exist
 
+    // resolve scans that were submitted by scan-tool, but not retrieved yet
+    scantool::virustotal::PendingScans pendingScans(
+        scantool::virustotal::PendingScans::defaultFileName(cacheMgr.getCacheDirectory()));
+    if (!pendingScans.load())
+    {
+      std::cerr << "Warning: Could not read file of pending scans "
+                << pendingScans.fileName() << "." << std::endl;
+    }
+    else if (!pendingScans.empty())
+    {
+      std::vector<std::string> scanIds;
+      for (const auto& [scan_id, entry] : pendingScans.entries())
+      {
+        // Files of the same scan are next to each other and need one request.
+        if (shard.containsDigest(entry.sha256)
+            && (scanIds.empty() || (scanIds.back() != scan_id)))
+          scanIds.push_back(scan_id);
+      }
+      if (!silent && !scanIds.empty())
+        std::cout << "Info: Checking " << scanIds.size()
+                  << " pending scan(s)..." << std::endl;
+      scantool::virustotal::ScannerV2& scanVT = opUpdate.scanner();
+      for (const auto& scan_id : scanIds)
+      {
+        const std::string name = pendingScans.entries().find(scan_id)->second.name;
+        // Finished reports are cached under the hash of the file.
+        scantool::virustotal::ReportV2 report;
+        if (!scanVT.getReport(scan_id, report, false, cacheMgr.getCacheDirectory()))
+        {
+          std::cout << "Info: Not all pending scans were checked!" << std::endl;
+          break;
+        }
+        if (report.successfulRetrieval())
+        {
+          pendingScans.resolve(scan_id);
+          if (!silent)
+            std::cout << "Report for " << name << " (scan ID " << scan_id
+                      << ") was added to the cache." << std::endl;
+        }
+        else if (report.notFound())
+        {
+          pendingScans.resolve(scan_id);
+          if (!silent)
+            std::cout << "Scan ID " << scan_id << " of " << name
+                      << " is unknown to VirusTotal and was removed." << std::endl;
+        }
+        else if (!silent)
+        {
+          std::cout << "Scan of " << name << " (scan ID " << scan_id
+                    << ") is still pending." << std::endl;
+        }
+      } // for (range-based)
+      if (!pendingScans.compact())
+        std::cerr << "Warning: Could not update file of pending scans "
+                  << pendingScans.fileName() << "." << std::endl;
+    } // if pending scans exist
+
     // done
     if (!silent)
       std::cout << "Cache update is complete." << std::endl;
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2015, 2016, 2019, 2021  Dirk Stolle
+    Copyright (C) 2015, 2016, 2019, 2021, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -32,11 +32,12 @@
 #endif
 #include "summary.hpp"
 #include "../Curly.hpp"
+#include "../hash/Manifest.hpp"
+#include "../hash/Sha256.hpp"
 #include "../metascan/Definitions.hpp"
 #include "../metascan/Scanner.hpp"
 #include "../../libstriezel/common/StringUtils.hpp"
 #include "../../libstriezel/filesystem/file.hpp"
-#include "../../libstriezel/hash/sha256/FileSourceUtility.hpp"
 #include "../../libstriezel/hash/sha256/sha256.hpp"
 #include "../ReturnCodes.hpp"
 
@@ -55,6 +56,12 @@ void showHelp()
             << "  --list FILE      - read the files which shall be scanned from the file FILE,\n"
             << "                     one per line.\n"
             << "  --files FILE     - same as --list FILE\n"
+            << "  --manifest FILE  - scan the files listed in the manifest FILE, which has\n"
+            << "                     the format of sha256sum, i.e. lines with the SHA-256\n"
+            << "                     hash, two spaces and the file name. The listed hashes\n"
+            << "                     are used instead of reading the files, so files are\n"
+            << "                     only read, if they have to be uploaded. Use - as FILE\n"
+            << "                     to read the manifest from standard input.\n"
             << "  --certfile FILE  - use the certificates in FILE to verify peers with.\n"
             << "  --burst          - enable burst mode, i.e. disregard any rate limits and\n"
             << "                     just send one request after the other until the rate\n"
@@ -170,6 +177,8 @@ int main(int argc, char ** argv)
   std::string certificateFile = "";
   // files that will be checked
   std::set<std::string> files_scan = std::set<std::string>();
+  // hashes of files from manifests; key = file name, value = SHA256 hash
+  std::map<std::string, SHA256::MessageDigest> manifestDigests;
 
   if ((argc > 1) && (argv != nullptr))
   {
@@ -287,6 +296,40 @@ int main(int argc, char ** argv)
             return scantool::rcInvalidParameter;
           }
         }
+        else if (param == "--manifest")
+        {
+          // enough parameters?
+          if ((i+1 < argc) && (argv[i+1] != nullptr))
+          {
+            const std::string manifestFile = std::string(argv[i+1]);
+            ++i; // Skip next parameter, because it's used as manifest already.
+            bool manifestRead = false;
+            if (manifestFile == "-")
+            {
+              manifestRead = scantool::hash::readManifest(std::cin, "from standard input", manifestDigests);
+            }
+            else
+            {
+              std::ifstream inFile;
+              inFile.open(manifestFile, std::ios_base::in | std::ios_base::binary);
+              if (!inFile.good() || !inFile.is_open())
+              {
+                std::cerr << "Error: Could not open manifest " << manifestFile
+                          << "!" << std::endl;
+                return scantool::rcFileError;
+              }
+              manifestRead = scantool::hash::readManifest(inFile, manifestFile, manifestDigests);
+            }
+            if (!manifestRead)
+              return scantool::rcFileError;
+          } // if
+          else
+          {
+            std::cerr << "Error: You have to enter a file name after \""
+                      << param << "\"." << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+        } // manifest with hashes
         // certificate file
         else if ((param == "--certfile") || (param == "--certs") || (param == "--cacert"))
         {
@@ -349,6 +392,13 @@ int main(int argc, char ** argv)
               << "Use --apikey to specify the Metadefender Cloud API key." << std::endl;
     return scantool::rcInvalidParameter;
   }
+  // Files from manifests are not checked for existence, they are only read,
+  // if they have to be uploaded.
+  for (const auto& [fileName, digest] : manifestDigests)
+  {
+    files_scan.insert(fileName);
+  }
+
   if (files_scan.empty())
   {
     std::cout << "No file scans requested, stopping here." << std::endl;
@@ -416,7 +466,9 @@ int main(int argc, char ** argv)
   // iterate over all files for scan requests
   for(const std::string& i : files_scan)
   {
-    const SHA256::MessageDigest fileHash = SHA256::computeFromFile(i);
+    const auto listed = manifestDigests.find(i);
+    const SHA256::MessageDigest fileHash = (listed != manifestDigests.end())
+        ? listed->second : scantool::hash::computeFromFile(i);
     if (fileHash.isNull())
     {
       std::cerr << "Error: Could not determine SHA256 hash of " << i
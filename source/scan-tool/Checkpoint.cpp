@@ -0,0 +1,230 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "Checkpoint.hpp"
+#include <cstdlib>
+#include <ctime>
+#include <sstream>
+#include "../../libstriezel/filesystem/file.hpp"
+#include "summary.hpp"
+
+namespace scantool::virustotal
+{
+
+/// number of blocks after which the state file is rewritten
+const uint64_t cMaximumBlocks = 100;
+
+const std::chrono::seconds Checkpoint::cDefaultInterval = std::chrono::seconds(60);
+
+Checkpoint::Checkpoint(const std::string& fileName, const std::chrono::seconds interval)
+: m_File(fileName),
+  m_CompletedFile(completedFileName(fileName)),
+  m_Interval(interval),
+  m_Completed(scantool::filesystem::PathSet()),
+  m_Pending(std::string()),
+  m_Replace(true),
+  m_LastSave(std::chrono::steady_clock::now()),
+  // The first checkpoint replaces an existing state file of another run.
+  m_Blocks(cMaximumBlocks)
+{
+}
+
+const std::string& Checkpoint::fileName() const noexcept
+{
+  return m_File.fileName();
+}
+
+std::string Checkpoint::completedFileName(const std::string& stateFile)
+{
+  return stateFile + ".done";
+}
+
+bool Checkpoint::load(std::map<std::string, std::string>& mapFileToHash,
+                      std::map<std::string, ScannerV2::Report>& mapHashToReport,
+                      QueuedScanMap& queued_scans,
+                      std::vector<std::pair<std::string, int64_t> >& largeFiles)
+{
+  /* file format: blocks of
+     begin time count
+     lines of the summary
+     end
+     where count is the number of completed files at the time of the block.
+     Each block contains the complete summary, so only the last one counts. */
+  bool inBlock = false;
+  uint64_t blockCount = 0;
+  uint64_t count = 0;
+  std::string blockSummary;
+  std::string summary;
+  const bool read = m_File.read([&](const std::string& text)
+  {
+    const std::string line = (!text.empty() && (text.back() == '\r'))
+        ? text.substr(0, text.size() - 1) : text;
+    if (line.compare(0, 6, "begin ") == 0)
+    {
+      // An incomplete block before is dropped.
+      inBlock = true;
+      const auto space = line.find(' ', 6);
+      blockCount = (space == std::string::npos)
+          ? 0 : std::strtoull(line.c_str() + space + 1, nullptr, 10);
+      blockSummary.clear();
+    }
+    else if (!inBlock)
+    {
+      return;
+    }
+    else if (line == "end")
+    {
+      count = blockCount;
+      summary = std::move(blockSummary);
+      inBlock = false;
+    }
+    else
+    {
+      blockSummary.append(line).append("\n");
+    }
+  });
+  if (!read)
+    return false;
+
+  std::istringstream stream(summary);
+  if (!parseSummary(stream, mapFileToHash, mapHashToReport, queued_scans, largeFiles))
+    return false;
+
+  /* file format of completed files:
+     done path (one line per completed file) */
+  uint64_t names = 0;
+  const bool readCompleted = m_CompletedFile.read([&](const std::string& line)
+  {
+    if (line.compare(0, 5, "done ") != 0)
+      return;
+    // Files after the last complete block have no summary, so they are not completed.
+    if (names < count)
+    {
+      const bool hasCarriageReturn = !line.empty() && (line.back() == '\r');
+      m_Completed.insert(line.substr(5, line.size() - 5 - (hasCarriageReturn ? 1 : 0)));
+    }
+    ++names;
+  });
+  if (!readCompleted)
+    return false;
+  if ((names > count) && !truncateCompleted(count))
+    return false;
+  m_Replace = false;
+  // Old blocks and incomplete writes are removed by the next checkpoint.
+  m_Blocks = cMaximumBlocks;
+  return true;
+}
+
+bool Checkpoint::completed(const std::string& fileName) const
+{
+  return m_Completed.contains(fileName);
+}
+
+void Checkpoint::markCompleted(const std::string& fileName)
+{
+  // Line breaks would end the line early and cannot be read back.
+  if (fileName.find_first_of("\r\n") != std::string::npos)
+    return;
+  if (m_Completed.insert(fileName))
+    m_Pending.append("done ").append(fileName).append("\n");
+}
+
+std::size_t Checkpoint::completedCount() const noexcept
+{
+  return m_Completed.size();
+}
+
+bool Checkpoint::due() const
+{
+  return std::chrono::steady_clock::now() - m_LastSave >= m_Interval;
+}
+
+bool Checkpoint::save(const std::map<std::string, std::string>& mapFileToHash,
+                      const std::map<std::string, ScannerV2::Report>& mapHashToReport,
+                      const QueuedScanMap& queued_scans,
+                      const std::vector<std::pair<std::string, int64_t> >& largeFiles)
+{
+  const std::string summary = formatSummary(mapFileToHash, mapHashToReport, queued_scans, largeFiles);
+  m_LastSave = std::chrono::steady_clock::now();
+  // The names go first, so that a block never counts names which are missing.
+  if (!writeCompleted())
+    return false;
+
+  const std::string block = "begin " + std::to_string(std::time(nullptr)) + " "
+                          + std::to_string(m_CompletedFile.lines()) + "\n"
+                          + summary + "end\n";
+  if (m_Blocks >= cMaximumBlocks)
+    return rewrite(block);
+  if (!m_File.append(block))
+    return false;
+  ++m_Blocks;
+  return true;
+}
+
+bool Checkpoint::writeCompleted()
+{
+  if (m_Replace)
+  {
+    if (!m_CompletedFile.rewrite(m_Pending))
+      return false;
+    m_Replace = false;
+  }
+  else if (!m_Pending.empty() && !m_CompletedFile.append(m_Pending))
+  {
+    return false;
+  }
+  m_Pending.clear();
+  return true;
+}
+
+bool Checkpoint::truncateCompleted(const uint64_t count)
+{
+  std::string content;
+  uint64_t names = 0;
+  const bool read = m_CompletedFile.read([&](const std::string& line)
+  {
+    if ((names < count) && (line.compare(0, 5, "done ") == 0))
+    {
+      content.append(line).append("\n");
+      ++names;
+    }
+  });
+  return read && m_CompletedFile.rewrite(content);
+}
+
+bool Checkpoint::rewrite(const std::string& block)
+{
+  if (!m_File.rewrite(block))
+    return false;
+  m_Blocks = 1;
+  return true;
+}
+
+bool Checkpoint::remove()
+{
+  const std::string completedFile = m_CompletedFile.fileName();
+  const bool removedCompleted = !libstriezel::filesystem::file::exists(completedFile)
+      || libstriezel::filesystem::file::remove(completedFile);
+  return removedCompleted
+      && (!libstriezel::filesystem::file::exists(m_File.fileName())
+          || libstriezel::filesystem::file::remove(m_File.fileName()));
+}
+
+} // namespace
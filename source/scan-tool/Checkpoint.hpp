@@ -0,0 +1,190 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_VT_CHECKPOINT_HPP
+#define SCANTOOL_VT_CHECKPOINT_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../filesystem/AppendOnlyFile.hpp"
+#include "../filesystem/PathSet.hpp"
+#include "../virustotal/ScannerV2.hpp"
+#include "QueuedScan.hpp"
+
+namespace scantool::virustotal
+{
+
+/** \brief State of a scan run that allows to resume it after interruption.
+ *
+ * The state file keeps the infected files, the queued scans and the files
+ * that were too large. Each checkpoint appends a block with the current
+ * summary to the state file. Blocks are only used, if they were written
+ * completely, so an interrupted write just loses the last checkpoint.
+ *
+ * The names of completed files go to a second file next to the state file,
+ * which only grows, so that rewriting the state file does not write all of
+ * them again. Each block notes how many of these names it covers.
+ */
+class Checkpoint
+{
+  public:
+    /** default time between two periodic checkpoints */
+    static const std::chrono::seconds cDefaultInterval;
+
+
+    /** \brief Constructor.
+     *
+     * \param fileName  path of the state file
+     * \param interval  time between two periodic checkpoints
+     */
+    explicit Checkpoint(const std::string& fileName, const std::chrono::seconds interval = cDefaultInterval);
+
+
+    /** \brief Gets the path of the state file.
+     *
+     * \return Returns the path of the state file.
+     */
+    const std::string& fileName() const noexcept;
+
+
+    /** \brief Gets the path of the file with the names of completed files.
+     *
+     * \param stateFile  path of the state file
+     * \return Returns the path of the file with the completed files.
+     */
+    static std::string completedFileName(const std::string& stateFile);
+
+
+    /** \brief Loads the state of an earlier run.
+     *
+     * \param mapFileToHash    map that maps filename to hash; key = file name, value = SHA256 hash
+     * \param mapHashToReport  map that maps SHA256 hashes to corresponding report; key = SHA256 hash, value = scan report
+     * \param queued_scans     list of queued scan requests; key = scan_id, value = queued scan record
+     * \param largeFiles       list of files that exceed the file size for scans; first = file name, second = file size in octets
+     * \return Returns true, if the state was loaded. Returns false, if the
+     *         state file could not be read.
+     * \remarks The next checkpoint rewrites the state file, so that blocks
+     *          of older checkpoints are removed. Completed files that were
+     *          written after the last complete block are dropped.
+     */
+    bool load(std::map<std::string, std::string>& mapFileToHash,
+              std::map<std::string, ScannerV2::Report>& mapHashToReport,
+              QueuedScanMap& queued_scans,
+              std::vector<std::pair<std::string, int64_t> >& largeFiles);
+
+
+    /** \brief Checks whether a file was completed already.
+     *
+     * \param fileName  name of the file
+     * \return Returns true, if the file was completed.
+     */
+    bool completed(const std::string& fileName) const;
+
+
+    /** \brief Marks a file as completed.
+     *
+     * \param fileName  name of the file
+     * \remarks The file is written to the state file by the next checkpoint.
+     *          Names with line breaks are not marked, so such files are
+     *          scanned again after resumption.
+     */
+    void markCompleted(const std::string& fileName);
+
+
+    /** \brief Gets the number of completed files.
+     *
+     * \return Returns the number of completed files.
+     */
+    std::size_t completedCount() const noexcept;
+
+
+    /** \brief Checks whether the next periodic checkpoint is due.
+     *
+     * \return Returns true, if the interval has passed since the last checkpoint.
+     */
+    bool due() const;
+
+
+    /** \brief Writes a checkpoint to the state file.
+     *
+     * The first checkpoint without an earlier load() replaces the state
+     * file and the file of completed files, so that the state of an
+     * unrelated run is not merged.
+     *
+     * \param mapFileToHash    map that maps filename to hash; key = file name, value = SHA256 hash
+     * \param mapHashToReport  map that maps SHA256 hashes to corresponding report; key = SHA256 hash, value = scan report
+     * \param queued_scans     list of queued scan requests; key = scan_id, value = queued scan record
+     * \param largeFiles       list of files that exceed the file size for scans; first = file name, second = file size in octets
+     * \return Returns true, if the checkpoint was written.
+     */
+    bool save(const std::map<std::string, std::string>& mapFileToHash,
+              const std::map<std::string, ScannerV2::Report>& mapHashToReport,
+              const QueuedScanMap& queued_scans,
+              const std::vector<std::pair<std::string, int64_t> >& largeFiles);
+
+
+    /** \brief Removes the state file and the file of completed files, e.g.
+     *         after the run is complete.
+     *
+     * \return Returns true, if both files do not exist anymore.
+     */
+    bool remove();
+  private:
+    /** \brief Writes the names of newly completed files.
+     *
+     * \return Returns true, if the names were written.
+     */
+    bool writeCompleted();
+
+
+    /** \brief Keeps only the given number of names in the file of completed
+     *         files, e.g. after an interrupted checkpoint.
+     *
+     * \param count  number of names to keep
+     * \return Returns true, if the file was shortened.
+     */
+    bool truncateCompleted(const uint64_t count);
+
+
+    /** \brief Rewrites the state file with a single block.
+     *
+     * \param block  the block with the current summary
+     * \return Returns true, if the state file was rewritten.
+     */
+    bool rewrite(const std::string& block);
+
+
+    scantool::filesystem::AppendOnlyFile m_File; /**< the state file */
+    scantool::filesystem::AppendOnlyFile m_CompletedFile; /**< file with the names of completed files */
+    std::chrono::seconds m_Interval; /**< time between two periodic checkpoints */
+    scantool::filesystem::PathSet m_Completed; /**< fingerprints of completed files */
+    std::string m_Pending; /**< lines of completed files that were not written yet */
+    bool m_Replace; /**< whether both files still belong to an unrelated run */
+    std::chrono::steady_clock::time_point m_LastSave; /**< time of the last checkpoint */
+    uint64_t m_Blocks; /**< number of blocks in the state file */
+}; // class
+
+} // namespace
+
+#endif // SCANTOOL_VT_CHECKPOINT_HPP
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2016, 2025  Dirk Stolle
+    Copyright (C) 2016, 2025, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -23,9 +23,10 @@
 
 #include <map>
 #include <set>
-#include <unordered_map>
+#include "../filesystem/FileFormat.hpp"
 #include "../virustotal/CacheManagerV2.hpp"
 #include "../virustotal/ScannerV2.hpp"
+#include "QueuedScan.hpp"
 
 namespace scantool::virustotal
 {
@@ -40,7 +41,18 @@ class Handler
     ///virtual destructor (empty)
     virtual ~Handler() { }
 
+    /** \brief Gets the file format that is handled by this handler.
+     *
+     * \return Returns the format of the files this handler can extract.
+     * \remarks The scan strategy detects the format of a file once and only
+     *          calls the handlers for that format.
+     */
+    virtual scantool::filesystem::FileFormat format() const = 0;
+
+
     /** \brief scan a given file using the implemented handling mechanism
+     *
+     * The scan strategy only calls this for files of the handler's format.
      *
      * \param strategy  reference to the current scan strategy
      * \param scanVT    the scanner that shall be used to scan the file
@@ -54,7 +66,7 @@ class Handler
      * \param ageLimit      time point for rescans (older reports trigger rescans)
      * \param mapHashToReport  maps SHA256 hashes to corresponding report; key = SHA256 hash, value = scan report
      * \param mapFileToHash    maps filename to hash; key = file name, value = SHA256 hash
-     * \param queuedScans      list of queued scan requests; key = scan_id, value = file name
+     * \param queuedScans      list of queued scan requests; key = scan_id, value = queued scan record
      * \param lastQueuedScanTime time point of the last queued scan - will be updated by this method for every scan
      * \param largeFiles       list of files that exceed the file size for scans; first = file name, second = file size in octets
      * \param processedFiles   number of files that have been processed so far
@@ -69,7 +81,7 @@ class Handler
               const std::chrono::time_point<std::chrono::system_clock> ageLimit,
               std::map<std::string, ScannerV2::Report>& mapHashToReport,
               std::map<std::string, std::string>& mapFileToHash,
-              std::unordered_map<std::string, std::string>& queued_scans,
+              QueuedScanMap& queued_scans,
               std::chrono::time_point<std::chrono::steady_clock>& lastQueuedScanTime,
               std::vector<std::pair<std::string, int64_t> >& largeFiles,
               std::set<std::string>::size_type& processedFiles,
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2017, 2025  Dirk Stolle
+    Copyright (C) 2017, 2025, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -27,15 +27,7 @@
 namespace scantool::virustotal
 {
 
-struct SevenZipDetection
-{
-  static bool isArcT(const std::string& fn)
-  {
-    return libstriezel::sevenZip::archive::is7z(fn);
-  }
-}; // struct
-
-typedef HandlerGeneric<libstriezel::sevenZip::archive, SevenZipDetection> Handler7z;
+typedef HandlerGeneric<libstriezel::sevenZip::archive, scantool::filesystem::FileFormat::SevenZip> Handler7z;
 
 } // namespace
 
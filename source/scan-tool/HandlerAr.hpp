@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2016, 2025  Dirk Stolle
+    Copyright (C) 2016, 2025, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -24,18 +24,10 @@
 #include "HandlerGeneric.hpp"
 #include "../../libstriezel/archive/ar/archive.hpp"
 
-struct ArDetection
-{
-  static bool isArcT(const std::string& fn)
-  {
-    return libstriezel::ar::archive::isAr(fn);
-  }
-}; // struct
-
 namespace scantool::virustotal
 {
 
-typedef HandlerGeneric<libstriezel::ar::archive, ArDetection> HandlerAr;
+typedef HandlerGeneric<libstriezel::ar::archive, scantool::filesystem::FileFormat::Ar> HandlerAr;
 
 } // namespace
 
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2016, 2025  Dirk Stolle
+    Copyright (C) 2016, 2025, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -22,7 +22,6 @@
 #define SCANTOOL_VT_HANDLERGENERIC_HPP
 
 #include <functional>
-#include <unordered_map>
 #include "../virustotal/CacheManagerV2.hpp"
 #include "../virustotal/ScannerV2.hpp"
 #include "../ReturnCodes.hpp"
@@ -34,13 +33,20 @@
 namespace scantool::virustotal
 {
 
-template<class ArcT, typename isArc>
+template<class ArcT, scantool::filesystem::FileFormat fmt>
 class HandlerGeneric: public Handler
 {
   public:
     /** constructor */
     HandlerGeneric(const bool ignoreErrors = false);
 
+
+    /** \brief Gets the file format that is handled by this handler.
+     *
+     * \return Returns the format of the files this handler can extract.
+     */
+    virtual scantool::filesystem::FileFormat format() const override;
+
     /** \brief scan a given file using the implemented handling mechanism
      *
      * \param strategy  reference to the current scan strategy
@@ -55,7 +61,7 @@ class HandlerGeneric: public Handler
      * \param ageLimit      time point for rescans (older reports trigger rescans)
      * \param mapHashToReport  maps SHA256 hashes to corresponding report; key = SHA256 hash, value = scan report
      * \param mapFileToHash    maps filename to hash; key = file name, value = SHA256 hash
-     * \param queuedScans      list of queued scan requests; key = scan_id, value = file name
+     * \param queuedScans      list of queued scan requests; key = scan_id, value = queued scan record
      * \param lastQueuedScanTime time point of the last queued scan - will be updated by this method for every scan
      * \param largeFiles       list of files that exceed the file size for scans; first = file name, second = file size in octets
      * \param processedFiles   number of files that have been processed so far
@@ -70,7 +76,7 @@ class HandlerGeneric: public Handler
               const std::chrono::time_point<std::chrono::system_clock> ageLimit,
               std::map<std::string, ScannerV2::Report>& mapHashToReport,
               std::map<std::string, std::string>& mapFileToHash,
-              std::unordered_map<std::string, std::string>& queued_scans,
+              QueuedScanMap& queued_scans,
               std::chrono::time_point<std::chrono::steady_clock>& lastQueuedScanTime,
               std::vector<std::pair<std::string, int64_t> >& largeFiles,
               std::set<std::string>::size_type& processedFiles,
@@ -93,31 +99,33 @@ class HandlerGeneric: public Handler
     bool m_IgnoreExtractionErrors; /**< whether to continue, if extraction fails */
 }; //class
 
-template<class ArcT, typename isArc>
-HandlerGeneric<ArcT, isArc>::HandlerGeneric(const bool ignoreErrors)
+template<class ArcT, scantool::filesystem::FileFormat fmt>
+HandlerGeneric<ArcT, fmt>::HandlerGeneric(const bool ignoreErrors)
 : Handler(),
   m_IgnoreExtractionErrors(ignoreErrors)
 {
 }
 
-template<class ArcT, typename isArc>
-int HandlerGeneric<ArcT, isArc>::handle(scantool::virustotal::ScanStrategy& strategy,
+template<class ArcT, scantool::filesystem::FileFormat fmt>
+scantool::filesystem::FileFormat HandlerGeneric<ArcT, fmt>::format() const
+{
+  return fmt;
+}
+
+template<class ArcT, scantool::filesystem::FileFormat fmt>
+int HandlerGeneric<ArcT, fmt>::handle(scantool::virustotal::ScanStrategy& strategy,
               ScannerV2& scanVT, const std::string& fileName,
               CacheManagerV2& cacheMgr, const std::string& requestCacheDirVT, const bool useRequestCache,
               const bool silent, const int maybeLimit, const int maxAgeInDays,
               const std::chrono::time_point<std::chrono::system_clock> ageLimit,
               std::map<std::string, ScannerV2::Report>& mapHashToReport,
               std::map<std::string, std::string>& mapFileToHash,
-              std::unordered_map<std::string, std::string>& queued_scans,
+              QueuedScanMap& queued_scans,
               std::chrono::time_point<std::chrono::steady_clock>& lastQueuedScanTime,
               std::vector<std::pair<std::string, int64_t> >& largeFiles,
               std::set<std::string>::size_type& processedFiles,
               std::set<std::string>::size_type& totalFiles)
 {
-  //If it is not a matching archive type, then there's nothing to do here.
-  if (!isArc::isArcT(fileName))
-    return 0;
-
   std::string tempDirectory = "";
   //create temp. directory for extraction
   if (!libstriezel::filesystem::directory::createTemp(tempDirectory))
@@ -150,10 +158,12 @@ int HandlerGeneric<ArcT, isArc>::handle(scantool::virustotal::ScanStrategy& stra
           return scantool::rcFileError;
         } //if extraction failed
         //scan file
+        strategy.enterArchiveEntry(fileName, ent.name());
         const int rcStrategy = strategy.scan(scanVT, destFile, cacheMgr, requestCacheDirVT,
         useRequestCache, silent, maybeLimit, maxAgeInDays, ageLimit,
         mapHashToReport, mapFileToHash, queued_scans, lastQueuedScanTime,
         largeFiles, processedFiles, totalFiles);
+        strategy.leaveArchiveEntry();
         //remove file
         libstriezel::filesystem::file::remove(destFile);
         //check return code
@@ -186,14 +196,14 @@ int HandlerGeneric<ArcT, isArc>::handle(scantool::virustotal::ScanStrategy& stra
   return 0;
 }
 
-template<class ArcT, typename isArc>
-bool HandlerGeneric<ArcT, isArc>::ignoreExtractionErrors() const
+template<class ArcT, scantool::filesystem::FileFormat fmt>
+bool HandlerGeneric<ArcT, fmt>::ignoreExtractionErrors() const
 {
   return m_IgnoreExtractionErrors;
 }
 
-template<class ArcT, typename isArc>
-void HandlerGeneric<ArcT, isArc>::ignoreExtractionErrors(const bool ignore)
+template<class ArcT, scantool::filesystem::FileFormat fmt>
+void HandlerGeneric<ArcT, fmt>::ignoreExtractionErrors(const bool ignore)
 {
   m_IgnoreExtractionErrors = ignore;
 }
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2016, 2025  Dirk Stolle
+    Copyright (C) 2016, 2025, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -35,6 +35,11 @@ HandlerGzip::HandlerGzip(const bool ignoreErrors)
 {
 }
 
+scantool::filesystem::FileFormat HandlerGzip::format() const
+{
+  return scantool::filesystem::FileFormat::Gzip;
+}
+
 int HandlerGzip::handle(scantool::virustotal::ScanStrategy& strategy,
               ScannerV2& scanVT, const std::string& fileName,
               CacheManagerV2& cacheMgr, const std::string& requestCacheDirVT, const bool useRequestCache,
@@ -42,16 +47,12 @@ int HandlerGzip::handle(scantool::virustotal::ScanStrategy& strategy,
               const std::chrono::time_point<std::chrono::system_clock> ageLimit,
               std::map<std::string, ScannerV2::Report>& mapHashToReport,
               std::map<std::string, std::string>& mapFileToHash,
-              std::unordered_map<std::string, std::string>& queued_scans,
+              QueuedScanMap& queued_scans,
               std::chrono::time_point<std::chrono::steady_clock>& lastQueuedScanTime,
               std::vector<std::pair<std::string, int64_t> >& largeFiles,
               std::set<std::string>::size_type& processedFiles,
               std::set<std::string>::size_type& totalFiles)
 {
-  //If it is not a gzipped file, then there's nothing to do here.
-  if (!libstriezel::gzip::archive::isGzip(fileName))
-    return 0;
-
   std::string tempDirectory = "";
   //create temp. directory for extraction
   if (!libstriezel::filesystem::directory::createTemp(tempDirectory))
@@ -85,10 +86,12 @@ int HandlerGzip::handle(scantool::virustotal::ScanStrategy& strategy,
         return scantool::rcFileError;
       } //if extraction failed
       //scan file
+      strategy.enterArchiveEntry(fileName, ent.name());
       const int rcStrategy = strategy.scan(scanVT, destFile, cacheMgr, requestCacheDirVT,
       useRequestCache, silent, maybeLimit, maxAgeInDays, ageLimit,
       mapHashToReport, mapFileToHash, queued_scans, lastQueuedScanTime,
       largeFiles, processedFiles, totalFiles);
+      strategy.leaveArchiveEntry();
       //remove file
       libstriezel::filesystem::file::remove(destFile);
       //check return code
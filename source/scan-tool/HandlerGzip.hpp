@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2016, 2025  Dirk Stolle
+    Copyright (C) 2016, 2025, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -21,7 +21,6 @@
 #ifndef SCANTOOL_VT_HANDLERGZIP_HPP
 #define SCANTOOL_VT_HANDLERGZIP_HPP
 
-#include <unordered_map>
 #include "../virustotal/CacheManagerV2.hpp"
 #include "../virustotal/ScannerV2.hpp"
 #include "Handler.hpp"
@@ -36,6 +35,13 @@ class HandlerGzip: public Handler
     HandlerGzip(const bool ignoreErrors = false);
 
 
+    /** \brief Gets the file format that is handled by this handler.
+     *
+     * \return Returns the format of the files this handler can extract.
+     */
+    virtual scantool::filesystem::FileFormat format() const override;
+
+
     /** \brief scan a given file using the implemented handling mechanism
      *
      * \param strategy  reference to the current scan strategy
@@ -50,7 +56,7 @@ class HandlerGzip: public Handler
      * \param ageLimit      time point for rescans (older reports trigger rescans)
      * \param mapHashToReport  maps SHA256 hashes to corresponding report; key = SHA256 hash, value = scan report
      * \param mapFileToHash    maps filename to hash; key = file name, value = SHA256 hash
-     * \param queuedScans      list of queued scan requests; key = scan_id, value = file name
+     * \param queuedScans      list of queued scan requests; key = scan_id, value = queued scan record
      * \param lastQueuedScanTime time point of the last queued scan - will be updated by this method for every scan
      * \param largeFiles       list of files that exceed the file size for scans; first = file name, second = file size in octets
      * \return Returns zero, if the file could be processed properly.
@@ -65,7 +71,7 @@ class HandlerGzip: public Handler
               const std::chrono::time_point<std::chrono::system_clock> ageLimit,
               std::map<std::string, ScannerV2::Report>& mapHashToReport,
               std::map<std::string, std::string>& mapFileToHash,
-              std::unordered_map<std::string, std::string>& queued_scans,
+              QueuedScanMap& queued_scans,
               std::chrono::time_point<std::chrono::steady_clock>& lastQueuedScanTime,
               std::vector<std::pair<std::string, int64_t> >& largeFiles,
               std::set<std::string>::size_type& processedFiles,
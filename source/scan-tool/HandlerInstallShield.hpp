@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2017, 2025  Dirk Stolle
+    Copyright (C) 2017, 2025, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -27,15 +27,7 @@
 namespace scantool::virustotal
 {
 
-struct InstallShieldDetection
-{
-  static bool isArcT(const std::string& fn)
-  {
-    return libstriezel::installshield::archive::isInstallShield(fn);
-  }
-}; // struct
-
-typedef HandlerGeneric<libstriezel::installshield::archive, InstallShieldDetection> HandlerInstallShield;
+typedef HandlerGeneric<libstriezel::installshield::archive, scantool::filesystem::FileFormat::InstallShield> HandlerInstallShield;
 
 } // namespace
 
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2017, 2025  Dirk Stolle
+    Copyright (C) 2017, 2025, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -27,15 +27,7 @@
 namespace scantool::virustotal
 {
 
-struct RarDetection
-{
-  static bool isArcT(const std::string& fn)
-  {
-    return libstriezel::rar::archive::isRar(fn);
-  }
-}; // struct
-
-typedef HandlerGeneric<libstriezel::rar::archive, RarDetection> HandlerRar;
+typedef HandlerGeneric<libstriezel::rar::archive, scantool::filesystem::FileFormat::Rar> HandlerRar;
 
 } // namespace
 
@@ -0,0 +1,146 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "HashBatch.hpp"
+#include <vector>
+#include "../hash/Sha256.hpp"
+#include "../hash/Sha256MultiBuffer.hpp"
+
+namespace scantool::virustotal
+{
+
+const std::size_t HashBatch::cDefaultBatchSize = 256;
+
+HashBatch::HashBatch(const std::set<std::string>& files, const std::size_t batchSize)
+: m_Files(files),
+  m_BatchSize(batchSize > 0 ? batchSize : 1),
+  m_Digests(std::unordered_map<std::string, SHA256::MessageDigest>()),
+  m_Cache(nullptr),
+  m_Known(std::unordered_map<std::string, SHA256::MessageDigest>()),
+  m_Formats(std::unordered_map<std::string, scantool::filesystem::FileFormat>())
+{
+}
+
+void HashBatch::setHashCache(scantool::hash::HashCache* cache) noexcept
+{
+  m_Cache = cache;
+}
+
+void HashBatch::setKnownDigest(const std::string& fileName, const SHA256::MessageDigest& digest)
+{
+  m_Known[fileName] = digest;
+}
+
+SHA256::MessageDigest HashBatch::digest(const std::string& fileName)
+{
+  const auto given = m_Known.find(fileName);
+  if (given != m_Known.end())
+    return given->second;
+
+  auto computed = m_Digests.find(fileName);
+  if (computed == m_Digests.end())
+  {
+    const auto iter = m_Files.find(fileName);
+    if (iter == m_Files.end())
+      return scantool::hash::computeFromFile(fileName);
+    computeBatch(iter);
+    computed = m_Digests.find(fileName);
+    if (computed == m_Digests.end())
+      return SHA256::MessageDigest();
+  }
+  const SHA256::MessageDigest result = computed->second;
+  m_Digests.erase(computed);
+  // The format is not needed anymore after the digest has been requested.
+  m_Formats.erase(fileName);
+  return result;
+}
+
+bool HashBatch::format(const std::string& fileName, scantool::filesystem::FileFormat& format)
+{
+  auto found = m_Formats.find(fileName);
+  if (found == m_Formats.end())
+  {
+    // Only files whose digest is still unknown will be read by a batch.
+    if ((m_Known.find(fileName) != m_Known.end()) || (m_Digests.find(fileName) != m_Digests.end()))
+      return false;
+    const auto iter = m_Files.find(fileName);
+    if (iter == m_Files.end())
+      return false;
+    computeBatch(iter);
+    found = m_Formats.find(fileName);
+    if (found == m_Formats.end())
+      return false;
+  }
+  format = found->second;
+  m_Formats.erase(found);
+  return true;
+}
+
+bool HashBatch::contains(const std::string& fileName) const
+{
+  return m_Files.find(fileName) != m_Files.end();
+}
+
+void HashBatch::computeBatch(std::set<std::string>::const_iterator iter)
+{
+  std::vector<std::string> batch;
+  std::vector<scantool::hash::FileStatus> states;
+  std::vector<bool> hasStatus;
+  while ((iter != m_Files.end()) && (batch.size() < m_BatchSize))
+  {
+    if ((m_Digests.find(*iter) == m_Digests.end()) && (m_Known.find(*iter) == m_Known.end()))
+    {
+      scantool::hash::FileStatus status{};
+      SHA256::MessageDigest cached;
+      const bool statusKnown = (m_Cache != nullptr)
+          && scantool::hash::FileStatus::get(*iter, status);
+      if (statusKnown && m_Cache->lookup(*iter, status, cached))
+      {
+        m_Digests[*iter] = cached;
+      }
+      else
+      {
+        batch.push_back(*iter);
+        states.push_back(status);
+        hasStatus.push_back(statusKnown);
+      }
+    }
+    ++iter;
+  }
+  if (batch.empty())
+    return;
+
+  // The start of each file is at hand anyway, so detect its format, too.
+  const auto sniff = [&](const std::size_t index, const uint8_t* data, const std::size_t length)
+  {
+    m_Formats[batch[index]] = scantool::filesystem::sniffFormat(data, length);
+  };
+  const auto digests = scantool::hash::computeFromFiles(batch, true, sniff);
+  for (std::size_t i = 0; i < batch.size(); ++i)
+  {
+    if (hasStatus[i])
+      m_Cache->store(batch[i], states[i], digests[i]);
+    m_Digests[batch[i]] = digests[i];
+  }
+  if (m_Cache != nullptr)
+    m_Cache->flush();
+}
+
+} // namespace
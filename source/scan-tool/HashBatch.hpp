@@ -0,0 +1,128 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_VT_HASHBATCH_HPP
+#define SCANTOOL_VT_HASHBATCH_HPP
+
+#include <cstddef>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include "../../libstriezel/hash/sha256/sha256.hpp"
+#include "../filesystem/FileFormat.hpp"
+#include "../hash/HashCache.hpp"
+
+namespace scantool::virustotal
+{
+
+/** \brief Computes the SHA-256 digests of the files to scan in batches.
+ *
+ * When the digest of one of the files is requested, the digests of the
+ * following files are computed, too. Small files of a batch are hashed in
+ * lockstep by the multi-buffer kernels, which is faster than hashing one
+ * file after another. The format of each read file is detected from the same
+ * read, so handlers do not have to read the start of the file again.
+ */
+class HashBatch
+{
+  public:
+    /** \brief Constructor.
+     *
+     * \param files      the files that will be scanned, in scan order; the
+     *                   set must outlive this instance
+     * \param batchSize  maximum number of files per batch
+     */
+    explicit HashBatch(const std::set<std::string>& files, const std::size_t batchSize = cDefaultBatchSize);
+
+
+    /// default number of files per batch
+    static const std::size_t cDefaultBatchSize;
+
+
+    /** \brief Gets the digest of a file.
+     *
+     * \param fileName  name of the file
+     * \return Returns the SHA-256 digest of the file.
+     *         Returns a null digest, if the file could not be read.
+     * \remarks Digests of files that are not part of the file set, e.g.
+     *          files extracted from archives, are computed right away.
+     */
+    SHA256::MessageDigest digest(const std::string& fileName);
+
+
+    /** \brief Gets the format of a file that was detected while hashing it.
+     *
+     * \param fileName  name of the file
+     * \param format    variable that receives the format of the file
+     * \return Returns true, if the format of the file is known.
+     *         Returns false, if the file is not read for its digest, e.g.
+     *         because the digest is cached or known in advance, or if the
+     *         file could not be read.
+     * \remarks If the digest of the file is not computed yet, this computes
+     *          the digests of the file's batch.
+     */
+    bool format(const std::string& fileName, scantool::filesystem::FileFormat& format);
+
+
+    /** \brief Checks whether a file is part of the file set of the batch.
+     *
+     * \param fileName  name of the file
+     * \return Returns true, if the batch provides the digest of the file.
+     */
+    bool contains(const std::string& fileName) const;
+
+
+    /** \brief Sets the persistent cache for the digests of the file set.
+     *
+     * \param cache  the hash cache, or nullptr for none; the cache must
+     *               outlive this instance
+     * \remarks Files whose status did not change since their digest was
+     *          cached are not read again. New digests are added to the cache.
+     */
+    void setHashCache(scantool::hash::HashCache* cache) noexcept;
+
+
+    /** \brief Sets the digest of a file that is known in advance, e.g. from
+     *         a manifest.
+     *
+     * \param fileName  name of the file
+     * \param digest    SHA-256 digest of the file
+     * \remarks The file is not read to get its digest.
+     */
+    void setKnownDigest(const std::string& fileName, const SHA256::MessageDigest& digest);
+  private:
+    /** \brief Computes the digests of the batch that starts at a file.
+     *
+     * \param iter  iterator to the first file of the batch in the file set
+     */
+    void computeBatch(std::set<std::string>::const_iterator iter);
+
+
+    const std::set<std::string>& m_Files; /**< files that will be scanned */
+    std::size_t m_BatchSize; /**< maximum number of files per batch */
+    std::unordered_map<std::string, SHA256::MessageDigest> m_Digests; /**< computed digests that were not requested yet */
+    scantool::hash::HashCache* m_Cache; /**< persistent digest cache, may be nullptr */
+    std::unordered_map<std::string, SHA256::MessageDigest> m_Known; /**< digests that are known in advance */
+    std::unordered_map<std::string, scantool::filesystem::FileFormat> m_Formats; /**< formats of read files whose digest or format was not requested yet */
+}; // class
+
+} // namespace
+
+#endif // SCANTOOL_VT_HASHBATCH_HPP
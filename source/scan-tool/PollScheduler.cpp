@@ -0,0 +1,183 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "PollScheduler.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace scantool::virustotal
+{
+
+const std::chrono::seconds PollScheduler::cDefaultInitialDelay = std::chrono::seconds(60);
+
+const std::chrono::seconds PollScheduler::cDefaultMaximumDelay = std::chrono::seconds(900);
+
+const std::chrono::seconds PollScheduler::cSlotWidth = std::chrono::seconds(15);
+
+const std::size_t PollScheduler::cSlotCount = 64;
+
+PollScheduler::PollScheduler(const std::chrono::seconds initialDelay, const std::chrono::seconds maximumDelay)
+: m_InitialDelay(std::max(initialDelay, std::chrono::seconds(0))),
+  m_MaximumDelay(std::max(maximumDelay, initialDelay)),
+  m_Origin(std::chrono::steady_clock::now()),
+  m_NextTick(0),
+  m_Slots(std::vector<std::vector<std::pair<std::string, int64_t> > >(cSlotCount)),
+  m_Ready(std::deque<std::pair<std::string, int64_t> >()),
+  m_Entries(std::unordered_map<std::string, Entry>())
+{
+}
+
+std::chrono::seconds PollScheduler::initialDelay() const noexcept
+{
+  return m_InitialDelay;
+}
+
+bool PollScheduler::add(const std::string& scan_id, const std::chrono::steady_clock::time_point firstPoll)
+{
+  const int64_t tick = tickOf(firstPoll);
+  if (!m_Entries.insert(std::make_pair(scan_id, Entry{ tick, 0 })).second)
+    return false;
+  schedule(scan_id, tick);
+  return true;
+}
+
+bool PollScheduler::contains(const std::string& scan_id) const
+{
+  return m_Entries.find(scan_id) != m_Entries.end();
+}
+
+void PollScheduler::remove(const std::string& scan_id)
+{
+  // Records in the slots are dropped when their slot is checked.
+  m_Entries.erase(scan_id);
+}
+
+bool PollScheduler::next(const std::chrono::steady_clock::time_point now, std::string& scan_id)
+{
+  advance(now);
+  while (!m_Ready.empty())
+  {
+    const auto record = m_Ready.front();
+    m_Ready.pop_front();
+    const auto iter = m_Entries.find(record.first);
+    // Skip records of removed or rescheduled scans.
+    if ((iter == m_Entries.end()) || (iter->second.tick != record.second))
+      continue;
+    iter->second.tick = -1;
+    ++iter->second.attempts;
+    scan_id = record.first;
+    return true;
+  }
+  return false;
+}
+
+void PollScheduler::postpone(const std::string& scan_id, const std::chrono::steady_clock::time_point now)
+{
+  const auto iter = m_Entries.find(scan_id);
+  if (iter == m_Entries.end())
+    return;
+  // The delay doubles with every poll that found the scan still queued.
+  std::chrono::seconds delay = m_InitialDelay;
+  for (unsigned int i = 1; (i < iter->second.attempts) && (delay < m_MaximumDelay); ++i)
+  {
+    delay *= 2;
+  }
+  delay = std::min(delay, m_MaximumDelay);
+  iter->second.tick = tickOf(now + delay);
+  schedule(scan_id, iter->second.tick);
+}
+
+unsigned int PollScheduler::attempts(const std::string& scan_id) const
+{
+  const auto iter = m_Entries.find(scan_id);
+  return (iter != m_Entries.end()) ? iter->second.attempts : 0;
+}
+
+std::chrono::steady_clock::time_point PollScheduler::nextPoll() const
+{
+  int64_t earliest = std::numeric_limits<int64_t>::max();
+  for (const auto& [scan_id, entry] : m_Entries)
+  {
+    if ((entry.tick >= 0) && (entry.tick < earliest))
+      earliest = entry.tick;
+  }
+  if (earliest == std::numeric_limits<int64_t>::max())
+    return std::chrono::steady_clock::time_point::max();
+  return m_Origin + cSlotWidth * earliest;
+}
+
+bool PollScheduler::empty() const noexcept
+{
+  return m_Entries.empty();
+}
+
+std::size_t PollScheduler::size() const noexcept
+{
+  return m_Entries.size();
+}
+
+int64_t PollScheduler::tickOf(const std::chrono::steady_clock::time_point when) const
+{
+  if (when <= m_Origin)
+    return 0;
+  /* Round down, so that a poll that is due now is not delayed. A poll can
+     happen less than one slot width earlier than requested, which does not
+     matter, because the delays are several slot widths. */
+  return (when - m_Origin) / cSlotWidth;
+}
+
+void PollScheduler::schedule(const std::string& scan_id, const int64_t tick)
+{
+  if (tick < m_NextTick)
+    m_Ready.push_back(std::make_pair(scan_id, tick));
+  else
+    m_Slots[static_cast<std::size_t>(tick % static_cast<int64_t>(cSlotCount))].push_back(std::make_pair(scan_id, tick));
+}
+
+void PollScheduler::advance(const std::chrono::steady_clock::time_point now)
+{
+  if (now < m_Origin)
+    return;
+  const int64_t nowTick = (now - m_Origin) / cSlotWidth;
+  if (nowTick < m_NextTick)
+    return;
+  // Every slot has to be checked at most once, even after a long pause.
+  const int64_t lastTick = std::min(nowTick, m_NextTick + static_cast<int64_t>(cSlotCount) - 1);
+  for (int64_t tick = m_NextTick; tick <= lastTick; ++tick)
+  {
+    auto& slot = m_Slots[static_cast<std::size_t>(tick % static_cast<int64_t>(cSlotCount))];
+    std::vector<std::pair<std::string, int64_t> > later;
+    for (auto& record : slot)
+    {
+      const auto iter = m_Entries.find(record.first);
+      if ((iter == m_Entries.end()) || (iter->second.tick != record.second))
+        continue;
+      // Slots are shared by ticks that are a whole turn of the wheel apart.
+      if (record.second <= nowTick)
+        m_Ready.push_back(std::move(record));
+      else
+        later.push_back(std::move(record));
+    }
+    slot.swap(later);
+  }
+  m_NextTick = nowTick + 1;
+}
+
+} // namespace
@@ -0,0 +1,193 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_VT_POLLSCHEDULER_HPP
+#define SCANTOOL_VT_POLLSCHEDULER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace scantool::virustotal
+{
+
+/** \brief Schedules the report requests for queued scans.
+ *
+ * Every scan ID gets its own time for the next poll. If the scan is still
+ * queued, the delay until the next poll is doubled, up to a maximum delay.
+ * So scans that take long do not use up the requests for the others, and
+ * no request is spent on a scan that most likely is not done yet.
+ *
+ * Due times are kept in a timer wheel whose slots have the width of the
+ * time between two requests, because polls cannot happen more often anyway.
+ */
+class PollScheduler
+{
+  public:
+    /// default delay between the scan request and the first poll
+    static const std::chrono::seconds cDefaultInitialDelay;
+
+    /// default maximum delay between two polls of the same scan
+    static const std::chrono::seconds cDefaultMaximumDelay;
+
+    /// width of a slot of the timer wheel
+    static const std::chrono::seconds cSlotWidth;
+
+    /// number of slots of the timer wheel
+    static const std::size_t cSlotCount;
+
+
+    /** \brief Constructor, creates an empty scheduler.
+     *
+     * \param initialDelay  delay between the scan request and the first poll
+     * \param maximumDelay  maximum delay between two polls of the same scan
+     */
+    PollScheduler(const std::chrono::seconds initialDelay = cDefaultInitialDelay,
+                  const std::chrono::seconds maximumDelay = cDefaultMaximumDelay);
+
+
+    /** \brief Gets the delay between the scan request and the first poll.
+     *
+     * \return Returns the initial delay.
+     */
+    std::chrono::seconds initialDelay() const noexcept;
+
+
+    /** \brief Adds a scan, if it is not scheduled yet.
+     *
+     * \param scan_id    ID of the scan
+     * \param firstPoll  time of the first poll
+     * \return Returns true, if the scan was added.
+     *         Returns false, if it was already scheduled.
+     */
+    bool add(const std::string& scan_id, const std::chrono::steady_clock::time_point firstPoll);
+
+
+    /** \brief Checks whether a scan is scheduled.
+     *
+     * \param scan_id  ID of the scan
+     * \return Returns true, if the scan is scheduled.
+     */
+    bool contains(const std::string& scan_id) const;
+
+
+    /** \brief Removes a scan, e.g. because its report was retrieved.
+     *
+     * \param scan_id  ID of the scan
+     */
+    void remove(const std::string& scan_id);
+
+
+    /** \brief Gets the next scan whose poll is due.
+     *
+     * \param now      the current time
+     * \param scan_id  variable that will hold the ID of the scan
+     * \return Returns true, if a poll is due.
+     *         Returns false, if no poll is due.
+     * \remarks The scan is not polled again, until it is either postponed
+     *          or removed.
+     */
+    bool next(const std::chrono::steady_clock::time_point now, std::string& scan_id);
+
+
+    /** \brief Schedules the next poll of a scan that is still queued.
+     *
+     * \param scan_id  ID of the scan
+     * \param now      the current time
+     */
+    void postpone(const std::string& scan_id, const std::chrono::steady_clock::time_point now);
+
+
+    /** \brief Gets the number of polls of a scan so far.
+     *
+     * \param scan_id  ID of the scan
+     * \return Returns the number of polls of the scan.
+     */
+    unsigned int attempts(const std::string& scan_id) const;
+
+
+    /** \brief Gets the time of the next poll.
+     *
+     * \return Returns the earliest due time of all scheduled scans.
+     *         Returns time_point::max(), if no poll is scheduled.
+     */
+    std::chrono::steady_clock::time_point nextPoll() const;
+
+
+    /** \brief Checks whether no scans are scheduled.
+     *
+     * \return Returns true, if no scans are scheduled.
+     */
+    bool empty() const noexcept;
+
+
+    /** \brief Gets the number of scheduled scans.
+     *
+     * \return Returns the number of scheduled scans.
+     */
+    std::size_t size() const noexcept;
+  private:
+    /** \brief State of a single scan. */
+    struct Entry
+    {
+      int64_t tick; /**< slot tick of the next poll, or -1 while the scan is polled */
+      unsigned int attempts; /**< number of polls so far */
+    }; // struct
+
+
+    /** \brief Gets the tick of the slot that contains a given time.
+     *
+     * \param when  the point in time
+     * \return Returns the tick of the slot that contains the time.
+     */
+    int64_t tickOf(const std::chrono::steady_clock::time_point when) const;
+
+
+    /** \brief Puts a scan into the slot of its tick.
+     *
+     * \param scan_id  ID of the scan
+     * \param tick     tick of the next poll
+     */
+    void schedule(const std::string& scan_id, const int64_t tick);
+
+
+    /** \brief Moves all scans whose ticks have passed to the ready list.
+     *
+     * \param now  the current time
+     */
+    void advance(const std::chrono::steady_clock::time_point now);
+
+
+    std::chrono::seconds m_InitialDelay; /**< delay before the first poll */
+    std::chrono::seconds m_MaximumDelay; /**< maximum delay between two polls */
+    std::chrono::steady_clock::time_point m_Origin; /**< start time of tick zero */
+    int64_t m_NextTick; /**< next tick whose slot has not been checked yet */
+    std::vector<std::vector<std::pair<std::string, int64_t> > > m_Slots; /**< slots of the wheel; first = scan ID, second = tick */
+    std::deque<std::pair<std::string, int64_t> > m_Ready; /**< scans whose polls are due; first = scan ID, second = tick */
+    std::unordered_map<std::string, Entry> m_Entries; /**< state of all scheduled scans, key = scan ID */
+}; // class
+
+} // namespace
+
+#endif // SCANTOOL_VT_POLLSCHEDULER_HPP
@@ -0,0 +1,73 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_VT_QUEUEDSCAN_HPP
+#define SCANTOOL_VT_QUEUEDSCAN_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+namespace scantool::virustotal
+{
+
+/** \brief Record of a scan that was queued for later report retrieval.
+ *
+ * The record keeps everything that is known about the file when it is
+ * submitted, because files extracted from archives are already deleted when
+ * the report is retrieved.
+ */
+struct QueuedScan
+{
+  /** \brief Default constructor, creates an empty record. */
+  QueuedScan();
+
+
+  std::string fileName; /**< name of the scanned file on disk */
+  std::string sha256; /**< SHA-256 hash of the file, may be empty if unknown */
+  int64_t size; /**< size of the file in octets, or -1 if unknown */
+  std::string origin; /**< file given by the user, i.e. the outermost archive for archive entries */
+  std::string archivePath; /**< path of the entry within origin, separated by "!/" for nested archives; empty for plain files */
+  bool extracted; /**< whether the entries of the file were scanned by an archive handler */
+  std::chrono::time_point<std::chrono::system_clock> submitted; /**< time of the scan request */
+
+
+  /** \brief Gets the name that identifies the file for the user.
+   *
+   * \return Returns the origin for plain files. For archive entries the
+   *         archive path is appended, e.g. "data.zip!/dir/file.exe".
+   */
+  std::string displayName() const;
+}; // struct
+
+/** list of queued scan requests; key = scan_id, value = queued scan record
+    Files with the same content may share a scan, so a scan_id can occur
+    several times, once for each file. */
+typedef std::unordered_multimap<std::string, QueuedScan> QueuedScanMap;
+
+/** function that gets the scan_id of each record that was added to a list of
+    queued scans or rescans */
+typedef std::function<void(const std::string& scan_id)> ScanAddedHandler;
+
+} // namespace
+
+#endif // SCANTOOL_VT_QUEUEDSCAN_HPP
@@ -0,0 +1,170 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "RevalidationQueue.hpp"
+#include <iostream>
+#include <utility>
+#include "../../libstriezel/filesystem/directory.hpp"
+#include "../../libstriezel/filesystem/file.hpp"
+
+namespace scantool::virustotal
+{
+
+const std::string RevalidationQueue::cFileName = "revalidation-queue.txt";
+
+RevalidationQueue::RevalidationQueue()
+: m_Queue(std::deque<std::pair<std::string, std::string> >()),
+  m_Hashes(std::unordered_set<std::string>()),
+  m_Rescans(nullptr),
+  m_ScanAdded()
+{
+}
+
+std::string RevalidationQueue::defaultFileName(const std::string& cacheRoot)
+{
+  return libstriezel::filesystem::slashify(cacheRoot) + cFileName;
+}
+
+bool RevalidationQueue::load(const std::string& fileName)
+{
+  if (!libstriezel::filesystem::file::exists(fileName))
+    return true;
+  scantool::filesystem::AppendOnlyFile file(fileName);
+  // Other processes must neither append nor take the same resources.
+  if (!file.lock())
+    return false;
+  // line format: SHA-256 hash, space, file name
+  const bool success = file.read([this](const std::string& line)
+  {
+    const auto space = line.find(' ');
+    if ((space == 0) || (space == std::string::npos) || (space + 1 == line.size())
+        || (line[0] == '#'))
+      return;
+    add(line.substr(0, space), line.substr(space + 1));
+  });
+  const bool emptied = success && ((file.lines() == 0)
+      || file.rewrite("# scan-tool revalidation queue\n"));
+  file.unlock();
+  return emptied;
+}
+
+bool RevalidationQueue::save(const std::string& fileName)
+{
+  std::string lines;
+  for (const auto& [hash, name] : m_Queue)
+  {
+    if (name.find_first_of("\r\n") == std::string::npos)
+      lines.append(hash).append(" ").append(name).append("\n");
+  }
+  m_Queue.clear();
+  m_Hashes.clear();
+  if (lines.empty())
+    return true;
+  scantool::filesystem::AppendOnlyFile file(fileName);
+  return file.append(lines);
+}
+
+bool RevalidationQueue::add(const std::string& hash, const std::string& fileName)
+{
+  if (!m_Hashes.insert(hash).second)
+    return false;
+  m_Queue.push_back(std::make_pair(hash, fileName));
+  return true;
+}
+
+void RevalidationQueue::setPendingRescans(QueuedScanMap* rescans) noexcept
+{
+  m_Rescans = rescans;
+}
+
+void RevalidationQueue::setScanAddedHandler(ScanAddedHandler handler)
+{
+  m_ScanAdded = std::move(handler);
+}
+
+bool RevalidationQueue::empty() const noexcept
+{
+  return m_Queue.empty();
+}
+
+std::size_t RevalidationQueue::size() const noexcept
+{
+  return m_Queue.size();
+}
+
+void RevalidationQueue::processIdle(ScannerV2& scanVT, CacheManagerV2& cacheMgr, const bool silent)
+{
+  while (!m_Queue.empty() && scanVT.scanLimitExpired())
+  {
+    processNext(scanVT, cacheMgr, silent);
+  }
+}
+
+void RevalidationQueue::processUntil(ScannerV2& scanVT, CacheManagerV2& cacheMgr, const bool silent,
+                                    const std::chrono::steady_clock::time_point deadline)
+{
+  while (!m_Queue.empty())
+  {
+    const auto nextRequest = scanVT.honoursTimeLimit()
+        ? scanVT.lastScanRequestTime() + scanVT.timeBetweenConsecutiveScanRequests()
+        : std::chrono::steady_clock::now();
+    if (nextRequest > deadline)
+      break;
+    processNext(scanVT, cacheMgr, silent);
+  }
+}
+
+bool RevalidationQueue::processNext(ScannerV2& scanVT, CacheManagerV2& cacheMgr, const bool silent)
+{
+  const auto item = m_Queue.front();
+  m_Queue.pop_front();
+  m_Hashes.erase(item.first);
+
+  std::string scan_id = "";
+  if (!scanVT.rescan(item.first, scan_id))
+  {
+    // The verdict of the file is already given, only its refresh fails.
+    std::cerr << "Warning: Could not initiate rescan for file " << item.second
+              << ", its report stays outdated." << std::endl;
+    return false;
+  }
+  if (!silent)
+    std::clog << "Info: " << item.second << " was queued for re-scan to "
+              << "revalidate its outdated report. Scan ID for retrieval is "
+              << scan_id << "." << std::endl;
+  // The report of the rescan is polled later.
+  if (m_Rescans != nullptr)
+  {
+    QueuedScan record;
+    record.fileName = item.second;
+    record.sha256 = item.first;
+    record.origin = item.second;
+    m_Rescans->emplace(scan_id, record);
+    if (m_ScanAdded)
+      m_ScanAdded(scan_id);
+  }
+  /* Delete a possibly existing cached entry for that file, because it is now
+     potentially outdated, as soon as the next request for that report is
+     performed. */
+  cacheMgr.deleteCachedElement(item.first);
+  return true;
+}
+
+} // namespace
@@ -0,0 +1,170 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_VT_REVALIDATIONQUEUE_HPP
+#define SCANTOOL_VT_REVALIDATIONQUEUE_HPP
+
+#include <chrono>
+#include <deque>
+#include <string>
+#include <unordered_set>
+#include "../filesystem/AppendOnlyFile.hpp"
+#include "../virustotal/CacheManagerV2.hpp"
+#include "../virustotal/ScannerV2.hpp"
+#include "QueuedScan.hpp"
+
+namespace scantool::virustotal
+{
+
+/** \brief Queue of files whose cached reports are outdated.
+ *
+ * Instead of waiting for a rescan while the file is processed, the verdict
+ * from the outdated report is used right away and the rescan is requested
+ * later, when the scanner has requests to spare. Resources that are left
+ * when the program ends can be saved, so that a later run requests their
+ * rescans instead of waiting for the time limit before the program exits.
+ */
+class RevalidationQueue
+{
+  public:
+    /// name of the file of remaining resources within the cache root directory
+    static const std::string cFileName;
+
+
+    /** \brief Constructor, creates an empty queue.
+     */
+    RevalidationQueue();
+
+
+    /** \brief Gets the default path of the file of remaining resources.
+     *
+     * \param cacheRoot  root directory of the request cache
+     * \return Returns the path of the file in the cache root directory.
+     */
+    static std::string defaultFileName(const std::string& cacheRoot);
+
+
+    /** \brief Takes the resources that earlier runs left in a file.
+     *
+     * \param fileName  path of the file
+     * \return Returns true, if the file was read or does not exist.
+     * \remarks The file is emptied, so that other processes do not request
+     *          the same rescans.
+     */
+    bool load(const std::string& fileName);
+
+
+    /** \brief Appends the remaining resources to a file, so that a later run
+     *         can request their rescans, and empties the queue.
+     *
+     * \param fileName  path of the file
+     * \return Returns true, if the resources were written.
+     * \remarks Resources whose file names contain line breaks are dropped.
+     */
+    bool save(const std::string& fileName);
+
+
+    /** \brief Adds a resource to the queue, if it is not queued yet.
+     *
+     * \param hash      SHA256 hash of the file
+     * \param fileName  name of the file
+     * \return Returns true, if the resource was added.
+     *         Returns false, if it was already queued.
+     */
+    bool add(const std::string& hash, const std::string& fileName);
+
+
+    /** \brief Sets the list that keeps the scans of requested rescans.
+     *
+     * \param rescans  list of rescans whose reports are still pending, or
+     *                 nullptr to forget the scan IDs of rescans (default);
+     *                 the list must outlive the queue
+     */
+    void setPendingRescans(QueuedScanMap* rescans) noexcept;
+
+
+    /** \brief Sets the function that is told about every new rescan.
+     *
+     * \param handler  the function, e.g. to schedule the polls of the rescan;
+     *                 may be empty
+     */
+    void setScanAddedHandler(ScanAddedHandler handler);
+
+
+    /** \brief Checks whether the queue is empty.
+     *
+     * \return Returns true, if no resources are queued.
+     */
+    bool empty() const noexcept;
+
+
+    /** \brief Gets the number of queued resources.
+     *
+     * \return Returns the number of queued resources.
+     */
+    std::size_t size() const noexcept;
+
+
+    /** \brief Requests rescans as long as no waiting for the time limit of
+     *         the scanner is required.
+     *
+     * \param scanVT    the scanner
+     * \param cacheMgr  cache manager
+     * \param silent    silence flag
+     * \remarks Resources whose rescan cannot be requested are dropped from
+     *          the queue. Their cached reports stay outdated, so later scans
+     *          of the files queue them again.
+     */
+    void processIdle(ScannerV2& scanVT, CacheManagerV2& cacheMgr, const bool silent);
+
+
+    /** \brief Requests rescans as long as they can be sent before a given
+     *         point in time.
+     *
+     * \param scanVT    the scanner
+     * \param cacheMgr  cache manager
+     * \param silent    silence flag
+     * \param deadline  time until which rescans may be requested
+     * \remarks Resources whose rescan cannot be requested are dropped.
+     */
+    void processUntil(ScannerV2& scanVT, CacheManagerV2& cacheMgr, const bool silent,
+                     const std::chrono::steady_clock::time_point deadline);
+  private:
+    /** \brief Requests a rescan for the first queued resource.
+     *
+     * \param scanVT    the scanner
+     * \param cacheMgr  cache manager
+     * \param silent    silence flag
+     * \return Returns true, if the rescan was requested.
+     *         Returns false, if the resource was dropped, because the rescan
+     *         could not be requested.
+     */
+    bool processNext(ScannerV2& scanVT, CacheManagerV2& cacheMgr, const bool silent);
+
+
+    std::deque<std::pair<std::string, std::string> > m_Queue; /**< queued resources; first = hash, second = file name */
+    std::unordered_set<std::string> m_Hashes; /**< hashes of queued resources */
+    QueuedScanMap* m_Rescans; /**< rescans whose reports are pending, may be nullptr */
+    ScanAddedHandler m_ScanAdded; /**< gets new rescans, may be empty */
+}; // class
+
+} // namespace
+
+#endif // SCANTOOL_VT_REVALIDATIONQUEUE_HPP
@@ -0,0 +1,186 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "RunJournal.hpp"
+#include <charconv>
+#include <chrono>
+
+namespace scantool::virustotal
+{
+
+/** \brief Parses the next space-separated number of a journal line.
+ *
+ * \param first  pointer to the first character, will be moved behind the number
+ * \param last   pointer behind the last character of the line
+ * \param value  variable that will hold the number
+ * \return Returns true, if a number followed by a space was found.
+ */
+template<typename T>
+static bool parseField(const char*& first, const char* last, T& value)
+{
+  const auto result = std::from_chars(first, last, value);
+  if ((result.ec != std::errc()) || (result.ptr == last) || (*result.ptr != ' '))
+    return false;
+  first = result.ptr + 1;
+  return true;
+}
+
+ScannerV2::Report RunJournal::Entry::report() const
+{
+  ScannerV2::Report result;
+  // response code of found reports
+  result.response_code = 1;
+  result.positives = positives;
+  result.total = total;
+  result.scan_date_t = scanDate;
+  // same format as the dates from the API, which are converted via mktime()
+  char buffer[32];
+  const std::tm* local = std::localtime(&scanDate);
+  if ((local != nullptr) && (std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", local) > 0))
+    result.scan_date = buffer;
+  result.sha256 = digest.toHexString();
+  result.resource = result.sha256;
+  return result;
+}
+
+RunJournal::RunJournal(const std::string& fileName)
+: m_File(fileName),
+  m_Entries(std::unordered_map<std::string, Entry>()),
+  m_Pending(std::string())
+{
+}
+
+bool RunJournal::load()
+{
+  m_Entries.clear();
+  m_Pending.clear();
+  return m_File.read([this](const std::string& line)
+  {
+    if (line.empty() || (line[0] == '#'))
+      return;
+    // line format: SHA-256 positives total scan_date device inode size mtime_ns ctime_ns path
+    if ((line.size() < 66) || (line[64] != ' '))
+      return;
+    Entry entry;
+    if (!entry.digest.fromHexString(line.substr(0, 64)))
+      return;
+    const char* first = line.data() + 65;
+    const char* last = line.data() + line.size();
+    int64_t scanDate = 0;
+    if (!parseField(first, last, entry.positives)
+        || !parseField(first, last, entry.total)
+        || !parseField(first, last, scanDate)
+        || !parseField(first, last, entry.status.device)
+        || !parseField(first, last, entry.status.inode)
+        || !parseField(first, last, entry.status.size)
+        || !parseField(first, last, entry.status.mtime_ns)
+        || !parseField(first, last, entry.status.ctime_ns)
+        || (first == last))
+      return;
+    entry.scanDate = static_cast<std::time_t>(scanDate);
+    m_Entries[std::string(first, last)] = entry;
+  });
+}
+
+bool RunJournal::lookup(const std::string& fileName, const scantool::hash::FileStatus& status, Entry& entry) const
+{
+  const auto iter = m_Entries.find(fileName);
+  if ((iter == m_Entries.end()) || !(iter->second.status == status))
+    return false;
+  entry = iter->second;
+  return true;
+}
+
+void RunJournal::record(const std::string& fileName, const scantool::hash::FileStatus& status,
+                        const SHA256::MessageDigest& digest, const ScannerV2::Report& report)
+{
+  if (digest.isNull() || fileName.empty() || !report.hasTime_t()
+      || (fileName.find('\n') != std::string::npos))
+    return;
+  /* A file that is modified again within the resolution of the time stamps
+     would keep its time stamps, so recently changed files are not recorded. */
+  const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+  const int64_t cRacyInterval = static_cast<int64_t>(2) * 1000000000;
+  if ((status.mtime_ns > now - cRacyInterval) || (status.ctime_ns > now - cRacyInterval))
+    return;
+  Entry entry;
+  entry.status = status;
+  entry.digest = digest;
+  entry.positives = report.positives;
+  entry.total = report.total;
+  entry.scanDate = report.scan_date_t;
+
+  const auto iter = m_Entries.find(fileName);
+  if (iter != m_Entries.end())
+  {
+    const Entry& old = iter->second;
+    if ((old.status == entry.status) && (old.digest == entry.digest)
+        && (old.positives == entry.positives) && (old.total == entry.total)
+        && (old.scanDate == entry.scanDate))
+      return;
+    iter->second = entry;
+  }
+  else
+  {
+    m_Entries.emplace(fileName, entry);
+  }
+  appendLine(fileName, entry, m_Pending);
+}
+
+void RunJournal::appendLine(const std::string& fileName, const Entry& entry, std::string& output)
+{
+  output.append(entry.digest.toHexString()).append(" ")
+        .append(std::to_string(entry.positives)).append(" ")
+        .append(std::to_string(entry.total)).append(" ")
+        .append(std::to_string(static_cast<int64_t>(entry.scanDate))).append(" ")
+        .append(std::to_string(entry.status.device)).append(" ")
+        .append(std::to_string(entry.status.inode)).append(" ")
+        .append(std::to_string(entry.status.size)).append(" ")
+        .append(std::to_string(entry.status.mtime_ns)).append(" ")
+        .append(std::to_string(entry.status.ctime_ns)).append(" ")
+        .append(fileName).append("\n");
+}
+
+bool RunJournal::flush()
+{
+  if (!m_File.append(m_Pending))
+    return false;
+  m_Pending.clear();
+  return true;
+}
+
+bool RunJournal::compact()
+{
+  if (!flush())
+    return false;
+  // Rewriting is only worth it, if at least half of the lines are replaced.
+  if (!m_File.worthRewriting(m_Entries.size(), 1000))
+    return true;
+
+  std::string content = "# scan-tool run journal\n";
+  for (const auto& [fileName, entry] : m_Entries)
+  {
+    appendLine(fileName, entry, content);
+  }
+  return m_File.rewrite(content);
+}
+
+} // namespace
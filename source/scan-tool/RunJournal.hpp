@@ -0,0 +1,141 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_VT_RUNJOURNAL_HPP
+#define SCANTOOL_VT_RUNJOURNAL_HPP
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <unordered_map>
+#include "../../libstriezel/hash/sha256/sha256.hpp"
+#include "../filesystem/AppendOnlyFile.hpp"
+#include "../hash/HashCache.hpp"
+#include "../virustotal/ScannerV2.hpp"
+
+namespace scantool::virustotal
+{
+
+/** \brief Journal of the verdicts of previous runs for incremental scans.
+ *
+ * The journal keeps the status, the digest and the verdict of every file
+ * whose report was retrieved. As long as the status of a file does not
+ * change and its report is not outdated, the next run can take the verdict
+ * from the journal instead of hashing the file and requesting its report.
+ *
+ * Like the hash cache, the journal is a text file where new entries are
+ * appended to, and later entries for the same file replace earlier ones.
+ */
+class RunJournal
+{
+  public:
+    /** recorded verdict of a file */
+    struct Entry
+    {
+      scantool::hash::FileStatus status; /**< status of the file when it was recorded */
+      SHA256::MessageDigest digest; /**< digest of the file's content */
+      int positives; /**< number of engines that detected a threat */
+      int total; /**< total number of engines */
+      std::time_t scanDate; /**< date of the report */
+
+
+      /** \brief Creates a report from the recorded verdict.
+       *
+       * \return Returns a report with the number of positives, the total
+       *         number of engines, the scan date and the hash of the file.
+       *         The results of the single engines are not recorded.
+       */
+      ScannerV2::Report report() const;
+    }; // struct
+
+
+    /** \brief Constructor.
+     *
+     * \param fileName  path of the journal file
+     */
+    explicit RunJournal(const std::string& fileName);
+
+
+    /** \brief Loads the journal from its file.
+     *
+     * \return Returns true, if the journal was loaded or did not exist.
+     *         Returns false, if the journal file could not be read.
+     * \remarks Malformed lines, e.g. an incomplete last line, are skipped.
+     */
+    bool load();
+
+
+    /** \brief Gets the recorded verdict of a file.
+     *
+     * \param fileName  name of the file
+     * \param status    current status of the file
+     * \param entry     variable that will hold the recorded entry
+     * \return Returns true, if there is an entry for the file with the given
+     *         status. Returns false otherwise.
+     */
+    bool lookup(const std::string& fileName, const scantool::hash::FileStatus& status, Entry& entry) const;
+
+
+    /** \brief Records the verdict for a file.
+     *
+     * \param fileName  name of the file
+     * \param status    current status of the file
+     * \param digest    digest of the file's content
+     * \param report    the retrieved report of the file
+     * \remarks Reports without valid scan date and files that were changed
+     *          in the last seconds are not recorded. Call flush() to write
+     *          new entries to the file.
+     */
+    void record(const std::string& fileName, const scantool::hash::FileStatus& status,
+                const SHA256::MessageDigest& digest, const ScannerV2::Report& report);
+
+
+    /** \brief Appends new entries to the journal file.
+     *
+     * \return Returns true, if all new entries were written.
+     */
+    bool flush();
+
+
+    /** \brief Rewrites the journal file without replaced entries, if there
+     *         are many of them.
+     *
+     * \return Returns true, if the journal file is compact or was compacted.
+     *         Returns false, if the journal file could not be rewritten.
+     */
+    bool compact();
+  private:
+    /** \brief Appends the line for an entry to a string.
+     *
+     * \param fileName  name of the file
+     * \param entry     the entry
+     * \param output    string that gets the line
+     */
+    static void appendLine(const std::string& fileName, const Entry& entry, std::string& output);
+
+
+    scantool::filesystem::AppendOnlyFile m_File; /**< the journal file */
+    std::unordered_map<std::string, Entry> m_Entries; /**< recorded entries by file name */
+    std::string m_Pending; /**< lines of new entries that were not written yet */
+}; // class
+
+} // namespace
+
+#endif // SCANTOOL_VT_RUNJOURNAL_HPP
@@ -0,0 +1,218 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "ScanPoller.hpp"
+#include <iostream>
+#include "../../libstriezel/hash/sha256/sha256.hpp"
+
+namespace scantool::virustotal
+{
+
+ScanPoller::ScanPoller(ScannerV2& scanVT, QueuedScanMap& queued_scans, QueuedScanMap& rescans,
+                       const std::string& requestCacheDirVT, const bool useRequestCache,
+                       const int maybeLimit, const bool silent,
+                       std::map<std::string, ScannerV2::Report>& mapHashToReport,
+                       std::map<std::string, std::string>& mapFileToHash)
+: m_Scanner(scanVT),
+  m_QueuedScans(queued_scans),
+  m_Rescans(rescans),
+  m_RequestCacheDir(requestCacheDirVT),
+  m_UseRequestCache(useRequestCache),
+  m_MaybeLimit(maybeLimit),
+  m_Silent(silent),
+  m_HashToReport(mapHashToReport),
+  m_FileToHash(mapFileToHash),
+  m_PendingScans(nullptr),
+  m_Journal(nullptr),
+  m_Polls(PollScheduler())
+{
+}
+
+void ScanPoller::setPendingScans(PendingScans* pending) noexcept
+{
+  m_PendingScans = pending;
+}
+
+void ScanPoller::setJournal(RunJournal* journal) noexcept
+{
+  m_Journal = journal;
+}
+
+void ScanPoller::added(const std::string& scan_id, const bool dueNow)
+{
+  const auto now = std::chrono::steady_clock::now();
+  // Scans of earlier runs are probably done already.
+  const bool earlier = dueNow || ((m_PendingScans != nullptr)
+      && (m_PendingScans->entries().find(scan_id) != m_PendingScans->entries().end()));
+  m_Polls.add(scan_id, earlier ? now : now + m_Polls.initialDelay());
+  if (m_PendingScans == nullptr)
+    return;
+  // Every file of a shared scan needs its own entry.
+  for (const QueuedScanMap* scans : { &m_QueuedScans, &m_Rescans })
+  {
+    const auto range = scans->equal_range(scan_id);
+    for (auto iter = range.first; iter != range.second; ++iter)
+    {
+      PendingScans::Entry entry;
+      entry.sha256 = iter->second.sha256;
+      entry.size = iter->second.size;
+      entry.submitted = std::chrono::system_clock::to_time_t(iter->second.submitted);
+      entry.name = iter->second.displayName();
+      m_PendingScans->add(scan_id, entry);
+    }
+  }
+  // Keep new scans, even if the program is terminated later.
+  flushPendingScans();
+}
+
+bool ScanPoller::poll(const std::string& scan_id)
+{
+  const bool isRescan = (m_QueuedScans.find(scan_id) == m_QueuedScans.end());
+  QueuedScanMap& scans = isRescan ? m_Rescans : m_QueuedScans;
+  const auto range = scans.equal_range(scan_id);
+  if (range.first == range.second)
+  {
+    m_Polls.remove(scan_id);
+    return false;
+  }
+  const std::string firstFile = range.first->second.displayName();
+  // Finished reports go into the request cache, too.
+  ScannerV2::Report report;
+  if (!m_Scanner.getReport(scan_id, report, false, m_UseRequestCache ? m_RequestCacheDir : std::string()))
+  {
+    if (!m_Silent)
+      std::clog << "Warning: Could not get queued scan report for scan ID "
+                << scan_id << " / file " << firstFile << "!" << std::endl;
+    m_Polls.postpone(scan_id, std::chrono::steady_clock::now());
+    return false;
+  }
+  if (report.stillInQueue())
+  {
+    // Response code -2 means that the scan is still queued for analysis.
+    m_Polls.postpone(scan_id, std::chrono::steady_clock::now());
+    return false;
+  }
+  if (!report.successfulRetrieval())
+  {
+    std::cerr << "Error: Got unexpected response code (" << report.response_code
+              << ") from API for scan ID " << scan_id << " / file " << firstFile
+              << ". It will be polled again later." << std::endl;
+    m_Polls.postpone(scan_id, std::chrono::steady_clock::now());
+    return false;
+  }
+  /* If the hash is not given, use the one from the time of submission.
+     Files from archives do not exist anymore at this point. */
+  if (report.sha256.empty())
+    report.sha256 = range.first->second.sha256;
+  // All files with the same content share the scan and its report.
+  for (auto iter = range.first; iter != range.second; ++iter)
+  {
+    const QueuedScan& queued = iter->second;
+    // Rescans replace the verdict that was given under the plain file name.
+    const std::string filename = isRescan ? queued.fileName : queued.displayName();
+    // Only the verdicts of plain files apply to the file as a whole.
+    SHA256::MessageDigest digest;
+    scantool::hash::FileStatus status{};
+    if ((m_Journal != nullptr) && queued.archivePath.empty() && !queued.extracted
+        && digest.fromHexString(queued.sha256)
+        && scantool::hash::FileStatus::get(queued.fileName, status))
+      m_Journal->record(queued.fileName, status, digest, report);
+    // got report
+    if (report.positives == 0)
+    {
+      if (!m_Silent)
+        std::cout << filename << " OK" << std::endl;
+      // The outdated report of a rescan may have flagged the file.
+      if (isRescan)
+        m_FileToHash.erase(filename);
+    }
+    else if (report.positives <= m_MaybeLimit)
+    {
+      if (!m_Silent)
+        std::clog << filename << " might be infected, got " << report.positives
+                  << " positives." << std::endl;
+      // add file to list of infected files
+      m_FileToHash[filename] = report.sha256;
+      m_HashToReport[report.sha256] = report;
+    }
+    else
+    {
+      if (!m_Silent)
+        std::clog << filename << " is INFECTED, got " << report.positives
+                  << " positives." << std::endl;
+      // add file to list of infected files
+      m_FileToHash[filename] = report.sha256;
+      m_HashToReport[report.sha256] = report;
+    } // else
+  } // for files of the scan
+  scans.erase(range.first, range.second);
+  m_Polls.remove(scan_id);
+  if (m_PendingScans != nullptr)
+  {
+    m_PendingScans->resolve(scan_id);
+    flushPendingScans();
+  }
+  return true;
+}
+
+bool ScanPoller::pollNext()
+{
+  std::string scan_id;
+  if (!m_Polls.next(std::chrono::steady_clock::now(), scan_id))
+    return false;
+  poll(scan_id);
+  return true;
+}
+
+std::size_t ScanPoller::pollIdle()
+{
+  std::size_t done = 0;
+  std::string scan_id;
+  while (m_Scanner.scanLimitExpired() && m_Polls.next(std::chrono::steady_clock::now(), scan_id))
+  {
+    if (poll(scan_id))
+      ++done;
+  }
+  return done;
+}
+
+std::chrono::steady_clock::time_point ScanPoller::nextPoll() const
+{
+  return m_Polls.nextPoll();
+}
+
+bool ScanPoller::empty() const noexcept
+{
+  return m_Polls.empty();
+}
+
+std::size_t ScanPoller::size() const noexcept
+{
+  return m_Polls.size();
+}
+
+void ScanPoller::flushPendingScans()
+{
+  if ((m_PendingScans != nullptr) && !m_PendingScans->flush())
+    std::cerr << "Warning: Could not write to file of pending scans "
+              << m_PendingScans->fileName() << "." << std::endl;
+}
+
+} // namespace
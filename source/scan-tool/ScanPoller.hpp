@@ -0,0 +1,166 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_VT_SCANPOLLER_HPP
+#define SCANTOOL_VT_SCANPOLLER_HPP
+
+#include <chrono>
+#include <map>
+#include <string>
+#include "../virustotal/PendingScans.hpp"
+#include "../virustotal/ScannerV2.hpp"
+#include "PollScheduler.hpp"
+#include "QueuedScan.hpp"
+#include "RunJournal.hpp"
+
+namespace scantool::virustotal
+{
+
+/** \brief Retrieves the reports of queued scans and rescans.
+ *
+ * Every new scan is announced with added(), which schedules its first poll
+ * and keeps it in the list of pending scans, so that later runs can get its
+ * report, too. The verdicts of retrieved reports go into the summary and
+ * into the run journal, like the verdicts of reports that were available
+ * right away.
+ */
+class ScanPoller
+{
+  public:
+    /** \brief Constructor.
+     *
+     * \param scanVT             scanner for requests to VirusTotal
+     * \param queued_scans       list of queued scan requests; key = scan_id, value = queued scan record
+     * \param rescans            list of requested rescans; key = scan_id, value = queued scan record
+     * \param requestCacheDirVT  directory of the request cache
+     * \param useRequestCache    whether retrieved reports go into the request cache
+     * \param maybeLimit         limit for "maybe infected"; higher count means infected
+     * \param silent             whether output will be reduced
+     * \param mapHashToReport    map that maps SHA256 hashes to corresponding report; key = SHA256 hash, value = scan report
+     * \param mapFileToHash      map that maps filename to hash; key = file name, value = SHA256 hash
+     */
+    ScanPoller(ScannerV2& scanVT, QueuedScanMap& queued_scans, QueuedScanMap& rescans,
+               const std::string& requestCacheDirVT, const bool useRequestCache,
+               const int maybeLimit, const bool silent,
+               std::map<std::string, ScannerV2::Report>& mapHashToReport,
+               std::map<std::string, std::string>& mapFileToHash);
+
+
+    ScanPoller(const ScanPoller& other) = delete;
+    ScanPoller& operator=(const ScanPoller& other) = delete;
+
+
+    /** \brief Sets the list of scans that are left to later runs.
+     *
+     * \param pending  the list of pending scans, or nullptr for none; the
+     *                 list must outlive the poller
+     */
+    void setPendingScans(PendingScans* pending) noexcept;
+
+
+    /** \brief Sets the journal that records the verdicts of scanned files.
+     *
+     * \param journal  the run journal, or nullptr for none; the journal
+     *                 must outlive the poller
+     */
+    void setJournal(RunJournal* journal) noexcept;
+
+
+    /** \brief Schedules the polls of a new record in the queued scans or
+     *         rescans.
+     *
+     * \param scan_id  ID of the scan of the new record
+     * \param dueNow   whether the scan was submitted long ago, e.g. by an
+     *                 interrupted run, so that it is polled right away
+     * \remarks Scans of earlier runs that are in the list of pending scans
+     *          are polled right away, too.
+     */
+    void added(const std::string& scan_id, const bool dueNow = false);
+
+
+    /** \brief Gets the report of a queued scan or rescan.
+     *
+     * \param scan_id  ID of the scan
+     * \return Returns true, if the scan is done and its report was handled.
+     *         Returns false, if the scan is not done yet or the report could
+     *         not be retrieved. Then the next poll is scheduled.
+     */
+    bool poll(const std::string& scan_id);
+
+
+    /** \brief Polls the next scan whose poll is due, if any.
+     *
+     * \return Returns true, if a scan was polled.
+     *         Returns false, if no poll is due.
+     */
+    bool pollNext();
+
+
+    /** \brief Polls due scans as long as no waiting for the time limit is
+     *         required.
+     *
+     * \return Returns the number of scans that are done.
+     */
+    std::size_t pollIdle();
+
+
+    /** \brief Gets the time of the next poll.
+     *
+     * \return Returns the earliest due time of all scheduled scans.
+     *         Returns time_point::max(), if no poll is scheduled.
+     */
+    std::chrono::steady_clock::time_point nextPoll() const;
+
+
+    /** \brief Checks whether no scans are scheduled.
+     *
+     * \return Returns true, if no scans are scheduled.
+     */
+    bool empty() const noexcept;
+
+
+    /** \brief Gets the number of scheduled scans.
+     *
+     * \return Returns the number of scheduled scans.
+     */
+    std::size_t size() const noexcept;
+  private:
+    /** \brief Writes changes of the list of pending scans, if any.
+     */
+    void flushPendingScans();
+
+
+    ScannerV2& m_Scanner; /**< scanner for requests to VirusTotal */
+    QueuedScanMap& m_QueuedScans; /**< queued scan requests */
+    QueuedScanMap& m_Rescans; /**< requested rescans */
+    std::string m_RequestCacheDir; /**< directory of the request cache */
+    bool m_UseRequestCache; /**< whether retrieved reports go into the request cache */
+    int m_MaybeLimit; /**< limit for "maybe infected" */
+    bool m_Silent; /**< whether output will be reduced */
+    std::map<std::string, ScannerV2::Report>& m_HashToReport; /**< reports of infected files */
+    std::map<std::string, std::string>& m_FileToHash; /**< infected files */
+    PendingScans* m_PendingScans; /**< scans that are left to later runs, may be nullptr */
+    RunJournal* m_Journal; /**< journal of verdicts, may be nullptr */
+    PollScheduler m_Polls; /**< times of the next polls */
+}; // class
+
+} // namespace
+
+#endif // SCANTOOL_VT_SCANPOLLER_HPP
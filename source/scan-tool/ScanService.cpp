@@ -0,0 +1,357 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "ScanService.hpp"
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#if defined(__linux__)
+#include <cerrno>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace scantool::virustotal
+{
+
+/// maximum length of a request line
+static const std::string::size_type cMaxLineLength = 65536;
+
+ScanService::ScanService(const std::string& socketPath, Resolver resolver, Handler handler, Delay delay)
+: m_SocketPath(socketPath),
+  m_Resolver(resolver),
+  m_Handler(handler),
+  m_Delay(delay),
+  m_Listener(-1),
+  m_NextId(0),
+  m_Clients(std::unordered_map<int, Client>()),
+  m_Interactive(std::deque<ServiceRequest>()),
+  m_Bulk(std::deque<ServiceRequest>())
+{
+}
+
+ScanService::~ScanService()
+{
+  #if defined(__linux__)
+  for (const auto& [id, client] : m_Clients)
+  {
+    close(client.fd);
+  }
+  if (m_Listener >= 0)
+  {
+    close(m_Listener);
+    unlink(m_SocketPath.c_str());
+  }
+  #endif
+}
+
+bool ScanService::supported() noexcept
+{
+  #if defined(__linux__)
+  return true;
+  #else
+  return false;
+  #endif
+}
+
+bool ScanService::start()
+{
+  #if defined(__linux__)
+  if (m_Listener >= 0)
+    return false;
+  struct sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (m_SocketPath.empty() || (m_SocketPath.size() >= sizeof(address.sun_path)))
+  {
+    std::cerr << "Error: The socket path " << m_SocketPath << " is empty or too long!"
+              << std::endl;
+    return false;
+  }
+  std::copy(m_SocketPath.begin(), m_SocketPath.end(), address.sun_path);
+
+  struct stat status;
+  if (lstat(m_SocketPath.c_str(), &status) == 0)
+  {
+    // Never remove anything else than a socket.
+    if (!S_ISSOCK(status.st_mode))
+    {
+      std::cerr << "Error: " << m_SocketPath << " exists and is not a socket!"
+                << std::endl;
+      return false;
+    }
+    const int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (probe < 0)
+      return false;
+    const bool inUse = connect(probe, reinterpret_cast<const struct sockaddr*>(&address), sizeof(address)) == 0;
+    close(probe);
+    if (inUse)
+    {
+      std::cerr << "Error: Another service is already listening on "
+                << m_SocketPath << "!" << std::endl;
+      return false;
+    }
+    // The socket was left over by a service that did not stop properly.
+    unlink(m_SocketPath.c_str());
+  }
+
+  const int listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (listener < 0)
+  {
+    std::cerr << "Error: Could not create socket!" << std::endl;
+    return false;
+  }
+  if (bind(listener, reinterpret_cast<const struct sockaddr*>(&address), sizeof(address)) != 0)
+  {
+    std::cerr << "Error: Could not bind socket to " << m_SocketPath << "!" << std::endl;
+    close(listener);
+    return false;
+  }
+  /* Clients can upload any file that the service can read, so only the
+     current user may connect. Nobody can connect before listen(). */
+  if ((chmod(m_SocketPath.c_str(), S_IRUSR | S_IWUSR) != 0) || (listen(listener, SOMAXCONN) != 0))
+  {
+    std::cerr << "Error: Could not listen on " << m_SocketPath << "!" << std::endl;
+    close(listener);
+    unlink(m_SocketPath.c_str());
+    return false;
+  }
+  m_Listener = listener;
+  return true;
+  #else
+  return false;
+  #endif
+}
+
+bool ScanService::serve(const std::chrono::milliseconds timeout)
+{
+  #if defined(__linux__)
+  if (m_Listener < 0)
+    return false;
+  // Waiting requests shall be handled as soon as the rate limit allows it.
+  std::chrono::milliseconds wait = timeout;
+  if (!m_Interactive.empty() || !m_Bulk.empty())
+    wait = std::max(std::chrono::milliseconds(0), std::min(wait, m_Delay()));
+
+  std::vector<struct pollfd> fds;
+  std::vector<int> ids;
+  fds.push_back({ m_Listener, POLLIN, 0 });
+  ids.push_back(-1);
+  for (const auto& [id, client] : m_Clients)
+  {
+    short events = client.inputClosed ? 0 : POLLIN;
+    if (!client.output.empty())
+      events |= POLLOUT;
+    fds.push_back({ client.fd, events, 0 });
+    ids.push_back(id);
+  }
+  if (poll(fds.data(), fds.size(), static_cast<int>(wait.count())) < 0)
+    return errno == EINTR;
+
+  for (std::size_t i = 1; i < fds.size(); ++i)
+  {
+    if (fds[i].revents == 0)
+      continue;
+    const auto found = m_Clients.find(ids[i]);
+    if (found == m_Clients.end())
+      continue;
+    Client& client = found->second;
+    bool alive = true;
+    if ((fds[i].revents & POLLHUP) != 0)
+      // The client is gone and cannot get any replies.
+      alive = false;
+    else if ((fds[i].revents & (POLLIN | POLLERR)) != 0)
+      alive = readRequests(ids[i], client);
+    if (alive && ((fds[i].revents & POLLOUT) != 0))
+      alive = sendReplies(client);
+    if (!alive)
+      dropClient(ids[i]);
+  }
+  if ((fds[0].revents & POLLIN) != 0)
+    acceptClients();
+
+  if ((!m_Interactive.empty() || !m_Bulk.empty()) && (m_Delay().count() <= 0))
+    handleNextRequest();
+
+  // Clients that sent all their requests are done, once they got all replies.
+  std::vector<int> finished;
+  for (const auto& [id, client] : m_Clients)
+  {
+    if (client.inputClosed && (client.waiting == 0) && client.output.empty())
+      finished.push_back(id);
+  }
+  for (const int id : finished)
+  {
+    dropClient(id);
+  }
+  return true;
+  #else
+  (void) timeout;
+  return false;
+  #endif
+}
+
+std::size_t ScanService::clientCount() const noexcept
+{
+  return m_Clients.size();
+}
+
+std::size_t ScanService::waitingRequests(const Lane lane) const noexcept
+{
+  return (lane == Lane::Bulk) ? m_Bulk.size() : m_Interactive.size();
+}
+
+void ScanService::acceptClients()
+{
+  #if defined(__linux__)
+  while (true)
+  {
+    const int fd = accept4(m_Listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0)
+      return;
+    m_Clients[m_NextId] = Client{ fd, std::string(), std::string(), false, 0 };
+    ++m_NextId;
+  }
+  #endif
+}
+
+bool ScanService::readRequests(const int id, Client& client)
+{
+  #if defined(__linux__)
+  char buffer[16384];
+  while (true)
+  {
+    const ssize_t length = recv(client.fd, buffer, sizeof(buffer), 0);
+    if (length > 0)
+    {
+      client.input.append(buffer, length);
+      continue;
+    }
+    if (length == 0)
+    {
+      client.inputClosed = true;
+      break;
+    }
+    if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+      break;
+    if (errno != EINTR)
+      return false;
+  }
+
+  std::string::size_type start = 0;
+  std::string::size_type end;
+  while ((end = client.input.find('\n', start)) != std::string::npos)
+  {
+    std::string line = client.input.substr(start, end - start);
+    start = end + 1;
+    if (!line.empty() && (line.back() == '\r'))
+      line.pop_back();
+    if (line.empty())
+      continue;
+    ServiceRequest request;
+    ServiceReply reply;
+    if (!ServiceRequest::parse(line, request))
+    {
+      reply.reason = "syntax";
+      reply.argument = line;
+      client.output += reply.toLine() + "\n";
+      continue;
+    }
+    request.client = id;
+    if (m_Resolver(request, reply))
+    {
+      reply.argument = request.argument;
+      client.output += reply.toLine() + "\n";
+      continue;
+    }
+    if (request.lane == Lane::Interactive)
+      m_Interactive.push_back(request);
+    else
+      m_Bulk.push_back(request);
+    ++client.waiting;
+  }
+  client.input.erase(0, start);
+  // A line without end would grow without limit.
+  if (client.input.size() > cMaxLineLength)
+    return false;
+  return sendReplies(client);
+  #else
+  (void) id;
+  (void) client;
+  return false;
+  #endif
+}
+
+bool ScanService::sendReplies(Client& client)
+{
+  #if defined(__linux__)
+  while (!client.output.empty())
+  {
+    const ssize_t length = send(client.fd, client.output.data(), client.output.size(), MSG_NOSIGNAL);
+    if (length > 0)
+    {
+      client.output.erase(0, length);
+      continue;
+    }
+    if ((length < 0) && (errno == EINTR))
+      continue;
+    // A full socket is no failure, the rest is sent later.
+    return (length < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK));
+  }
+  return true;
+  #else
+  (void) client;
+  return false;
+  #endif
+}
+
+void ScanService::handleNextRequest()
+{
+  std::deque<ServiceRequest>& lane = m_Interactive.empty() ? m_Bulk : m_Interactive;
+  const ServiceRequest request = lane.front();
+  lane.pop_front();
+  ServiceReply reply = m_Handler(request);
+  reply.argument = request.argument;
+  const auto found = m_Clients.find(request.client);
+  if (found == m_Clients.end())
+    return;
+  --found->second.waiting;
+  found->second.output += reply.toLine() + "\n";
+  if (!sendReplies(found->second))
+    dropClient(request.client);
+}
+
+void ScanService::dropClient(const int id)
+{
+  const auto found = m_Clients.find(id);
+  if (found == m_Clients.end())
+    return;
+  #if defined(__linux__)
+  close(found->second.fd);
+  #endif
+  m_Clients.erase(found);
+  const auto fromClient = [id](const ServiceRequest& request) { return request.client == id; };
+  m_Interactive.erase(std::remove_if(m_Interactive.begin(), m_Interactive.end(), fromClient), m_Interactive.end());
+  m_Bulk.erase(std::remove_if(m_Bulk.begin(), m_Bulk.end(), fromClient), m_Bulk.end());
+}
+
+} // namespace
@@ -0,0 +1,193 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_VT_SCANSERVICE_HPP
+#define SCANTOOL_VT_SCANSERVICE_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include "ServiceProtocol.hpp"
+
+namespace scantool::virustotal
+{
+
+/** \brief Scan service that accepts requests on a local UNIX socket.
+ *
+ * All requests of all clients are handled by one process, so they share one
+ * rate limit, one request cache and one pool of connections to VirusTotal.
+ * Requests that can be answered locally, e.g. from the request cache, are
+ * answered right away. The others wait in their lane until the rate limit
+ * allows the next request to VirusTotal. Interactive requests always go
+ * before bulk requests, even if the bulk requests arrived earlier.
+ *
+ * The service is only supported on Linux.
+ */
+class ScanService
+{
+  public:
+    /** \brief Function that tries to answer a request without VirusTotal.
+     *
+     * It gets the request and the reply to fill. It returns true, if the
+     * reply is complete. Otherwise it returns false and may set the digest
+     * of the request, so it does not have to be computed again later.
+     * The service sets the argument of the reply.
+     */
+    typedef std::function<bool(ServiceRequest& request, ServiceReply& reply)> Resolver;
+
+    /** \brief Function that answers a request with the help of VirusTotal.
+     *
+     * The service sets the argument of the reply.
+     */
+    typedef std::function<ServiceReply(const ServiceRequest& request)> Handler;
+
+    /** \brief Function that gets the time until the next request to
+     *         VirusTotal can be sent without waiting for the rate limit.
+     */
+    typedef std::function<std::chrono::milliseconds()> Delay;
+
+
+    /** \brief Constructor.
+     *
+     * \param socketPath  path of the socket
+     * \param resolver    function that answers requests locally
+     * \param handler     function that answers requests with VirusTotal
+     * \param delay       function that gets the time until the rate limit
+     *                    allows the next request
+     */
+    ScanService(const std::string& socketPath, Resolver resolver, Handler handler, Delay delay);
+
+
+    /** \brief Destructor, closes all connections and removes the socket.
+     */
+    ~ScanService();
+
+
+    ScanService(const ScanService& other) = delete;
+    ScanService& operator=(const ScanService& other) = delete;
+
+
+    /** \brief Checks whether the service is supported on the current system.
+     *
+     * \return Returns true, if the service is supported.
+     */
+    static bool supported() noexcept;
+
+
+    /** \brief Creates the socket and starts listening for clients.
+     *
+     * \return Returns true, if the service is listening.
+     *         Returns false, if the socket could not be created, e.g. because
+     *         another service already listens on it.
+     * \remarks A socket file that is left over from a service that did not
+     *          stop properly is replaced. The socket is only accessible for
+     *          the current user.
+     */
+    bool start();
+
+
+    /** \brief Handles new clients, incoming requests and outgoing replies
+     *         until the timeout expires or a waiting request was handled.
+     *
+     * \param timeout  maximum time to wait for clients and requests
+     * \return Returns true, if the service goes on.
+     *         Returns false, if the service failed and has to be stopped.
+     * \remarks At most one request is sent to VirusTotal per call.
+     */
+    bool serve(const std::chrono::milliseconds timeout);
+
+
+    /** \brief Gets the number of connected clients.
+     *
+     * \return Returns the number of connected clients.
+     */
+    std::size_t clientCount() const noexcept;
+
+
+    /** \brief Gets the number of requests that wait for VirusTotal.
+     *
+     * \param lane  the lane
+     * \return Returns the number of waiting requests in the lane.
+     */
+    std::size_t waitingRequests(const Lane lane) const noexcept;
+  private:
+    /// connected client
+    struct Client
+    {
+      int fd; /**< socket of the connection */
+      std::string input; /**< received data that is not a complete line yet */
+      std::string output; /**< replies that were not sent yet */
+      bool inputClosed; /**< whether the client will not send more requests */
+      std::size_t waiting; /**< number of requests of the client in the lanes */
+    };
+
+
+    /** \brief Accepts new clients.
+     */
+    void acceptClients();
+
+
+    /** \brief Reads and handles the requests of a client.
+     *
+     * \param id      id of the client
+     * \param client  the client
+     * \return Returns false, if the connection failed.
+     */
+    bool readRequests(const int id, Client& client);
+
+
+    /** \brief Sends the replies that are pending for a client.
+     *
+     * \param client  the client
+     * \return Returns false, if the connection failed.
+     */
+    bool sendReplies(Client& client);
+
+
+    /** \brief Handles the next waiting request with VirusTotal.
+     */
+    void handleNextRequest();
+
+
+    /** \brief Closes the connection to a client and drops its requests.
+     *
+     * \param id  id of the client
+     */
+    void dropClient(const int id);
+
+
+    std::string m_SocketPath; /**< path of the socket */
+    Resolver m_Resolver; /**< answers requests locally */
+    Handler m_Handler; /**< answers requests with VirusTotal */
+    Delay m_Delay; /**< gets the time until the next request to VirusTotal */
+    int m_Listener; /**< listening socket, or -1 */
+    int m_NextId; /**< id for the next client */
+    std::unordered_map<int, Client> m_Clients; /**< connected clients by id */
+    std::deque<ServiceRequest> m_Interactive; /**< interactive requests that wait for VirusTotal */
+    std::deque<ServiceRequest> m_Bulk; /**< bulk requests that wait for VirusTotal */
+}; // class
+
+} // namespace
+
+#endif // SCANTOOL_VT_SCANSERVICE_HPP
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2016, 2025  Dirk Stolle
+    Copyright (C) 2016, 2025, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -19,41 +19,249 @@
 */
 
 #include "ScanStrategy.hpp"
+#include <ctime>
+#include <iostream>
+#include <utility>
+#include "../hash/FileReader.hpp"
+#include "../hash/Sha256.hpp"
+#include "../hash/Sha256MultiBuffer.hpp"
 
 namespace scantool::virustotal
 {
 
 ScanStrategy::ScanStrategy()
-: m_Handlers(std::vector<std::unique_ptr<Handler> >())
+: m_Handlers(std::vector<std::unique_ptr<Handler> >()),
+  m_Freshness(nullptr),
+  m_HashBatch(nullptr),
+  m_ArchiveEntries(std::vector<std::pair<std::string, std::string> >()),
+  m_Journal(nullptr),
+  m_PendingScans(nullptr),
+  m_UploadLedger(nullptr),
+  m_ReuploadAfterDays(0),
+  m_UploadOutbox(nullptr),
+  m_ScanAdded(),
+  m_FileExtracted(false),
+  m_Head(std::vector<uint8_t>()),
+  m_SniffedFile(std::string()),
+  m_SniffedDigest(SHA256::MessageDigest())
 {
 }
 
+void ScanStrategy::setFreshnessPolicy(const FreshnessPolicy* policy) noexcept
+{
+  m_Freshness = policy;
+}
+
+bool ScanStrategy::isOutdated(const ScannerV2::Report& report,
+                              const std::chrono::time_point<std::chrono::system_clock> ageLimit) const
+{
+  if (m_Freshness != nullptr)
+    return m_Freshness->isOutdated(report);
+  return report.hasTime_t()
+      && (std::chrono::system_clock::from_time_t(report.scan_date_t) < ageLimit);
+}
+
+int ScanStrategy::maxAgeFor(const ScannerV2::Report& report, const int maxAgeInDays) const noexcept
+{
+  if (m_Freshness != nullptr)
+    return m_Freshness->maxAgeFor(report);
+  return maxAgeInDays;
+}
+
+void ScanStrategy::setHashBatch(HashBatch* batch) noexcept
+{
+  m_HashBatch = batch;
+}
+
+SHA256::MessageDigest ScanStrategy::fileDigest(const std::string& fileName)
+{
+  if (!m_SniffedFile.empty() && (m_SniffedFile == fileName))
+  {
+    m_SniffedFile.clear();
+    return m_SniffedDigest;
+  }
+  if (m_HashBatch != nullptr)
+    return m_HashBatch->digest(fileName);
+  return scantool::hash::computeFromFile(fileName);
+}
+
+void ScanStrategy::setJournal(RunJournal* journal) noexcept
+{
+  m_Journal = journal;
+}
+
+void ScanStrategy::setPendingScans(const PendingScans* pending) noexcept
+{
+  m_PendingScans = pending;
+}
+
+void ScanStrategy::setUploadLedger(UploadLedger* ledger, const int reuploadAfterDays) noexcept
+{
+  m_UploadLedger = ledger;
+  m_ReuploadAfterDays = reuploadAfterDays;
+}
+
+void ScanStrategy::setUploadOutbox(UploadOutbox* outbox) noexcept
+{
+  m_UploadOutbox = outbox;
+}
+
+void ScanStrategy::setScanAddedHandler(ScanAddedHandler handler)
+{
+  m_ScanAdded = std::move(handler);
+}
+
+void ScanStrategy::journalVerdict(const std::string& fileName, const SHA256::MessageDigest& digest,
+                                  const ScannerV2::Report& report)
+{
+  if ((m_Journal == nullptr) || !m_ArchiveEntries.empty() || m_FileExtracted)
+    return;
+  scantool::hash::FileStatus status{};
+  if (scantool::hash::FileStatus::get(fileName, status))
+    m_Journal->record(fileName, status, digest, report);
+}
+
 void ScanStrategy::addHandler(std::unique_ptr<Handler>&& handler)
 {
   m_Handlers.push_back(std::move(handler));
 }
 
+void ScanStrategy::enterArchiveEntry(const std::string& archiveFileName, const std::string& entryName)
+{
+  m_ArchiveEntries.push_back(std::make_pair(archiveFileName, entryName));
+}
+
+void ScanStrategy::leaveArchiveEntry()
+{
+  if (!m_ArchiveEntries.empty())
+    m_ArchiveEntries.pop_back();
+}
+
+QueuedScan ScanStrategy::queuedScan(const std::string& fileName, const std::string& sha256,
+                                    const int64_t size) const
+{
+  QueuedScan record;
+  record.fileName = fileName;
+  record.sha256 = sha256;
+  record.size = size;
+  if (m_ArchiveEntries.empty())
+  {
+    record.origin = fileName;
+  }
+  else
+  {
+    record.origin = m_ArchiveEntries.front().first;
+    for (const auto& entry : m_ArchiveEntries)
+    {
+      if (!record.archivePath.empty())
+        record.archivePath += "!/";
+      record.archivePath += entry.second;
+    }
+  }
+  record.extracted = m_FileExtracted;
+  record.submitted = std::chrono::system_clock::now();
+  return record;
+}
+
+bool ScanStrategy::pendingScan(const std::string& sha256, std::string& scan_id) const
+{
+  return (m_PendingScans != nullptr) && m_PendingScans->find(sha256, scan_id);
+}
+
+bool ScanStrategy::usesUploadLedger() const noexcept
+{
+  return m_UploadLedger != nullptr;
+}
+
+bool ScanStrategy::recentUpload(const std::string& sha256, UploadLedger::Entry& entry) const
+{
+  if ((m_UploadLedger == nullptr) || (m_ReuploadAfterDays <= 0)
+      || !m_UploadLedger->find(sha256, entry))
+    return false;
+  const std::time_t now = std::time(nullptr);
+  return entry.uploaded + static_cast<std::time_t>(m_ReuploadAfterDays) * 86400 > now;
+}
+
+void ScanStrategy::recordUpload(const std::string& sha256, const std::string& scan_id)
+{
+  if ((m_UploadLedger == nullptr) || sha256.empty())
+    return;
+  // Write right away, so that an interrupted run keeps its uploads.
+  if (!m_UploadLedger->record(sha256, scan_id, std::time(nullptr)) || !m_UploadLedger->flush())
+    std::cerr << "Warning: Could not record upload of file with hash " << sha256
+              << " in the upload ledger " << m_UploadLedger->fileName() << "." << std::endl;
+}
+
+bool ScanStrategy::enqueueUpload(const std::string& fileName)
+{
+  return (m_UploadOutbox != nullptr) && m_UploadOutbox->add(fileName);
+}
+
+void ScanStrategy::scanAdded(const std::string& scan_id) const
+{
+  if (m_ScanAdded)
+    m_ScanAdded(scan_id);
+}
+
+scantool::filesystem::FileFormat ScanStrategy::fileFormat(const std::string& fileName)
+{
+  m_SniffedFile.clear();
+  scantool::filesystem::FileFormat format = scantool::filesystem::FileFormat::Unknown;
+  if ((m_HashBatch != nullptr) && m_HashBatch->format(fileName, format))
+    return format;
+
+  /* Read as much as the batch would read, so that small files can be hashed
+     from the same read. */
+  const std::size_t readSize = scantool::hash::cMaxMultiBufferFileSize + 1;
+  m_Head.resize(readSize);
+  std::size_t length = 0;
+  if (!scantool::hash::readFileStart(fileName, m_Head.data(), readSize, length))
+    return format;
+  if ((length <= scantool::hash::cMaxMultiBufferFileSize)
+      && ((m_HashBatch == nullptr) || !m_HashBatch->contains(fileName)))
+  {
+    scantool::hash::Sha256 sha;
+    sha.update(m_Head.data(), length);
+    m_SniffedDigest = sha.finish();
+    m_SniffedFile = fileName;
+  }
+  return scantool::filesystem::sniffFormat(m_Head.data(), length);
+}
+
 int ScanStrategy::applyHandlers(ScannerV2& scanVT, const std::string& fileName,
               CacheManagerV2& cacheMgr, const std::string& requestCacheDirVT, const bool useRequestCache,
               const bool silent, const int maybeLimit, const int maxAgeInDays,
               const std::chrono::time_point<std::chrono::system_clock> ageLimit,
               std::map<std::string, ScannerV2::Report>& mapHashToReport,
               std::map<std::string, std::string>& mapFileToHash,
-              std::unordered_map<std::string, std::string>& queued_scans,
+              QueuedScanMap& queued_scans,
               std::chrono::time_point<std::chrono::steady_clock>& lastQueuedScanTime,
               std::vector<std::pair<std::string, int64_t> >& largeFiles,
               std::set<std::string>::size_type& processedFiles,
               std::set<std::string>::size_type& totalFiles)
 {
+  m_FileExtracted = false;
+  // Without handlers there is no need to know the format.
+  if (m_Handlers.empty())
+    return 0;
+  const scantool::filesystem::FileFormat format = fileFormat(fileName);
+  if (format == scantool::filesystem::FileFormat::Unknown)
+    return 0;
+  bool extracted = false;
   for (auto & handler : m_Handlers)
   {
+    if (handler->format() != format)
+      continue;
     const int rc = handler->handle(*this, scanVT, fileName, cacheMgr, requestCacheDirVT,
         useRequestCache, silent, maybeLimit, maxAgeInDays, ageLimit,
         mapHashToReport, mapFileToHash, queued_scans, lastQueuedScanTime,
         largeFiles, processedFiles, totalFiles);
     if (rc != 0)
       return rc;
+    extracted = true;
   }
+  // Scans of the entries have reset the flag, so set it after all handlers.
+  m_FileExtracted = extracted;
   // All handlers are done.
   return 0;
 }
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2016, 2025  Dirk Stolle
+    Copyright (C) 2016, 2025, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -21,10 +21,19 @@
 #ifndef SCANTOOL_VT_SCANSTRATEGY_HPP
 #define SCANTOOL_VT_SCANSTRATEGY_HPP
 
-#include <unordered_map>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "../filesystem/FileFormat.hpp"
 #include "../virustotal/CacheManagerV2.hpp"
+#include "../virustotal/FreshnessPolicy.hpp"
+#include "../virustotal/PendingScans.hpp"
 #include "../virustotal/ScannerV2.hpp"
+#include "../virustotal/UploadLedger.hpp"
 #include "Handler.hpp"
+#include "HashBatch.hpp"
+#include "RunJournal.hpp"
+#include "UploadOutbox.hpp"
 
 namespace scantool::virustotal
 {
@@ -55,7 +64,7 @@ class ScanStrategy
      * \param ageLimit      time point for rescans (older reports trigger rescans)
      * \param mapHashToReport  maps SHA256 hashes to corresponding report; key = SHA256 hash, value = scan report
      * \param mapFileToHash    maps filename to hash; key = file name, value = SHA256 hash
-     * \param queuedScans      list of queued scan requests; key = scan_id, value = file name
+     * \param queuedScans      list of queued scan requests; key = scan_id, value = queued scan record
      * \param lastQueuedScanTime time point of the last queued scan - will be updated by this method for every scan
      * \param largeFiles       list of files that exceed the file size for scans; first = file name, second = file size in octets
      * \param processedFiles   number of files that have been processed so far
@@ -69,13 +78,77 @@ class ScanStrategy
               const std::chrono::time_point<std::chrono::system_clock> ageLimit,
               std::map<std::string, ScannerV2::Report>& mapHashToReport,
               std::map<std::string, std::string>& mapFileToHash,
-              std::unordered_map<std::string, std::string>& queued_scans,
+              QueuedScanMap& queued_scans,
               std::chrono::time_point<std::chrono::steady_clock>& lastQueuedScanTime,
               std::vector<std::pair<std::string, int64_t> >& largeFiles,
               std::set<std::string>::size_type& processedFiles,
               std::set<std::string>::size_type& totalFiles) = 0;
 
 
+    /** \brief Sets the policy that decides whether a report is outdated.
+     *
+     * \param policy  the freshness policy, or nullptr to treat all reports
+     *                older than the age limit passed to scan() as outdated;
+     *                the policy must outlive the strategy
+     */
+    void setFreshnessPolicy(const FreshnessPolicy* policy) noexcept;
+
+
+    /** \brief Sets the batch that provides the digests of files.
+     *
+     * \param batch  the hash batch, or nullptr to hash each file on its own;
+     *               the batch must outlive the strategy
+     */
+    void setHashBatch(HashBatch* batch) noexcept;
+
+
+    /** \brief Sets the journal that records the verdicts of scanned files.
+     *
+     * \param journal  the run journal, or nullptr for none; the journal
+     *                  must outlive the strategy
+     */
+    void setJournal(RunJournal* journal) noexcept;
+
+
+    /** \brief Sets the list of scans that were submitted by earlier runs.
+     *
+     * \param pending  the list of pending scans, or nullptr for none; the
+     *                 list must outlive the strategy
+     * \remarks Files with a pending scan are not uploaded again, instead
+     *          the report of the earlier scan is retrieved.
+     */
+    void setPendingScans(const PendingScans* pending) noexcept;
+
+
+    /** \brief Sets the ledger of files that were uploaded before.
+     *
+     * \param ledger  the upload ledger, or nullptr for none; the ledger must
+     *                outlive the strategy
+     * \param reuploadAfterDays  number of days after which a file may be
+     *                uploaded again; zero means that files are always uploaded
+     * \remarks Strategies that upload files without asking for a report
+     *          first skip files that were uploaded within the interval.
+     */
+    void setUploadLedger(UploadLedger* ledger, const int reuploadAfterDays) noexcept;
+
+
+    /** \brief Sets the outbox that gets files instead of uploading them.
+     *
+     * \param outbox  the upload outbox, or nullptr to upload files directly;
+     *                the outbox must outlive the strategy
+     * \remarks Only the scan-and-forget strategy uses the outbox.
+     */
+    void setUploadOutbox(UploadOutbox* outbox) noexcept;
+
+
+    /** \brief Sets the function that is told about every new queued scan.
+     *
+     * \param handler  the function, e.g. to schedule the polls of the scan;
+     *                 may be empty
+     */
+    void setScanAddedHandler(ScanAddedHandler handler);
+
+
     /** \brief adds a new handler object to the strategy
      *
      * \param handler   the new handler
@@ -83,7 +156,25 @@ class ScanStrategy
     void addHandler(std::unique_ptr<Handler>&& handler);
 
 
-    /** \brief applies all handlers to the given file
+    /** \brief Notes that the following scans are for an entry of an archive.
+     *
+     * Handlers call this before they scan an extracted entry, so that queued
+     * scans can name the archive entry instead of the temporary file.
+     * \param archiveFileName  name of the archive file on disk
+     * \param entryName        name of the entry within the archive
+     */
+    void enterArchiveEntry(const std::string& archiveFileName, const std::string& entryName);
+
+
+    /** \brief Notes that the scan of the current archive entry is done.
+     */
+    void leaveArchiveEntry();
+
+
+    /** \brief applies the handlers for the format of the given file
+     *
+     * The format is detected once from the start of the file, which is
+     * usually already read to compute the digest of the file.
      *
      * \param scanVT    the scanner that shall be used to scan the file
      * \param fileName  name of the file that shall be scanned
@@ -96,7 +187,7 @@ class ScanStrategy
      * \param ageLimit      time point for rescans (older reports trigger rescans)
      * \param mapHashToReport  maps SHA256 hashes to corresponding report; key = SHA256 hash, value = scan report
      * \param mapFileToHash    maps filename to hash; key = file name, value = SHA256 hash
-     * \param queuedScans      list of queued scan requests; key = scan_id, value = file name
+     * \param queuedScans      list of queued scan requests; key = scan_id, value = queued scan record
      * \param lastQueuedScanTime time point of the last queued scan - will be updated by this method for every scan
      * \param largeFiles       list of files that exceed the file size for scans; first = file name, second = file size in octets
      * \param processedFiles   number of files that have been processed so far
@@ -110,13 +201,138 @@ class ScanStrategy
               const std::chrono::time_point<std::chrono::system_clock> ageLimit,
               std::map<std::string, ScannerV2::Report>& mapHashToReport,
               std::map<std::string, std::string>& mapFileToHash,
-              std::unordered_map<std::string, std::string>& queued_scans,
+              QueuedScanMap& queued_scans,
               std::chrono::time_point<std::chrono::steady_clock>& lastQueuedScanTime,
               std::vector<std::pair<std::string, int64_t> >& largeFiles,
               std::set<std::string>::size_type& processedFiles,
               std::set<std::string>::size_type& totalFiles);
+  protected:
+    /** \brief Checks whether a report is outdated.
+     *
+     * \param report    the report
+     * \param ageLimit  time point for rescans, used if no policy is set
+     * \return Returns true, if the report is outdated.
+     */
+    bool isOutdated(const ScannerV2::Report& report,
+                    const std::chrono::time_point<std::chrono::system_clock> ageLimit) const;
+
+
+    /** \brief Gets the maximum age in days that applies to a report.
+     *
+     * \param report        the report
+     * \param maxAgeInDays  maximum age, used if no policy is set
+     * \return Returns the maximum age of the report in days.
+     */
+    int maxAgeFor(const ScannerV2::Report& report, const int maxAgeInDays) const noexcept;
+
+
+    /** \brief Gets the SHA-256 digest of a file.
+     *
+     * \param fileName  name of the file
+     * \return Returns the digest of the file. Returns a null digest, if the
+     *         file could not be read.
+     */
+    SHA256::MessageDigest fileDigest(const std::string& fileName);
+
+
+    /** \brief Records the verdict of a file in the run journal, if any.
+     *
+     * \param fileName  name of the file
+     * \param digest    digest of the file
+     * \param report    the retrieved report of the file
+     * \remarks Entries of archives and archives whose entries were scanned
+     *          are not recorded, because the verdict of the file alone does
+     *          not cover the verdicts of the entries.
+     */
+    void journalVerdict(const std::string& fileName, const SHA256::MessageDigest& digest,
+                        const ScannerV2::Report& report);
+
+
+    /** \brief Creates the record for a scan that is queued for later retrieval.
+     *
+     * \param fileName  name of the scanned file
+     * \param sha256    SHA-256 hash of the file as hexadecimal string
+     * \param size      size of the file in octets, or -1 if unknown
+     * \return Returns the record, including the archive entry that is
+     *         currently scanned, if any.
+     */
+    QueuedScan queuedScan(const std::string& fileName, const std::string& sha256,
+                          const int64_t size) const;
+
+
+    /** \brief Finds a scan of a file that was submitted by an earlier run.
+     *
+     * \param sha256   SHA-256 hash of the file as hexadecimal string
+     * \param scan_id  variable that will hold the ID of the scan
+     * \return Returns true, if a scan of the file is still pending.
+     */
+    bool pendingScan(const std::string& sha256, std::string& scan_id) const;
+
+
+    /** \brief Checks whether an upload ledger is set.
+     *
+     * \return Returns true, if uploads are recorded in a ledger.
+     */
+    bool usesUploadLedger() const noexcept;
+
+
+    /** \brief Finds an upload of a file within the re-upload interval.
+     *
+     * \param sha256  SHA-256 hash of the file as hexadecimal string
+     * \param entry   variable that will hold the data of the upload
+     * \return Returns true, if the file shall not be uploaded again.
+     */
+    bool recentUpload(const std::string& sha256, UploadLedger::Entry& entry) const;
+
+
+    /** \brief Records an upload in the upload ledger, if any.
+     *
+     * \param sha256   SHA-256 hash of the uploaded file as hexadecimal string
+     * \param scan_id  ID of the requested scan
+     */
+    void recordUpload(const std::string& sha256, const std::string& scan_id);
+
+
+    /** \brief Adds a file to the upload outbox, if any.
+     *
+     * \param fileName  name of the file
+     * \return Returns true, if the file was added to the outbox.
+     *         Returns false, if the file has to be uploaded directly.
+     */
+    bool enqueueUpload(const std::string& fileName);
+
+
+    /** \brief Tells the handler, if any, about a new record in the queued
+     *         scans or rescans.
+     *
+     * \param scan_id  ID of the scan of the new record
+     */
+    void scanAdded(const std::string& scan_id) const;
   private:
+    /** \brief Detects the format of a file.
+     *
+     * \param fileName  name of the file
+     * \return Returns the format of the file.
+     * \remarks If the file is small enough to be read completely, its digest
+     *          is computed from the same read and kept for fileDigest().
+     */
+    scantool::filesystem::FileFormat fileFormat(const std::string& fileName);
+
+
     std::vector<std::unique_ptr<Handler> > m_Handlers; /**< list of active handlers */
+    const FreshnessPolicy* m_Freshness; /**< freshness policy, may be nullptr */
+    HashBatch* m_HashBatch; /**< provider of file digests, may be nullptr */
+    std::vector<std::pair<std::string, std::string> > m_ArchiveEntries; /**< archive entries that are currently scanned; first = archive file, second = entry name */
+    RunJournal* m_Journal; /**< journal of verdicts, may be nullptr */
+    const PendingScans* m_PendingScans; /**< scans of earlier runs, may be nullptr */
+    UploadLedger* m_UploadLedger; /**< uploads of earlier runs, may be nullptr */
+    int m_ReuploadAfterDays; /**< days after which files are uploaded again, zero for always */
+    UploadOutbox* m_UploadOutbox; /**< outbox for uploads, may be nullptr */
+    ScanAddedHandler m_ScanAdded; /**< gets new queued scans, may be empty */
+    bool m_FileExtracted; /**< whether handlers extracted the last file passed to applyHandlers() */
+    std::vector<uint8_t> m_Head; /**< buffer for the start of files whose format is detected */
+    std::string m_SniffedFile; /**< name of the last file that was read completely by fileFormat(), if its digest was not requested yet */
+    SHA256::MessageDigest m_SniffedDigest; /**< digest of m_SniffedFile */
 }; // class
 
 } // namespace
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2015, 2016, 2017, 2025  Dirk Stolle
+    Copyright (C) 2015, 2016, 2017, 2025, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -21,7 +21,6 @@
 #include "ScanStrategyDefault.hpp"
 #include <iostream>
 #include "../../libstriezel/filesystem/file.hpp"
-#include "../../libstriezel/hash/sha256/FileSourceUtility.hpp"
 #include "../../libstriezel/hash/sha256/sha256.hpp"
 #include "../ReturnCodes.hpp"
 
@@ -29,9 +28,20 @@ namespace scantool::virustotal
 {
 
 ScanStrategyDefault::ScanStrategyDefault()
-: ScanStrategy()
+: ScanStrategy(),
+  m_Revalidation(nullptr),
+  m_Rescans(nullptr)
 {
-  //empty
+}
+
+void ScanStrategyDefault::setRevalidationQueue(RevalidationQueue* queue) noexcept
+{
+  m_Revalidation = queue;
+}
+
+void ScanStrategyDefault::setPendingRescans(QueuedScanMap* rescans) noexcept
+{
+  m_Rescans = rescans;
 }
 
 int ScanStrategyDefault::scan(ScannerV2& scanVT, const std::string& fileName,
@@ -40,7 +50,7 @@ int ScanStrategyDefault::scan(ScannerV2& scanVT, const std::string& fileName,
               const std::chrono::time_point<std::chrono::system_clock> ageLimit,
               std::map<std::string, ScannerV2::Report>& mapHashToReport,
               std::map<std::string, std::string>& mapFileToHash,
-              std::unordered_map<std::string, std::string>& queued_scans,
+              QueuedScanMap& queued_scans,
               std::chrono::time_point<std::chrono::steady_clock>& lastQueuedScanTime,
               std::vector<std::pair<std::string, int64_t> >& largeFiles,
               std::set<std::string>::size_type& processedFiles,
@@ -54,9 +64,16 @@ int ScanStrategyDefault::scan(ScannerV2& scanVT, const std::string& fileName,
   if (handlerCode != 0)
     return handlerCode;
   // go on with normal strategy
-  const SHA256::MessageDigest fileHash = SHA256::computeFromFile(fileName);
+  const SHA256::MessageDigest fileHash = fileDigest(fileName);
   if (fileHash.isNull())
   {
+    // Files from lists are not checked for existence in advance.
+    if (!libstriezel::filesystem::file::exists(fileName))
+    {
+      std::cout << "Warning: File " << fileName << " does not exist, skipping it."
+                << std::endl;
+      return 0;
+    }
     std::cout << "Error: Could not determine SHA256 hash of " << fileName
               << "!" << std::endl;
     return scantool::rcFileError;
@@ -91,10 +108,20 @@ int ScanStrategyDefault::scan(ScannerV2& scanVT, const std::string& fileName,
         mapFileToHash[fileName] = hashString;
         mapHashToReport[hashString] = report;
       } //else (file is probably infected)
+      //remember verdict for incremental scans
+      journalVerdict(fileName, fileHash, report);
 
       //check, if rescan is required because of age
-      if (report.hasTime_t()
-          && (std::chrono::system_clock::from_time_t(report.scan_date_t) < ageLimit))
+      if (isOutdated(report, ageLimit) && (m_Revalidation != nullptr))
+      {
+        // The verdict above stays as it is, rescan happens later.
+        if (m_Revalidation->add(hashString, fileName) && !silent)
+          std::clog << "Info: Report for " << fileName << " is from "
+                    << report.scan_date << " and thus it is older than "
+                    << maxAgeFor(report, maxAgeInDays) << " days. It will be revalidated later."
+                    << std::endl;
+      } // if outdated report shall be revalidated later
+      else if (isOutdated(report, ageLimit))
       {
         std::string scan_id = "";
         if (!scanVT.rescan(hashString, scan_id))
@@ -106,9 +133,16 @@ int ScanStrategyDefault::scan(ScannerV2& scanVT, const std::string& fileName,
         if (!silent)
           std::clog << "Info: " << fileName << " was queued for re-scan, because "
                     << "report is from " << report.scan_date
-                    << " and thus it is older than " << maxAgeInDays
+                    << " and thus it is older than " << maxAgeFor(report, maxAgeInDays)
                     << " days. Scan ID for retrieval is " << scan_id
                     << "." << std::endl;
+        // The report of the rescan is polled later.
+        if (m_Rescans != nullptr)
+        {
+          m_Rescans->emplace(scan_id, queuedScan(fileName, hashString,
+              libstriezel::filesystem::file::getSize64(fileName)));
+          scanAdded(scan_id);
+        }
         /* Delete a possibly existing cached entry for that file, because
            it is now potentially outdated, as soon as the next request for
            that report is performed. */
@@ -122,19 +156,31 @@ int ScanStrategyDefault::scan(ScannerV2& scanVT, const std::string& fileName,
       if ((fileSize <= scanVT.maxScanSize()) && (fileSize >= 0))
       {
         std::string scan_id = "";
-        if (!scanVT.scan(fileName, scan_id))
+        // An earlier run may have submitted the file already.
+        if (pendingScan(hashString, scan_id))
         {
-          std::cerr << "Error: Could not submit file " << fileName
-                    << " for scanning." << std::endl;
-          return scantool::rcScanError;
+          if (!silent)
+            std::clog << "Info: File " << fileName << " was already queued for scan "
+                      << "by an earlier run. Scan ID is " << scan_id << "." << std::endl;
+        }
+        else
+        {
+          if (!scanVT.scan(fileName, scan_id))
+          {
+            std::cerr << "Error: Could not submit file " << fileName
+                      << " for scanning." << std::endl;
+            return scantool::rcScanError;
+          }
+          //remember time of last scan request
+          lastQueuedScanTime = std::chrono::steady_clock::now();
+          recordUpload(hashString, scan_id);
+          if (!silent)
+            std::clog << "Info: File " << fileName << " was queued for scan. Scan ID is "
+                      << scan_id << "." << std::endl;
         }
-        //remember time of last scan request
-        lastQueuedScanTime = std::chrono::steady_clock::now();
         //add scan ID to list of queued scans for later retrieval
-        queued_scans[scan_id] = fileName;
-        if (!silent)
-          std::clog << "Info: File " << fileName << " was queued for scan. Scan ID is "
-                    << scan_id << "." << std::endl;
+        queued_scans.emplace(scan_id, queuedScan(fileName, hashString, fileSize));
+        scanAdded(scan_id);
         //delete previous report, because it contains no relevant data
         cacheMgr.deleteCachedElement(hashString);
       } //if file size is below limit
@@ -156,7 +202,9 @@ int ScanStrategyDefault::scan(ScannerV2& scanVT, const std::string& fileName,
       if (!silent)
         std::cout << "Info: File " << fileName << " is still in the scan "
                   << "queue and will be queued for later retrieval." << std::endl;
-      queued_scans[hashString] = fileName;
+      queued_scans.emplace(hashString, queuedScan(fileName, hashString,
+          libstriezel::filesystem::file::getSize64(fileName)));
+      scanAdded(hashString);
     } //if file is still in queue
     else
     {
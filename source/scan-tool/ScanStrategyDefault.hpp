@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2016, 2025  Dirk Stolle
+    Copyright (C) 2016, 2025, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -21,6 +21,7 @@
 #ifndef SCANTOOL_VT_SCANSTRATEGYDEFAULT_HPP
 #define SCANTOOL_VT_SCANSTRATEGYDEFAULT_HPP
 
+#include "RevalidationQueue.hpp"
 #include "ScanStrategy.hpp"
 
 namespace scantool::virustotal
@@ -35,6 +36,26 @@ class ScanStrategyDefault: public ScanStrategy
     ScanStrategyDefault();
 
 
+    /** \brief Sets the queue for files with outdated reports.
+     *
+     * \param queue  the revalidation queue, or nullptr to request rescans of
+     *               outdated reports immediately (default); the queue must
+     *               outlive the strategy
+     * \remarks If a queue is set, the verdict of an outdated report is used
+     *          as it is and the rescan is left to the queue.
+     */
+    void setRevalidationQueue(RevalidationQueue* queue) noexcept;
+
+
+    /** \brief Sets the list that keeps the scans of immediate rescans.
+     *
+     * \param rescans  list of rescans whose reports are still pending, or
+     *                 nullptr to forget the scan IDs of rescans (default);
+     *                 the list must outlive the strategy
+     */
+    void setPendingRescans(QueuedScanMap* rescans) noexcept;
+
+
     /** \brief scan a given file using the default strategy
      *
      * \param scanVT    the scanner that shall be used to scan the file
@@ -48,7 +69,7 @@ class ScanStrategyDefault: public ScanStrategy
      * \param ageLimit      time point for rescans (older reports trigger rescans)
      * \param mapHashToReport  maps SHA256 hashes to corresponding report; key = SHA256 hash, value = scan report
      * \param mapFileToHash    maps filename to hash; key = file name, value = SHA256 hash
-     * \param queuedScans      list of queued scan requests; key = scan_id, value = file name
+     * \param queuedScans      list of queued scan requests; key = scan_id, value = queued scan record
      * \param lastQueuedScanTime time point of the last queued scan - will be updated by this method for every scan
      * \param largeFiles       list of files that exceed the file size for scans; first = file name, second = file size in octets
      * \param processedFiles   number of files that have been processed so far
@@ -62,11 +83,14 @@ class ScanStrategyDefault: public ScanStrategy
               const std::chrono::time_point<std::chrono::system_clock> ageLimit,
               std::map<std::string, ScannerV2::Report>& mapHashToReport,
               std::map<std::string, std::string>& mapFileToHash,
-              std::unordered_map<std::string, std::string>& queued_scans,
+              QueuedScanMap& queued_scans,
               std::chrono::time_point<std::chrono::steady_clock>& lastQueuedScanTime,
               std::vector<std::pair<std::string, int64_t> >& largeFiles,
               std::set<std::string>::size_type& processedFiles,
               std::set<std::string>::size_type& totalFiles) override;
+  private:
+    RevalidationQueue* m_Revalidation; /**< queue for outdated reports, may be nullptr */
+    QueuedScanMap* m_Rescans; /**< rescans whose reports are pending, may be nullptr */
 }; // class
 
 } //namespace
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2016, 2025  Dirk Stolle
+    Copyright (C) 2016, 2025, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -40,7 +40,7 @@ int ScanStrategyDirectScan::scan(ScannerV2& scanVT, const std::string& fileName,
               const std::chrono::time_point<std::chrono::system_clock> ageLimit,
               std::map<std::string, ScannerV2::Report>& mapHashToReport,
               std::map<std::string, std::string>& mapFileToHash,
-              std::unordered_map<std::string, std::string>& queued_scans,
+              QueuedScanMap& queued_scans,
               std::chrono::time_point<std::chrono::steady_clock>& lastQueuedScanTime,
               std::vector<std::pair<std::string, int64_t> >& largeFiles,
               std::set<std::string>::size_type& processedFiles,
@@ -60,8 +60,30 @@ int ScanStrategyDirectScan::scan(ScannerV2& scanVT, const std::string& fileName,
      scans have been added to the list of queued scans.
    */
   const int64_t fileSize = libstriezel::filesystem::file::getSize64(fileName);
+  // Files from lists are not checked for existence in advance.
+  if ((fileSize < 0) && !libstriezel::filesystem::file::exists(fileName))
+  {
+    std::cout << "Warning: File " << fileName << " does not exist, skipping it."
+              << std::endl;
+    return 0;
+  }
   if ((fileSize <= scanVT.maxScanSize()) && (fileSize >= 0))
   {
+    /* Hash the file while it still exists, because files extracted from
+       archives are gone when the report is retrieved. */
+    const SHA256::MessageDigest fileHash = fileDigest(fileName);
+    const std::string hashString = fileHash.isNull() ? std::string() : fileHash.toHexString();
+    // Files that were uploaded recently get the report of the earlier scan.
+    UploadLedger::Entry upload;
+    if (!hashString.empty() && recentUpload(hashString, upload))
+    {
+      queued_scans.emplace(upload.scan_id, queuedScan(fileName, hashString, fileSize));
+      scanAdded(upload.scan_id);
+      if (!silent)
+        std::clog << "Info: File " << fileName << " was already uploaded by an "
+                  << "earlier run. Scan ID is " << upload.scan_id << "." << std::endl;
+      return 0;
+    }
     std::string scan_id = "";
     if (!scanVT.scan(fileName, scan_id))
     {
@@ -71,8 +93,10 @@ int ScanStrategyDirectScan::scan(ScannerV2& scanVT, const std::string& fileName,
     }
     //remember time of last scan request
     lastQueuedScanTime = std::chrono::steady_clock::now();
+    recordUpload(hashString, scan_id);
     //add scan ID to list of queued scans for later retrieval
-    queued_scans[scan_id] = fileName;
+    queued_scans.emplace(scan_id, queuedScan(fileName, hashString, fileSize));
+    scanAdded(scan_id);
     if (!silent)
       std::clog << "Info: File " << fileName << " was queued for scan. Scan ID is "
                 << scan_id << "." << std::endl;
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2015, 2016, 2017, 2025  Dirk Stolle
+    Copyright (C) 2015, 2016, 2017, 2025, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -21,7 +21,6 @@
 #include "ScanStrategyNoRescan.hpp"
 #include <iostream>
 #include "../../libstriezel/filesystem/file.hpp"
-#include "../../libstriezel/hash/sha256/FileSourceUtility.hpp"
 #include "../../libstriezel/hash/sha256/sha256.hpp"
 #include "../ReturnCodes.hpp"
 
@@ -40,7 +39,7 @@ int ScanStrategyNoRescan::scan(ScannerV2& scanVT, const std::string& fileName,
               const std::chrono::time_point<std::chrono::system_clock> ageLimit,
               std::map<std::string, ScannerV2::Report>& mapHashToReport,
               std::map<std::string, std::string>& mapFileToHash,
-              std::unordered_map<std::string, std::string>& queued_scans,
+              QueuedScanMap& queued_scans,
               std::chrono::time_point<std::chrono::steady_clock>& lastQueuedScanTime,
               std::vector<std::pair<std::string, int64_t> >& largeFiles,
               std::set<std::string>::size_type& processedFiles,
@@ -54,9 +53,16 @@ int ScanStrategyNoRescan::scan(ScannerV2& scanVT, const std::string& fileName,
   if (handlerCode != 0)
     return handlerCode;
   //go on with no-rescan strategy
-  const SHA256::MessageDigest fileHash = SHA256::computeFromFile(fileName);
+  const SHA256::MessageDigest fileHash = fileDigest(fileName);
   if (fileHash.isNull())
   {
+    // Files from lists are not checked for existence in advance.
+    if (!libstriezel::filesystem::file::exists(fileName))
+    {
+      std::cout << "Warning: File " << fileName << " does not exist, skipping it."
+                << std::endl;
+      return 0;
+    }
     std::cout << "Error: Could not determine SHA256 hash of " << fileName
               << "!" << std::endl;
     return scantool::rcFileError;
@@ -65,6 +71,23 @@ int ScanStrategyNoRescan::scan(ScannerV2& scanVT, const std::string& fileName,
   scantool::virustotal::ScannerV2::Report report;
   if (scanVT.getReport(hashString, report, useRequestCache, requestCacheDirVT))
   {
+    /* No rescans are requested here, but an outdated cached report may still
+       be replaced by the latest report that VirusTotal has for the file. */
+    if (useRequestCache && report.successfulRetrieval()
+        && isOutdated(report, ageLimit))
+    {
+      scantool::virustotal::ScannerV2::Report latest;
+      if (scanVT.getReport(hashString, latest, false, requestCacheDirVT)
+          && latest.successfulRetrieval())
+      {
+        if (!silent)
+          std::clog << "Info: Cached report for " << fileName << " was older than "
+                    << maxAgeFor(report, maxAgeInDays) << " days and has been "
+                    << "replaced by the latest report from " << latest.scan_date
+                    << "." << std::endl;
+        report = latest;
+      }
+    } // if cached report is outdated
     if (report.successfulRetrieval())
     {
       //got report
@@ -91,6 +114,8 @@ int ScanStrategyNoRescan::scan(ScannerV2& scanVT, const std::string& fileName,
         mapFileToHash[fileName] = hashString;
         mapHashToReport[hashString] = report;
       } //else (file is probably infected)
+      //remember verdict for incremental scans
+      journalVerdict(fileName, fileHash, report);
     } //if file was in report database
     else if (report.notFound())
     {
@@ -99,19 +124,31 @@ int ScanStrategyNoRescan::scan(ScannerV2& scanVT, const std::string& fileName,
       if ((fileSize <= scanVT.maxScanSize()) && (fileSize >= 0))
       {
         std::string scan_id = "";
-        if (!scanVT.scan(fileName, scan_id))
+        // An earlier run may have submitted the file already.
+        if (pendingScan(hashString, scan_id))
+        {
+          if (!silent)
+            std::clog << "Info: File " << fileName << " was already queued for scan "
+                      << "by an earlier run. Scan ID is " << scan_id << "." << std::endl;
+        }
+        else
         {
-          std::cerr << "Error: Could not submit file " << fileName
-                    << " for scanning." << std::endl;
-          return scantool::rcScanError;
+          if (!scanVT.scan(fileName, scan_id))
+          {
+            std::cerr << "Error: Could not submit file " << fileName
+                      << " for scanning." << std::endl;
+            return scantool::rcScanError;
+          }
+          //remember time of last scan request
+          lastQueuedScanTime = std::chrono::steady_clock::now();
+          recordUpload(hashString, scan_id);
+          if (!silent)
+            std::clog << "Info: File " << fileName << " was queued for scan. Scan ID is "
+                      << scan_id << "." << std::endl;
         }
-        //remember time of last scan request
-        lastQueuedScanTime = std::chrono::steady_clock::now();
         //add scan ID to list of queued scans for later retrieval
-        queued_scans[scan_id] = fileName;
-        if (!silent)
-          std::clog << "Info: File " << fileName << " was queued for scan. Scan ID is "
-                    << scan_id << "." << std::endl;
+        queued_scans.emplace(scan_id, queuedScan(fileName, hashString, fileSize));
+        scanAdded(scan_id);
         //delete previous report, because it contains no relevant data
         cacheMgr.deleteCachedElement(hashString);
       } //if file size is below limit
@@ -133,7 +170,9 @@ int ScanStrategyNoRescan::scan(ScannerV2& scanVT, const std::string& fileName,
       if (!silent)
         std::cout << "Info: File " << fileName << " is still in the scan "
                   << "queue and will be queued for later retrieval." << std::endl;
-      queued_scans[hashString] = fileName;
+      queued_scans.emplace(hashString, queuedScan(fileName, hashString,
+          libstriezel::filesystem::file::getSize64(fileName)));
+      scanAdded(hashString);
     } //if file is still in queue
     else
     {
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2017, 2025  Dirk Stolle
+    Copyright (C) 2017, 2025, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -40,12 +40,20 @@ int ScanStrategyScanAndForget::scan(ScannerV2& scanVT, const std::string& fileNa
               const std::chrono::time_point<std::chrono::system_clock> ageLimit,
               std::map<std::string, ScannerV2::Report>& mapHashToReport,
               std::map<std::string, std::string>& mapFileToHash,
-              std::unordered_map<std::string, std::string>& queued_scans,
+              QueuedScanMap& queued_scans,
               std::chrono::time_point<std::chrono::steady_clock>& lastQueuedScanTime,
               std::vector<std::pair<std::string, int64_t> >& largeFiles,
               std::set<std::string>::size_type& processedFiles,
               std::set<std::string>::size_type& totalFiles)
 {
+  /* With an outbox, the file is only put into the outbox. The process that
+     drains the outbox applies the handlers and uploads the file later. */
+  if (enqueueUpload(fileName))
+  {
+    if (!silent)
+      std::clog << "Info: File " << fileName << " was put into the upload outbox." << std::endl;
+    return 0;
+  }
   //apply any handlers
   const int handlerCode = applyHandlers(scanVT, fileName, cacheMgr, requestCacheDirVT,
       useRequestCache, silent, maybeLimit, maxAgeInDays, ageLimit, mapHashToReport,
@@ -60,8 +68,32 @@ int ScanStrategyScanAndForget::scan(ScannerV2& scanVT, const std::string& fileNa
      afterwards by the main program.
    */
   const int64_t fileSize = libstriezel::filesystem::file::getSize64(fileName);
+  // Files from lists are not checked for existence in advance.
+  if ((fileSize < 0) && !libstriezel::filesystem::file::exists(fileName))
+  {
+    std::cout << "Warning: File " << fileName << " does not exist, skipping it."
+              << std::endl;
+    return 0;
+  }
   if ((fileSize <= scanVT.maxScanSize()) && (fileSize >= 0))
   {
+    /* Files that were uploaded recently are not uploaded again. Only the
+       ledger needs the digest, so files are not hashed without it. */
+    std::string hashString = "";
+    if (usesUploadLedger())
+    {
+      const SHA256::MessageDigest fileHash = fileDigest(fileName);
+      if (!fileHash.isNull())
+        hashString = fileHash.toHexString();
+      UploadLedger::Entry upload;
+      if (!hashString.empty() && recentUpload(hashString, upload))
+      {
+        if (!silent)
+          std::clog << "Info: File " << fileName << " was already uploaded by an "
+                    << "earlier run. Scan ID is " << upload.scan_id << "." << std::endl;
+        return 0;
+      }
+    }
     std::string scan_id = "";
     if (!scanVT.scan(fileName, scan_id))
     {
@@ -71,6 +103,7 @@ int ScanStrategyScanAndForget::scan(ScannerV2& scanVT, const std::string& fileNa
     }
     //remember time of last scan request
     lastQueuedScanTime = std::chrono::steady_clock::now();
+    recordUpload(hashString, scan_id);
     if (!silent)
       std::clog << "Info: File " << fileName << " was queued for scan. Scan ID is "
                 << scan_id << "." << std::endl;
@@ -0,0 +1,200 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "ServiceBackend.hpp"
+#include <iostream>
+#include "../hash/Sha256.hpp"
+#include "../virustotal/CacheManagerV2.hpp"
+#include "../../libstriezel/filesystem/file.hpp"
+#include "../../libstriezel/hash/sha256/sha256.hpp"
+
+namespace scantool::virustotal
+{
+
+ServiceBackend::ServiceBackend(ScannerV2& scanVT, const FreshnessPolicy& freshness,
+                               scantool::hash::HashCache* hashCache, const CacheWriter* cacheWriter,
+                               const std::string& requestCacheDirVT, const bool useRequestCache,
+                               const bool silent,
+                               std::map<std::string, ScannerV2::Report>& mapHashToReport,
+                               std::map<std::string, std::string>& mapFileToHash,
+                               std::set<std::string>::size_type& processedFiles,
+                               std::set<std::string>::size_type& totalFiles)
+: m_Scanner(scanVT),
+  m_Freshness(freshness),
+  m_HashCache(hashCache),
+  m_CacheWriter(cacheWriter),
+  m_RequestCacheDir(requestCacheDirVT),
+  m_UseRequestCache(useRequestCache),
+  m_Silent(silent),
+  m_HashToReport(mapHashToReport),
+  m_FileToHash(mapFileToHash),
+  m_ProcessedFiles(processedFiles),
+  m_TotalFiles(totalFiles)
+{
+}
+
+void ServiceBackend::recordInfection(const std::string& fileName, const std::string& digest,
+                                     const ScannerV2::Report& report)
+{
+  if (report.positives <= 0)
+    return;
+  // add file to list of infected files
+  m_FileToHash[fileName] = digest;
+  m_HashToReport[digest] = report;
+}
+
+bool ServiceBackend::resolve(ServiceRequest& request, ServiceReply& reply)
+{
+  ++m_TotalFiles;
+  if (request.command == ServiceRequest::Command::Lookup)
+  {
+    request.digest = request.argument;
+  }
+  else
+  {
+    scantool::hash::FileStatus status{};
+    SHA256::MessageDigest digest;
+    if (!libstriezel::filesystem::file::exists(request.argument)
+        || !scantool::hash::FileStatus::get(request.argument, status))
+    {
+      reply.reason = "no-file";
+      ++m_ProcessedFiles;
+      return true;
+    }
+    if ((m_HashCache == nullptr) || !m_HashCache->lookup(request.argument, status, digest))
+    {
+      digest = scantool::hash::computeFromFile(request.argument);
+      if (!digest.isNull() && (m_HashCache != nullptr))
+      {
+        m_HashCache->store(request.argument, status, digest);
+        m_HashCache->flush();
+      }
+    }
+    if (digest.isNull())
+    {
+      reply.reason = "hash";
+      ++m_ProcessedFiles;
+      return true;
+    }
+    request.digest = digest.toHexString();
+  }
+  reply.digest = request.digest;
+  // Fresh reports from the request cache are used without waiting.
+  if (!m_UseRequestCache)
+    return false;
+  const std::string cachedFile = CacheManagerV2::getPathForCachedElement(
+      request.digest, m_RequestCacheDir);
+  std::string pending;
+  if (cachedFile.empty() || (!libstriezel::filesystem::file::exists(cachedFile)
+      && ((m_CacheWriter == nullptr) || !m_CacheWriter->pendingContent(cachedFile, pending))))
+    return false;
+  ScannerV2::Report report;
+  if (!m_Scanner.getReport(request.digest, report, true, m_RequestCacheDir)
+      || !report.successfulRetrieval() || m_Freshness.isOutdated(report))
+    return false;
+  reply.status = ServiceReply::Status::Report;
+  reply.positives = report.positives;
+  reply.total = report.total;
+  recordInfection(request.argument, request.digest, report);
+  ++m_ProcessedFiles;
+  return true;
+}
+
+ServiceReply ServiceBackend::handle(const ServiceRequest& request)
+{
+  ServiceReply reply;
+  reply.digest = request.digest;
+  ++m_ProcessedFiles;
+  ScannerV2::Report report;
+  if (!m_Scanner.getReport(request.digest, report, false, m_RequestCacheDir))
+  {
+    reply.reason = "request";
+    return reply;
+  }
+  if (report.successfulRetrieval())
+  {
+    reply.status = ServiceReply::Status::Report;
+    reply.positives = report.positives;
+    reply.total = report.total;
+    recordInfection(request.argument, request.digest, report);
+    return reply;
+  }
+  if (report.stillInQueue())
+  {
+    // The hash serves as scan ID for files that are already queued.
+    reply.status = ServiceReply::Status::Queued;
+    reply.scanId = request.digest;
+    return reply;
+  }
+  if (!report.notFound())
+  {
+    reply.reason = "response";
+    return reply;
+  }
+  if (request.command == ServiceRequest::Command::Lookup)
+  {
+    reply.status = ServiceReply::Status::Unknown;
+    return reply;
+  }
+  const int64_t fileSize = libstriezel::filesystem::file::getSize64(request.argument);
+  if (fileSize < 0)
+  {
+    reply.reason = "no-file";
+    return reply;
+  }
+  if (fileSize > m_Scanner.maxScanSize())
+  {
+    reply.reason = "too-large";
+    return reply;
+  }
+  std::string scan_id = "";
+  if (!m_Scanner.scan(request.argument, scan_id))
+  {
+    reply.reason = "upload";
+    return reply;
+  }
+  reply.status = ServiceReply::Status::Queued;
+  reply.scanId = scan_id;
+  if (!m_Silent)
+    std::clog << "Info: File " << request.argument << " was queued for scan. Scan ID is "
+              << scan_id << "." << std::endl;
+  return reply;
+}
+
+std::chrono::milliseconds ServiceBackend::delay() const
+{
+  if (!m_Scanner.honoursTimeLimit())
+    return std::chrono::milliseconds(0);
+  const auto next = m_Scanner.lastHashLookupTime() + m_Scanner.timeBetweenConsecutiveHashLookups();
+  const auto now = std::chrono::steady_clock::now();
+  if (next <= now)
+    return std::chrono::milliseconds(0);
+  return std::chrono::duration_cast<std::chrono::milliseconds>(next - now) + std::chrono::milliseconds(1);
+}
+
+ScanService ServiceBackend::makeService(const std::string& socketPath)
+{
+  return ScanService(socketPath,
+      [this](ServiceRequest& request, ServiceReply& reply) { return resolve(request, reply); },
+      [this](const ServiceRequest& request) { return handle(request); },
+      [this]() { return delay(); });
+}
+
+} // namespace
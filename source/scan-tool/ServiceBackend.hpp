@@ -0,0 +1,133 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_VT_SERVICEBACKEND_HPP
+#define SCANTOOL_VT_SERVICEBACKEND_HPP
+
+#include <chrono>
+#include <map>
+#include <set>
+#include <string>
+#include "ScanService.hpp"
+#include "../hash/HashCache.hpp"
+#include "../virustotal/CacheWriter.hpp"
+#include "../virustotal/FreshnessPolicy.hpp"
+#include "../virustotal/ScannerV2.hpp"
+
+namespace scantool::virustotal
+{
+
+/** \brief Answers the requests of a scan service with the request cache
+ *         and VirusTotal.
+ *
+ * The results of all requests are collected like those of a normal scan,
+ * so they show up in the summary when the service is stopped.
+ */
+class ServiceBackend
+{
+  public:
+    /** \brief Constructor.
+     *
+     * \param scanVT             scanner for requests to VirusTotal
+     * \param freshness          policy that decides whether a cached report is outdated
+     * \param hashCache          persistent digest cache, may be nullptr
+     * \param cacheWriter        background writer of the request cache, may be nullptr
+     * \param requestCacheDirVT  directory of the request cache
+     * \param useRequestCache    whether the request cache answers requests
+     * \param silent             whether output will be reduced
+     * \param mapHashToReport    map that maps SHA256 hashes to corresponding report; key = SHA256 hash, value = scan report
+     * \param mapFileToHash      map that maps filename to hash; key = file name, value = SHA256 hash
+     * \param processedFiles     number of handled requests
+     * \param totalFiles         number of received requests
+     */
+    ServiceBackend(ScannerV2& scanVT, const FreshnessPolicy& freshness,
+                   scantool::hash::HashCache* hashCache, const CacheWriter* cacheWriter,
+                   const std::string& requestCacheDirVT, const bool useRequestCache,
+                   const bool silent,
+                   std::map<std::string, ScannerV2::Report>& mapHashToReport,
+                   std::map<std::string, std::string>& mapFileToHash,
+                   std::set<std::string>::size_type& processedFiles,
+                   std::set<std::string>::size_type& totalFiles);
+
+
+    ServiceBackend(const ServiceBackend& other) = delete;
+    ServiceBackend& operator=(const ServiceBackend& other) = delete;
+
+
+    /** \brief Answers a request with a fresh report from the request cache.
+     *
+     * \param request  the request, gets the digest of the file
+     * \param reply    the reply to fill
+     * \return Returns true, if the reply is complete.
+     *         Returns false, if the request needs VirusTotal.
+     */
+    bool resolve(ServiceRequest& request, ServiceReply& reply);
+
+
+    /** \brief Answers a request with the help of VirusTotal, and uploads
+     *         unknown files.
+     *
+     * \param request  the request, with the digest set by resolve()
+     * \return Returns the reply to the request.
+     */
+    ServiceReply handle(const ServiceRequest& request);
+
+
+    /** \brief Gets the time until the rate limit allows the next request.
+     *
+     * \return Returns the time to wait, or zero if a request can be sent now.
+     */
+    std::chrono::milliseconds delay() const;
+
+
+    /** \brief Creates a scan service that uses this backend.
+     *
+     * \param socketPath  path of the socket of the service
+     * \return Returns the scan service. The backend must outlive it.
+     */
+    ScanService makeService(const std::string& socketPath);
+  private:
+    /** \brief Adds the report of a file to the list of infected files, if it
+     *         has any positives.
+     *
+     * \param fileName  name of the file
+     * \param digest    SHA-256 hash of the file
+     * \param report    the report
+     */
+    void recordInfection(const std::string& fileName, const std::string& digest,
+                         const ScannerV2::Report& report);
+
+
+    ScannerV2& m_Scanner; /**< scanner for requests to VirusTotal */
+    const FreshnessPolicy& m_Freshness; /**< decides whether cached reports are outdated */
+    scantool::hash::HashCache* m_HashCache; /**< persistent digest cache, may be nullptr */
+    const CacheWriter* m_CacheWriter; /**< writer of the request cache, may be nullptr */
+    std::string m_RequestCacheDir; /**< directory of the request cache */
+    bool m_UseRequestCache; /**< whether the request cache answers requests */
+    bool m_Silent; /**< whether output will be reduced */
+    std::map<std::string, ScannerV2::Report>& m_HashToReport; /**< reports of infected files by hash */
+    std::map<std::string, std::string>& m_FileToHash; /**< hashes of infected files by name */
+    std::set<std::string>::size_type& m_ProcessedFiles; /**< number of handled requests */
+    std::set<std::string>::size_type& m_TotalFiles; /**< number of received requests */
+}; // class
+
+} // namespace
+
+#endif // SCANTOOL_VT_SERVICEBACKEND_HPP
@@ -0,0 +1,132 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "ServiceClient.hpp"
+#include <algorithm>
+#if defined(__linux__)
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace scantool::virustotal
+{
+
+ServiceClient::ServiceClient()
+: m_Fd(-1),
+  m_Input(std::string())
+{
+}
+
+ServiceClient::~ServiceClient()
+{
+  #if defined(__linux__)
+  if (m_Fd >= 0)
+    close(m_Fd);
+  #endif
+}
+
+bool ServiceClient::connect(const std::string& socketPath)
+{
+  #if defined(__linux__)
+  if (m_Fd >= 0)
+    return false;
+  struct sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (socketPath.empty() || (socketPath.size() >= sizeof(address.sun_path)))
+    return false;
+  std::copy(socketPath.begin(), socketPath.end(), address.sun_path);
+  const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0)
+    return false;
+  if (::connect(fd, reinterpret_cast<const struct sockaddr*>(&address), sizeof(address)) != 0)
+  {
+    close(fd);
+    return false;
+  }
+  m_Fd = fd;
+  return true;
+  #else
+  (void) socketPath;
+  return false;
+  #endif
+}
+
+bool ServiceClient::send(const ServiceRequest& request)
+{
+  #if defined(__linux__)
+  if ((m_Fd < 0) || (request.argument.find('\n') != std::string::npos))
+    return false;
+  const std::string line = request.toLine() + "\n";
+  std::string::size_type offset = 0;
+  while (offset < line.size())
+  {
+    const ssize_t length = ::send(m_Fd, line.data() + offset, line.size() - offset, MSG_NOSIGNAL);
+    if (length > 0)
+      offset += length;
+    else if ((length < 0) && (errno == EINTR))
+      continue;
+    else
+      return false;
+  }
+  return true;
+  #else
+  (void) request;
+  return false;
+  #endif
+}
+
+bool ServiceClient::finish()
+{
+  #if defined(__linux__)
+  return (m_Fd >= 0) && (shutdown(m_Fd, SHUT_WR) == 0);
+  #else
+  return false;
+  #endif
+}
+
+bool ServiceClient::receive(ServiceReply& reply)
+{
+  #if defined(__linux__)
+  if (m_Fd < 0)
+    return false;
+  std::string::size_type end;
+  while ((end = m_Input.find('\n')) == std::string::npos)
+  {
+    char buffer[4096];
+    const ssize_t length = recv(m_Fd, buffer, sizeof(buffer), 0);
+    if (length > 0)
+      m_Input.append(buffer, length);
+    else if ((length < 0) && (errno == EINTR))
+      continue;
+    else
+      return false;
+  }
+  const std::string line = m_Input.substr(0, end);
+  m_Input.erase(0, end + 1);
+  return ServiceReply::parse(line, reply);
+  #else
+  (void) reply;
+  return false;
+  #endif
+}
+
+} // namespace
@@ -0,0 +1,91 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_VT_SERVICECLIENT_HPP
+#define SCANTOOL_VT_SERVICECLIENT_HPP
+
+#include <string>
+#include "ServiceProtocol.hpp"
+
+namespace scantool::virustotal
+{
+
+/** \brief Client that sends requests to a scan service.
+ *
+ * Requests can be sent in a row before the replies are received. The
+ * service answers requests in the order it handles them, which is not
+ * necessarily the order of the requests.
+ */
+class ServiceClient
+{
+  public:
+    /** \brief Default constructor.
+     */
+    ServiceClient();
+
+
+    /** \brief Destructor, closes the connection.
+     */
+    ~ServiceClient();
+
+
+    ServiceClient(const ServiceClient& other) = delete;
+    ServiceClient& operator=(const ServiceClient& other) = delete;
+
+
+    /** \brief Connects to a scan service.
+     *
+     * \param socketPath  path of the socket of the service
+     * \return Returns true, if the connection was established.
+     */
+    bool connect(const std::string& socketPath);
+
+
+    /** \brief Sends a request to the service.
+     *
+     * \param request  the request
+     * \return Returns true, if the request was sent.
+     */
+    bool send(const ServiceRequest& request);
+
+
+    /** \brief Tells the service that no more requests will be sent.
+     *
+     * \return Returns true, if the service was told.
+     */
+    bool finish();
+
+
+    /** \brief Waits for the next reply of the service.
+     *
+     * \param reply  variable that will hold the reply
+     * \return Returns true, if a reply was received.
+     *         Returns false, if the connection was closed or failed, or if
+     *         the reply was malformed.
+     */
+    bool receive(ServiceReply& reply);
+  private:
+    int m_Fd; /**< socket of the connection, or -1 */
+    std::string m_Input; /**< received data that is not a complete line yet */
+}; // class
+
+} // namespace
+
+#endif // SCANTOOL_VT_SERVICECLIENT_HPP
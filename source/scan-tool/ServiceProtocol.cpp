@@ -0,0 +1,189 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "ServiceProtocol.hpp"
+#include <charconv>
+#include <vector>
+
+namespace scantool::virustotal
+{
+
+/** \brief Splits a line into a number of words and the rest of the line.
+ *
+ * \param line   the line
+ * \param count  number of words before the rest
+ * \param words  vector that will hold the words
+ * \param rest   string that will hold the rest of the line after the words
+ * \return Returns true, if the line has enough words and a non-empty rest.
+ */
+static bool splitLine(const std::string& line, const std::size_t count,
+                      std::vector<std::string>& words, std::string& rest)
+{
+  words.clear();
+  std::string::size_type start = 0;
+  while (words.size() < count)
+  {
+    const auto space = line.find(' ', start);
+    if ((space == std::string::npos) || (space == start))
+      return false;
+    words.push_back(line.substr(start, space - start));
+    start = space + 1;
+  }
+  rest = line.substr(start);
+  return !rest.empty() && (rest.find('\n') == std::string::npos);
+}
+
+/** \brief Checks whether a string is a hexadecimal MD5, SHA-1 or SHA-256 hash.
+ *
+ * \param hash  the string
+ * \return Returns true, if the string looks like a hash.
+ */
+static bool isHash(const std::string& hash)
+{
+  if ((hash.size() != 32) && (hash.size() != 40) && (hash.size() != 64))
+    return false;
+  return hash.find_first_not_of("0123456789abcdefABCDEF") == std::string::npos;
+}
+
+/** \brief Parses a non-negative integer.
+ *
+ * \param text   the text
+ * \param value  variable that will hold the value
+ * \return Returns true, if the text is a non-negative integer.
+ */
+static bool parseCount(const std::string& text, int& value)
+{
+  const char* end = text.data() + text.size();
+  const auto result = std::from_chars(text.data(), end, value);
+  return (result.ec == std::errc()) && (result.ptr == end) && (value >= 0);
+}
+
+ServiceRequest::ServiceRequest()
+: lane(Lane::Interactive),
+  command(Command::Scan),
+  argument(std::string()),
+  digest(std::string()),
+  client(-1)
+{
+}
+
+std::string ServiceRequest::toLine() const
+{
+  return std::string(lane == Lane::Bulk ? "bulk" : "interactive")
+       + (command == Command::Lookup ? " lookup " : " scan ") + argument;
+}
+
+bool ServiceRequest::parse(const std::string& line, ServiceRequest& request)
+{
+  std::vector<std::string> words;
+  std::string rest;
+  if (!splitLine(line, 2, words, rest))
+    return false;
+  if (words[0] == "interactive")
+    request.lane = Lane::Interactive;
+  else if (words[0] == "bulk")
+    request.lane = Lane::Bulk;
+  else
+    return false;
+  if (words[1] == "scan")
+    request.command = Command::Scan;
+  else if ((words[1] == "lookup") && isHash(rest))
+    request.command = Command::Lookup;
+  else
+    return false;
+  request.argument = rest;
+  request.digest.clear();
+  return true;
+}
+
+ServiceReply::ServiceReply()
+: status(Status::Error),
+  digest(std::string()),
+  positives(0),
+  total(0),
+  scanId(std::string()),
+  reason(std::string()),
+  argument(std::string())
+{
+}
+
+std::string ServiceReply::toLine() const
+{
+  switch (status)
+  {
+    case Status::Report:
+         return "report " + digest + " " + std::to_string(positives) + " "
+              + std::to_string(total) + " " + argument;
+    case Status::Queued:
+         return "queued " + digest + " " + scanId + " " + argument;
+    case Status::Unknown:
+         return "unknown " + digest + " " + argument;
+    case Status::Error:
+    default:
+         return "error " + (reason.empty() ? std::string("unspecified") : reason) + " " + argument;
+  }
+}
+
+bool ServiceReply::parse(const std::string& line, ServiceReply& reply)
+{
+  std::vector<std::string> words;
+  std::string rest;
+  const auto space = line.find(' ');
+  if (space == std::string::npos)
+    return false;
+  const std::string kind = line.substr(0, space);
+  reply = ServiceReply();
+  if (kind == "report")
+  {
+    if (!splitLine(line, 4, words, rest) || !isHash(words[1])
+        || !parseCount(words[2], reply.positives) || !parseCount(words[3], reply.total))
+      return false;
+    reply.status = Status::Report;
+    reply.digest = words[1];
+  }
+  else if (kind == "queued")
+  {
+    if (!splitLine(line, 3, words, rest) || !isHash(words[1]))
+      return false;
+    reply.status = Status::Queued;
+    reply.digest = words[1];
+    reply.scanId = words[2];
+  }
+  else if (kind == "unknown")
+  {
+    if (!splitLine(line, 2, words, rest) || !isHash(words[1]))
+      return false;
+    reply.status = Status::Unknown;
+    reply.digest = words[1];
+  }
+  else if (kind == "error")
+  {
+    if (!splitLine(line, 2, words, rest))
+      return false;
+    reply.status = Status::Error;
+    reply.reason = words[1];
+  }
+  else
+    return false;
+  reply.argument = rest;
+  return true;
+}
+
+} // namespace
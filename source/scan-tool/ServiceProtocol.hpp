@@ -0,0 +1,138 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_VT_SERVICEPROTOCOL_HPP
+#define SCANTOOL_VT_SERVICEPROTOCOL_HPP
+
+#include <string>
+
+namespace scantool::virustotal
+{
+
+/// priority lane of a request to the scan service
+enum class Lane
+{
+  Interactive, /**< requests that someone is waiting for, handled first */
+  Bulk /**< requests that are only handled when no interactive ones wait */
+};
+
+
+/** \brief Request to the scan service.
+ *
+ * Requests are sent as single lines of the form "<lane> <command> <argument>",
+ * e.g. "interactive scan /home/user/file.exe" or "bulk lookup <SHA-256>".
+ * The argument is the rest of the line, so file names may contain spaces.
+ */
+struct ServiceRequest
+{
+  /// kind of request
+  enum class Command
+  {
+    Scan, /**< get the report of a file, upload it if it is unknown */
+    Lookup /**< get the report of a hash, never upload anything */
+  };
+
+
+  /** \brief Default constructor, creates an interactive scan request.
+   */
+  ServiceRequest();
+
+
+  /** \brief Formats the request as line for the protocol.
+   *
+   * \return Returns the line without the terminating line feed.
+   */
+  std::string toLine() const;
+
+
+  /** \brief Parses a request line.
+   *
+   * \param line     the line without the terminating line feed
+   * \param request  variable that will hold the parsed request
+   * \return Returns true, if the line is a valid request.
+   *         Returns false otherwise.
+   */
+  static bool parse(const std::string& line, ServiceRequest& request);
+
+
+  Lane lane; /**< priority lane of the request */
+  Command command; /**< kind of request */
+  std::string argument; /**< file name for scans, hash for lookups */
+  std::string digest; /**< SHA-256 hash of the file, set by the service */
+  int client; /**< connection the request came from, set by the service */
+}; // struct
+
+
+/** \brief Reply of the scan service.
+ *
+ * Replies are sent as single lines. They end with the argument of the
+ * request, so clients can match replies to requests:
+ *
+ *     report <SHA-256> <positives> <total> <argument>
+ *     queued <SHA-256> <scan ID> <argument>
+ *     unknown <hash> <argument>
+ *     error <reason> <argument>
+ */
+struct ServiceReply
+{
+  /// kind of reply
+  enum class Status
+  {
+    Report, /**< a report is available */
+    Queued, /**< the file was uploaded and waits for its scan */
+    Unknown, /**< there is no report for the hash */
+    Error /**< the request could not be handled */
+  };
+
+
+  /** \brief Default constructor, creates an error reply.
+   */
+  ServiceReply();
+
+
+  /** \brief Formats the reply as line for the protocol.
+   *
+   * \return Returns the line without the terminating line feed.
+   */
+  std::string toLine() const;
+
+
+  /** \brief Parses a reply line.
+   *
+   * \param line   the line without the terminating line feed
+   * \param reply  variable that will hold the parsed reply
+   * \return Returns true, if the line is a valid reply.
+   *         Returns false otherwise.
+   */
+  static bool parse(const std::string& line, ServiceReply& reply);
+
+
+  Status status; /**< kind of reply */
+  std::string digest; /**< hash of the file, if status is not Error */
+  int positives; /**< number of engines that detected a threat, for reports */
+  int total; /**< total number of engines, for reports */
+  std::string scanId; /**< scan ID, for queued files */
+  std::string reason; /**< single word that describes the error, for errors */
+  std::string argument; /**< argument of the request */
+}; // struct
+
+} // namespace
+
+#endif // SCANTOOL_VT_SERVICEPROTOCOL_HPP
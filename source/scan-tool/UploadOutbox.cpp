@@ -0,0 +1,232 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "UploadOutbox.hpp"
+#if defined(__linux__)
+#include <cstdlib>
+#endif
+
+namespace scantool::virustotal
+{
+
+const unsigned int UploadOutbox::cMaximumAttempts = 3;
+
+UploadOutbox::UploadOutbox(const std::string& fileName)
+: m_File(fileName, true),
+  m_Order(std::deque<std::pair<std::string, uint64_t> >()),
+  m_Queued(std::unordered_map<std::string, uint64_t>()),
+  m_Failures(std::unordered_map<std::string, unsigned int>()),
+  m_Additions(0),
+  m_Pending(std::string())
+{
+}
+
+const std::string& UploadOutbox::fileName() const noexcept
+{
+  return m_File.fileName();
+}
+
+bool UploadOutbox::load()
+{
+  m_Order.clear();
+  m_Queued.clear();
+  m_Failures.clear();
+  m_Additions = 0;
+  m_Pending.clear();
+  return m_File.read([this](const std::string& line)
+  {
+    if (line.empty() || (line[0] == '#') || (line.size() <= 2) || (line[1] != ' '))
+      return;
+    const std::string name = line.substr(2);
+    if (line[0] == '+')
+    {
+      // Adding a parked file again gives it new attempts.
+      if (enqueue(name))
+        m_Failures.erase(name);
+    }
+    else if (line[0] == '-')
+    {
+      m_Queued.erase(name);
+      m_Failures.erase(name);
+    }
+    else if (line[0] == '!')
+    {
+      countFailure(name);
+    }
+  });
+}
+
+bool UploadOutbox::add(const std::string& name)
+{
+  if (name.empty() || (name.find_first_of("\r\n") != std::string::npos))
+    return false;
+  std::string path = name;
+  #if defined(__linux__)
+  char* resolved = realpath(name.c_str(), nullptr);
+  if (resolved != nullptr)
+  {
+    path = std::string(resolved);
+    free(resolved);
+  }
+  #endif
+  if (enqueue(path))
+  {
+    m_Failures.erase(path);
+    m_Pending.append("+ ").append(path).append("\n");
+  }
+  return true;
+}
+
+bool UploadOutbox::enqueue(const std::string& name)
+{
+  if (!m_Queued.insert(std::make_pair(name, m_Additions)).second)
+    return false;
+  m_Order.push_back(std::make_pair(name, m_Additions));
+  ++m_Additions;
+  return true;
+}
+
+bool UploadOutbox::next(std::string& name)
+{
+  // Files that are done are only dropped from the order when they are met.
+  while (!m_Order.empty())
+  {
+    const auto iter = m_Queued.find(m_Order.front().first);
+    if ((iter != m_Queued.end()) && (iter->second == m_Order.front().second))
+    {
+      name = m_Order.front().first;
+      return true;
+    }
+    m_Order.pop_front();
+  } // while
+  return false;
+}
+
+void UploadOutbox::done(const std::string& name)
+{
+  if (m_Queued.erase(name) > 0)
+  {
+    m_Failures.erase(name);
+    m_Pending.append("- ").append(name).append("\n");
+  }
+}
+
+bool UploadOutbox::failed(const std::string& name)
+{
+  if (m_Queued.find(name) == m_Queued.end())
+    return false;
+  m_Pending.append("! ").append(name).append("\n");
+  return countFailure(name);
+}
+
+bool UploadOutbox::countFailure(const std::string& name)
+{
+  if (m_Queued.erase(name) == 0)
+    return false;
+  // The old position in the order is skipped by next(), like done files.
+  if (++m_Failures[name] >= cMaximumAttempts)
+    return false;
+  return enqueue(name);
+}
+
+std::size_t UploadOutbox::parked() const noexcept
+{
+  std::size_t count = 0;
+  for (const auto& entry : m_Failures)
+  {
+    if (entry.second >= cMaximumAttempts)
+      ++count;
+  }
+  return count;
+}
+
+bool UploadOutbox::empty() const noexcept
+{
+  return m_Queued.empty();
+}
+
+std::size_t UploadOutbox::size() const noexcept
+{
+  return m_Queued.size();
+}
+
+bool UploadOutbox::flush()
+{
+  if (!m_File.append(m_Pending))
+    return false;
+  m_Pending.clear();
+  return true;
+}
+
+bool UploadOutbox::compact()
+{
+  // Producers must not append while the file is replaced.
+  if (!flush() || !m_File.lock())
+    return false;
+  const bool success = rewrite();
+  m_File.unlock();
+  return success;
+}
+
+bool UploadOutbox::rewrite()
+{
+  // Other processes may have added or uploaded files in the meantime.
+  if (!load())
+    return false;
+  // Rewriting is only worth it, if most of the lines are obsolete.
+  if (!m_File.worthRewriting(m_Queued.size() + m_Failures.size(), 100))
+    return true;
+
+  // Each failed upload keeps its line, so that the attempts are not reset.
+  const auto appendFailures = [this](std::string& content, const std::string& name)
+  {
+    const auto iter = m_Failures.find(name);
+    if (iter == m_Failures.end())
+      return;
+    for (unsigned int i = 0; i < iter->second; ++i)
+    {
+      content.append("! ").append(name).append("\n");
+    }
+  };
+  std::string content = "# scan-tool upload outbox\n";
+  for (const auto& entry : m_Failures)
+  {
+    if (entry.second >= cMaximumAttempts)
+    {
+      content.append("+ ").append(entry.first).append("\n");
+      appendFailures(content, entry.first);
+    }
+  }
+  std::deque<std::pair<std::string, uint64_t> > order;
+  for (const auto& entry : m_Order)
+  {
+    const auto iter = m_Queued.find(entry.first);
+    if ((iter != m_Queued.end()) && (iter->second == entry.second))
+    {
+      content.append("+ ").append(entry.first).append("\n");
+      appendFailures(content, entry.first);
+      order.push_back(entry);
+    }
+  }
+  m_Order = std::move(order);
+  return m_File.rewrite(content);
+}
+
+} // namespace
@@ -0,0 +1,197 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_VT_UPLOADOUTBOX_HPP
+#define SCANTOOL_VT_UPLOADOUTBOX_HPP
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include "../filesystem/AppendOnlyFile.hpp"
+
+namespace scantool::virustotal
+{
+
+/** \brief Durable queue of files that wait for their upload to VirusTotal.
+ *
+ * Producers only append the names of the files to the outbox, which is much
+ * faster than the upload itself. A separate process drains the outbox and
+ * uploads the files at the rate that the API key allows.
+ *
+ * The outbox is a text file where new lines are appended to. Lines that
+ * start with "+ " add a file, and lines that start with "- " remove a file
+ * after its upload. A file stays in the outbox until its upload is done, so
+ * a crash of the drainer does not lose queued files. Lines that start with
+ * "! " note a failed upload, which moves the file to the end of the queue.
+ * After cMaximumAttempts failed uploads the file is parked: it stays in the
+ * outbox file, but it is not uploaded again until a producer adds it anew. On Linux, every write is
+ * synchronized to disk before it returns, and writers lock the file, so that
+ * several producers and the drainer can use the same outbox at once.
+ */
+class UploadOutbox
+{
+  public:
+    /** \brief Constructor.
+     *
+     * \param fileName  path of the outbox file
+     */
+    explicit UploadOutbox(const std::string& fileName);
+
+
+    /// number of failed uploads after which a file is parked
+    static const unsigned int cMaximumAttempts;
+
+
+    /** \brief Gets the path of the outbox file.
+     *
+     * \return Returns the path of the outbox file.
+     */
+    const std::string& fileName() const noexcept;
+
+
+    /** \brief Loads the queued files from the outbox file.
+     *
+     * \return Returns true, if the outbox was loaded or did not exist.
+     *         Returns false, if the outbox file could not be read.
+     * \remarks Malformed lines are skipped, and so is an incomplete last
+     *          line that may contain a truncated name. Changes that were not
+     *          written yet are lost.
+     */
+    bool load();
+
+
+    /** \brief Adds a file to the outbox.
+     *
+     * \param name  name of the file; relative names are made absolute, so
+     *              the drainer may run in another directory
+     * \return Returns true, if the file is queued in the outbox now.
+     *         Returns false, if the name cannot be stored, e.g. because it
+     *         contains a line break.
+     * \remarks Call flush() to write the new entry to the file.
+     */
+    bool add(const std::string& name);
+
+
+    /** \brief Gets the file that was queued first.
+     *
+     * \param name  variable that will hold the name of the file
+     * \return Returns true, if a file is queued.
+     *         Returns false, if the outbox is empty.
+     */
+    bool next(std::string& name);
+
+
+    /** \brief Removes a file whose upload is done.
+     *
+     * \param name  name of the file, as returned by next()
+     * \remarks Call flush() to write the change to the file.
+     */
+    void done(const std::string& name);
+
+
+    /** \brief Notes a failed upload of a file.
+     *
+     * \param name  name of the file, as returned by next()
+     * \return Returns true, if the file was moved to the end of the queue.
+     *         Returns false, if the file is parked now, because its upload
+     *         failed too often.
+     * \remarks Call flush() to write the change to the file.
+     */
+    bool failed(const std::string& name);
+
+
+    /** \brief Gets the number of parked files, i.e. files whose upload
+     *         failed too often.
+     *
+     * \return Returns the number of parked files.
+     */
+    std::size_t parked() const noexcept;
+
+
+    /** \brief Checks whether no files are queued.
+     *
+     * \return Returns true, if no files are queued.
+     */
+    bool empty() const noexcept;
+
+
+    /** \brief Gets the number of queued files.
+     *
+     * \return Returns the number of queued files.
+     */
+    std::size_t size() const noexcept;
+
+
+    /** \brief Appends the changes to the outbox file and waits until they
+     *         are on the disk.
+     *
+     * \return Returns true, if all changes were written.
+     */
+    bool flush();
+
+
+    /** \brief Reloads the outbox, so that files of other processes are kept,
+     *         and rewrites the outbox file without the uploaded files, if
+     *         there are many of them.
+     *
+     * \return Returns true, if the outbox file is compact or was compacted.
+     *         Returns false, if the outbox file could not be rewritten.
+     */
+    bool compact();
+  private:
+    /** \brief Reloads the outbox and rewrites the outbox file, if many of
+     *         its lines are obsolete.
+     *
+     * \return Returns true, if the outbox file is compact or was compacted.
+     * \remarks The caller has to hold the lock of the outbox file.
+     */
+    bool rewrite();
+
+
+    /** \brief Queues a file without recording the change.
+     *
+     * \param name  name of the file
+     * \return Returns true, if the file was not queued before.
+     */
+    bool enqueue(const std::string& name);
+
+
+    /** \brief Counts a failed upload without recording the change.
+     *
+     * \param name  name of the file
+     * \return Returns true, if the file was moved to the end of the queue.
+     *         Returns false, if the file was not queued or is parked now.
+     */
+    bool countFailure(const std::string& name);
+
+
+    scantool::filesystem::AppendOnlyFile m_File; /**< the outbox file */
+    std::deque<std::pair<std::string, uint64_t> > m_Order; /**< files in order of their addition; first = name, second = number of the addition */
+    std::unordered_map<std::string, uint64_t> m_Queued; /**< files that are still queued; key = name, value = number of the addition */
+    std::unordered_map<std::string, unsigned int> m_Failures; /**< failed uploads of queued and parked files; key = name, value = number of failures */
+    uint64_t m_Additions; /**< number of additions so far */
+    std::string m_Pending; /**< lines of changes that were not written yet */
+}; // class
+
+} // namespace
+
+#endif // SCANTOOL_VT_UPLOADOUTBOX_HPP
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2015, 2016, 2017, 2021  Dirk Stolle
+    Copyright (C) 2015, 2016, 2017, 2021, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -18,18 +18,20 @@
  -------------------------------------------------------------------------------
 */
 
+#include <csignal> //for std::sig_atomic_t
 #include <cstdlib> //for std::exit()
+#include <ctime>
 #include <fstream>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <thread> //for sleep functionality
-#if defined(__linux__) || defined(linux)
-#include <csignal>
-#elif defined(_WIN32)
+#if defined(_WIN32)
 #include <Windows.h>
 #endif
+#include "Checkpoint.hpp"
 #include "Handler7z.hpp"
 #include "HandlerAr.hpp"
 #include "HandlerCab.hpp"
@@ -39,22 +41,41 @@
 #include "HandlerRar.hpp"
 #include "HandlerTar.hpp"
 #include "HandlerXz.hpp"
+#include "RevalidationQueue.hpp"
+#include "RunJournal.hpp"
+#include "ScanPoller.hpp"
+#include "ScanService.hpp"
 #include "Strategies.hpp"
 #include "ScanStrategyDefault.hpp"
 #include "ScanStrategyDirectScan.hpp"
 #include "ScanStrategyNoRescan.hpp"
 #include "ScanStrategyScanAndForget.hpp"
+#include "ServiceBackend.hpp"
+#include "serviceScan.hpp"
 #include "summary.hpp"
+#include "UploadOutbox.hpp"
 #include "Version.hpp"
 #include "ZipHandler.hpp"
 #include "../Configuration.hpp"
+#include "../filesystem/DirectoryWalker.hpp"
+#include "../filesystem/DirectoryWatcher.hpp"
+#include "../filesystem/ListReader.hpp"
+#include "../filesystem/PathSet.hpp"
 #include "../Curly.hpp"
+#include "../hash/FileReader.hpp"
+#include "../hash/HashCache.hpp"
+#include "../hash/Manifest.hpp"
+#include "../hash/Sha256.hpp"
+#include "../hash/Shard.hpp"
 #include "../virustotal/CacheManagerV2.hpp"
+#include "../virustotal/CacheWriter.hpp"
+#include "../virustotal/PendingScans.hpp"
+#include "../virustotal/QuotaLease.hpp"
 #include "../virustotal/ScannerV2.hpp"
+#include "../virustotal/UploadLedger.hpp"
 #include "../../libstriezel/common/StringUtils.hpp"
 #include "../../libstriezel/filesystem/file.hpp"
 #include "../../libstriezel/filesystem/directory.hpp"
-#include "../../libstriezel/hash/sha256/FileSourceUtility.hpp"
 #include "../../libstriezel/hash/sha256/sha256.hpp"
 #include "../Constants.hpp"
 #include "../ReturnCodes.hpp"
@@ -78,12 +99,100 @@ void showHelp()
             << "  FILE             - file that shall be scanned. Can be repeated multiple\n"
             << "                     times, if you want to scan several files.\n"
             << "  --list FILE      - read the files which shall be scanned from the file FILE,\n"
-            << "                     one per line.\n"
+            << "                     one per line. The list is read while the files are\n"
+            << "                     scanned, and files that do not exist are skipped when\n"
+            << "                     they are due. Use - as FILE to read the list from\n"
+            << "                     standard input.\n"
             << "  --files FILE     - same as --list FILE\n"
+            << "  --list0 FILE     - like --list FILE, but the file names in FILE are\n"
+            << "                     separated by NUL characters, as with find -print0.\n"
+            << "  --files0 FILE    - same as --list0 FILE\n"
+            << "  --recursive DIR  - scan all regular files in the directory DIR and its\n"
+            << "                     subdirectories. Can be repeated. Symbolic links are not\n"
+            << "                     followed. The scan of the first files starts while the\n"
+            << "                     directories are still searched.\n"
+            << "  --include GLOB   - only scan files from --recursive directories that match\n"
+            << "                     the pattern GLOB, e.g. \"*.exe\". Patterns without a\n"
+            << "                     slash are matched against the file name, others against\n"
+            << "                     the path relative to DIR, where ** also matches slashes.\n"
+            << "                     Can be repeated to include files matching any pattern.\n"
+            << "  --exclude GLOB   - do not scan files and do not enter directories from the\n"
+            << "                     --recursive directories that match the pattern GLOB.\n"
+            << "                     Can be repeated.\n"
+            << "  --one-file-system\n"
+            << "                   - do not enter directories on other file systems than the\n"
+            << "                     one of DIR during a --recursive scan.\n"
+            << "  --min-size N     - only scan files from --recursive directories that have a\n"
+            << "                     size of at least N octets.\n"
+            << "  --max-size N     - only scan files from --recursive directories that have a\n"
+            << "                     size of at most N octets.\n"
+            << "  --watch DIR      - keep running and scan files in the directory DIR and its\n"
+            << "                     subdirectories whenever they are written or moved there.\n"
+            << "                     Can be repeated. Existing files are not scanned, unless\n"
+            << "                     DIR is given with --recursive, too. The options\n"
+            << "                     --include, --exclude, --one-file-system, --min-size and\n"
+            << "                     --max-size apply to watched directories as well. Only\n"
+            << "                     available on Linux. Stop the program with SIGINT or\n"
+            << "                     SIGTERM.\n"
+            << "  --watch-delay N  - scan files from watched directories after they have not\n"
+            << "                     been changed for N seconds. Default is 2 seconds.\n"
+            << "  --serve SOCKET   - run as scan service that answers scan requests from\n"
+            << "                     clients on the local socket SOCKET, until the program is\n"
+            << "                     stopped with SIGINT or SIGTERM. All clients share one\n"
+            << "                     rate limit and one request cache. Only the current user\n"
+            << "                     can connect. Only available on Linux.\n"
+            << "  --connect SOCKET - let the scan service on the socket SOCKET scan the files\n"
+            << "                     given as parameters instead of scanning them directly.\n"
+            << "                     No API key is required in this case.\n"
+            << "  --bulk           - send requests to the scan service as bulk requests, which\n"
+            << "                     are only handled while no interactive requests wait.\n"
+            << "  --manifest FILE  - scan the files listed in the manifest FILE, which has\n"
+            << "                     the format of sha256sum, i.e. lines with the SHA-256\n"
+            << "                     hash, two spaces and the file name. The listed hashes\n"
+            << "                     are used instead of reading the files, so files are\n"
+            << "                     only read, if they have to be uploaded. Use - as FILE\n"
+            << "                     to read the manifest from standard input.\n"
+            << "  --shard I/N      - only scan the I-th of N slices of the given files, so\n"
+            << "                     that N nodes can scan the files together, e.g. with\n"
+            << "                     --shard 2/4 on the second of four nodes.\n"
+            << "  --shard-by WHAT  - sets how files are assigned to slices. Possible values:\n"
+            << "                     content - by the SHA-256 hash of the file's content,\n"
+            << "                               so duplicates end up in the same slice\n"
+            << "                               (default)\n"
+            << "                     path    - by a hash of the file's path as given, so\n"
+            << "                               files of other slices are not read at all\n"
+            << "  --summary-file FILE\n"
+            << "                   - write the summary into the file FILE, too, so that it\n"
+            << "                     can be merged with the summaries of other slices.\n"
+            << "  --checkpoint FILE\n"
+            << "                   - save the state of the scan into the file FILE every\n"
+            << "                     minute and when the program is terminated, so that an\n"
+            << "                     interrupted scan can be resumed with --resume FILE.\n"
+            << "                     The names of completed files go to FILE.done.\n"
+            << "  --resume FILE    - resume an interrupted scan from the state file FILE.\n"
+            << "                     Pass the same files, lists and directories as before.\n"
+            << "                     Completed files are skipped, and the reports of queued\n"
+            << "                     scans are retrieved. New checkpoints go to FILE, too.\n"
+            << "  --poll-time N    - wait up to N seconds for the reports of queued scans after\n"
+            << "                     all files have been processed. Scans that are still\n"
+            << "                     queued are polled less and less often. Default is 300\n"
+            << "                     seconds.\n"
+            << "  --merge-summary FILE\n"
+            << "                   - show the combined summary of all summary files given\n"
+            << "                     with --merge-summary and quit without scanning files.\n"
             << "  --max-age N      - specifies the maximum age for retrieved scan reports to\n"
             << "                     be N days, where N is a positive integer. Files whose\n"
             << "                     reports are older than N days will be queued for rescan.\n"
             << "                     Default value is " << cDefaultMaxAge << " days.\n"
+            << "  --max-age-clean N\n"
+            << "                   - sets the maximum age for clean reports, i.e. reports\n"
+            << "                     without positives from at least "
+            << scantool::virustotal::FreshnessPolicy::cMinimumEnginesForClean << " engines, to N days.\n"
+            << "                     Default is the value of --max-age.\n"
+            << "  --max-age-maybe N\n"
+            << "                   - sets the maximum age for reports with at least one\n"
+            << "                     positive, but not more than the limit set by --maybe, to\n"
+            << "                     N days. Default is the value of --max-age.\n"
             << "  --cache          - cache API requests locally to avoid requesting reports on\n"
             << "                     files that have been requested recently. This option is\n"
             << "                     disabled by default.\n"
@@ -92,6 +201,58 @@ void showHelp()
             << "                     cache directory is specified, the program will try to use\n"
             << "                     a preset directory (usually ~/.scan-tool/vt-cache, as in\n"
             << "                     earlier versions).\n"
+            << "  --cache-sync     - synchronize the request cache to disk after each batch\n"
+            << "                     of written reports. Reports are written to the cache in\n"
+            << "                     the background, so this only costs little time. This\n"
+            << "                     option only has an effect, if the --cache option is\n"
+            << "                     specified, too.\n"
+            << "  --hash-cache FILE\n"
+            << "                   - keep the SHA-256 digests of scanned files in the file\n"
+            << "                     FILE. Files whose size, time stamps and inode did not\n"
+            << "                     change since the last run are not read again. The file\n"
+            << "                     is created, if it does not exist.\n"
+            << "  --quota-file FILE\n"
+            << "                   - share the rate limit of the API key with other\n"
+            << "                     processes through the lease file FILE. By default, all\n"
+            << "                     processes of the user with the same API key share a\n"
+            << "                     lease file in ~/.scan-tool/.\n"
+            << "  --journal FILE   - scan incrementally and keep the verdicts of scanned files\n"
+            << "                     in the file FILE. Files that did not change since the\n"
+            << "                     last run get their verdict from FILE, unless it is\n"
+            << "                     older than the maximum age (see --max-age). The file is\n"
+            << "                     created, if it does not exist.\n"
+            << "  --pending-scans FILE\n"
+            << "                   - keep the queued scans whose reports were not retrieved\n"
+            << "                     yet in the file FILE, so that later runs do not upload\n"
+            << "                     these files again, but retrieve the reports of the\n"
+            << "                     earlier scans. Default is the file " << scantool::virustotal::PendingScans::cFileName << "\n"
+            << "                     in the cache directory, if the request cache is used.\n"
+            << "  --upload-ledger FILE\n"
+            << "                   - record the hashes of uploaded files in the file FILE.\n"
+            << "                     The strategies direct and scan-and-forget do not upload\n"
+            << "                     files again that are already in FILE, see\n"
+            << "                     --reupload-after. Default is the file " << scantool::virustotal::UploadLedger::cFileName << "\n"
+            << "                     in the cache directory, if the request cache is used.\n"
+            << "  --reupload-after N\n"
+            << "                   - upload files with the same content again after N days\n"
+            << "                     have passed since the last upload. Zero means that files\n"
+            << "                     are always uploaded. Default is 30 days.\n"
+            << "  --outbox FILE    - put the files into the upload outbox FILE instead of\n"
+            << "                     uploading them. Another process uploads them later with\n"
+            << "                     --drain-outbox FILE. Implies the scan-and-forget strategy.\n"
+            << "  --drain-outbox FILE\n"
+            << "                   - upload the files in the upload outbox FILE at the rate\n"
+            << "                     that the API key allows, including files that are put\n"
+            << "                     into the outbox in the meantime, and quit when it is\n"
+            << "                     empty. Files stay in FILE until their upload is done.\n"
+            << "                     Implies the scan-and-forget strategy.\n"
+            << "  --io-mode MODE   - sets how files are read for hashing. Possible modes are:\n"
+            << "                     cached - normal reads through the page cache (default)\n"
+            << "                     nocache - drops the read files from the page cache, so\n"
+            << "                               that scans do not push other data out of it\n"
+            << "                     direct - reads large files with direct I/O, bypassing\n"
+            << "                              the page cache, where the file system allows\n"
+            << "                              it. Otherwise like nocache.\n"
             << "  --strategy STRA  - sets the scan strategy to STRA. Possible strategies are:\n"
             << "                     default - checks for existing reports before submitting a\n"
             << "                               file for scan to VirusTotal\n"
@@ -102,6 +263,13 @@ void showHelp()
             << "                                 old reports.\n"
             << "                     scan-and-forget - only submits files for scanning to\n"
             << "                                       VirusTotal, but does not get reports.\n"
+            << "  --revalidate-later\n"
+            << "                   - use the verdict of reports that are older than the\n"
+            << "                     maximum age (see --max-age) right away and request the\n"
+            << "                     rescan later, when no requests to VirusTotal are pending.\n"
+            << "                     Rescans that are left at the end are requested by later\n"
+            << "                     runs that use the same request cache. Only has an effect\n"
+            << "                     on the default scan strategy.\n"
             << "  --zip            - add ZIP file handler which extracts ZIP files and scans\n"
             << "                     each contained file, too.\n"
             << "  --7zip | --7z    - add 7-Zip file handler which extracts 7-Zip files and\n"
@@ -135,29 +303,53 @@ void showVersion()
   std::cout << "scan-tool, " << scantool::version << std::endl;
 }
 
-/* Four variables that will be used in main() but also in signal handling
+/* Some variables that will be used in main() but also in signal handling
    function and are therefore declared as global variables. */
 //maps SHA256 hashes to corresponding report; key = SHA256 hash, value = scan report
 std::map<std::string, scantool::virustotal::ScannerV2::Report> mapHashToReport;
 //maps filename to hash; key = file name, value = SHA256 hash
 std::map<std::string, std::string> mapFileToHash = std::map<std::string, std::string>();
-//list of queued scan requests; key = scan_id, value = file name
-std::unordered_map<std::string, std::string> queued_scans = std::unordered_map<std::string, std::string>();
+//list of queued scan requests; key = scan_id, value = queued scan record
+scantool::virustotal::QueuedScanMap queued_scans = scantool::virustotal::QueuedScanMap();
 //list of files that exceed the file size for scans; first = file name, second = file size in octets
 std::vector<std::pair<std::string, int64_t> > largeFiles;
 // for statistics: total number of files
 std::set<std::string>::size_type totalFiles;
 // for statistics: number of processed files
 std::set<std::string>::size_type processedFiles;
+// background writer for the request cache, if the cache is enabled
+std::unique_ptr<scantool::virustotal::CacheWriter> cacheWriter = nullptr;
+// state of the scan for resumption, if checkpoints are enabled
+std::unique_ptr<scantool::virustotal::Checkpoint> checkpoint = nullptr;
+// outbox that gets the files instead of uploading them, if any
+std::unique_ptr<scantool::virustotal::UploadOutbox> outbox = nullptr;
+
+/* Signal handlers may only set these flags, because almost nothing else is
+   safe in a signal handler. The main thread acts on them in handleSignals(). */
+// number of the signal that requested termination, zero if there is none
+volatile std::sig_atomic_t terminationSignal = 0;
+// number of the signal that requested the statistics, zero if there is none
+volatile std::sig_atomic_t statisticsSignal = 0;
 
 #if defined(__linux__) || defined(linux)
 /** \brief signal handling function for Linux systems
  *
  * \param sig   the signal number (e.g. 15 for SIGTERM)
- * \remarks This function will not return, because it calls std::exit() at
- *          the end. std::exit() never returns.
+ * \remarks The signal is only noted here, handleSignals() acts on it.
  */
 void linux_signal_handler(int sig)
+{
+  if ((sig == SIGUSR1) || (SIGUSR2 == sig))
+    statisticsSignal = sig;
+  else
+    terminationSignal = sig;
+}
+
+/** \brief writes the name of a signal to the log
+ *
+ * \param sig   the signal number (e.g. 15 for SIGTERM)
+ */
+void logSignal(const int sig)
 {
   std::clog << "INFO: Caught signal ";
   switch (sig)
@@ -179,56 +371,77 @@ void linux_signal_handler(int sig)
         break;
   } //switch
   std::clog << "!" << std::endl;
-  if ((sig == SIGTERM) || (SIGINT == sig))
-  {
-    std::clog << "Only " << processedFiles << " out of " << totalFiles
-              << " files were processed." << std::endl;
-    //Show the summary, e.g. infected files, too large files, and unfinished
-    // queued scans, because user might want to see that despite termination.
-    showSummary(mapFileToHash, mapHashToReport, queued_scans, largeFiles);
-    std::clog << "Terminating program early due to caught signal." << std::endl;
-    std::exit(scantool::rcProgramTerminationBySignal);
-  } //if SIGINT or SIGTERM
-  else if ((sig == SIGUSR1) || (SIGUSR2 == sig))
-  {
-    std::clog << "Current statistics:" << std::endl
-              << processedFiles << " out of " << totalFiles
-              << " files were processed so far." << std::endl;
-    std::clog << "Queued for scan: " << queued_scans.size() << " item(s)." << std::endl;
-  } //else if SIGUSR1 or SIGUSR2
 }
 #elif defined(_WIN32)
 /** \brief signal handling function for Windows systems
  *
  * \param ctrlSignal   the received control signal
  * \return Returns false, if signal was not handled.
- *         Hypothetically returns true, if signal was handled, but in that
- *         case std::exit() steps in to terminate the program.
- * \remarks This function will never return true, because it calls std::exit()
- *          at the end, when a signal is handled. std::exit() never returns.
+ *         Returns true, if signal was handled.
+ * \remarks The signal is only noted here, handleSignals() acts on it.
  */
 BOOL windows_signal_handler(DWORD ctrlSignal)
 {
   switch (ctrlSignal)
   {
     case CTRL_C_EVENT:
-         std::clog << "INFO: Received Ctrl+C!";
-         std::clog << "Only " << processedFiles << " out of " << totalFiles
-                   << " files were processed." << std::endl;
-         //Show the summary, e.g. infected files, too large files, and
-         // unfinished queued scans, because user might want to see that
-         // despite termination.
-         showSummary(mapFileToHash, mapHashToReport, queued_scans, largeFiles);
-         std::clog << "Terminating program early due to caught signal."
-                   << std::endl;
-         std::exit(scantool::rcProgramTerminationBySignal);
-         return TRUE; //bogus
-         break;
+         terminationSignal = 1;
+         return TRUE;
   } //switch
   return FALSE;
 }
+
+/** \brief writes the name of a signal to the log
+ *
+ * \param sig   the noted signal
+ */
+void logSignal(const int sig)
+{
+  (void) sig;
+  std::clog << "INFO: Received Ctrl+C!" << std::endl;
+}
 #endif
 
+/** \brief acts on the signals that were noted by the signal handler
+ *
+ * \remarks This function will not return, if termination was requested,
+ *          because it calls std::exit() then. std::exit() never returns.
+ */
+void handleSignals()
+{
+  if (statisticsSignal != 0)
+  {
+    logSignal(statisticsSignal);
+    statisticsSignal = 0;
+    std::clog << "Current statistics:" << std::endl
+              << processedFiles << " out of " << totalFiles
+              << " files were processed so far." << std::endl;
+    std::clog << "Queued for scan: " << queued_scans.size() << " item(s)." << std::endl;
+  }
+  if (terminationSignal == 0)
+    return;
+  logSignal(terminationSignal);
+  std::clog << "Only " << processedFiles << " out of " << totalFiles
+            << " files were processed." << std::endl;
+  //Show the summary, e.g. infected files, too large files, and unfinished
+  // queued scans, because user might want to see that despite termination.
+  showSummary(mapFileToHash, mapHashToReport, queued_scans, largeFiles);
+  // Reports that were already retrieved shall not get lost.
+  if (cacheWriter != nullptr)
+    cacheWriter->finish();
+  // The scan can be continued from here.
+  if ((checkpoint != nullptr)
+      && checkpoint->save(mapFileToHash, mapHashToReport, queued_scans, largeFiles))
+    std::clog << "The state of the scan was saved. Use --resume "
+              << checkpoint->fileName() << " to continue." << std::endl;
+  // Files that were put into the outbox are handed off to the drainer.
+  if ((outbox != nullptr) && !outbox->flush())
+    std::cerr << "Warning: Could not write to upload outbox " << outbox->fileName()
+              << "." << std::endl;
+  std::clog << "Terminating program early due to caught signal." << std::endl;
+  std::exit(scantool::rcProgramTerminationBySignal);
+}
+
 int main(int argc, char ** argv)
 {
   // string that will hold the API key
@@ -239,12 +452,74 @@ int main(int argc, char ** argv)
   int maybeLimit = 0;
   // maximum age of scan reports in days without requesting rescan
   int maxAgeInDays = 0;
+  // maximum age of clean reports in days, zero means general maximum age
+  int maxAgeClean = 0;
+  // maximum age of "maybe infected" reports in days, zero means general maximum age
+  int maxAgeMaybe = 0;
   // flag for using request cache
   bool useRequestCache = false;
+  // flag for synchronizing the request cache to disk
+  bool syncRequestCache = false;
+  // flag for delayed rescans of outdated reports
+  bool revalidateLater = false;
   // custom cache directory path
   std::string requestCacheDirVT = "";
+  // path of the file digest cache, empty for none
+  std::string hashCacheFile = "";
+  // path of the lease file that shares the rate limit, empty for default
+  std::string quotaFile = "";
+  // path of the run journal for incremental scans, empty for none
+  std::string journalFile = "";
+  // file with the queued scans of earlier runs, empty for default
+  std::string pendingFile = "";
+  // ledger of uploaded files, empty for default
+  std::string uploadLedgerFile = "";
+  // days after which files are uploaded again, negative for default
+  int reuploadAfterDays = -1;
+  // outbox that gets the files instead of uploading them, empty for none
+  std::string outboxFile = "";
+  // outbox whose files are uploaded, empty for none
+  std::string drainFile = "";
+  // slice of the files that is scanned by this run
+  scantool::hash::Shard shard;
+  bool shardSet = false;
+  // whether files are assigned to slices by their path instead of their content
+  bool shardByPath = false;
+  bool shardBySet = false;
+  // path of the file that gets the summary, empty for none
+  std::string summaryFile = "";
+  // summary files that will be merged instead of scanning files
+  std::vector<std::string> mergeSummaries;
+  // path of the state file for checkpoints, empty for none
+  std::string checkpointFile = "";
+  // whether an earlier run is resumed from the state file
+  bool resume = false;
+  // how files are read for hashing
+  bool ioModeSet = false;
   // files that will be checked
   std::set<std::string> files_scan = std::set<std::string>();
+  // lists of files that will be checked, read while the files are scanned
+  std::vector<std::unique_ptr<scantool::filesystem::ListReader> > fileLists;
+  // whether a list or manifest is read from standard input
+  bool stdinUsed = false;
+  // directories that will be searched for files to check
+  std::vector<std::string> recursiveDirs = std::vector<std::string>();
+  // filters for the files found in these directories
+  scantool::filesystem::WalkOptions walkOptions;
+  // directories that will be watched for new or changed files
+  std::vector<std::string> watchDirs = std::vector<std::string>();
+  // time in seconds without changes before files in watched directories are scanned
+  int watchDelay = -1;
+  // time in seconds to wait for queued scans after all files are processed
+  int pollTime = -1;
+  // socket of the scan service to run, empty for none
+  std::string serveSocket = "";
+  // socket of the scan service to send the files to, empty for none
+  std::string connectSocket = "";
+  // whether requests to the scan service are bulk requests
+  bool bulkRequests = false;
+  // hashes of files from manifests; key = file name, value = SHA256 hash
+  std::map<std::string, SHA256::MessageDigest> manifestDigests;
   // scan strategy
   scantool::virustotal::Strategy selectedStrategy = scantool::virustotal::Strategy::None;
   // flags for archive file handlers
@@ -393,49 +668,79 @@ int main(int argc, char ** argv)
             return scantool::rcInvalidParameter;
           }
         } // "maybe" limit
-        else if ((param == "--files") || (param == "--list"))
+        else if ((param == "--files") || (param == "--list")
+                 || (param == "--files0") || (param == "--list0"))
         {
           // enough parameters?
           if ((i+1 < argc) && (argv[i+1] != nullptr))
           {
             const std::string listFile = std::string(argv[i+1]);
             ++i; // Skip next parameter, because it's used as list file already.
-            if (!libstriezel::filesystem::file::exists(listFile))
+            if (listFile == "-")
+            {
+              if (stdinUsed)
+              {
+                std::cerr << "Error: Standard input can only be read once!" << std::endl;
+                return scantool::rcInvalidParameter;
+              }
+              stdinUsed = true;
+            }
+            else if (!libstriezel::filesystem::file::exists(listFile))
             {
               std::cerr << "Error: File " << listFile << " does not exist!"
                         << std::endl;
               return scantool::rcFileError;
             }
-            // open file and read file names
-            std::ifstream inFile;
-            inFile.open(listFile, std::ios_base::in | std::ios_base::binary);
-            if (!inFile.good() || !inFile.is_open())
+            // The file names are read later, while the files are scanned.
+            const char delimiter = (param.back() == '0') ? '\0' : '\n';
+            auto list = std::make_unique<scantool::filesystem::ListReader>(listFile, delimiter);
+            if (!list->isOpen())
             {
               std::cout << "Error: Could not open file " << listFile << "!"
                         << std::endl;
               return scantool::rcFileError;
             }
-            std::string nextFile;
-            while (!inFile.eof())
+            fileLists.push_back(std::move(list));
+          } // if
+          else
+          {
+            std::cerr << "Error: You have to enter a file name after \""
+                      << param << "\"." << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+        } // list of files
+        else if (param == "--manifest")
+        {
+          // enough parameters?
+          if ((i+1 < argc) && (argv[i+1] != nullptr))
+          {
+            const std::string manifestFile = std::string(argv[i+1]);
+            ++i; // Skip next parameter, because it's used as manifest already.
+            bool manifestRead = false;
+            if (manifestFile == "-")
+            {
+              if (stdinUsed)
+              {
+                std::cerr << "Error: Standard input can only be read once!" << std::endl;
+                return scantool::rcInvalidParameter;
+              }
+              stdinUsed = true;
+              manifestRead = scantool::hash::readManifest(std::cin, "from standard input", manifestDigests);
+            }
+            else
             {
-              std::getline(inFile, nextFile, '\n');
-              if (!nextFile.empty())
+              std::ifstream inFile;
+              inFile.open(manifestFile, std::ios_base::in | std::ios_base::binary);
+              if (!inFile.good() || !inFile.is_open())
               {
-                if (libstriezel::filesystem::file::exists(nextFile))
-                {
-                  #ifdef SCAN_TOOL_DEBUG
-                  std::cout << "Info: Adding " << nextFile << " to list of files for scan." << std::endl;
-                  #endif // SCAN_TOOL_DEBUG
-                  files_scan.insert(nextFile);
-                }
-                else
-                {
-                  std::cout << "Warning: File " << nextFile << " does not exist, skipping it."
-                            << std::endl;
-                }
-              } // if string not empty
-            } // while
-            inFile.close();
+                std::cerr << "Error: Could not open manifest " << manifestFile
+                          << "!" << std::endl;
+                return scantool::rcFileError;
+              }
+              manifestRead = scantool::hash::readManifest(inFile, manifestFile, manifestDigests);
+            }
+            if (!manifestRead)
+              return scantool::rcFileError;
           } // if
           else
           {
@@ -443,11 +748,14 @@ int main(int argc, char ** argv)
                       << param << "\"." << std::endl;
             return scantool::rcInvalidParameter;
           }
-        } // list of files
+        } // manifest with hashes
         // age limit for reports
-        else if ((param == "--max-age") || (param == "--age-limit"))
+        else if ((param == "--max-age") || (param == "--age-limit")
+                 || (param == "--max-age-clean") || (param == "--max-age-maybe"))
         {
-          if (maxAgeInDays > 0)
+          int& maxAge = (param == "--max-age-clean") ? maxAgeClean
+                      : ((param == "--max-age-maybe") ? maxAgeMaybe : maxAgeInDays);
+          if (maxAge > 0)
           {
             std::cerr << "Error: Report age has been specified multiple times." << std::endl;
             return scantool::rcInvalidParameter;
@@ -475,7 +783,7 @@ int main(int argc, char ** argv)
               limit = 36500;
             }
             // Assign the parameter value.
-            maxAgeInDays = limit;
+            maxAge = limit;
             ++i; // Skip next parameter, because it's used as limit already.
           }
           else
@@ -527,6 +835,28 @@ int main(int argc, char ** argv)
           }
           useRequestCache = true;
         } // request cache
+        // delayed rescans of outdated reports
+        else if ((param == "--revalidate-later") || (param == "--stale-while-revalidate"))
+        {
+          if (revalidateLater)
+          {
+            std::cerr << "Error: Parameter " << param << " must not occur more than once!"
+                      << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+          revalidateLater = true;
+        } // delayed rescans
+        // synchronize request cache to disk
+        else if (param == "--cache-sync")
+        {
+          if (syncRequestCache)
+          {
+            std::cerr << "Error: Parameter " << param << " must not occur more than once!"
+                      << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+          syncRequestCache = true;
+        } // synchronize request cache
         // set custom directory for request cache
         else if ((param == "--cache-dir") || (param == "--cache-directory") || (param == "--request-cache-directory"))
         {
@@ -549,136 +879,633 @@ int main(int argc, char ** argv)
             return scantool::rcInvalidParameter;
           }
         } // request cache directory
-        else if (param == "--zip")
+        else if (param == "--hash-cache")
         {
-          // Has the ZIP option already been set?
-          if (handleZIP)
+          if (!hashCacheFile.empty())
           {
-            std::cerr << "Error: Parameter " << param << " must not occur more than once!"
-                      << std::endl;
+            std::cerr << "Error: Hash cache file was already set to "
+                      << hashCacheFile << "!" << std::endl;
             return scantool::rcInvalidParameter;
           }
-          handleZIP = true;
-        } // handle ZIP files
-        else if ((param == "--7zip") || (param == "--7z") || (param == "--7-zip"))
-        {
-          // Has the 7z option already been set?
-          if (handle7Zip)
+          // enough parameters?
+          if ((i+1 < argc) && (argv[i+1] != nullptr))
           {
-            std::cerr << "Error: Parameter " << param << " must not occur more than once!"
-                      << std::endl;
+            hashCacheFile = std::string(argv[i+1]);
+            ++i; // Skip next parameter, because it's already used as file name.
+          }
+          else
+          {
+            std::cerr << "Error: You have to enter a file name after \""
+                      << param << "\"." << std::endl;
             return scantool::rcInvalidParameter;
           }
-          handle7Zip = true;
-        } // handle 7-Zip files
-        else if (param == "--tar")
+        } // hash cache file
+        else if (param == "--quota-file")
         {
-          // Has the tar option already been set?
-          if (handleTar)
+          if (!quotaFile.empty())
           {
-            std::cerr << "Error: Parameter " << param << " must not occur more than once!"
-                      << std::endl;
+            std::cerr << "Error: Quota lease file was already set to "
+                      << quotaFile << "!" << std::endl;
             return scantool::rcInvalidParameter;
           }
-          handleTar = true;
-        } // handle tape archive files
-        else if ((param == "--gzip") || (param == "--gz"))
+          // enough parameters?
+          if ((i+1 < argc) && (argv[i+1] != nullptr))
+          {
+            quotaFile = std::string(argv[i+1]);
+            ++i; // Skip next parameter, because it's already used as file name.
+          }
+          else
+          {
+            std::cerr << "Error: You have to enter a file name after \""
+                      << param << "\"." << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+        } // quota lease file
+        else if (param == "--shard")
         {
-          // Has the gzip option already been set?
-          if (handleGzip)
+          if (shardSet)
           {
             std::cerr << "Error: Parameter " << param << " must not occur more than once!"
                       << std::endl;
             return scantool::rcInvalidParameter;
           }
-          handleGzip = true;
-        } // handle .gz files
-        else if (param == "--xz")
+          // enough parameters?
+          if ((i+1 < argc) && (argv[i+1] != nullptr))
+          {
+            const std::string shardText = std::string(argv[i+1]);
+            if (!scantool::hash::Shard::fromString(shardText, shard))
+            {
+              std::cerr << "Error: \"" << shardText << "\" is not a valid shard! "
+                        << "Use I/N with 1 <= I <= N, e.g. 2/4." << std::endl;
+              return scantool::rcInvalidParameter;
+            }
+            shardSet = true;
+            ++i; // Skip next parameter, because it's already used as shard.
+          }
+          else
+          {
+            std::cerr << "Error: You have to enter a shard like 2/4 after \""
+                      << param << "\"." << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+        } // shard
+        else if (param == "--shard-by")
         {
-          // Has the XZ option already been set?
-          if (handleXz)
+          if (shardBySet)
           {
             std::cerr << "Error: Parameter " << param << " must not occur more than once!"
                       << std::endl;
             return scantool::rcInvalidParameter;
           }
-          handleXz = true;
-        } // handle XZ compressed files
-        else if (param == "--ar")
+          // enough parameters?
+          if ((i+1 < argc) && (argv[i+1] != nullptr))
+          {
+            const std::string shardBy = std::string(argv[i+1]);
+            if ((shardBy != "content") && (shardBy != "path"))
+            {
+              std::cerr << "Error: \"" << shardBy << "\" is not a valid value for "
+                        << param << ". Valid values are content and path." << std::endl;
+              return scantool::rcInvalidParameter;
+            }
+            shardByPath = (shardBy == "path");
+            shardBySet = true;
+            ++i; // Skip next parameter, because it's already used as value.
+          }
+          else
+          {
+            std::cerr << "Error: You have to enter content or path after \""
+                      << param << "\"." << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+        } // how files are assigned to shards
+        else if ((param == "--summary-file") || (param == "--merge-summary"))
         {
-          // Has the Ar option already been set?
-          if (handleAr)
+          if ((param == "--summary-file") && !summaryFile.empty())
           {
-            std::cerr << "Error: Parameter " << param << " must not occur more than once!"
-                      << std::endl;
+            std::cerr << "Error: Summary file was already set to "
+                      << summaryFile << "!" << std::endl;
             return scantool::rcInvalidParameter;
           }
-          handleAr = true;
-        } // handle Ar archive files
-        else if ((param == "--iso") || (param == "--iso9660"))
+          // enough parameters?
+          if ((i+1 < argc) && (argv[i+1] != nullptr))
+          {
+            if (param == "--summary-file")
+              summaryFile = std::string(argv[i+1]);
+            else
+              mergeSummaries.push_back(std::string(argv[i+1]));
+            ++i; // Skip next parameter, because it's already used as file name.
+          }
+          else
+          {
+            std::cerr << "Error: You have to enter a file name after \""
+                      << param << "\"." << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+        } // summary files
+        else if ((param == "--checkpoint") || (param == "--resume"))
         {
-          // Has the ISO9660 option already been set?
-          if (handleISO9660)
+          // enough parameters?
+          if ((i+1 < argc) && (argv[i+1] != nullptr))
           {
-            std::cerr << "Error: Parameter " << param << " must not occur more than once!"
-                      << std::endl;
+            const std::string stateFile = std::string(argv[i+1]);
+            if (!checkpointFile.empty() && (checkpointFile != stateFile))
+            {
+              std::cerr << "Error: State file was already set to "
+                        << checkpointFile << "!" << std::endl;
+              return scantool::rcInvalidParameter;
+            }
+            checkpointFile = stateFile;
+            if (param == "--resume")
+              resume = true;
+            ++i; // Skip next parameter, because it's already used as file name.
+          }
+          else
+          {
+            std::cerr << "Error: You have to enter a file name after \""
+                      << param << "\"." << std::endl;
             return scantool::rcInvalidParameter;
           }
-          handleISO9660 = true;
-        } // handle .iso files
-        else if ((param == "--cab") || (param == "--cabinet"))
+        } // state file
+        else if (param == "--journal")
         {
-          // Has the CAB option already been set?
-          if (handleCab)
+          if (!journalFile.empty())
           {
-            std::cerr << "Error: Parameter " << param << " must not occur more than once!"
-                      << std::endl;
+            std::cerr << "Error: Journal file was already set to "
+                      << journalFile << "!" << std::endl;
             return scantool::rcInvalidParameter;
           }
-          handleCab = true;
-        } // handle .cab files
-        else if (param == "--rar")
+          // enough parameters?
+          if ((i+1 < argc) && (argv[i+1] != nullptr))
+          {
+            journalFile = std::string(argv[i+1]);
+            ++i; // Skip next parameter, because it's already used as file name.
+          }
+          else
+          {
+            std::cerr << "Error: You have to enter a file name after \""
+                      << param << "\"." << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+        } // run journal file
+        else if (param == "--pending-scans")
         {
-          // Has the Rar option already been set?
-          if (handleRar)
+          if (!pendingFile.empty())
           {
-            std::cerr << "Error: Parameter " << param << " must not occur more than once!"
-                      << std::endl;
+            std::cerr << "Error: File for pending scans was already set to "
+                      << pendingFile << "!" << std::endl;
             return scantool::rcInvalidParameter;
           }
-          handleRar = true;
-        } // handle .rar files
-        else if ((param == "--installshield") || (param == "--unshield"))
+          // enough parameters?
+          if ((i+1 < argc) && (argv[i+1] != nullptr))
+          {
+            pendingFile = std::string(argv[i+1]);
+            ++i; // Skip next parameter, because it's already used as file name.
+          }
+          else
+          {
+            std::cerr << "Error: You have to enter a file name after \""
+                      << param << "\"." << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+        } // file for pending scans
+        else if (param == "--upload-ledger")
         {
-          // Has the InstallShield option already been set?
-          if (handleInstallShield)
+          if (!uploadLedgerFile.empty())
           {
-            std::cerr << "Error: Parameter " << param << " must not occur more than once!"
-                      << std::endl;
+            std::cerr << "Error: Upload ledger was already set to "
+                      << uploadLedgerFile << "!" << std::endl;
             return scantool::rcInvalidParameter;
           }
-          handleInstallShield = true;
-        } // handle InstallShield CAB files
-        else if ((param == "--ignore-extraction-errors") || (param == "--ignore-archive-errors"))
+          // enough parameters?
+          if ((i+1 < argc) && (argv[i+1] != nullptr))
+          {
+            uploadLedgerFile = std::string(argv[i+1]);
+            ++i; // Skip next parameter, because it's already used as file name.
+          }
+          else
+          {
+            std::cerr << "Error: You have to enter a file name after \""
+                      << param << "\"." << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+        } // upload ledger
+        else if (param == "--reupload-after")
         {
-          // Has the ignore option already been set?
-          if (ignoreExtractionErrors)
+          if (reuploadAfterDays >= 0)
           {
             std::cerr << "Error: Parameter " << param << " must not occur more than once!"
                       << std::endl;
             return scantool::rcInvalidParameter;
           }
-          ignoreExtractionErrors = true;
-        } // ignore archive extraction errors
-        else if ((param == "--integrity") || (param == "-i"))
+          // enough parameters?
+          if ((i+1 < argc) && (argv[i+1] != nullptr))
+          {
+            const std::string integer = std::string(argv[i+1]);
+            if (!stringToInt(integer, reuploadAfterDays) || (reuploadAfterDays < 0))
+            {
+              std::cerr << "Error: \"" << integer << "\" is not a non-negative integer!"
+                        << std::endl;
+              return scantool::rcInvalidParameter;
+            }
+            // Is it more than ca. 100 years?
+            if (reuploadAfterDays > 36500)
+            {
+              if (!silent)
+                std::cerr << "Warning: Re-upload interval was capped to 36500 days." << std::endl;
+              reuploadAfterDays = 36500;
+            }
+            ++i; // Skip next parameter, because it's used as interval already.
+          }
+          else
+          {
+            std::cerr << "Error: You have to enter a number of days after \""
+                      << param << "\"." << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+        } // interval for uploads of the same file
+        else if ((param == "--outbox") || (param == "--drain-outbox"))
         {
-          // add note about new executable for cache stuff
-          std::cerr << "Error: Checking cache for corrupt files is now done "
-                    << "by scan-tool-cache. Use scan-tool-cache instead."
-                    << std::endl;
-          return scantool::rcInvalidParameter;
-        } // integrity check
-        else if ((param == "--transition") || (param == "--cache-transition"))
+          std::string& boxFile = (param == "--outbox") ? outboxFile : drainFile;
+          if (!outboxFile.empty() || !drainFile.empty())
+          {
+            std::cerr << "Error: Upload outbox was already set to "
+                      << (outboxFile.empty() ? drainFile : outboxFile) << "!" << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+          // enough parameters?
+          if ((i+1 < argc) && (argv[i+1] != nullptr))
+          {
+            boxFile = std::string(argv[i+1]);
+            ++i; // Skip next parameter, because it's already used as file name.
+          }
+          else
+          {
+            std::cerr << "Error: You have to enter a file name after \""
+                      << param << "\"." << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+        } // upload outbox
+        else if (param == "--io-mode")
+        {
+          if (ioModeSet)
+          {
+            std::cerr << "Error: Parameter " << param << " must not occur more than once!"
+                      << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+          // enough parameters?
+          if ((i+1 < argc) && (argv[i+1] != nullptr))
+          {
+            const std::string modeName = std::string(argv[i+1]);
+            scantool::hash::ReadMode mode = scantool::hash::ReadMode::Cached;
+            if (!scantool::hash::parseReadMode(modeName, mode))
+            {
+              std::cerr << "Error: \"" << modeName << "\" is not a valid I/O mode. "
+                        << "Valid modes are cached, nocache and direct." << std::endl;
+              return scantool::rcInvalidParameter;
+            }
+            scantool::hash::setReadMode(mode);
+            ioModeSet = true;
+            ++i; // Skip next parameter, because it's already used as mode.
+          }
+          else
+          {
+            std::cerr << "Error: You have to enter a mode after \""
+                      << param << "\"." << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+        } // I/O mode for hashing
+        else if (param == "--recursive")
+        {
+          // enough parameters?
+          if ((i+1 < argc) && (argv[i+1] != nullptr))
+          {
+            const std::string dirName = std::string(argv[i+1]);
+            ++i; // Skip next parameter, because it's used as directory already.
+            if (!libstriezel::filesystem::directory::exists(dirName))
+            {
+              std::cerr << "Error: Directory " << dirName << " does not exist!"
+                        << std::endl;
+              return scantool::rcFileError;
+            }
+            recursiveDirs.push_back(dirName);
+          }
+          else
+          {
+            std::cerr << "Error: You have to enter a directory name after \""
+                      << param << "\"." << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+        } // directory for recursive scan
+        else if (param == "--watch")
+        {
+          // enough parameters?
+          if ((i+1 < argc) && (argv[i+1] != nullptr))
+          {
+            const std::string dirName = std::string(argv[i+1]);
+            ++i; // Skip next parameter, because it's used as directory already.
+            if (!libstriezel::filesystem::directory::exists(dirName))
+            {
+              std::cerr << "Error: Directory " << dirName << " does not exist!"
+                        << std::endl;
+              return scantool::rcFileError;
+            }
+            watchDirs.push_back(dirName);
+          }
+          else
+          {
+            std::cerr << "Error: You have to enter a directory name after \""
+                      << param << "\"." << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+        } // directory to watch
+        else if (param == "--watch-delay")
+        {
+          if (watchDelay >= 0)
+          {
+            std::cerr << "Error: Parameter " << param << " must not occur more than once!"
+                      << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+          // enough parameters?
+          if ((i+1 < argc) && (argv[i+1] != nullptr))
+          {
+            const std::string integer = std::string(argv[i+1]);
+            if (!stringToInt(integer, watchDelay) || (watchDelay < 0))
+            {
+              std::cerr << "Error: \"" << integer << "\" is not a non-negative integer!"
+                        << std::endl;
+              return scantool::rcInvalidParameter;
+            }
+            ++i; // Skip next parameter, because it's used as delay already.
+          }
+          else
+          {
+            std::cerr << "Error: You have to enter a number of seconds after \""
+                      << param << "\"." << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+        } // delay for watched directories
+        else if (param == "--poll-time")
+        {
+          if (pollTime >= 0)
+          {
+            std::cerr << "Error: Parameter " << param << " must not occur more than once!"
+                      << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+          // enough parameters?
+          if ((i+1 < argc) && (argv[i+1] != nullptr))
+          {
+            const std::string integer = std::string(argv[i+1]);
+            if (!stringToInt(integer, pollTime) || (pollTime < 0))
+            {
+              std::cerr << "Error: \"" << integer << "\" is not a non-negative integer!"
+                        << std::endl;
+              return scantool::rcInvalidParameter;
+            }
+            ++i; // Skip next parameter, because it's used as poll time already.
+          }
+          else
+          {
+            std::cerr << "Error: You have to enter a number of seconds after \""
+                      << param << "\"." << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+        } // time to wait for queued scans
+        else if ((param == "--serve") || (param == "--connect"))
+        {
+          std::string& socketPath = (param == "--serve") ? serveSocket : connectSocket;
+          if (!serveSocket.empty() || !connectSocket.empty())
+          {
+            std::cerr << "Error: Only one of --serve and --connect can be given, "
+                      << "and only once!" << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+          // enough parameters?
+          if ((i+1 < argc) && (argv[i+1] != nullptr))
+          {
+            socketPath = std::string(argv[i+1]);
+            ++i; // Skip next parameter, because it's used as socket already.
+            if (socketPath.empty())
+            {
+              std::cerr << "Error: The socket after " << param
+                        << " must not be empty!" << std::endl;
+              return scantool::rcInvalidParameter;
+            }
+          }
+          else
+          {
+            std::cerr << "Error: You have to enter a socket path after \""
+                      << param << "\"." << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+        } // socket of scan service
+        else if (param == "--bulk")
+        {
+          if (bulkRequests)
+          {
+            std::cerr << "Error: Parameter " << param << " must not occur more than once!"
+                      << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+          bulkRequests = true;
+        } // bulk requests to scan service
+        else if ((param == "--include") || (param == "--exclude"))
+        {
+          // enough parameters?
+          if ((i+1 < argc) && (argv[i+1] != nullptr))
+          {
+            const std::string pattern = std::string(argv[i+1]);
+            ++i; // Skip next parameter, because it's used as pattern already.
+            if (pattern.empty())
+            {
+              std::cerr << "Error: The pattern after " << param
+                        << " must not be empty!" << std::endl;
+              return scantool::rcInvalidParameter;
+            }
+            if (param == "--include")
+              walkOptions.include.push_back(pattern);
+            else
+              walkOptions.exclude.push_back(pattern);
+          }
+          else
+          {
+            std::cerr << "Error: You have to enter a pattern after \""
+                      << param << "\"." << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+        } // include or exclude pattern for recursive scan
+        else if (param == "--one-file-system")
+        {
+          if (walkOptions.oneFileSystem)
+          {
+            std::cerr << "Error: Parameter " << param << " must not occur more than once!"
+                      << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+          walkOptions.oneFileSystem = true;
+        } // stay on file system of directories for recursive scan
+        else if ((param == "--min-size") || (param == "--max-size"))
+        {
+          int64_t& limit = (param == "--min-size") ? walkOptions.minSize : walkOptions.maxSize;
+          if (limit >= 0)
+          {
+            std::cerr << "Error: Parameter " << param << " must not occur more than once!"
+                      << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+          // enough parameters?
+          if ((i+1 < argc) && (argv[i+1] != nullptr))
+          {
+            const std::string integer = std::string(argv[i+1]);
+            int64_t size = -1;
+            if (!stringToLongLong(integer, size) || (size < 0))
+            {
+              std::cerr << "Error: \"" << integer << "\" is not a non-negative integer!"
+                        << std::endl;
+              return scantool::rcInvalidParameter;
+            }
+            limit = size;
+            ++i; // Skip next parameter, because it's used as size already.
+          }
+          else
+          {
+            std::cerr << "Error: You have to enter a size in octets after \""
+                      << param << "\"." << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+        } // size limit for recursive scan
+        else if (param == "--zip")
+        {
+          // Has the ZIP option already been set?
+          if (handleZIP)
+          {
+            std::cerr << "Error: Parameter " << param << " must not occur more than once!"
+                      << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+          handleZIP = true;
+        } // handle ZIP files
+        else if ((param == "--7zip") || (param == "--7z") || (param == "--7-zip"))
+        {
+          // Has the 7z option already been set?
+          if (handle7Zip)
+          {
+            std::cerr << "Error: Parameter " << param << " must not occur more than once!"
+                      << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+          handle7Zip = true;
+        } // handle 7-Zip files
+        else if (param == "--tar")
+        {
+          // Has the tar option already been set?
+          if (handleTar)
+          {
+            std::cerr << "Error: Parameter " << param << " must not occur more than once!"
+                      << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+          handleTar = true;
+        } // handle tape archive files
+        else if ((param == "--gzip") || (param == "--gz"))
+        {
+          // Has the gzip option already been set?
+          if (handleGzip)
+          {
+            std::cerr << "Error: Parameter " << param << " must not occur more than once!"
+                      << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+          handleGzip = true;
+        } // handle .gz files
+        else if (param == "--xz")
+        {
+          // Has the XZ option already been set?
+          if (handleXz)
+          {
+            std::cerr << "Error: Parameter " << param << " must not occur more than once!"
+                      << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+          handleXz = true;
+        } // handle XZ compressed files
+        else if (param == "--ar")
+        {
+          // Has the Ar option already been set?
+          if (handleAr)
+          {
+            std::cerr << "Error: Parameter " << param << " must not occur more than once!"
+                      << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+          handleAr = true;
+        } // handle Ar archive files
+        else if ((param == "--iso") || (param == "--iso9660"))
+        {
+          // Has the ISO9660 option already been set?
+          if (handleISO9660)
+          {
+            std::cerr << "Error: Parameter " << param << " must not occur more than once!"
+                      << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+          handleISO9660 = true;
+        } // handle .iso files
+        else if ((param == "--cab") || (param == "--cabinet"))
+        {
+          // Has the CAB option already been set?
+          if (handleCab)
+          {
+            std::cerr << "Error: Parameter " << param << " must not occur more than once!"
+                      << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+          handleCab = true;
+        } // handle .cab files
+        else if (param == "--rar")
+        {
+          // Has the Rar option already been set?
+          if (handleRar)
+          {
+            std::cerr << "Error: Parameter " << param << " must not occur more than once!"
+                      << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+          handleRar = true;
+        } // handle .rar files
+        else if ((param == "--installshield") || (param == "--unshield"))
+        {
+          // Has the InstallShield option already been set?
+          if (handleInstallShield)
+          {
+            std::cerr << "Error: Parameter " << param << " must not occur more than once!"
+                      << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+          handleInstallShield = true;
+        } // handle InstallShield CAB files
+        else if ((param == "--ignore-extraction-errors") || (param == "--ignore-archive-errors"))
+        {
+          // Has the ignore option already been set?
+          if (ignoreExtractionErrors)
+          {
+            std::cerr << "Error: Parameter " << param << " must not occur more than once!"
+                      << std::endl;
+            return scantool::rcInvalidParameter;
+          }
+          ignoreExtractionErrors = true;
+        } // ignore archive extraction errors
+        else if ((param == "--integrity") || (param == "-i"))
+        {
+          // add note about new executable for cache stuff
+          std::cerr << "Error: Checking cache for corrupt files is now done "
+                    << "by scan-tool-cache. Use scan-tool-cache instead."
+                    << std::endl;
+          return scantool::rcInvalidParameter;
+        } // integrity check
+        else if ((param == "--transition") || (param == "--cache-transition"))
         {
           // add note about new executable for cache stuff
           std::cerr << "Error: Cache transition is now done by scan-tool-cache."
@@ -707,18 +1534,151 @@ int main(int argc, char ** argv)
     } // while
   } // if arguments present
 
+  // Merging summaries of earlier runs does not scan anything.
+  if (!mergeSummaries.empty())
+  {
+    if (!files_scan.empty() || !fileLists.empty() || !recursiveDirs.empty()
+        || !watchDirs.empty() || !manifestDigests.empty() || !serveSocket.empty()
+        || !connectSocket.empty())
+    {
+      std::cerr << "Error: Files cannot be scanned while summaries are merged." << std::endl;
+      return scantool::rcInvalidParameter;
+    }
+    for (const auto& fileName : mergeSummaries)
+    {
+      if (!loadSummary(fileName, mapFileToHash, mapHashToReport, queued_scans, largeFiles))
+      {
+        std::cerr << "Error: Could not read summary file " << fileName << "!" << std::endl;
+        return scantool::rcFileError;
+      }
+    }
+    showSummary(mapFileToHash, mapHashToReport, queued_scans, largeFiles);
+    if (!summaryFile.empty()
+        && !saveSummary(summaryFile, mapFileToHash, mapHashToReport, queued_scans, largeFiles))
+    {
+      std::cerr << "Error: Could not write summary file " << summaryFile << "!" << std::endl;
+      return scantool::rcFileError;
+    }
+    return 0;
+  } // if summaries are merged
+
+  if (shardBySet && !shardSet)
+  {
+    std::cerr << "Error: --shard-by has no effect without --shard." << std::endl;
+    return scantool::rcInvalidParameter;
+  }
+  if (!shard.all() && (!serveSocket.empty() || !connectSocket.empty()))
+  {
+    std::cerr << "Error: Shards cannot be used together with the scan service." << std::endl;
+    return scantool::rcInvalidParameter;
+  }
+  if (!checkpointFile.empty() && (!serveSocket.empty() || !connectSocket.empty()))
+  {
+    std::cerr << "Error: Checkpoints cannot be used together with the scan service." << std::endl;
+    return scantool::rcInvalidParameter;
+  }
+  // The upload outbox only makes sense for the scan-and-forget strategy.
+  if (!outboxFile.empty() || !drainFile.empty())
+  {
+    if (selectedStrategy == scantool::virustotal::Strategy::None)
+    {
+      selectedStrategy = scantool::virustotal::Strategy::ScanAndForget;
+    }
+    else if (selectedStrategy != scantool::virustotal::Strategy::ScanAndForget)
+    {
+      std::cerr << "Error: The upload outbox can only be used with the scan-and-forget "
+                << "strategy." << std::endl;
+      return scantool::rcInvalidParameter;
+    }
+    if (!serveSocket.empty() || !connectSocket.empty())
+    {
+      std::cerr << "Error: The upload outbox cannot be used together with the scan service."
+                << std::endl;
+      return scantool::rcInvalidParameter;
+    }
+  }
+  if (!drainFile.empty())
+  {
+    if (!files_scan.empty() || !fileLists.empty() || !recursiveDirs.empty()
+        || !watchDirs.empty() || !manifestDigests.empty())
+    {
+      std::cerr << "Error: Files cannot be scanned while the upload outbox is drained."
+                << std::endl;
+      return scantool::rcInvalidParameter;
+    }
+    // Files of other shards or completed files would be removed without upload.
+    if (!shard.all() || !checkpointFile.empty())
+    {
+      std::cerr << "Error: Shards and checkpoints cannot be used while the upload "
+                << "outbox is drained." << std::endl;
+      return scantool::rcInvalidParameter;
+    }
+  }
+
+  if ((!serveSocket.empty() || !connectSocket.empty())
+      && !scantool::virustotal::ScanService::supported())
+  {
+    std::cerr << "Error: The scan service is only supported on Linux." << std::endl;
+    return scantool::rcInvalidParameter;
+  }
+  if (!connectSocket.empty())
+  {
+    if (!fileLists.empty() || !recursiveDirs.empty() || !watchDirs.empty()
+        || !manifestDigests.empty())
+    {
+      std::cerr << "Error: Only files given as parameters can be sent to the "
+                << "scan service." << std::endl;
+      return scantool::rcInvalidParameter;
+    }
+    if (files_scan.empty())
+    {
+      std::cout << "No file scans requested, stopping here." << std::endl;
+      return 0;
+    }
+    if (maybeLimit <= 0)
+      maybeLimit = 3;
+    totalFiles = files_scan.size();
+    processedFiles = 0;
+    return scantool::virustotal::scanWithService(connectSocket, files_scan,
+        bulkRequests ? scantool::virustotal::Lane::Bulk : scantool::virustotal::Lane::Interactive,
+        maybeLimit, silent, mapHashToReport, mapFileToHash, queued_scans, largeFiles,
+        processedFiles);
+  } // if files are scanned by a service
+  if (!serveSocket.empty() && (!files_scan.empty() || !fileLists.empty()
+      || !recursiveDirs.empty() || !watchDirs.empty() || !manifestDigests.empty()))
+  {
+    std::cerr << "Error: The scan service does not scan files given as parameters. "
+              << "Use --connect to send files to the service." << std::endl;
+    return scantool::rcInvalidParameter;
+  }
+
   if (key.empty())
   {
     std::cerr << "Error: This program won't work properly without an API key! "
               << "Use --apikey to specify the VirusTotal API key." << std::endl;
     return scantool::rcInvalidParameter;
   }
-  if (files_scan.empty())
+  // Files from manifests are not checked for existence, they are only read,
+  // if they have to be uploaded.
+  for (const auto& [fileName, digest] : manifestDigests)
+  {
+    files_scan.insert(fileName);
+  }
+
+  // A resumed run may only have to retrieve the reports of queued scans.
+  if (files_scan.empty() && fileLists.empty() && recursiveDirs.empty() && watchDirs.empty()
+      && serveSocket.empty() && !resume && drainFile.empty())
   {
     std::cout << "No file scans requested, stopping here." << std::endl;
     return 0;
   } // if no requests
 
+  if (!watchDirs.empty() && !scantool::filesystem::DirectoryWatcher::supported())
+  {
+    std::cerr << "Error: Watching directories is only supported on Linux." << std::endl;
+    return scantool::rcInvalidParameter;
+  }
+
   // set "false positive" limit, if it was not set
   if (maybeLimit <= 0)
     maybeLimit = 3;
@@ -731,7 +1691,10 @@ int main(int argc, char ** argv)
                 << " days." << std::endl;
   }
 
-  const auto ageLimit = std::chrono::system_clock::now() - std::chrono::hours(24*maxAgeInDays);
+  // age limits that depend on the verdict of the report
+  scantool::virustotal::FreshnessPolicy freshness(maxAgeInDays, maybeLimit);
+  freshness.setMaxAgeClean(maxAgeClean);
+  freshness.setMaxAgeMaybe(maxAgeMaybe);
 
   // handle request cache settings
   scantool::virustotal::CacheManagerV2 cacheMgr(requestCacheDirVT);
@@ -749,9 +1712,92 @@ int main(int argc, char ** argv)
                 << "Cache directory is " << requestCacheDirVT << "." << std::endl;
   } // if useRequestCache
 
+  // Scans of earlier runs are not submitted again.
+  std::unique_ptr<scantool::virustotal::PendingScans> pendingScans = nullptr;
+  if (pendingFile.empty() && useRequestCache)
+    pendingFile = scantool::virustotal::PendingScans::defaultFileName(requestCacheDirVT);
+  if (!pendingFile.empty())
+  {
+    pendingScans = std::make_unique<scantool::virustotal::PendingScans>(pendingFile);
+    if (!pendingScans->load())
+    {
+      std::cerr << "Warning: Could not read file of pending scans " << pendingFile
+                << ", files of earlier scans may be uploaded again." << std::endl;
+    }
+    else if (!pendingScans->empty() && !silent)
+    {
+      std::clog << "Info: Scans of " << pendingScans->size() << " file(s) of earlier "
+                << "runs are still pending." << std::endl;
+    }
+  }
+
+  // Files that were uploaded recently are not uploaded again.
+  if (reuploadAfterDays < 0)
+    reuploadAfterDays = 30;
+  std::unique_ptr<scantool::virustotal::UploadLedger> uploadLedger = nullptr;
+  if (uploadLedgerFile.empty() && useRequestCache)
+    uploadLedgerFile = scantool::virustotal::UploadLedger::defaultFileName(requestCacheDirVT);
+  if (!uploadLedgerFile.empty())
+  {
+    uploadLedger = std::make_unique<scantool::virustotal::UploadLedger>(uploadLedgerFile);
+    if (!uploadLedger->load())
+    {
+      std::cerr << "Warning: Could not read upload ledger " << uploadLedgerFile
+                << ", files may be uploaded again." << std::endl;
+    }
+  }
+
+  // Producers put files into the outbox, the drainer uploads them.
+  std::unique_ptr<scantool::virustotal::UploadOutbox> drainBox = nullptr;
+  if (!outboxFile.empty())
+  {
+    outbox = std::make_unique<scantool::virustotal::UploadOutbox>(outboxFile);
+    if (!outbox->load())
+    {
+      std::cerr << "Warning: Could not read upload outbox " << outboxFile
+                << ", files may be put into it twice." << std::endl;
+    }
+  }
+  else if (!drainFile.empty())
+  {
+    drainBox = std::make_unique<scantool::virustotal::UploadOutbox>(drainFile);
+    if (!drainBox->load())
+    {
+      std::cerr << "Error: Could not read upload outbox " << drainFile << "!" << std::endl;
+      return scantool::rcFileError;
+    }
+  }
+
   totalFiles = files_scan.size();
   processedFiles = 0;
 
+  // The state of an interrupted run is restored before the scan starts.
+  if (!checkpointFile.empty())
+  {
+    checkpoint = std::make_unique<scantool::virustotal::Checkpoint>(checkpointFile);
+    if (resume)
+    {
+      if (!libstriezel::filesystem::file::exists(checkpointFile))
+      {
+        std::cerr << "Error: State file " << checkpointFile << " does not exist!"
+                  << std::endl;
+        return scantool::rcFileError;
+      }
+      if (!checkpoint->load(mapFileToHash, mapHashToReport, queued_scans, largeFiles))
+      {
+        std::cerr << "Error: Could not read state file " << checkpointFile << "!"
+                  << std::endl;
+        return scantool::rcFileError;
+      }
+      if (!silent)
+        std::clog << "Info: Resuming scan with " << checkpoint->completedCount()
+                  << " completed file(s) and " << queued_scans.size()
+                  << " queued scan(s)." << std::endl;
+    } // if resume
+  } // if checkpoints are enabled
+  // number of files that were completed by an earlier run
+  std::set<std::string>::size_type resumedFiles = 0;
+
   // install signal handlers
   #if defined(__linux__) || defined(linux)
   struct sigaction sa;
@@ -773,6 +1819,9 @@ int main(int argc, char ** argv)
               << std::endl;
     return scantool::rcSignalHandlerError;
   }
+  // Statistics requests shall not interrupt reads, e.g. of lists from
+  // standard input, so those get restarted.
+  sa.sa_flags = SA_RESTART;
   // ... and one for SIGUSR1, ...
   if (sigaction(SIGUSR1, &sa, nullptr) != 0)
   {
@@ -800,9 +1849,47 @@ int main(int argc, char ** argv)
 
   // create scanner: pass API key, honour time limits, set silent mode
   scantool::virustotal::ScannerV2 scanVT(key, true, silent);
+  // Signals shall not wait until the time limit has expired.
+  scanVT.setWaitHandler(handleSignals);
+  // All processes with the same API key share its rate limit.
+  if (quotaFile.empty())
+    quotaFile = scantool::virustotal::QuotaLease::defaultFileName(key);
+  scantool::virustotal::QuotaLease quotaLease(quotaFile, scanVT.timeBetweenConsecutiveHashLookups());
+  if (quotaLease.open())
+    scanVT.setQuotaLease(&quotaLease);
+  else
+    std::cerr << "Warning: Could not open quota lease file " << quotaFile
+              << ", the rate limit is not shared with other processes." << std::endl;
+  if (useRequestCache)
+  {
+    // Reports are written in the background, so the scan does not wait for it.
+    cacheWriter = std::make_unique<scantool::virustotal::CacheWriter>(
+        scantool::virustotal::CacheWriter::cDefaultCapacity, syncRequestCache);
+    scanVT.setCacheWriter(cacheWriter.get());
+    cacheMgr.setCacheWriter(cacheWriter.get());
+  }
   // time when last scan was queued
   std::chrono::steady_clock::time_point lastQueuedScanTime = std::chrono::steady_clock::now() - std::chrono::hours(24);
 
+  // rescans whose reports are still pending; key = scan_id, value = queued scan record
+  scantool::virustotal::QueuedScanMap rescans = scantool::virustotal::QueuedScanMap();
+  // files with outdated reports, if rescans happen later
+  scantool::virustotal::RevalidationQueue revalidation;
+  revalidation.setPendingRescans(&rescans);
+  // file of files with outdated reports that are left to later runs
+  std::string revalidationFile = "";
+  // retrieves the reports of queued scans and rescans
+  scantool::virustotal::ScanPoller poller(scanVT, queued_scans, rescans,
+      requestCacheDirVT, useRequestCache, maybeLimit, silent,
+      mapHashToReport, mapFileToHash);
+  poller.setPendingScans(pendingScans.get());
+  revalidation.setScanAddedHandler([&poller](const std::string& scan_id) { poller.added(scan_id); });
+  // Scans from an interrupted run are probably done already.
+  for (const auto& entry : queued_scans)
+  {
+    poller.added(entry.first, true);
+  }
+
   std::unique_ptr<scantool::virustotal::ScanStrategy> strategy = nullptr;
   switch (selectedStrategy)
   {
@@ -819,9 +1906,102 @@ int main(int argc, char ** argv)
     case scantool::virustotal::Strategy::None:
     default:
          // Use default strategy in all other cases.
-         strategy = std::unique_ptr<scantool::virustotal::ScanStrategyDefault>(new scantool::virustotal::ScanStrategyDefault());
+         {
+           auto defaultStrategy = std::unique_ptr<scantool::virustotal::ScanStrategyDefault>(new scantool::virustotal::ScanStrategyDefault());
+           if (revalidateLater)
+           {
+             defaultStrategy->setRevalidationQueue(&revalidation);
+             if (useRequestCache)
+               revalidationFile = scantool::virustotal::RevalidationQueue::defaultFileName(requestCacheDirVT);
+           }
+           defaultStrategy->setPendingRescans(&rescans);
+           strategy = std::move(defaultStrategy);
+         }
          break;
   }
+  // Rescans that earlier runs could not request are requested in idle time.
+  if (!revalidationFile.empty())
+  {
+    if (!revalidation.load(revalidationFile))
+      std::cerr << "Warning: Could not read revalidation queue " << revalidationFile
+                << "." << std::endl;
+    else if (!revalidation.empty() && !silent)
+      std::clog << "Info: " << revalidation.size() << " outdated report(s) of earlier "
+                << "runs wait for revalidation." << std::endl;
+  }
+  strategy->setFreshnessPolicy(&freshness);
+  strategy->setPendingScans(pendingScans.get());
+  strategy->setScanAddedHandler([&poller](const std::string& scan_id) { poller.added(scan_id); });
+  strategy->setUploadLedger(uploadLedger.get(), reuploadAfterDays);
+  strategy->setUploadOutbox(outbox.get());
+  // digests of the files are computed in batches, as far as they are needed
+  scantool::virustotal::HashBatch hashBatch(files_scan);
+  /* The scan-and-forget strategy only uses digests for the upload ledger, so
+     batches would otherwise read the files without need. Files that go into
+     the outbox are not read at all. Handlers detect the format on their own. */
+  const bool useHashBatch = (selectedStrategy != scantool::virustotal::Strategy::ScanAndForget)
+      || ((uploadLedger != nullptr) && (outbox == nullptr));
+  if (useHashBatch)
+    strategy->setHashBatch(&hashBatch);
+  // batch of the files that are currently scanned
+  scantool::virustotal::HashBatch* activeBatch = &hashBatch;
+  for (const auto& [fileName, digest] : manifestDigests)
+  {
+    hashBatch.setKnownDigest(fileName, digest);
+  }
+  // Digests of unchanged files can be taken from the hash cache.
+  std::unique_ptr<scantool::hash::HashCache> hashCache = nullptr;
+  if (!hashCacheFile.empty())
+  {
+    hashCache = std::make_unique<scantool::hash::HashCache>(hashCacheFile);
+    if (!hashCache->load())
+    {
+      std::cerr << "Warning: Could not read hash cache file " << hashCacheFile
+                << ", all files will be hashed again." << std::endl;
+    }
+    hashBatch.setHashCache(hashCache.get());
+  }
+  // Unchanged files can take their verdict from the journal of earlier runs.
+  std::unique_ptr<scantool::virustotal::RunJournal> journal = nullptr;
+  std::set<std::string>::size_type journalVerdicts = 0;
+  if (!journalFile.empty())
+  {
+    journal = std::make_unique<scantool::virustotal::RunJournal>(journalFile);
+    if (!journal->load())
+    {
+      std::cerr << "Warning: Could not read journal file " << journalFile
+                << ", all files will be scanned again." << std::endl;
+    }
+    strategy->setJournal(journal.get());
+    poller.setJournal(journal.get());
+  }
+
+  if (!serveSocket.empty())
+  {
+    // All requests of the service go through one pool of connections.
+    if (!Curly::shareConnections())
+      std::cerr << "Warning: Connections to VirusTotal cannot be reused." << std::endl;
+
+    scantool::virustotal::ServiceBackend backend(scanVT, freshness, hashCache.get(),
+        cacheWriter.get(), requestCacheDirVT, useRequestCache, silent,
+        mapHashToReport, mapFileToHash, processedFiles, totalFiles);
+    scantool::virustotal::ScanService service = backend.makeService(serveSocket);
+    if (!service.start())
+    {
+      std::cerr << "Error: Could not start the scan service on " << serveSocket
+                << "!" << std::endl;
+      return scantool::rcFileError;
+    }
+    if (!silent)
+      std::clog << "Info: Scan service is listening on " << serveSocket << "." << std::endl;
+    // The service runs until it is stopped by a signal.
+    while (service.serve(std::chrono::seconds(1)))
+    {
+      handleSignals();
+    }
+    std::cerr << "Error: The scan service failed!" << std::endl;
+    return scantool::rcScanError;
+  } // if program runs as scan service
 
   // check, if user wants ZIP handler
   if (handleZIP)
@@ -879,11 +2059,94 @@ int main(int argc, char ** argv)
     strategy->addHandler(std::unique_ptr<scantool::virustotal::HandlerRar>(new scantool::virustotal::HandlerRar(true)));
   }
 
-  // iterate over all files for scan requests
-  for(const std::string& i : files_scan)
+  // The directories are searched while the first found files are scanned.
+  std::unique_ptr<scantool::filesystem::DirectoryWalker> walker = nullptr;
+  if (!recursiveDirs.empty())
+  {
+    walker = std::make_unique<scantool::filesystem::DirectoryWalker>(walkOptions);
+    walker->start(recursiveDirs);
+  }
+  // Watching starts before the scan, so that no changes are missed.
+  std::unique_ptr<scantool::filesystem::DirectoryWatcher> watcher = nullptr;
+  if (!watchDirs.empty())
   {
+    watcher = std::make_unique<scantool::filesystem::DirectoryWatcher>(walkOptions,
+        std::chrono::seconds(watchDelay >= 0 ? watchDelay : 2));
+    if (!watcher->start(watchDirs))
+    {
+      std::cerr << "Error: Could not watch the given directories for changes!"
+                << std::endl;
+      return scantool::rcFileError;
+    }
+  }
+
+  // number of files that were left to other shards
+  std::set<std::string>::size_type shardSkipped = 0;
+  const auto skipForShard = [&]() -> int
+  {
+    ++shardSkipped;
+    ++processedFiles;
+    return 0;
+  };
+
+  const auto scanSingleFile = [&](const std::string& fileName) -> int
+  {
+    // Files of other shards are left to the other nodes.
+    if (!shard.all() && shardByPath && !shard.containsPath(fileName))
+      return skipForShard();
+    // Take the verdict of unchanged files from the journal, if it is recent.
+    scantool::hash::FileStatus status{};
+    scantool::virustotal::RunJournal::Entry entry;
+    if ((journal != nullptr) && scantool::hash::FileStatus::get(fileName, status)
+        && journal->lookup(fileName, status, entry))
+    {
+      if (!shard.all() && !shardByPath && !shard.containsDigest(entry.digest.toHexString()))
+        return skipForShard();
+      const scantool::virustotal::ScannerV2::Report report = entry.report();
+      if (!freshness.isOutdated(report))
+      {
+        if (report.positives == 0)
+        {
+          if (!silent)
+            std::cout << fileName << " OK" << std::endl;
+        }
+        else
+        {
+          if (!silent)
+            std::clog << fileName << (report.positives <= maybeLimit ? " might be infected" : " is INFECTED")
+                      << ", got " << report.positives << " positives." << std::endl;
+          // add file to list of infected files
+          mapFileToHash[fileName] = report.sha256;
+          // Keep a complete report, if there is one.
+          mapHashToReport.insert(std::make_pair(report.sha256, report));
+        }
+        ++journalVerdicts;
+        ++processedFiles;
+        return 0;
+      }
+    } // if file is in journal
+    if (!shard.all() && !shardByPath)
+    {
+      /* The digest is kept for the strategy, so the file is not read twice.
+         Unreadable files are left to the first shard, which reports them. */
+      const SHA256::MessageDigest digest = activeBatch->digest(fileName);
+      if (digest.isNull())
+      {
+        if (!shard.containsDigest(std::string()))
+          return skipForShard();
+      }
+      else
+      {
+        if (!shard.containsDigest(digest.toHexString()))
+          return skipForShard();
+        activeBatch->setKnownDigest(fileName, digest);
+      }
+    } // if files are assigned to shards by content
+    /* The age limit is taken per file, because watched directories are
+       scanned for a long time after the start of the program. */
+    const auto ageLimit = std::chrono::system_clock::now() - std::chrono::hours(24*maxAgeInDays);
     // apply strategy to current file
-    const int exitCode = strategy->scan(scanVT, i, cacheMgr, requestCacheDirVT,
+    const int exitCode = strategy->scan(scanVT, fileName, cacheMgr, requestCacheDirVT,
         useRequestCache, silent, maybeLimit, maxAgeInDays, ageLimit,
         mapHashToReport, mapFileToHash, queued_scans, lastQueuedScanTime,
         largeFiles, processedFiles, totalFiles);
@@ -892,90 +2155,402 @@ int main(int argc, char ** argv)
       return exitCode;
     // increase number of processed files
     ++processedFiles;
-  }
+    // Keep new verdicts, even if the program is terminated later.
+    if ((journal != nullptr) && !journal->flush())
+    {
+      std::cerr << "Warning: Could not write to journal file " << journalFile
+                << "." << std::endl;
+    }
+    // use requests that would otherwise remain unused for polls and revalidation
+    poller.pollIdle();
+    revalidation.processIdle(scanVT, cacheMgr, silent);
+    return 0;
+  };
+
+  // writes a checkpoint, if checkpoints are enabled
+  const auto saveCheckpoint = [&]()
+  {
+    if ((checkpoint != nullptr)
+        && !checkpoint->save(mapFileToHash, mapHashToReport, queued_scans, largeFiles))
+      std::cerr << "Warning: Could not write to state file " << checkpointFile
+                << "." << std::endl;
+  };
 
-  // try to retrieve queued scans
-  if (!queued_scans.empty())
+  const auto scanFile = [&](const std::string& fileName) -> int
   {
-    const auto duration = std::chrono::steady_clock::now() - lastQueuedScanTime;
-    if (duration < std::chrono::seconds(60))
+    // A checkpoint written here contains only completed files.
+    handleSignals();
+    if (checkpoint == nullptr)
+      return scanSingleFile(fileName);
+    // Files that were completed before the interruption are not scanned again.
+    if (checkpoint->completed(fileName))
     {
-      if (!silent)
-        std::cout << "Giving VirusTotal some extra seconds to finish queued scans."
-                  << std::endl;
-      // Wait until 60 seconds since last queued scan are expired.
-      std::this_thread::sleep_for(std::chrono::seconds(60) - duration);
-    } // if not enough time elapsed
+      ++resumedFiles;
+      ++processedFiles;
+      return 0;
+    }
+    const int exitCode = scanSingleFile(fileName);
+    if (exitCode != 0)
+      return exitCode;
+    checkpoint->markCompleted(fileName);
+    if (checkpoint->due())
+      saveCheckpoint();
+    return 0;
+  };
+
+  // hands the files that were put into the outbox off to the drainer
+  const auto flushOutbox = [&]() -> int
+  {
+    if ((outbox != nullptr) && !outbox->flush())
+    {
+      std::cerr << "Error: Could not write to upload outbox " << outboxFile << "!" << std::endl;
+      return scantool::rcFileError;
+    }
+    return 0;
+  };
+
+  // scans a chunk of files from a feed or a watched directory
+  const auto scanChunk = [&](const std::set<std::string>& chunk) -> int
+  {
+    totalFiles += chunk.size();
+    // Each chunk of files is hashed as one batch.
+    scantool::virustotal::HashBatch chunkBatch(chunk);
+    chunkBatch.setHashCache(hashCache.get());
+    activeBatch = &chunkBatch;
+    if (useHashBatch)
+      strategy->setHashBatch(&chunkBatch);
+    int exitCode = 0;
+    for (const std::string& i : chunk)
+    {
+      exitCode = scanFile(i);
+      if (exitCode != 0)
+        break;
+    }
+    activeBatch = &hashBatch;
+    if (useHashBatch)
+      strategy->setHashBatch(&hashBatch);
+    if (exitCode != 0)
+      return exitCode;
+    return flushOutbox();
+  };
 
-    auto qsIter = queued_scans.begin();
-    while (qsIter != queued_scans.end())
+  // Files in the outbox are uploaded until it is empty.
+  if (drainBox != nullptr)
+  {
+    totalFiles = drainBox->size();
+    std::string fileName;
+    /* Many failures in a row rather mean that the network or the API key
+       fails, and then the files shall not be parked one after another. */
+    const unsigned int maximumFailuresInRow = 10;
+    unsigned int failuresInRow = 0;
+    int lastFailure = 0;
+    while (failuresInRow < maximumFailuresInRow)
     {
-      const std::string& scan_id = qsIter->first;
-      const std::string& filename = qsIter->second;
-      scantool::virustotal::ScannerV2::Report report;
-      if (scanVT.getReport(scan_id, report, false, std::string()))
+      handleSignals();
+      if (!drainBox->next(fileName))
       {
-        if (report.successfulRetrieval())
-        {
-          // got report
-          if (report.positives == 0)
-          {
-            if (!silent)
-              std::cout << filename << " OK" << std::endl;
-          }
-          else if (report.positives <= maybeLimit)
-          {
-            if (!silent)
-              std::clog << filename << " might be infected, got " << report.positives
-                        << " positives." << std::endl;
-            // if hash is not given, recalculate it
-            if (report.sha256.empty())
-            {
-              report.sha256 = SHA256::computeFromFile(filename).toHexString();
-            } // if hash is not present
-            // add file to list of infected files
-            mapFileToHash[filename] = report.sha256;
-            mapHashToReport[report.sha256] = report;
-          }
-          else if (report.positives > maybeLimit)
-          {
-            if (!silent)
-              std::clog << filename << " is INFECTED, got " << report.positives
-                        << " positives." << std::endl;
-            // add file to list of infected files
-            mapFileToHash[filename] = report.sha256;
-            mapHashToReport[report.sha256] = report;
-          } // else
-        } // if file was in report database
-        else if (report.stillInQueue())
-        {
-          /* Response code -2 means that this stuff is still queued for
-             analysis. Most likely any of the following items will still be
-             queued, too, so we break out of the for loop here.
-          */
-          break;
-        }
-        else
-        {
-          std::cerr << "Error: Got unexpected response code (" << report.response_code
-                    << ") from API. No further report retrieval of queued scans." << std::endl;
+        // Producers may have put more files into the outbox in the meantime.
+        if (!drainBox->load() || !drainBox->next(fileName))
           break;
-        }
-        queued_scans.erase(qsIter);
-        qsIter = queued_scans.begin();
-      } // if report could be retrieved
+        totalFiles = processedFiles + drainBox->size();
+      }
+      // A failed upload must not block the files behind it.
+      const int exitCode = scanSingleFile(fileName);
+      if (exitCode == 0)
+      {
+        drainBox->done(fileName);
+        failuresInRow = 0;
+      }
       else
       {
-        if (!silent)
-          std::clog << "Warning: Could not get queued scan report for scan ID "
-                    << scan_id << " / file " << filename << "!" << std::endl;
-        ++qsIter;
+        ++failuresInRow;
+        lastFailure = exitCode;
+        if (drainBox->failed(fileName))
+          std::cerr << "Warning: Could not upload " << fileName << ", it will be "
+                    << "tried again after the other files in the outbox." << std::endl;
+        else
+          std::cerr << "Warning: Could not upload " << fileName << " after "
+                    << scantool::virustotal::UploadOutbox::cMaximumAttempts
+                    << " attempts, it is parked in the outbox until it is added again."
+                    << std::endl;
+      }
+      if (!drainBox->flush())
+      {
+        std::cerr << "Error: Could not write to upload outbox " << drainFile << "!" << std::endl;
+        return scantool::rcFileError;
+      }
+    } // while
+    if (!drainBox->compact())
+      std::cerr << "Warning: Could not compact upload outbox " << drainFile << "." << std::endl;
+    if (drainBox->parked() > 0)
+      std::cerr << "Warning: " << drainBox->parked() << " file(s) in the outbox "
+                << drainFile << " could not be uploaded." << std::endl;
+    if (failuresInRow >= maximumFailuresInRow)
+    {
+      std::cerr << "Error: The last " << failuresInRow << " uploads failed, the "
+                << "remaining files stay in the outbox." << std::endl;
+      return lastFailure;
+    }
+  } // if outbox is drained
+
+  // iterate over all files for scan requests
+  for(const std::string& i : files_scan)
+  {
+    const int exitCode = scanFile(i);
+    if (exitCode != 0)
+      return exitCode;
+  }
+  const int outboxCode = flushOutbox();
+  if (outboxCode != 0)
+    return outboxCode;
+
+  // Files from lists and directories are scanned as they are read or found.
+  std::vector<scantool::filesystem::FileFeed*> feeds;
+  for (const auto& list : fileLists)
+  {
+    feeds.push_back(list.get());
+  }
+  if (walker != nullptr)
+    feeds.push_back(walker.get());
+  // Duplicates are detected by fingerprints, full paths would take too much
+  // memory for long lists.
+  scantool::filesystem::PathSet seen;
+  if (!feeds.empty())
+  {
+    for (const std::string& fileName : files_scan)
+    {
+      seen.insert(fileName);
+    }
+  }
+  for (scantool::filesystem::FileFeed* feed : feeds)
+  {
+    std::vector<std::string> found;
+    while (feed->next(found, scantool::virustotal::HashBatch::cDefaultBatchSize))
+    {
+      std::set<std::string> chunk;
+      for (auto& fileName : found)
+      {
+        if (seen.insert(fileName))
+          chunk.insert(std::move(fileName));
+      }
+      const int exitCode = scanChunk(chunk);
+      if (exitCode != 0)
+        return exitCode;
+    }
+  } // for feed
+  for (const auto& list : fileLists)
+  {
+    if (list->failed())
+      std::cerr << "Error: Could not read the list " << list->fileName()
+                << " completely, the remaining files were not scanned." << std::endl;
+  }
+  fileLists.clear();
+  if (walker != nullptr)
+  {
+    for (const auto& dirName : walker->failedDirectories())
+    {
+      std::cerr << "Warning: Could not read directory " << dirName
+                << ", its files were not scanned." << std::endl;
+    }
+    walker = nullptr;
+  } // if directories were searched
+
+  // Watched directories get scanned until the program is terminated.
+  if (watcher != nullptr)
+  {
+    if (!silent)
+      std::clog << "Info: Watching " << watcher->directoryCount() << " director"
+                << (watcher->directoryCount() == 1 ? "y" : "ies") << " for new "
+                << "or changed files." << std::endl;
+    std::vector<std::string> changed;
+    while (watcher->wait(changed, scantool::virustotal::HashBatch::cDefaultBatchSize, std::chrono::seconds(15)))
+    {
+      handleSignals();
+      for (const auto& dirName : watcher->takeFailedDirectories())
+      {
+        std::cerr << "Warning: Could not watch directory " << dirName
+                  << ", changes of its files will not be scanned." << std::endl;
+      }
+      if (watcher->takeEventsLost())
+      {
+        std::cerr << "Warning: Too many changes at once, some changes may have "
+                  << "been lost. All watched files will be scanned again." << std::endl;
+      }
+      if (!changed.empty())
+      {
+        const int exitCode = scanChunk(std::set<std::string>(changed.begin(), changed.end()));
+        if (exitCode != 0)
+          return exitCode;
+        continue;
+      } // if files were changed
+      // Idle time is used for reports of queued scans and for revalidation.
+      // Retrieved reports do not have to be polled again after a restart.
+      if ((poller.pollIdle() > 0) || ((checkpoint != nullptr) && checkpoint->due()))
+        saveCheckpoint();
+      revalidation.processIdle(scanVT, cacheMgr, silent);
+    } // while
+    watcher = nullptr;
+  } // if directories are watched
+
+  // Reports of queued scans are polled until they are done or the time is up.
+  if (!poller.empty())
+  {
+    const auto pollDeadline = std::chrono::steady_clock::now()
+        + std::chrono::seconds(pollTime >= 0 ? pollTime : 300);
+    if (!silent)
+      std::cout << "Giving VirusTotal some extra time to finish " << poller.size()
+                << " queued scan(s)." << std::endl;
+    while (!poller.empty())
+    {
+      handleSignals();
+      if (poller.pollNext())
+        continue;
+      const auto nextPoll = poller.nextPoll();
+      if (nextPoll > pollDeadline)
+        break;
+      // The waiting time can be used for revalidation.
+      revalidation.processUntil(scanVT, cacheMgr, silent, nextPoll);
+      // The wait ends early, if a signal arrives.
+      const auto wakeUp = std::min(nextPoll, poller.nextPoll());
+      while ((terminationSignal == 0) && (statisticsSignal == 0)
+             && (std::chrono::steady_clock::now() < wakeUp))
+      {
+        std::this_thread::sleep_until(std::min(wakeUp,
+            std::chrono::steady_clock::now() + std::chrono::seconds(1)));
       }
     } // while
+    // Retrieved reports do not have to be polled again after a restart.
+    saveCheckpoint();
   } // if some scans are/were queued
 
   // show the summary, e.g. infected files, too large files, and unfinished queued scans
   showSummary(mapFileToHash, mapHashToReport, queued_scans, largeFiles);
+  if (!rescans.empty() && !silent)
+    std::clog << "Info: " << rescans.size() << " rescan(s) did not finish in time, "
+              << "the verdicts of these files are based on outdated reports." << std::endl;
+  if ((resumedFiles > 0) && !silent)
+    std::clog << "Info: " << resumedFiles << " file(s) were completed before the "
+              << "interruption and were not scanned again." << std::endl;
+  if (!shard.all() && !silent)
+    std::clog << "Info: Shard " << shard.toString() << " skipped " << shardSkipped
+              << " file(s) that belong to other shards." << std::endl;
+  if ((outbox != nullptr) && !silent)
+    std::clog << "Info: " << outbox->size() << " file(s) wait in the upload outbox "
+              << outboxFile << ". Use --drain-outbox " << outboxFile << " to upload them."
+              << std::endl;
+  // The summaries of several shards can be merged later.
+  bool summaryWritten = true;
+  if (!summaryFile.empty())
+  {
+    summaryWritten = saveSummary(summaryFile, mapFileToHash, mapHashToReport,
+                                 queued_scans, largeFiles);
+    if (!summaryWritten)
+      std::cerr << "Error: Could not write summary file " << summaryFile << "!" << std::endl;
+  }
+
+  // Verdicts are complete, so only requests that need no waiting are spent
+  // on rescans. The remaining ones are left to later runs.
+  // Later runs retrieve the reports of the requested rescans.
+  if (!revalidation.empty())
+    revalidation.processIdle(scanVT, cacheMgr, silent);
+  if (!revalidation.empty())
+  {
+    const std::size_t remaining = revalidation.size();
+    if (revalidationFile.empty())
+    {
+      if (!silent)
+        std::clog << "Info: No rescans were requested for " << remaining
+                  << " outdated report(s)." << std::endl;
+    }
+    else if (!revalidation.save(revalidationFile))
+    {
+      std::cerr << "Warning: Could not write revalidation queue " << revalidationFile
+                << ", " << remaining << " outdated report(s) will not be revalidated."
+                << std::endl;
+    }
+    else if (!silent)
+    {
+      std::clog << "Info: " << remaining << " outdated report(s) will be revalidated "
+                << "by later runs." << std::endl;
+    }
+  }
+
+  // New digests are already in the hash cache, only replaced ones are removed.
+  if ((hashCache != nullptr) && !hashCache->compact())
+  {
+    std::cerr << "Warning: Could not update hash cache file " << hashCacheFile
+              << "." << std::endl;
+  }
+  else if ((hashCache != nullptr) && !silent)
+  {
+    std::clog << "Info: " << hashCache->hits() << " of "
+              << (hashCache->hits() + hashCache->misses())
+              << " file digest(s) were taken from the hash cache." << std::endl;
+  }
+
+  // Scans that are still queued are kept for later runs.
+  if ((pendingScans != nullptr) && !pendingScans->compact())
+  {
+    std::cerr << "Warning: Could not update file of pending scans " << pendingFile
+              << "." << std::endl;
+  }
+  else if ((pendingScans != nullptr) && !queued_scans.empty() && !silent)
+  {
+    std::clog << "Info: The reports of the queued scans will be retrieved by later "
+              << "runs that use " << pendingFile << "." << std::endl;
+  }
+
+  // Uploads are already in the ledger, only expired ones are removed.
+  if (uploadLedger != nullptr)
+  {
+    // Without an interval nothing expires, because nothing was looked up.
+    const std::time_t expired = (reuploadAfterDays > 0)
+        ? std::time(nullptr) - static_cast<std::time_t>(reuploadAfterDays) * 86400
+        : 0;
+    if (!uploadLedger->compact(expired))
+      std::cerr << "Warning: Could not update upload ledger " << uploadLedgerFile
+                << "." << std::endl;
+  }
+
+  // New verdicts are already in the journal, only replaced ones are removed.
+  if ((journal != nullptr) && !journal->compact())
+  {
+    std::cerr << "Warning: Could not update journal file " << journalFile
+              << "." << std::endl;
+  }
+  else if ((journal != nullptr) && !silent)
+  {
+    std::clog << "Info: " << journalVerdicts << " of " << processedFiles
+              << " file(s) were unchanged and got their verdict from the journal."
+              << std::endl;
+  }
+
+  // write the remaining reports to the request cache
+  if (cacheWriter != nullptr)
+  {
+    cacheWriter->finish();
+    if (cacheWriter->failed() > 0)
+      std::cerr << "Warning: " << cacheWriter->failed() << " report(s) could "
+                << "not be written to the request cache." << std::endl;
+  }
+
+  // The state is only needed for queued scans whose reports are still missing.
+  if (checkpoint != nullptr)
+  {
+    if (queued_scans.empty())
+    {
+      if (!checkpoint->remove())
+        std::cerr << "Warning: Could not remove state file " << checkpointFile
+                  << "." << std::endl;
+    }
+    else
+    {
+      saveCheckpoint();
+      if (!silent)
+        std::clog << "Info: The reports of the queued scans can be retrieved "
+                  << "later with --resume " << checkpointFile << "." << std::endl;
+    }
+  } // if checkpoints are enabled
 
-  return 0;
+  return summaryWritten ? 0 : scantool::rcFileError;
 }
@@ -0,0 +1,153 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "serviceScan.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include "ServiceClient.hpp"
+#include "summary.hpp"
+#include "../../libstriezel/filesystem/file.hpp"
+#include "../ReturnCodes.hpp"
+
+namespace scantool::virustotal
+{
+
+int scanWithService(const std::string& socketPath, const std::set<std::string>& files,
+                    const Lane lane, const int maybeLimit, const bool silent,
+                    std::map<std::string, ScannerV2::Report>& mapHashToReport,
+                    std::map<std::string, std::string>& mapFileToHash,
+                    QueuedScanMap& queued_scans,
+                    std::vector<std::pair<std::string, int64_t> >& largeFiles,
+                    std::set<std::string>::size_type& processedFiles)
+{
+  ServiceClient client;
+  if (!client.connect(socketPath))
+  {
+    std::cerr << "Error: Could not connect to the scan service on " << socketPath
+              << "!" << std::endl;
+    return scantool::rcScanError;
+  }
+  // The service may run in another directory, so it needs absolute paths.
+  std::map<std::string, std::string> mapPathToFile;
+  for (const std::string& fileName : files)
+  {
+    ServiceRequest request;
+    request.lane = lane;
+    request.command = ServiceRequest::Command::Scan;
+    request.argument = fileName;
+    #if defined(__linux__)
+    char* resolved = realpath(fileName.c_str(), nullptr);
+    if (resolved != nullptr)
+    {
+      request.argument = std::string(resolved);
+      free(resolved);
+    }
+    #endif
+    mapPathToFile[request.argument] = fileName;
+    if (!client.send(request))
+    {
+      std::cerr << "Error: Could not send request for " << fileName
+                << " to the scan service!" << std::endl;
+      return scantool::rcScanError;
+    }
+  }
+  client.finish();
+
+  int exitCode = 0;
+  for (std::size_t received = 0; received < mapPathToFile.size(); ++received)
+  {
+    ServiceReply reply;
+    if (!client.receive(reply))
+    {
+      std::cerr << "Error: Did not get all replies from the scan service!" << std::endl;
+      exitCode = scantool::rcScanError;
+      break;
+    }
+    const auto found = mapPathToFile.find(reply.argument);
+    const std::string fileName = (found != mapPathToFile.end()) ? found->second : reply.argument;
+    ++processedFiles;
+    switch (reply.status)
+    {
+      case ServiceReply::Status::Report:
+           if (reply.positives == 0)
+           {
+             if (!silent)
+               std::cout << fileName << " OK" << std::endl;
+           }
+           else
+           {
+             if (!silent)
+               std::clog << fileName << (reply.positives <= maybeLimit ? " might be infected" : " is INFECTED")
+                         << ", got " << reply.positives << " positives." << std::endl;
+             ScannerV2::Report report;
+             report.response_code = 1;
+             report.positives = reply.positives;
+             report.total = reply.total;
+             report.sha256 = reply.digest;
+             // add file to list of infected files
+             mapFileToHash[fileName] = reply.digest;
+             mapHashToReport[reply.digest] = report;
+           }
+           break;
+      case ServiceReply::Status::Queued:
+           {
+             if (!silent)
+               std::clog << "Info: File " << fileName << " was queued for scan. Scan ID is "
+                         << reply.scanId << "." << std::endl;
+             QueuedScan record;
+             record.fileName = fileName;
+             record.origin = fileName;
+             record.sha256 = reply.digest;
+             record.size = libstriezel::filesystem::file::getSize64(fileName);
+             record.submitted = std::chrono::system_clock::now();
+             queued_scans.emplace(reply.scanId, record);
+           }
+           break;
+      case ServiceReply::Status::Unknown:
+           std::cerr << "Error: The scan service has no report for " << fileName
+                     << "!" << std::endl;
+           exitCode = scantool::rcScanError;
+           break;
+      case ServiceReply::Status::Error:
+      default:
+           if (reply.reason == "too-large")
+           {
+             const int64_t fileSize = libstriezel::filesystem::file::getSize64(fileName);
+             if (!silent)
+               std::cout << "Warning: File " << fileName << " is "
+                         << libstriezel::filesystem::getSizeString(fileSize)
+                         << " and exceeds maximum file size for scan! "
+                         << "File will be skipped." << std::endl;
+             largeFiles.push_back(std::pair<std::string, int64_t>(fileName, fileSize));
+             break;
+           }
+           std::cerr << "Error: The scan service could not scan " << fileName
+                     << " (" << reply.reason << ")." << std::endl;
+           exitCode = scantool::rcScanError;
+           break;
+    } // switch
+  } // for
+  // show the summary, e.g. infected files, too large files and queued scans
+  showSummary(mapFileToHash, mapHashToReport, queued_scans, largeFiles);
+  return exitCode;
+}
+
+} // namespace
@@ -0,0 +1,61 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_VT_SERVICESCAN_HPP
+#define SCANTOOL_VT_SERVICESCAN_HPP
+
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../virustotal/ScannerV2.hpp"
+#include "QueuedScan.hpp"
+#include "ServiceProtocol.hpp"
+
+namespace scantool::virustotal
+{
+
+/** \brief lets a scan service scan files and shows the summary
+ *
+ * \param socketPath       path of the socket of the scan service
+ * \param files            the files to scan
+ * \param lane             lane for the requests
+ * \param maybeLimit       limit for "maybe infected"; higher count means infected
+ * \param silent           whether output will be reduced
+ * \param mapHashToReport  map that maps SHA256 hashes to corresponding report; key = SHA256 hash, value = scan report
+ * \param mapFileToHash    map that maps filename to hash; key = file name, value = SHA256 hash
+ * \param queued_scans     list of queued scan requests; key = scan_id, value = queued scan record
+ * \param largeFiles       list of files that exceed the file size for scans; first = file name, second = file size in octets
+ * \param processedFiles   number of files whose reply was received
+ * \return Returns zero, if all files were handled by the service.
+ *         Returns a non-zero exit code otherwise.
+ */
+int scanWithService(const std::string& socketPath, const std::set<std::string>& files,
+                    const Lane lane, const int maybeLimit, const bool silent,
+                    std::map<std::string, ScannerV2::Report>& mapHashToReport,
+                    std::map<std::string, std::string>& mapFileToHash,
+                    QueuedScanMap& queued_scans,
+                    std::vector<std::pair<std::string, int64_t> >& largeFiles,
+                    std::set<std::string>::size_type& processedFiles);
+
+} // namespace
+
+#endif // SCANTOOL_VT_SERVICESCAN_HPP
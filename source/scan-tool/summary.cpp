@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2015, 2016, 2025  Dirk Stolle
+    Copyright (C) 2015, 2016, 2025, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -20,7 +20,12 @@
 
 #include "summary.hpp"
 #include <algorithm>
+#include <charconv>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <set>
+#include <string_view>
 #include "../../libstriezel/filesystem/file.hpp"
 
 namespace scantool::virustotal
@@ -28,7 +33,7 @@ namespace scantool::virustotal
 
 void showSummary(const std::map<std::string, std::string>& mapFileToHash,
                  std::map<std::string, ScannerV2::Report>& mapHashToReport,
-                 const std::unordered_map<std::string, std::string>& queued_scans,
+                 const QueuedScanMap& queued_scans,
                  std::vector<std::pair<std::string, int64_t> >& largeFiles)
 {
   //list possibly infected files
@@ -64,7 +69,10 @@ void showSummary(const std::map<std::string, std::string>& mapFileToHash,
               << std::endl;
     for(auto& qElem : queued_scans)
     {
-      std::cout << "  " << qElem.second << " (scan ID " << qElem.first << ")" << std::endl;
+      std::cout << "  " << qElem.second.displayName() << " (scan ID " << qElem.first;
+      if (!qElem.second.sha256.empty())
+        std::cout << ", SHA256 " << qElem.second.sha256;
+      std::cout << ")" << std::endl;
     } //for (range-based)
   } //if there are some queued scans
 
@@ -93,4 +101,223 @@ void showSummary(const std::map<std::string, std::string>& mapFileToHash,
   } //if there are some "large" files
 }
 
+/** \brief Replaces line breaks in a text of a report by spaces.
+ *
+ * \param text  the text
+ * \return Returns the text without line breaks.
+ */
+static std::string singleLine(std::string text)
+{
+  std::replace_if(text.begin(), text.end(),
+                  [](const char c) { return (c == '\r') || (c == '\n'); }, ' ');
+  return text;
+}
+
+std::string formatSummary(const std::map<std::string, std::string>& mapFileToHash,
+                          const std::map<std::string, ScannerV2::Report>& mapHashToReport,
+                          const QueuedScanMap& queued_scans,
+                          const std::vector<std::pair<std::string, int64_t> >& largeFiles,
+                          std::vector<std::string>* skippedNames)
+{
+  // Names with line breaks would forge lines, so they are left out.
+  const auto storable = [skippedNames](const std::string& name)
+  {
+    if (name.find_first_of("\r\n") == std::string::npos)
+      return true;
+    if (skippedNames != nullptr)
+      skippedNames->push_back(name);
+    return false;
+  };
+
+  /* line formats:
+     report SHA-256 positives total scan_date
+     detection SHA-256 engine<TAB>result
+     file SHA-256 path
+     queued scan_id SHA-256 size name
+     large size path
+     Unknown hashes are written as "-". */
+  std::string content = "# scan-tool summary\n";
+  for (const auto& [hash, report] : mapHashToReport)
+  {
+    content.append("report ").append(hash).append(" ")
+           .append(std::to_string(report.positives)).append(" ")
+           .append(std::to_string(report.total)).append(" ")
+           .append(singleLine(report.scan_date)).append("\n");
+    for (const auto& engine : report.scans)
+    {
+      if (engine->detected)
+        content.append("detection ").append(hash).append(" ").append(singleLine(engine->engine))
+               .append("\t").append(singleLine(engine->result)).append("\n");
+    }
+  } // for reports
+  for (const auto& [name, hash] : mapFileToHash)
+  {
+    if (!storable(name))
+      continue;
+    content.append("file ").append(hash.empty() ? "-" : hash).append(" ")
+           .append(name).append("\n");
+  }
+  for (const auto& [scan_id, queued] : queued_scans)
+  {
+    if (!storable(queued.displayName()))
+      continue;
+    content.append("queued ").append(scan_id).append(" ")
+           .append(queued.sha256.empty() ? "-" : queued.sha256).append(" ")
+           .append(std::to_string(queued.size)).append(" ")
+           .append(queued.displayName()).append("\n");
+  }
+  for (const auto& [name, size] : largeFiles)
+  {
+    if (!storable(name))
+      continue;
+    content.append("large ").append(std::to_string(size)).append(" ")
+           .append(name).append("\n");
+  }
+  return content;
+}
+
+bool saveSummary(const std::string& fileName,
+                 const std::map<std::string, std::string>& mapFileToHash,
+                 const std::map<std::string, ScannerV2::Report>& mapHashToReport,
+                 const QueuedScanMap& queued_scans,
+                 const std::vector<std::pair<std::string, int64_t> >& largeFiles)
+{
+  std::vector<std::string> skippedNames;
+  const std::string content = formatSummary(mapFileToHash, mapHashToReport,
+                                            queued_scans, largeFiles, &skippedNames);
+  for (const auto& name : skippedNames)
+  {
+    std::cerr << "Warning: The name of the file \"" << name << "\" contains a "
+              << "line break, so the file is not written to the summary file "
+              << fileName << "." << std::endl;
+  }
+  std::ofstream output(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!output.good())
+    return false;
+  output.write(content.data(), content.size());
+  output.close();
+  return output.good();
+}
+
+/** \brief Splits the next space-separated field off a line.
+ *
+ * \param line   the remaining line, will hold the rest after the field
+ * \param field  variable that will hold the field
+ * \return Returns true, if a non-empty field was found.
+ */
+static bool nextField(std::string_view& line, std::string_view& field)
+{
+  const auto space = line.find(' ');
+  field = line.substr(0, space);
+  line = (space == std::string_view::npos) ? std::string_view() : line.substr(space + 1);
+  return !field.empty();
+}
+
+/** \brief Parses a number field.
+ *
+ * \param field  the field
+ * \param value  variable that will hold the number
+ * \return Returns true, if the field is a number.
+ */
+template<typename T>
+static bool parseNumber(const std::string_view field, T& value)
+{
+  const auto result = std::from_chars(field.data(), field.data() + field.size(), value);
+  return (result.ec == std::errc()) && (result.ptr == field.data() + field.size());
+}
+
+bool parseSummary(std::istream& input,
+                  std::map<std::string, std::string>& mapFileToHash,
+                  std::map<std::string, ScannerV2::Report>& mapHashToReport,
+                  QueuedScanMap& queued_scans,
+                  std::vector<std::pair<std::string, int64_t> >& largeFiles)
+{
+  // hashes of the reports that were added by this file
+  std::set<std::string> added;
+  std::string text;
+  while (std::getline(input, text))
+  {
+    if (!text.empty() && (text.back() == '\r'))
+      text.pop_back();
+    if (text.empty() || (text[0] == '#'))
+      continue;
+    std::string_view line(text);
+    std::string_view type;
+    std::string_view hash;
+    if (!nextField(line, type))
+      continue;
+    if (type == "report")
+    {
+      std::string_view positives;
+      std::string_view total;
+      ScannerV2::Report report;
+      if (!nextField(line, hash) || !nextField(line, positives) || !nextField(line, total)
+          || !parseNumber(positives, report.positives) || !parseNumber(total, report.total))
+        continue;
+      report.sha256 = std::string(hash);
+      report.scan_date = std::string(line);
+      // Reports for the same file from different runs are the same.
+      if (mapHashToReport.insert(std::make_pair(report.sha256, report)).second)
+        added.insert(report.sha256);
+    }
+    else if (type == "detection")
+    {
+      if (!nextField(line, hash))
+        continue;
+      const auto separator = line.find('\t');
+      const auto iter = mapHashToReport.find(std::string(hash));
+      // Reports that were known before already have their detections.
+      if ((separator == std::string_view::npos) || (iter == mapHashToReport.end())
+          || (added.find(iter->first) == added.end()))
+        continue;
+      auto engine = std::make_shared<ScannerV2::Report::Engine>();
+      engine->engine = std::string(line.substr(0, separator));
+      engine->detected = true;
+      engine->result = std::string(line.substr(separator + 1));
+      iter->second.scans.push_back(engine);
+    }
+    else if (type == "file")
+    {
+      if (!nextField(line, hash) || line.empty())
+        continue;
+      mapFileToHash[std::string(line)] = (hash == "-") ? std::string() : std::string(hash);
+    }
+    else if (type == "queued")
+    {
+      std::string_view scan_id;
+      std::string_view size;
+      QueuedScan queued;
+      if (!nextField(line, scan_id) || !nextField(line, hash) || !nextField(line, size)
+          || !parseNumber(size, queued.size) || line.empty())
+        continue;
+      // Only the name for the user is known, not the file on disk.
+      queued.origin = std::string(line);
+      if (hash != "-")
+        queued.sha256 = std::string(hash);
+      queued_scans.emplace(std::string(scan_id), queued);
+    }
+    else if (type == "large")
+    {
+      std::string_view size;
+      int64_t fileSize = 0;
+      if (!nextField(line, size) || !parseNumber(size, fileSize) || line.empty())
+        continue;
+      largeFiles.push_back(std::make_pair(std::string(line), fileSize));
+    }
+  } // while
+  return !input.bad();
+}
+
+bool loadSummary(const std::string& fileName,
+                 std::map<std::string, std::string>& mapFileToHash,
+                 std::map<std::string, ScannerV2::Report>& mapHashToReport,
+                 QueuedScanMap& queued_scans,
+                 std::vector<std::pair<std::string, int64_t> >& largeFiles)
+{
+  std::ifstream input(fileName, std::ios::in | std::ios::binary);
+  if (!input)
+    return false;
+  return parseSummary(input, mapFileToHash, mapHashToReport, queued_scans, largeFiles);
+}
+
 } // namespace
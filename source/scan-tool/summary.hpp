@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2015, 2016, 2025  Dirk Stolle
+    Copyright (C) 2015, 2016, 2025, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -21,12 +21,13 @@
 #ifndef SCANTOOL_SUMMARY_HPP
 #define SCANTOOL_SUMMARY_HPP
 
+#include <istream>
 #include <map>
 #include <string>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 #include "../virustotal/ScannerV2.hpp"
+#include "QueuedScan.hpp"
 
 namespace scantool::virustotal
 {
@@ -35,12 +36,92 @@ namespace scantool::virustotal
  *
  * \param mapFileToHash    map that maps filename to hash; key = file name, value = SHA256 hash
  * \param mapHashToReport  map that maps SHA256 hashes to corresponding report; key = SHA256 hash, value = scan report
- * \param queued_scans     list of queued scan requests; key = scan_id, value = file name
+ * \param queued_scans     list of queued scan requests; key = scan_id, value = queued scan record
  * \param largeFiles       list of files that exceed the file size for scans; first = file name, second = file size in octets
  */
 void showSummary(const std::map<std::string, std::string>& mapFileToHash,
                  std::map<std::string, ScannerV2::Report>& mapHashToReport,
-                 const std::unordered_map<std::string, std::string>& queued_scans,
+                 const QueuedScanMap& queued_scans,
+                 std::vector<std::pair<std::string, int64_t> >& largeFiles);
+
+
+/** \brief Formats the summary of a scan-tool run as text.
+ *
+ * \param mapFileToHash    map that maps filename to hash; key = file name, value = SHA256 hash
+ * \param mapHashToReport  map that maps SHA256 hashes to corresponding report; key = SHA256 hash, value = scan report
+ * \param queued_scans     list of queued scan requests; key = scan_id, value = queued scan record
+ * \param largeFiles       list of files that exceed the file size for scans; first = file name, second = file size in octets
+ * \param skippedNames     optional list that gets the names of files that were
+ *                         left out, because they contain line breaks
+ * \return Returns the lines of the summary, as they are written by saveSummary().
+ * \remarks A line break in a file name would end the line early, and the
+ *          rest of the name would be read as a line of its own. So files
+ *          with such names are left out, and line breaks in the texts of
+ *          reports are replaced by spaces.
+ */
+std::string formatSummary(const std::map<std::string, std::string>& mapFileToHash,
+                          const std::map<std::string, ScannerV2::Report>& mapHashToReport,
+                          const QueuedScanMap& queued_scans,
+                          const std::vector<std::pair<std::string, int64_t> >& largeFiles,
+                          std::vector<std::string>* skippedNames = nullptr);
+
+
+/** \brief Writes the summary of a scan-tool run into a file, so that the
+ *         summaries of several runs can be merged later.
+ *
+ * \param fileName         path of the summary file
+ * \param mapFileToHash    map that maps filename to hash; key = file name, value = SHA256 hash
+ * \param mapHashToReport  map that maps SHA256 hashes to corresponding report; key = SHA256 hash, value = scan report
+ * \param queued_scans     list of queued scan requests; key = scan_id, value = queued scan record
+ * \param largeFiles       list of files that exceed the file size for scans; first = file name, second = file size in octets
+ * \return Returns true, if the file was written. Returns false otherwise.
+ * \remarks Only the detections of the reports are written, results of
+ *          engines that did not detect anything are left out. Files whose
+ *          names contain line breaks are left out, too, and a warning about
+ *          them is written to the standard error output.
+ */
+bool saveSummary(const std::string& fileName,
+                 const std::map<std::string, std::string>& mapFileToHash,
+                 const std::map<std::string, ScannerV2::Report>& mapHashToReport,
+                 const QueuedScanMap& queued_scans,
+                 const std::vector<std::pair<std::string, int64_t> >& largeFiles);
+
+
+/** \brief Reads the lines of a summary from a stream and adds them to the
+ *         given summary.
+ *
+ * \param input            the stream
+ * \param mapFileToHash    map that maps filename to hash; key = file name, value = SHA256 hash
+ * \param mapHashToReport  map that maps SHA256 hashes to corresponding report; key = SHA256 hash, value = scan report
+ * \param queued_scans     list of queued scan requests; key = scan_id, value = queued scan record
+ * \param largeFiles       list of files that exceed the file size for scans; first = file name, second = file size in octets
+ * \return Returns true, if the stream was read. Returns false otherwise.
+ * \remarks Malformed lines and lines of unknown types are skipped. Queued
+ *          scans only get the name of the file for the user, but no file
+ *          name on disk.
+ */
+bool parseSummary(std::istream& input,
+                  std::map<std::string, std::string>& mapFileToHash,
+                  std::map<std::string, ScannerV2::Report>& mapHashToReport,
+                  QueuedScanMap& queued_scans,
+                  std::vector<std::pair<std::string, int64_t> >& largeFiles);
+
+
+/** \brief Reads a summary file written by saveSummary() and adds its content
+ *         to the given summary.
+ *
+ * \param fileName         path of the summary file
+ * \param mapFileToHash    map that maps filename to hash; key = file name, value = SHA256 hash
+ * \param mapHashToReport  map that maps SHA256 hashes to corresponding report; key = SHA256 hash, value = scan report
+ * \param queued_scans     list of queued scan requests; key = scan_id, value = queued scan record
+ * \param largeFiles       list of files that exceed the file size for scans; first = file name, second = file size in octets
+ * \return Returns true, if the file was read. Returns false otherwise.
+ * \remarks Malformed lines are skipped.
+ */
+bool loadSummary(const std::string& fileName,
+                 std::map<std::string, std::string>& mapFileToHash,
+                 std::map<std::string, ScannerV2::Report>& mapHashToReport,
+                 QueuedScanMap& queued_scans,
                  std::vector<std::pair<std::string, int64_t> >& largeFiles);
 
 } // namespace
@@ -0,0 +1,236 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "CacheLayout.hpp"
+#include <fstream>
+#include <iostream>
+#include "../../libstriezel/common/StringUtils.hpp"
+#include "../../libstriezel/filesystem/directory.hpp"
+#include "../../libstriezel/filesystem/file.hpp"
+
+namespace scantool::virustotal
+{
+
+const unsigned int CacheLayout::cDefaultLevels = 1;
+const unsigned int CacheLayout::cDefaultWidth = 2;
+const std::string CacheLayout::cDescriptorFileName = "cache-layout.conf";
+
+CacheLayout::CacheLayout(const unsigned int levels, const unsigned int width)
+: m_Levels(cDefaultLevels),
+  m_Width(cDefaultWidth)
+{
+  if (isValid(levels, width))
+  {
+    m_Levels = levels;
+    m_Width = width;
+  }
+}
+
+bool CacheLayout::isValid(const unsigned int levels, const unsigned int width) noexcept
+{
+  /* More than 16^8 leaf directories make no sense for any realistic number
+     of cached reports, so the total prefix length is limited to eight. */
+  return (levels >= 1) && (levels <= 4) && (width >= 1) && (width <= 3)
+      && (levels * width <= 8);
+}
+
+unsigned int CacheLayout::levels() const noexcept
+{
+  return m_Levels;
+}
+
+unsigned int CacheLayout::width() const noexcept
+{
+  return m_Width;
+}
+
+unsigned int CacheLayout::directoriesPerLevel() const noexcept
+{
+  return 1u << (4 * m_Width);
+}
+
+bool CacheLayout::isDefault() const noexcept
+{
+  return (m_Levels == cDefaultLevels) && (m_Width == cDefaultWidth);
+}
+
+std::string CacheLayout::relativeDirectory(const std::string& resourceID) const
+{
+  std::string result;
+  result.reserve(m_Levels * (m_Width + 1));
+  for (unsigned int level = 0; level < m_Levels; ++level)
+  {
+    if (level > 0)
+      result.push_back(libstriezel::filesystem::pathDelimiter);
+    result.append(resourceID, level * m_Width, m_Width);
+  }
+  return result;
+}
+
+std::string CacheLayout::toString() const
+{
+  return std::to_string(m_Levels) + " level(s) of "
+       + std::to_string(directoriesPerLevel()) + " directories";
+}
+
+bool CacheLayout::fromString(const std::string& text, CacheLayout& layout)
+{
+  const auto x_pos = text.find('x');
+  if ((x_pos == std::string::npos) || (x_pos == 0))
+    return false;
+  unsigned int levels = 0;
+  unsigned int width = 0;
+  if (!stringToUnsignedInt(text.substr(0, x_pos), levels)
+      || !stringToUnsignedInt(text.substr(x_pos + 1), width))
+    return false;
+  if (!isValid(levels, width))
+    return false;
+  layout = CacheLayout(levels, width);
+  return true;
+}
+
+bool CacheLayout::loadFromCacheRoot(const std::string& cacheRoot, CacheLayout& layout)
+{
+  const std::string descriptor = libstriezel::filesystem::slashify(cacheRoot)
+                               + cDescriptorFileName;
+  if (!libstriezel::filesystem::file::exists(descriptor))
+  {
+    // Caches without descriptor use the traditional layout.
+    layout = CacheLayout();
+    return true;
+  }
+
+  std::ifstream input;
+  input.open(descriptor, std::ios::in | std::ios::binary);
+  if (!input)
+    return false;
+
+  unsigned int levels = 0;
+  unsigned int width = 0;
+  std::string line;
+  while (std::getline(input, line))
+  {
+    // check for possible carriage return at end (happens on Windows systems)
+    if (!line.empty() && (line.back() == '\r'))
+      line.erase(line.length() - 1);
+    // skip empty lines and comments
+    if (line.empty() || (line[0] == '#'))
+      continue;
+
+    const auto sep_pos = line.find('=');
+    if ((sep_pos == std::string::npos) || (sep_pos == 0))
+    {
+      std::cerr << "Error: Invalid line in cache layout descriptor: \""
+                << line << "\"." << std::endl;
+      return false;
+    }
+    const std::string name = line.substr(0, sep_pos);
+    const std::string value = line.substr(sep_pos + 1);
+    if (name == "levels")
+    {
+      if (!stringToUnsignedInt(value, levels))
+        return false;
+    }
+    else if (name == "width")
+    {
+      if (!stringToUnsignedInt(value, width))
+        return false;
+    }
+    else
+    {
+      std::cerr << "Error: Unknown entry in cache layout descriptor: \""
+                << line << "\"." << std::endl;
+      return false;
+    }
+  } // while
+
+  if (!isValid(levels, width))
+  {
+    std::cerr << "Error: Cache layout descriptor " << descriptor
+              << " contains an unsupported layout." << std::endl;
+    return false;
+  }
+  layout = CacheLayout(levels, width);
+  return true;
+}
+
+bool CacheLayout::saveToCacheRoot(const std::string& cacheRoot) const
+{
+  const std::string descriptor = libstriezel::filesystem::slashify(cacheRoot)
+                               + cDescriptorFileName;
+  std::ofstream output(descriptor, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!output.good())
+    return false;
+  output << "# scan-tool request cache layout, do not edit manually.\n"
+         << "# Use scan-tool-cache --relayout to change the layout.\n"
+         << "levels=" << m_Levels << "\n"
+         << "width=" << m_Width << "\n";
+  output.close();
+  return output.good();
+}
+
+void CacheLayout::forEachLeafDirectory(const std::string& cacheRoot, const std::function<void(const std::string&)>& func) const
+{
+  if (!libstriezel::filesystem::directory::exists(cacheRoot))
+    return;
+  visit(libstriezel::filesystem::unslashify(cacheRoot), 0, func);
+}
+
+void CacheLayout::visit(const std::string& directory, const unsigned int level, const std::function<void(const std::string&)>& func) const
+{
+  if (level == m_Levels)
+  {
+    func(directory);
+    return;
+  }
+  const auto entries = libstriezel::filesystem::getDirectoryFileList(directory);
+  for (const auto & entry : entries)
+  {
+    if (entry.isDirectory && isLevelDirectoryName(entry.fileName))
+    {
+      visit(directory + libstriezel::filesystem::pathDelimiter + entry.fileName,
+            level + 1, func);
+    }
+  } // for
+}
+
+bool CacheLayout::isLevelDirectoryName(const std::string& name) const
+{
+  if (name.size() != m_Width)
+    return false;
+  for (const char c : name)
+  {
+    if (!(((c >= '0') && (c <= '9')) || ((c >= 'a') && (c <= 'f'))))
+      return false;
+  }
+  return true;
+}
+
+bool CacheLayout::operator==(const CacheLayout& other) const noexcept
+{
+  return (m_Levels == other.m_Levels) && (m_Width == other.m_Width);
+}
+
+bool CacheLayout::operator!=(const CacheLayout& other) const noexcept
+{
+  return !(*this == other);
+}
+
+} // namespace
@@ -0,0 +1,199 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_VT_CACHELAYOUT_HPP
+#define SCANTOOL_VT_CACHELAYOUT_HPP
+
+#include <functional>
+#include <string>
+
+namespace scantool::virustotal
+{
+
+/** \brief Describes the directory fan-out of the request cache.
+ *
+ * Cached elements are distributed over nested subdirectories whose names are
+ * taken from the leading characters of the resource ID. The layout with one
+ * level and a width of two characters, e.g. "ab/ab16da...json", is the
+ * traditional layout with 256 subdirectories. Larger caches can use more
+ * levels, e.g. "ab/16/ab16da...json" for two levels of width two, to keep the
+ * number of files per directory small.
+ *
+ * The layout of a cache is recorded in a descriptor file in the cache's root
+ * directory. Caches without such a file use the traditional layout.
+ */
+class CacheLayout
+{
+  public:
+    /** \brief Constructor.
+     *
+     * \param levels  number of directory levels
+     * \param width   number of characters per directory name
+     * \remarks Invalid values result in the default layout.
+     */
+    CacheLayout(const unsigned int levels = cDefaultLevels, const unsigned int width = cDefaultWidth);
+
+
+    /// default number of directory levels
+    static const unsigned int cDefaultLevels;
+
+    /// default number of characters per directory name
+    static const unsigned int cDefaultWidth;
+
+    /// name of the descriptor file within the cache root directory
+    static const std::string cDescriptorFileName;
+
+
+    /** \brief Checks whether the given combination of levels and width is
+     *         supported.
+     *
+     * \param levels  number of directory levels
+     * \param width   number of characters per directory name
+     * \return Returns true, if the combination is supported.
+     */
+    static bool isValid(const unsigned int levels, const unsigned int width) noexcept;
+
+
+    /** \brief Gets the number of directory levels.
+     *
+     * \return Returns the number of directory levels.
+     */
+    unsigned int levels() const noexcept;
+
+
+    /** \brief Gets the number of characters per directory name.
+     *
+     * \return Returns the number of characters per directory name.
+     */
+    unsigned int width() const noexcept;
+
+
+    /** \brief Gets the number of directories per level.
+     *
+     * \return Returns the number of directories on each level, e.g. 256 for
+     *         a width of two characters.
+     */
+    unsigned int directoriesPerLevel() const noexcept;
+
+
+    /** \brief Checks whether this is the traditional layout with one level of
+     *         256 subdirectories.
+     *
+     * \return Returns true, if this is the default layout.
+     */
+    bool isDefault() const noexcept;
+
+
+    /** \brief Gets the relative directory path of a cached element.
+     *
+     * \param resourceID  the resource ID, i.e. a SHA256 hash
+     * \return Returns the relative path of the directory that contains the
+     *         cached element, e.g. "ab/16" (without trailing delimiter).
+     * \remarks The resource ID is not checked for validity here.
+     */
+    std::string relativeDirectory(const std::string& resourceID) const;
+
+
+    /** \brief Gets a human-readable description of the layout.
+     *
+     * \return Returns a string like "2 level(s) of 256 directories".
+     */
+    std::string toString() const;
+
+
+    /** \brief Tries to parse a layout from a string like "2x2".
+     *
+     * \param text  the string, format is LEVELSxWIDTH
+     * \param layout  variable that will hold the parsed layout
+     * \return Returns true, if the string could be parsed.
+     */
+    static bool fromString(const std::string& text, CacheLayout& layout);
+
+
+    /** \brief Tries to read the layout from the descriptor file of a cache.
+     *
+     * \param cacheRoot  the cache's root directory
+     * \param layout     variable that will hold the layout
+     * \return Returns true, if the descriptor was read or if it does not
+     *         exist (default layout). Returns false, if the descriptor is
+     *         present but invalid.
+     */
+    static bool loadFromCacheRoot(const std::string& cacheRoot, CacheLayout& layout);
+
+
+    /** \brief Writes the layout to the descriptor file of a cache.
+     *
+     * \param cacheRoot  the cache's root directory (must exist)
+     * \return Returns true, if the descriptor was written successfully.
+     */
+    bool saveToCacheRoot(const std::string& cacheRoot) const;
+
+
+    /** \brief Calls a function for each existing leaf directory of a cache.
+     *
+     * \param cacheRoot  the cache's root directory
+     * \param func       function that gets the path of each leaf directory
+     * \remarks Only directories with names matching the layout are visited,
+     *          and directories that do not exist are never touched, so the
+     *          cost only depends on the number of existing directories.
+     */
+    void forEachLeafDirectory(const std::string& cacheRoot, const std::function<void(const std::string&)>& func) const;
+
+
+    /** \brief Checks for equality.
+     *
+     * \param other  the other layout
+     * \return Returns true, if both layouts are equal.
+     */
+    bool operator==(const CacheLayout& other) const noexcept;
+
+
+    /** \brief Checks for inequality.
+     *
+     * \param other  the other layout
+     * \return Returns true, if both layouts are not equal.
+     */
+    bool operator!=(const CacheLayout& other) const noexcept;
+  private:
+    /** \brief Checks whether a name is a valid directory name for this layout.
+     *
+     * \param name  the directory name
+     * \return Returns true, if the name consists of exactly width() lower
+     *         case hexadecimal digits.
+     */
+    bool isLevelDirectoryName(const std::string& name) const;
+
+
+    /** \brief Visits the existing directories of one level recursively.
+     *
+     * \param directory  the current directory
+     * \param level      level of the current directory (zero is the root)
+     * \param func       function that gets the path of each leaf directory
+     */
+    void visit(const std::string& directory, const unsigned int level, const std::function<void(const std::string&)>& func) const;
+
+
+    unsigned int m_Levels; /**< number of directory levels */
+    unsigned int m_Width;  /**< number of characters per directory name */
+}; // class
+
+} // namespace
+
+#endif // SCANTOOL_VT_CACHELAYOUT_HPP
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2015, 2016, 2017, 2021, 2025  Dirk Stolle
+    Copyright (C) 2015, 2016, 2017, 2021, 2025, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -19,12 +19,15 @@
 */
 
 #include <iostream>
+#include <map>
+#include <mutex>
 #include "../../libstriezel/common/StringUtils.hpp"
 #include "../../libstriezel/filesystem/directory.hpp"
 #include "../../libstriezel/filesystem/file.hpp"
 #include "../../libstriezel/hash/sha256/sha256.hpp"
 #include "../ReturnCodes.hpp"
 #include "CacheManagerV2.hpp"
+#include "CacheWriter.hpp"
 #include "ReportV2.hpp"
 
 namespace scantool::virustotal
@@ -32,8 +35,15 @@ namespace scantool::virustotal
 
 const int64_t maxCacheFileSize = 1024 * 1024 * 2;
 
+/* Layouts of cache directories that have been used so far, so that the
+   layout descriptor does not have to be read for every cached element. */
+static std::mutex knownLayoutsMutex;
+static std::map<std::string, CacheLayout> knownLayouts;
+
 CacheManagerV2::CacheManagerV2(const std::string& cacheRoot)
-: m_CacheRoot(cacheRoot)
+: m_CacheRoot(cacheRoot),
+  m_Layout(CacheLayout()),
+  m_CacheWriter(nullptr)
 {
   /* Nobody likes accidental directory traversals via malformed input. */
   if (m_CacheRoot.find(std::string("..") + libstriezel::filesystem::pathDelimiter)
@@ -42,6 +52,7 @@ CacheManagerV2::CacheManagerV2(const std::string& cacheRoot)
   // Use default path instead of empty string.
   if (m_CacheRoot.empty())
     m_CacheRoot = getDefaultCacheDirectory();
+  m_Layout = getLayoutForCacheRoot(m_CacheRoot);
 }
 
 std::string CacheManagerV2::getDefaultCacheDirectory()
@@ -77,34 +88,79 @@ bool CacheManagerV2::createCacheDirectory()
     if (!libstriezel::filesystem::directory::createRecursive(m_CacheRoot))
       return false;
   } // if cache directory does not exist
+  // record the layout, so that all tools use the same layout
+  const std::string descriptor = libstriezel::filesystem::slashify(m_CacheRoot)
+                               + CacheLayout::cDescriptorFileName;
+  if (!libstriezel::filesystem::file::exists(descriptor))
+  {
+    if (!m_Layout.saveToCacheRoot(m_CacheRoot))
+      return false;
+  }
+  /* Create the sub directories of the first level. Deeper levels of the
+     layout are created on demand by createDirectoryForCachedElement(). */
   const std::vector<char> subChars = { '0', '1', '2', '3', '4', '5', '6', '7',
                                        '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'};
-  // create sub directories
-  for (const auto & charOne : subChars)
+  const unsigned int count = m_Layout.directoriesPerLevel();
+  for (unsigned int i = 0; i < count; ++i)
   {
-    for (const auto & charTwo : subChars)
+    std::string name(m_Layout.width(), '0');
+    for (unsigned int pos = 0; pos < m_Layout.width(); ++pos)
     {
-      const auto subDirectory = m_CacheRoot + libstriezel::filesystem::pathDelimiter
-                              + std::string(1, charOne) + std::string(1, charTwo);
-      if (!libstriezel::filesystem::directory::exists(subDirectory))
-      {
-        // try to create the directory
-        if (!libstriezel::filesystem::directory::create(subDirectory))
-          return false;
-      } // if cache sub directory does not exist
-    } // for (inner)
-  } // for (outer)
+      name[m_Layout.width() - 1 - pos] = subChars[(i >> (4 * pos)) & 0xF];
+    }
+    const auto subDirectory = m_CacheRoot + libstriezel::filesystem::pathDelimiter
+                            + name;
+    if (!libstriezel::filesystem::directory::exists(subDirectory))
+    {
+      // try to create the directory
+      if (!libstriezel::filesystem::directory::create(subDirectory))
+        return false;
+    } // if cache sub directory does not exist
+  } // for
 
   // Cache directory already exists. We've got nothing more to do here.
   return true;
 }
 
+const CacheLayout& CacheManagerV2::getLayout() const noexcept
+{
+  return m_Layout;
+}
+
+CacheLayout CacheManagerV2::getLayoutForCacheRoot(const std::string& cacheRoot)
+{
+  const std::string key = libstriezel::filesystem::unslashify(cacheRoot);
+  std::lock_guard<std::mutex> guard(knownLayoutsMutex);
+  const auto iter = knownLayouts.find(key);
+  if (iter != knownLayouts.end())
+    return iter->second;
+
+  CacheLayout layout;
+  if (!CacheLayout::loadFromCacheRoot(key, layout))
+  {
+    std::cerr << "Warning: The layout descriptor of the cache in " << key
+              << " could not be read. Using the default layout instead."
+              << std::endl;
+    layout = CacheLayout();
+  }
+  /* Only remember layouts of existing caches. Otherwise a layout that is
+     written later (e.g. by createCacheDirectory()) would go unnoticed. */
+  if (libstriezel::filesystem::directory::exists(key))
+    knownLayouts[key] = layout;
+  return layout;
+}
+
 std::string CacheManagerV2::getPathForCachedElement(const std::string& resourceID) const
 {
-  return getPathForCachedElement(resourceID, m_CacheRoot);
+  return getPathForCachedElement(resourceID, m_CacheRoot, m_Layout);
 }
 
 std::string CacheManagerV2::getPathForCachedElement(const std::string& resourceID, const std::string& cacheRoot)
+{
+  return getPathForCachedElement(resourceID, cacheRoot, getLayoutForCacheRoot(cacheRoot));
+}
+
+std::string CacheManagerV2::getPathForCachedElement(const std::string& resourceID, const std::string& cacheRoot, const CacheLayout& layout)
 {
   /* Only SHA256 hashes are valid resource identifiers. Hashes with timestamp,
      e.g. "4beb421019d7d2177d46d08227103a930c6ae35b2eff6d17217734ed0c8ee96f-1450132861",
@@ -118,17 +174,45 @@ std::string CacheManagerV2::getPathForCachedElement(const std::string& resourceI
       != std::string::npos)
     return std::string("");
 
-  /* General path for a cached element is
+  /* General path for a cached element with the default layout is
      ~/.scan-tool/vt-cache/<first two characters of resource ID>/<resourceID>.json,
      e.g. ~/.scan-tool/vt-cache/ab/ab16da937795be615ce4bef4e4d5337e782a7e982ff13cea1ece3e89d914678f.json
      for the resource "ab16da937795be615ce4bef4e4d5337e782a7e982ff13cea1ece3e89d914678f".
+     Layouts with more levels add further subdirectories, e.g.
+     ~/.scan-tool/vt-cache/ab/16/ab16da937795be615ce4bef4e4d5337e782a7e982ff13cea1ece3e89d914678f.json
   */
-  return libstriezel::filesystem::slashify(cacheRoot) + resourceID.substr(0, 2)
+  return libstriezel::filesystem::slashify(cacheRoot) + layout.relativeDirectory(resourceID)
        + libstriezel::filesystem::pathDelimiter + resourceID + ".json";
 }
 
+bool CacheManagerV2::createDirectoryForCachedElement(const std::string& resourceID, const std::string& cacheRoot)
+{
+  const std::string path = getPathForCachedElement(resourceID, cacheRoot);
+  if (path.empty())
+    return false;
+  const std::string directory = path.substr(0, path.rfind(libstriezel::filesystem::pathDelimiter));
+  if (libstriezel::filesystem::directory::exists(directory))
+    return true;
+  /* Another thread or process may have created the directory in the meantime,
+     so a failed creation is only an error, if the directory is still missing. */
+  return libstriezel::filesystem::directory::createRecursive(directory)
+      || libstriezel::filesystem::directory::exists(directory);
+}
+
+void CacheManagerV2::setCacheWriter(CacheWriter* writer) noexcept
+{
+  m_CacheWriter = writer;
+}
+
 bool CacheManagerV2::deleteCachedElement(const std::string& resourceID)
 {
+  // A queued write would bring the element back later.
+  if (m_CacheWriter != nullptr)
+  {
+    const std::string cachedFile = getPathForCachedElement(resourceID);
+    if (!cachedFile.empty())
+      m_CacheWriter->cancel(cachedFile);
+  }
   return deleteCachedElement(resourceID, m_CacheRoot);
 }
 
@@ -164,93 +248,83 @@ uint_least32_t CacheManagerV2::checkIntegrity(const bool deleteCorrupted, const
 
   uint_least32_t corrupted = 0;
 
-  const std::vector<char> subChars = { '0', '1', '2', '3', '4', '5', '6', '7',
-                                       '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'};
-  for (const auto firstChar : subChars)
+  m_Layout.forEachLeafDirectory(m_CacheRoot,
+      [&](const std::string& currentSubDirectory)
   {
-    for (const auto secondChar : subChars)
+    const auto files = libstriezel::filesystem::getDirectoryFileList(currentSubDirectory);
+    #ifdef SCAN_TOOL_DEBUG
+    std::clog << "Found " << files.size() << " files in "
+              << currentSubDirectory << "." << std::endl;
+    #endif // SCAN_TOOL_DEBUG
+    for (auto const & file : files)
     {
-      const std::string currentSubDirectory = libstriezel::filesystem::slashify(m_CacheRoot)
-                      + std::string(1, firstChar) + std::string(1, secondChar);
-      if (libstriezel::filesystem::directory::exists(currentSubDirectory))
+      // entry must not be a directory and have valid file name
+      if (!file.isDirectory && isCachedElementName(file.fileName))
       {
-        const auto files = libstriezel::filesystem::getDirectoryFileList(currentSubDirectory);
-        #ifdef SCAN_TOOL_DEBUG
-        std::clog << "Found " << files.size() << " files in "
-                  << currentSubDirectory << "." << std::endl;
-        #endif // SCAN_TOOL_DEBUG
-        for (auto const & file : files)
+        const auto fileName = currentSubDirectory
+              + libstriezel::filesystem::pathDelimiter + file.fileName;
+        const auto fileSize = libstriezel::filesystem::file::getSize64(fileName);
+        // check, if file is way too large for a proper cache file
+        if (fileSize >= maxCacheFileSize)
         {
-          // entry must not be a directory and have valid file name
-          if (!file.isDirectory && isCachedElementName(file.fileName))
+          // Several kilobytes are alright, but not megabytes.
+          ++corrupted;
+          std::clog << "Info: JSON file " << fileName
+                    << " is too large for a cached response!" << std::endl;
+          if (deleteCorrupted)
+            libstriezel::filesystem::file::remove(fileName);
+        } // if file is too large
+        else
+        {
+          std::string content = "";
+          if (libstriezel::filesystem::file::readIntoString(fileName, content))
           {
-            const auto fileName = currentSubDirectory
-                  + libstriezel::filesystem::pathDelimiter + file.fileName;
-            const auto fileSize = libstriezel::filesystem::file::getSize64(fileName);
-            // check, if file is way too large for a proper cache file
-            if (fileSize >= maxCacheFileSize)
+            ReportV2 report;
+            if (report.fromJsonString(content))
             {
-              // Several kilobytes are alright, but not megabytes.
-              ++corrupted;
-              std::clog << "Info: JSON file " << fileName
-                        << " is too large for a cached response!" << std::endl;
-              if (deleteCorrupted)
+              // response code zero means: file not known to VirusTotal
+              if (deleteUnknown && (report.response_code == 0))
+              {
+                std::cout << "Info: " << fileName << " contains no relevant data." << std::endl;
                 libstriezel::filesystem::file::remove(fileName);
-            } // if file is too large
+              } // if report can be deleted
+              // check SHA256 hash and location
+              else if ((report.sha256 != file.fileName.substr(0, 64))
+                       or (getPathForCachedElement(report.sha256) != fileName))
+              {
+                std::cout << "Info: SHA256 hash of " << file.fileName
+                          << " is \"" << report.sha256 << "\" and does not"
+                          << " match file name." << std::endl;
+                ++corrupted;
+                if (deleteCorrupted)
+                  libstriezel::filesystem::file::remove(fileName);
+              } // else if SHA256 does not match
+            } // if report could be filled from JSON
             else
             {
-              std::string content = "";
-              if (libstriezel::filesystem::file::readIntoString(fileName, content))
-              {
-                ReportV2 report;
-                if (report.fromJsonString(content))
-                {
-                  // response code zero means: file not known to VirusTotal
-                  if (deleteUnknown && (report.response_code == 0))
-                  {
-                    std::cout << "Info: " << fileName << " contains no relevant data." << std::endl;
-                    libstriezel::filesystem::file::remove(fileName);
-                  } // if report can be deleted
-                  // check SHA256 hash
-                  else if ((report.sha256 != file.fileName.substr(0, 64))
-                           or (firstChar != file.fileName[0])
-                           or (secondChar != file.fileName[1]))
-                  {
-                    std::cout << "Info: SHA256 hash of " << file.fileName
-                              << " is \"" << report.sha256 << "\" and does not"
-                              << " match file name." << std::endl;
-                    ++corrupted;
-                    if (deleteCorrupted)
-                      libstriezel::filesystem::file::remove(fileName);
-                  } // else if SHA256 does not match
-                } // if report could be filled from JSON
-                else
-                {
-                  // JSON data is probably not a report
-                  std::clog << "Info: JSON data from " << fileName << " could not be parsed!" << std::endl;
-                  ++corrupted;
-                  if (deleteCorrupted)
-                    libstriezel::filesystem::file::remove(fileName);
-                }
-              } // if file was read
-              else
-              {
-                std::cout << "Error: Could not read file " << fileName << "!"
-                          << std::endl;
-              }
-            } // else (file size might be OK)
-          } // if JSON file with correct name
+              // JSON data is probably not a report
+              std::clog << "Info: JSON data from " << fileName << " could not be parsed!" << std::endl;
+              ++corrupted;
+              if (deleteCorrupted)
+                libstriezel::filesystem::file::remove(fileName);
+            }
+          } // if file was read
           else
           {
-            if (!file.isDirectory)
-            {
-              std::cout << "Info: File " << file.fileName << " has incorrect naming scheme." << std::endl;
-            }
-          } // else (incorrect naming)
-        } // for (inner)
-      } // if subdirectory exists
-    } // for (2nd char)
-  } // for (1st char)
+            std::cout << "Error: Could not read file " << fileName << "!"
+                      << std::endl;
+          }
+        } // else (file size might be OK)
+      } // if JSON file with correct name
+      else
+      {
+        if (!file.isDirectory)
+        {
+          std::cout << "Info: File " << file.fileName << " has incorrect naming scheme." << std::endl;
+        }
+      } // else (incorrect naming)
+    } // for
+  }); // lambda for each leaf directory
   return corrupted;
 }
 
@@ -331,7 +405,8 @@ uint_least32_t CacheManagerV2::transitionOneTo256()
             else
             {
               const std::string newPath = getPathForCachedElement(file.fileName.substr(0, 64));
-              if (libstriezel::filesystem::file::rename(fileName, newPath))
+              if (createDirectoryForCachedElement(file.fileName.substr(0, 64), m_CacheRoot)
+                  && libstriezel::filesystem::file::rename(fileName, newPath))
                 ++moved_files;
               else
               {
@@ -355,7 +430,7 @@ uint_least32_t CacheManagerV2::transitionOneTo256()
     } // if JSON file with correct name
     else
     {
-      if (!file.isDirectory)
+      if (!file.isDirectory && (file.fileName != CacheLayout::cDescriptorFileName))
       {
         std::cout << "Info: File " << file.fileName << " has incorrect naming scheme." << std::endl;
       }
@@ -370,6 +445,10 @@ uint_least32_t CacheManagerV2::transition16To256()
   if (!libstriezel::filesystem::directory::exists(m_CacheRoot))
     return 0;
 
+  // Single character directories are part of the current layout.
+  if (m_Layout.width() == 1)
+    return 0;
+
   uint_least32_t moved_files = 0;
 
   const std::vector<std::string> sub = { std::string("0"), "1", "2", "3", "4",
@@ -419,7 +498,8 @@ uint_least32_t CacheManagerV2::transition16To256()
                 else
                 {
                   const std::string newPath = getPathForCachedElement(file.fileName.substr(0, 64));
-                  if (libstriezel::filesystem::file::rename(fileName, newPath))
+                  if (createDirectoryForCachedElement(file.fileName.substr(0, 64), m_CacheRoot)
+                      && libstriezel::filesystem::file::rename(fileName, newPath))
                     ++moved_files;
                   else
                   {
@@ -461,4 +541,111 @@ uint_least32_t CacheManagerV2::transition16To256()
   return moved_files;
 }
 
+int CacheManagerV2::changeLayout(const CacheLayout& newLayout)
+{
+  if (newLayout == m_Layout)
+  {
+    std::cout << "Info: The cache already uses " << newLayout.toString()
+              << ". Nothing to do here." << std::endl;
+    return 0;
+  }
+
+  if (libstriezel::filesystem::directory::exists(m_CacheRoot))
+  {
+    std::cout << "Moving cached files from " << m_Layout.toString() << " to "
+              << newLayout.toString() << ". This may take a while ..." << std::endl;
+  }
+  else if (!libstriezel::filesystem::directory::createRecursive(m_CacheRoot))
+  {
+    std::cout << "Error: Could not create cache directory " << m_CacheRoot
+              << "!" << std::endl;
+    return scantool::rcFileError;
+  }
+
+  uint_least32_t moved_files = 0;
+  uint_least32_t failed_moves = 0;
+  const std::string root = libstriezel::filesystem::unslashify(m_CacheRoot);
+  m_Layout.forEachLeafDirectory(m_CacheRoot,
+      [&](const std::string& currentSubDirectory)
+  {
+    const auto files = libstriezel::filesystem::getDirectoryFileList(currentSubDirectory);
+    for (auto const & file : files)
+    {
+      if (file.isDirectory || !isCachedElementName(file.fileName))
+        continue;
+      const auto fileName = currentSubDirectory
+            + libstriezel::filesystem::pathDelimiter + file.fileName;
+      if (moveCachedElement(fileName, file.fileName.substr(0, 64), root, newLayout))
+        ++moved_files;
+      else
+        ++failed_moves;
+    } // for
+    /* Remove the directory and its parents, if they are empty now. Removal
+       fails for non-empty directories, e.g. directories that are still used
+       by the new layout, and that is intended. */
+    std::string directory = currentSubDirectory;
+    while ((directory.size() > root.size())
+           && libstriezel::filesystem::directory::remove(directory))
+    {
+      directory.erase(directory.rfind(libstriezel::filesystem::pathDelimiter));
+    }
+  }); // lambda for each leaf directory
+
+  /* The descriptor is written even if some files could not be moved, because
+     the majority of cached files is already located in the new layout. */
+  if (!newLayout.saveToCacheRoot(m_CacheRoot))
+  {
+    std::cout << "Error: Could not write the layout descriptor of the cache!"
+              << std::endl;
+    return scantool::rcFileError;
+  }
+  {
+    std::lock_guard<std::mutex> guard(knownLayoutsMutex);
+    knownLayouts[root] = newLayout;
+  }
+  m_Layout = newLayout;
+  // create first level of directories for the new layout
+  if (!createCacheDirectory())
+  {
+    std::cout << "Error: Could not create new cache directory structure!" << std::endl;
+    return scantool::rcFileError;
+  }
+
+  if (failed_moves > 0)
+  {
+    std::cout << "Error: " << failed_moves << " cached file(s) could not be "
+              << "moved to the new layout!" << std::endl;
+    return scantool::rcFileError;
+  }
+  if (moved_files == 1)
+    std::cout << "One cached file was moved." << std::endl;
+  else
+    std::cout << moved_files << " cached files were moved." << std::endl;
+  std::cout << "The cache now uses " << newLayout.toString() << "." << std::endl;
+  return 0;
+}
+
+bool CacheManagerV2::moveCachedElement(const std::string& fileName, const std::string& resourceID, const std::string& cacheRoot, const CacheLayout& layout)
+{
+  const std::string newPath = getPathForCachedElement(resourceID, cacheRoot, layout);
+  if (newPath.empty())
+    return false;
+  if (newPath == fileName)
+    return true;
+  const std::string directory = newPath.substr(0, newPath.rfind(libstriezel::filesystem::pathDelimiter));
+  if (!libstriezel::filesystem::directory::exists(directory)
+      && !libstriezel::filesystem::directory::createRecursive(directory))
+  {
+    std::cout << "Error: Could not create directory " << directory << "!" << std::endl;
+    return false;
+  }
+  if (!libstriezel::filesystem::file::rename(fileName, newPath))
+  {
+    std::cout << "Error: Could not move file " << fileName << " to "
+              << newPath << "!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
 } // namespace
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2015, 2016, 2021  Dirk Stolle
+    Copyright (C) 2015, 2016, 2021, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -23,10 +23,14 @@
 
 #include <cstdint>
 #include <string>
+#include "CacheLayout.hpp"
 
 namespace scantool::virustotal
 {
 
+// forward declaration
+class CacheWriter;
+
 /** CacheManagerV2 can be used to manage the local request cache for
     VirusTotal API V2 reports. */
 class CacheManagerV2
@@ -67,6 +71,24 @@ class CacheManagerV2
     bool createCacheDirectory();
 
 
+    /** \brief Gets the directory layout of the current cache.
+     *
+     * \return Returns the layout of the current cache directory.
+     */
+    const CacheLayout& getLayout() const noexcept;
+
+
+    /** \brief Gets the directory layout of a cache.
+     *
+     * \param cacheRoot   the cache's root directory
+     * \return Returns the layout as recorded in the layout descriptor of the
+     *         cache. Returns the default layout, if there is no descriptor.
+     * \remarks The descriptor is only read once per cache directory and
+     *          program run, so repeated calls are cheap.
+     */
+    static CacheLayout getLayoutForCacheRoot(const std::string& cacheRoot);
+
+
     /** \brief Gets the hypothetical path for a cached element.
      *
      * \param resourceID  the resource ID, i.e. a SHA256 hash
@@ -93,6 +115,41 @@ class CacheManagerV2
     static std::string getPathForCachedElement(const std::string& resourceID, const std::string& cacheRoot);
 
 
+    /** \brief Gets the hypothetical path for a cached element,
+     *         using a custom cache root directory and layout.
+     *
+     * \param resourceID  the resource ID, i.e. a SHA256 hash
+     * \param cacheRoot   the cache's root directory
+     * \param layout      the directory layout of the cache
+     * \return Returns the full path to the file for the cached element.
+     * Returns an empty string, if @resourceID is an invalid resource ID.
+     */
+    static std::string getPathForCachedElement(const std::string& resourceID, const std::string& cacheRoot, const CacheLayout& layout);
+
+
+    /** \brief Creates the directory for a cached element, if it is missing.
+     *
+     * \param resourceID  the resource ID, i.e. a SHA256 hash
+     * \param cacheRoot   the cache's root directory
+     * \return Returns true, if the directory exists or was created.
+     *         Returns false, if the directory could not be created or if
+     *         @resourceID is an invalid resource ID.
+     * \remarks Layouts with more than one level only create the first level
+     *          in createCacheDirectory(), deeper levels are created on demand.
+     */
+    static bool createDirectoryForCachedElement(const std::string& resourceID, const std::string& cacheRoot);
+
+
+    /** \brief Sets the writer that performs queued writes to the cache.
+     *
+     * \param writer  the cache writer, or nullptr for none; the writer must
+     *                outlive this instance
+     * \remarks Pending writes for an element are discarded, when the element
+     *          is deleted via deleteCachedElement().
+     */
+    void setCacheWriter(CacheWriter* writer) noexcept;
+
+
     /** \brief Tries to delete the cached element for a given resource ID.
      *
      * \param resourceID  the resource ID, i.e. a SHA256 hash
@@ -147,7 +204,32 @@ class CacheManagerV2
      * main() function.
      */
     int performTransition();
+
+
+    /** \brief Moves all cached elements into a new directory layout and
+     *         records the new layout in the cache's layout descriptor.
+     *
+     * \param newLayout  the new directory layout
+     * \return Returns zero in case of success.
+     * Returns a non-zero value, if an error occurred.
+     * \remarks The returned value is suitable as exit code for the program's
+     * main() function. The operation should not be interrupted, because
+     * elements that are not moved yet will not be found with the new layout.
+     */
+    int changeLayout(const CacheLayout& newLayout);
   private:
+    /** \brief Moves a cached element to its location in a given layout.
+     *
+     * \param fileName   current path of the cached element
+     * \param resourceID the resource ID, i.e. a SHA256 hash
+     * \param cacheRoot  the cache's root directory
+     * \param layout     the layout that determines the new location
+     * \return Returns true, if the file was moved or already was at the
+     *         right location. Returns false otherwise.
+     */
+    static bool moveCachedElement(const std::string& fileName, const std::string& resourceID, const std::string& cacheRoot, const CacheLayout& layout);
+
+
     /** \brief Moves cached files from the old cache directory structure
      *         without subdirectories to their new location in the current
      *         directory structure with 256 subdirectories.
@@ -170,11 +252,16 @@ class CacheManagerV2
      *          0.22 till 0.25 of scan-tool.
      *          In order to perform the transition the new directories must
      *          already be present. Call createCacheDirectory() to achieve that.
+     *          Nothing is moved, if the current layout uses one character per
+     *          directory name, because then those 16 directories are part of
+     *          the current layout.
      */
     uint_least32_t transition16To256();
 
 
     std::string m_CacheRoot; /**< path to the chosen root cache directory */
+    CacheLayout m_Layout; /**< directory layout of the cache */
+    CacheWriter* m_CacheWriter; /**< writer for queued writes, may be nullptr */
 }; // class
 
 } // namespace
@@ -0,0 +1,288 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "CacheWriter.hpp"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <vector>
+#if defined(__linux__) || defined(linux)
+  #include <csignal>
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+#include "CacheManagerV2.hpp"
+
+namespace scantool::virustotal
+{
+
+const std::size_t CacheWriter::cDefaultCapacity = 1024;
+
+CacheWriter::CacheWriter(const std::size_t capacity, const bool syncToDisk)
+: m_Capacity(capacity > 0 ? capacity : 1),
+  m_Sync(syncToDisk),
+  m_Mutex(),
+  m_WorkAvailable(),
+  m_BatchDone(),
+  m_Order(std::deque<std::string>()),
+  m_Queued(std::unordered_map<std::string, PendingWrite>()),
+  m_InFlight(std::unordered_map<std::string, PendingWrite>()),
+  m_Stop(false),
+  m_Finished(false),
+  m_Written(0),
+  m_Coalesced(0),
+  m_Failed(0),
+  m_Thread()
+{
+  m_Thread = std::thread(&CacheWriter::run, this);
+}
+
+CacheWriter::~CacheWriter()
+{
+  finish();
+}
+
+bool CacheWriter::enqueue(const std::string& resourceID, const std::string& cacheRoot, const std::string& content)
+{
+  const std::string path = CacheManagerV2::getPathForCachedElement(resourceID, cacheRoot);
+  if (path.empty())
+    return false;
+
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  while (!m_Finished)
+  {
+    const auto iter = m_Queued.find(path);
+    if (iter != m_Queued.end())
+    {
+      // Only the newest content of an element needs to be written.
+      iter->second.content = content;
+      ++m_Coalesced;
+      return true;
+    }
+    if (m_Queued.size() < m_Capacity)
+    {
+      m_Queued[path] = PendingWrite{ resourceID, cacheRoot, content };
+      m_Order.push_back(path);
+      lock.unlock();
+      m_WorkAvailable.notify_one();
+      return true;
+    }
+    // Queue is full, wait for the writer thread to catch up.
+    m_BatchDone.wait(lock);
+  } // while
+
+  // There is no writer thread anymore, so write directly.
+  lock.unlock();
+  const bool success = writeElement(path, PendingWrite{ resourceID, cacheRoot, content });
+  lock.lock();
+  if (success)
+    ++m_Written;
+  else
+    ++m_Failed;
+  return success;
+}
+
+bool CacheWriter::pendingContent(const std::string& path, std::string& content) const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  // Queued writes are always newer than the writes of the current batch.
+  auto iter = m_Queued.find(path);
+  if (iter != m_Queued.end())
+  {
+    content = iter->second.content;
+    return true;
+  }
+  iter = m_InFlight.find(path);
+  if (iter != m_InFlight.end())
+  {
+    content = iter->second.content;
+    return true;
+  }
+  return false;
+}
+
+void CacheWriter::cancel(const std::string& path)
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  // The entry in m_Order is skipped by the writer thread later.
+  if (m_Queued.erase(path) > 0)
+    m_BatchDone.notify_all();
+  m_BatchDone.wait(lock, [this, &path]() { return m_InFlight.find(path) == m_InFlight.end(); });
+}
+
+void CacheWriter::finish()
+{
+  std::unique_lock<std::mutex> lock(m_Mutex, std::defer_lock);
+  /* finish() may be called by a signal handler that interrupted enqueue() in
+     the same thread. The mutex would never be released in that case, so give
+     up after a while instead of waiting forever. */
+  bool locked = false;
+  for (unsigned int attempt = 0; !locked && (attempt < 200); ++attempt)
+  {
+    locked = lock.try_lock();
+    if (!locked)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  if (!locked)
+  {
+    std::cerr << "Warning: Queued writes to the request cache could not be "
+              << "completed." << std::endl;
+    if (m_Thread.joinable())
+      m_Thread.detach();
+    return;
+  }
+  if (m_Finished)
+    return;
+  m_Finished = true;
+  m_Stop = true;
+  lock.unlock();
+  m_WorkAvailable.notify_one();
+  if (m_Thread.joinable())
+    m_Thread.join();
+}
+
+void CacheWriter::run()
+{
+  #if defined(__linux__) || defined(linux)
+  /* Signals shall be handled by the main thread, because the signal handler
+     of scan-tool calls finish() and that would never return in this thread. */
+  sigset_t allSignals;
+  sigfillset(&allSignals);
+  pthread_sigmask(SIG_BLOCK, &allSignals, nullptr);
+  #endif
+
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  while (true)
+  {
+    m_WorkAvailable.wait(lock, [this]() { return !m_Queued.empty() || m_Stop; });
+    if (m_Queued.empty())
+      break;
+
+    /* Everything that was queued while the previous batch was written forms
+       the next batch, so batches grow when the disk is slow. */
+    std::vector<std::string> batch;
+    batch.reserve(m_Queued.size());
+    for (const auto& path : m_Order)
+    {
+      const auto iter = m_Queued.find(path);
+      if (iter != m_Queued.end())
+      {
+        m_InFlight[path] = std::move(iter->second);
+        m_Queued.erase(iter);
+        batch.push_back(path);
+      }
+    } // for
+    m_Order.clear();
+    lock.unlock();
+    m_BatchDone.notify_all();
+
+    // Other threads only read m_InFlight while the batch is written.
+    uint_least32_t written = 0;
+    uint_least32_t failed = 0;
+    std::set<std::string> cacheRoots;
+    for (const auto& path : batch)
+    {
+      const PendingWrite& write = m_InFlight.at(path);
+      if (writeElement(path, write))
+        ++written;
+      else
+        ++failed;
+      cacheRoots.insert(write.cacheRoot);
+    } // for
+    if (m_Sync)
+    {
+      for (const auto& root : cacheRoots)
+      {
+        syncCache(root);
+      }
+    }
+
+    lock.lock();
+    m_InFlight.clear();
+    m_Written += written;
+    m_Failed += failed;
+    m_BatchDone.notify_all();
+  } // while
+}
+
+bool CacheWriter::writeElement(const std::string& path, const PendingWrite& write)
+{
+  // Deeper levels of the cache layout are created on demand.
+  if (!CacheManagerV2::createDirectoryForCachedElement(write.resourceID, write.cacheRoot))
+  {
+    std::cerr << "Error in CacheWriter::writeElement(): Directory for cached JSON could not be created!" << std::endl;
+    return false;
+  }
+  std::ofstream cachedJSON(path, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+  if (!cachedJSON.good())
+  {
+    std::cerr << "Error in CacheWriter::writeElement(): JSON data file could not be opened for update!" << std::endl;
+    return false;
+  }
+  cachedJSON.write(write.content.c_str(), write.content.size());
+  if (!cachedJSON.good())
+  {
+    cachedJSON.close();
+    std::cerr << "Error in CacheWriter::writeElement(): JSON data could not be written to cache!" << std::endl;
+    return false;
+  }
+  cachedJSON.close();
+  return true;
+}
+
+void CacheWriter::syncCache(const std::string& cacheRoot)
+{
+  #if defined(__linux__) || defined(linux)
+  // One syncfs() per batch is much cheaper than one fsync() per file.
+  const int fd = open(cacheRoot.c_str(), O_RDONLY | O_DIRECTORY);
+  if (fd < 0)
+    return;
+  if (syncfs(fd) != 0)
+  {
+    std::cerr << "Warning: Request cache " << cacheRoot << " could not be "
+              << "synchronized to disk." << std::endl;
+  }
+  close(fd);
+  #else
+  // No cheap way to synchronize a whole directory, leave it to the OS.
+  (void) cacheRoot;
+  #endif
+}
+
+uint_least32_t CacheWriter::written() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Written;
+}
+
+uint_least32_t CacheWriter::coalesced() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Coalesced;
+}
+
+uint_least32_t CacheWriter::failed() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Failed;
+}
+
+} // namespace
@@ -0,0 +1,164 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_VT_CACHEWRITER_HPP
+#define SCANTOOL_VT_CACHEWRITER_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace scantool::virustotal
+{
+
+/** \brief Writes elements of the request cache in a background thread.
+ *
+ * Writes are put into a bounded queue and are performed by a separate thread,
+ * so that the caller does not have to wait for the disk. Several writes to the
+ * same cached element that are still queued are coalesced into a single one.
+ * Optionally the written data is synchronized to disk once per batch of
+ * writes instead of once per file.
+ */
+class CacheWriter
+{
+  public:
+    /** \brief Constructor. Starts the writer thread.
+     *
+     * \param capacity    maximum number of queued writes; enqueue() blocks,
+     *                    if the queue is full
+     * \param syncToDisk  whether written data shall be synchronized to disk
+     *                    after each batch of writes
+     */
+    CacheWriter(const std::size_t capacity = cDefaultCapacity, const bool syncToDisk = false);
+
+
+    /** \brief Destructor. Writes all queued elements and stops the thread.
+     */
+    ~CacheWriter();
+
+
+    // There is only one writer thread per instance, so no copies.
+    CacheWriter(const CacheWriter& other) = delete;
+    CacheWriter& operator=(const CacheWriter& other) = delete;
+
+
+    /// default maximum number of queued writes
+    static const std::size_t cDefaultCapacity;
+
+
+    /** \brief Queues the content of a cached element for writing.
+     *
+     * \param resourceID  the resource ID, i.e. a SHA256 hash
+     * \param cacheRoot   the cache's root directory
+     * \param content     the content of the cached element (JSON)
+     * \return Returns true, if the write was queued or, after finish() has
+     *         been called, performed directly. Returns false, if the direct
+     *         write failed or if @resourceID is invalid.
+     */
+    bool enqueue(const std::string& resourceID, const std::string& cacheRoot, const std::string& content);
+
+
+    /** \brief Gets the content of a cached element that has not been
+     *         written completely yet.
+     *
+     * \param path     path of the cached element
+     * \param content  receives the content, if the element is pending
+     * \return Returns true, if a write for that element is pending.
+     *         Returns false otherwise.
+     */
+    bool pendingContent(const std::string& path, std::string& content) const;
+
+
+    /** \brief Discards a pending write for a cached element.
+     *
+     * \param path  path of the cached element
+     * \remarks If the element is written at the moment, the function waits
+     *          until that write is done, so the caller can safely delete
+     *          the file afterwards.
+     */
+    void cancel(const std::string& path);
+
+
+    /** \brief Writes all queued elements and stops the writer thread.
+     *
+     * \remarks Can be called more than once, e.g. from a signal handler and
+     *          from the destructor. Later writes are performed directly.
+     */
+    void finish();
+
+
+    /// functions to return gathered information
+    uint_least32_t written() const;
+    uint_least32_t coalesced() const;
+    uint_least32_t failed() const;
+  private:
+    /** \brief A write that has not been performed yet. */
+    struct PendingWrite
+    {
+      std::string resourceID; /**< resource ID of the cached element */
+      std::string cacheRoot; /**< root directory of the cache */
+      std::string content; /**< content of the cached element */
+    }; // struct
+
+
+    /** \brief Main function of the writer thread.
+     */
+    void run();
+
+
+    /** \brief Writes a single cached element to disk.
+     *
+     * \param path   path of the cached element
+     * \param write  the data to write
+     * \return Returns true, if the element was written successfully.
+     */
+    static bool writeElement(const std::string& path, const PendingWrite& write);
+
+
+    /** \brief Synchronizes the file system of a cache to disk.
+     *
+     * \param cacheRoot  the cache's root directory
+     */
+    static void syncCache(const std::string& cacheRoot);
+
+
+    std::size_t m_Capacity; /**< maximum number of queued writes */
+    bool m_Sync; /**< whether to synchronize data to disk after each batch */
+    mutable std::mutex m_Mutex; /**< guards all following members */
+    std::condition_variable m_WorkAvailable; /**< signals new writes or stop request */
+    std::condition_variable m_BatchDone; /**< signals free space in the queue or finished batch */
+    std::deque<std::string> m_Order; /**< paths of queued writes in order of arrival */
+    std::unordered_map<std::string, PendingWrite> m_Queued; /**< queued writes, key = path */
+    std::unordered_map<std::string, PendingWrite> m_InFlight; /**< writes of the current batch, key = path */
+    bool m_Stop; /**< whether the thread shall stop after writing all queued elements */
+    bool m_Finished; /**< whether finish() was called */
+    uint_least32_t m_Written; /**< number of written elements */
+    uint_least32_t m_Coalesced; /**< number of writes that were merged with a queued write */
+    uint_least32_t m_Failed; /**< number of writes that failed */
+    std::thread m_Thread; /**< the writer thread */
+}; // class
+
+} // namespace
+
+#endif // SCANTOOL_VT_CACHEWRITER_HPP
@@ -0,0 +1,72 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "FreshnessPolicy.hpp"
+
+namespace scantool::virustotal
+{
+
+/* Currently about 60 to 70 engines scan each file. A clean report from only a
+   few engines is not as reliable, so it gets the general maximum age. */
+const int FreshnessPolicy::cMinimumEnginesForClean = 40;
+
+FreshnessPolicy::FreshnessPolicy(const int maxAgeInDays, const int maybeLimit)
+: m_MaxAge(maxAgeInDays),
+  m_MaxAgeClean(0),
+  m_MaxAgeMaybe(0),
+  m_MaybeLimit(maybeLimit)
+{
+}
+
+void FreshnessPolicy::setMaxAgeClean(const int days) noexcept
+{
+  m_MaxAgeClean = days;
+}
+
+void FreshnessPolicy::setMaxAgeMaybe(const int days) noexcept
+{
+  m_MaxAgeMaybe = days;
+}
+
+int FreshnessPolicy::maxAgeFor(const ReportV2& report) const noexcept
+{
+  if ((report.positives == 0) && (report.total >= cMinimumEnginesForClean)
+      && (m_MaxAgeClean > 0))
+    return m_MaxAgeClean;
+  if ((report.positives > 0) && (report.positives <= m_MaybeLimit)
+      && (m_MaxAgeMaybe > 0))
+    return m_MaxAgeMaybe;
+  return m_MaxAge;
+}
+
+bool FreshnessPolicy::isOutdated(const ReportV2& report) const
+{
+  return isOutdated(report, std::chrono::system_clock::now());
+}
+
+bool FreshnessPolicy::isOutdated(const ReportV2& report, const std::chrono::system_clock::time_point now) const
+{
+  if (!report.hasTime_t())
+    return false;
+  const auto ageLimit = now - std::chrono::hours(24 * maxAgeFor(report));
+  return std::chrono::system_clock::from_time_t(report.scan_date_t) < ageLimit;
+}
+
+} // namespace
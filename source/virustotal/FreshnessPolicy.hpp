@@ -0,0 +1,106 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_VT_FRESHNESSPOLICY_HPP
+#define SCANTOOL_VT_FRESHNESSPOLICY_HPP
+
+#include <chrono>
+#include "ReportV2.hpp"
+
+namespace scantool::virustotal
+{
+
+/** \brief Decides whether a report is outdated, depending on its verdict.
+ *
+ * Reports of files that many engines consider clean rarely change, while
+ * reports with only a few positives often do. So the maximum age of a report
+ * can be set separately for
+ *   - clean reports, i.e. no positives and at least cMinimumEnginesForClean
+ *     engines,
+ *   - "maybe infected" reports, i.e. at least one positive but not more than
+ *     the "maybe" limit,
+ * and all other reports use the general maximum age.
+ */
+class FreshnessPolicy
+{
+  public:
+    /** \brief Constructor.
+     *
+     * \param maxAgeInDays  general maximum age of reports in days
+     * \param maybeLimit    limit for "maybe infected"; higher count means infected
+     */
+    FreshnessPolicy(const int maxAgeInDays, const int maybeLimit);
+
+
+    /// minimum number of engines for a clean report to count as clean
+    static const int cMinimumEnginesForClean;
+
+
+    /** \brief Sets the maximum age of clean reports.
+     *
+     * \param days  maximum age in days; zero means the general maximum age
+     */
+    void setMaxAgeClean(const int days) noexcept;
+
+
+    /** \brief Sets the maximum age of "maybe infected" reports.
+     *
+     * \param days  maximum age in days; zero means the general maximum age
+     */
+    void setMaxAgeMaybe(const int days) noexcept;
+
+
+    /** \brief Gets the maximum age that applies to a given report.
+     *
+     * \param report  the report
+     * \return Returns the maximum age of the report in days.
+     */
+    int maxAgeFor(const ReportV2& report) const noexcept;
+
+
+    /** \brief Checks whether a report is outdated at the current time.
+     *
+     * \param report  the report
+     * \return Returns true, if the report has a scan date and that date is
+     *         older than the maximum age for the report.
+     * \remarks The current time is taken on every call, so a policy that is
+     *          used by a long-running process stays correct.
+     */
+    bool isOutdated(const ReportV2& report) const;
+
+
+    /** \brief Checks whether a report is outdated at a given time.
+     *
+     * \param report  the report
+     * \param now     the time to check against
+     * \return Returns true, if the report has a scan date and that date is
+     *         older than the maximum age for the report at the given time.
+     */
+    bool isOutdated(const ReportV2& report, const std::chrono::system_clock::time_point now) const;
+  private:
+    int m_MaxAge; /**< general maximum age in days */
+    int m_MaxAgeClean; /**< maximum age of clean reports in days, zero = general age */
+    int m_MaxAgeMaybe; /**< maximum age of "maybe infected" reports in days, zero = general age */
+    int m_MaybeLimit; /**< limit for "maybe infected" */
+}; // class
+
+} // namespace
+
+#endif // SCANTOOL_VT_FRESHNESSPOLICY_HPP
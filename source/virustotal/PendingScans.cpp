@@ -0,0 +1,221 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "PendingScans.hpp"
+#include <algorithm>
+#include <charconv>
+#include "../../libstriezel/filesystem/directory.hpp"
+
+namespace scantool::virustotal
+{
+
+/** \brief Gets the next space-separated field of a line.
+ *
+ * \param first  pointer to the first character, will be moved behind the field
+ * \param last   pointer behind the last character of the line
+ * \param field  variable that will hold the field
+ * \return Returns true, if a non-empty field followed by a space was found.
+ */
+static bool nextField(const char*& first, const char* last, std::string& field)
+{
+  const char* space = std::find(first, last, ' ');
+  if ((space == first) || (space == last))
+    return false;
+  field.assign(first, space);
+  first = space + 1;
+  return true;
+}
+
+/** \brief Parses the next space-separated number of a line.
+ *
+ * \param first  pointer to the first character, will be moved behind the number
+ * \param last   pointer behind the last character of the line
+ * \param value  variable that will hold the number
+ * \return Returns true, if a number followed by a space was found.
+ */
+static bool parseNumber(const char*& first, const char* last, int64_t& value)
+{
+  const auto result = std::from_chars(first, last, value);
+  if ((result.ec != std::errc()) || (result.ptr == last) || (*result.ptr != ' '))
+    return false;
+  first = result.ptr + 1;
+  return true;
+}
+
+const std::string PendingScans::cFileName = "pending-scans.txt";
+
+PendingScans::PendingScans(const std::string& fileName)
+: m_File(fileName),
+  m_Entries(std::unordered_multimap<std::string, Entry>()),
+  m_Digests(std::unordered_map<std::string, std::string>()),
+  m_Pending(std::string())
+{
+}
+
+std::string PendingScans::defaultFileName(const std::string& cacheRoot)
+{
+  return libstriezel::filesystem::slashify(cacheRoot) + cFileName;
+}
+
+const std::string& PendingScans::fileName() const noexcept
+{
+  return m_File.fileName();
+}
+
+bool PendingScans::load()
+{
+  m_Entries.clear();
+  m_Digests.clear();
+  m_Pending.clear();
+  return m_File.read([this](const std::string& line)
+  {
+    if (line.empty() || (line[0] == '#'))
+      return;
+    // resolved scan: "- " followed by the scan ID
+    if ((line.size() > 2) && (line[0] == '-') && (line[1] == ' '))
+    {
+      forget(line.substr(2));
+      return;
+    }
+    // line format: scan_id SHA-256 size submitted name
+    const char* first = line.data();
+    const char* last = line.data() + line.size();
+    std::string scan_id;
+    Entry entry;
+    int64_t submitted = 0;
+    if (!nextField(first, last, scan_id) || !nextField(first, last, entry.sha256)
+        || !parseNumber(first, last, entry.size) || !parseNumber(first, last, submitted)
+        || (first == last))
+      return;
+    if (entry.sha256 == "-")
+      entry.sha256.clear();
+    entry.submitted = static_cast<std::time_t>(submitted);
+    entry.name.assign(first, last);
+    insert(scan_id, entry);
+  });
+}
+
+bool PendingScans::add(const std::string& scan_id, const Entry& entry)
+{
+  if (scan_id.empty() || (scan_id == "-") || entry.name.empty()
+      || (scan_id.find_first_of(" \r\n") != std::string::npos)
+      || (entry.sha256.find_first_of(" \r\n") != std::string::npos)
+      || (entry.name.find_first_of("\r\n") != std::string::npos))
+    return false;
+  if (!insert(scan_id, entry))
+    return false;
+  appendLine(scan_id, entry, m_Pending);
+  return true;
+}
+
+bool PendingScans::insert(const std::string& scan_id, const Entry& entry)
+{
+  const auto range = m_Entries.equal_range(scan_id);
+  for (auto iter = range.first; iter != range.second; ++iter)
+  {
+    if (iter->second.name == entry.name)
+      return false;
+  }
+  m_Entries.emplace(scan_id, entry);
+  if (!entry.sha256.empty())
+    m_Digests[entry.sha256] = scan_id;
+  return true;
+}
+
+void PendingScans::resolve(const std::string& scan_id)
+{
+  if (forget(scan_id))
+    m_Pending.append("- ").append(scan_id).append("\n");
+}
+
+bool PendingScans::forget(const std::string& scan_id)
+{
+  const auto range = m_Entries.equal_range(scan_id);
+  if (range.first == range.second)
+    return false;
+  for (auto iter = range.first; iter != range.second; ++iter)
+  {
+    const auto digest = m_Digests.find(iter->second.sha256);
+    if ((digest != m_Digests.end()) && (digest->second == scan_id))
+      m_Digests.erase(digest);
+  }
+  m_Entries.erase(range.first, range.second);
+  return true;
+}
+
+bool PendingScans::find(const std::string& sha256, std::string& scan_id) const
+{
+  const auto iter = m_Digests.find(sha256);
+  if (iter == m_Digests.end())
+    return false;
+  scan_id = iter->second;
+  return true;
+}
+
+const std::unordered_multimap<std::string, PendingScans::Entry>& PendingScans::entries() const noexcept
+{
+  return m_Entries;
+}
+
+bool PendingScans::empty() const noexcept
+{
+  return m_Entries.empty();
+}
+
+std::size_t PendingScans::size() const noexcept
+{
+  return m_Entries.size();
+}
+
+void PendingScans::appendLine(const std::string& scan_id, const Entry& entry, std::string& output)
+{
+  output.append(scan_id).append(" ")
+        .append(entry.sha256.empty() ? std::string("-") : entry.sha256).append(" ")
+        .append(std::to_string(entry.size)).append(" ")
+        .append(std::to_string(static_cast<int64_t>(entry.submitted))).append(" ")
+        .append(entry.name).append("\n");
+}
+
+bool PendingScans::flush()
+{
+  if (!m_File.append(m_Pending))
+    return false;
+  m_Pending.clear();
+  return true;
+}
+
+bool PendingScans::compact()
+{
+  // Other processes may have added or resolved scans in the meantime.
+  if (!flush() || !load())
+    return false;
+  // Rewriting is only worth it, if most of the lines are obsolete.
+  if (!m_File.worthRewriting(m_Entries.size(), 100))
+    return true;
+
+  std::string content = "# scan-tool pending scans\n";
+  for (const auto& [scan_id, entry] : m_Entries)
+  {
+    appendLine(scan_id, entry, content);
+  }
+  return m_File.rewrite(content);
+}
+
+} // namespace
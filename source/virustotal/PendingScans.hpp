@@ -0,0 +1,200 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_VT_PENDINGSCANS_HPP
+#define SCANTOOL_VT_PENDINGSCANS_HPP
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <unordered_map>
+#include "../filesystem/AppendOnlyFile.hpp"
+
+namespace scantool::virustotal
+{
+
+/** \brief List of submitted scans whose reports have not been retrieved yet.
+ *
+ * The list survives the program, so that a later run does not upload the
+ * same file again, but only requests the report of the earlier scan. By
+ * default it is kept in the root directory of the request cache, so
+ * scan-tool-cache can resolve the remaining scans, too.
+ *
+ * Like the run journal, the list is a text file where new lines are appended
+ * to. Lines for new scans contain the scan ID, the hash, the size, the time
+ * of submission and the name of the file, and lines that start with "- "
+ * remove the scan with the given ID again. Files with the same content share
+ * the scan, so there may be several lines with the same scan ID.
+ */
+class PendingScans
+{
+  public:
+    /** data of a pending scan */
+    struct Entry
+    {
+      std::string sha256; /**< SHA-256 hash of the file, may be empty if unknown */
+      int64_t size; /**< size of the file in octets, or -1 if unknown */
+      std::time_t submitted; /**< time of the scan request */
+      std::string name; /**< name of the file for the user */
+    }; // struct
+
+
+    /// name of the list file within the cache root directory
+    static const std::string cFileName;
+
+
+    /** \brief Constructor.
+     *
+     * \param fileName  path of the list file
+     */
+    explicit PendingScans(const std::string& fileName);
+
+
+    /** \brief Gets the default path of the list file for a request cache.
+     *
+     * \param cacheRoot  root directory of the request cache
+     * \return Returns the path of the list file in the cache root directory.
+     */
+    static std::string defaultFileName(const std::string& cacheRoot);
+
+
+    /** \brief Gets the path of the list file.
+     *
+     * \return Returns the path of the list file.
+     */
+    const std::string& fileName() const noexcept;
+
+
+    /** \brief Loads the list from its file.
+     *
+     * \return Returns true, if the list was loaded or did not exist.
+     *         Returns false, if the list file could not be read.
+     * \remarks Malformed lines are skipped. An incomplete last line of an
+     *          interrupted write is ignored and removed by the next flush().
+     *          Entries that were added but not written yet are lost.
+     */
+    bool load();
+
+
+    /** \brief Adds a pending scan.
+     *
+     * \param scan_id  ID of the scan
+     * \param entry    data of the scan
+     * \return Returns true, if the scan was added.
+     *         Returns false, if the scan of a file with the same name is
+     *         already pending or if its data cannot be stored, e.g. because
+     *         the name contains a line break.
+     * \remarks Call flush() to write the new entry to the file.
+     */
+    bool add(const std::string& scan_id, const Entry& entry);
+
+
+    /** \brief Removes a scan whose report was retrieved, for all its files.
+     *
+     * \param scan_id  ID of the scan
+     * \remarks Call flush() to write the change to the file.
+     */
+    void resolve(const std::string& scan_id);
+
+
+    /** \brief Finds a pending scan of a file.
+     *
+     * \param sha256   SHA-256 hash of the file
+     * \param scan_id  variable that will hold the ID of the scan
+     * \return Returns true, if a scan of the file is pending.
+     */
+    bool find(const std::string& sha256, std::string& scan_id) const;
+
+
+    /** \brief Gets all pending scans.
+     *
+     * \return Returns the pending scans; key = scan ID, value = data of a
+     *         file of the scan. Several files may share a scan ID.
+     */
+    const std::unordered_multimap<std::string, Entry>& entries() const noexcept;
+
+
+    /** \brief Checks whether no scans are pending.
+     *
+     * \return Returns true, if no scans are pending.
+     */
+    bool empty() const noexcept;
+
+
+    /** \brief Gets the number of files with pending scans.
+     *
+     * \return Returns the number of files with pending scans.
+     */
+    std::size_t size() const noexcept;
+
+
+    /** \brief Appends the changes to the list file.
+     *
+     * \return Returns true, if all changes were written.
+     */
+    bool flush();
+
+
+    /** \brief Reloads the list, so that changes of other processes are kept,
+     *         and rewrites the list file without resolved scans, if there are
+     *         many of them.
+     *
+     * \return Returns true, if the list file is compact or was compacted.
+     *         Returns false, if the list file could not be rewritten.
+     */
+    bool compact();
+  private:
+    /** \brief Adds a scan without recording the change.
+     *
+     * \param scan_id  ID of the scan
+     * \param entry    data of the scan
+     * \return Returns true, if the scan was added.
+     *         Returns false, if a file with the same name is already known
+     *         for the scan.
+     */
+    bool insert(const std::string& scan_id, const Entry& entry);
+
+
+    /** \brief Removes a scan without recording the change.
+     *
+     * \param scan_id  ID of the scan
+     * \return Returns true, if the scan was pending.
+     */
+    bool forget(const std::string& scan_id);
+
+
+    /** \brief Appends the line for an entry to a string.
+     *
+     * \param scan_id  ID of the scan
+     * \param entry    data of the scan
+     * \param output   string that gets the line
+     */
+    static void appendLine(const std::string& scan_id, const Entry& entry, std::string& output);
+
+
+    scantool::filesystem::AppendOnlyFile m_File; /**< the list file */
+    std::unordered_multimap<std::string, Entry> m_Entries; /**< files of pending scans by scan ID */
+    std::unordered_map<std::string, std::string> m_Digests; /**< scan IDs by SHA-256 hash */
+    std::string m_Pending; /**< lines of changes that were not written yet */
+}; // class
+
+} // namespace
+
+#endif // SCANTOOL_VT_PENDINGSCANS_HPP
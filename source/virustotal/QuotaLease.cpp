@@ -0,0 +1,138 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "QuotaLease.hpp"
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include "../../libstriezel/filesystem/directory.hpp"
+#if defined(__linux__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace scantool::virustotal
+{
+
+/* Slots that are further ahead can only come from a clock that was set back,
+   because not that many processes will ever wait for the same key. */
+static const std::chrono::hours cMaxAhead = std::chrono::hours(1);
+
+QuotaLease::QuotaLease(const std::string& fileName, const std::chrono::milliseconds interval)
+: m_FileName(fileName),
+  m_Interval(interval),
+  m_Fd(-1)
+{
+}
+
+QuotaLease::~QuotaLease()
+{
+  #if defined(__linux__)
+  if (m_Fd >= 0)
+    close(m_Fd);
+  #endif
+}
+
+std::string QuotaLease::defaultFileName(const std::string& apikey)
+{
+  std::string homeDirectory;
+  if (!libstriezel::filesystem::directory::getHome(homeDirectory))
+    homeDirectory = "/tmp/";
+  // FNV-1a hash, so that the file name does not reveal the API key
+  uint64_t hash = 14695981039346656037ULL;
+  for (const char c : apikey)
+  {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ULL;
+  }
+  char hex[17];
+  std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash));
+  return libstriezel::filesystem::slashify(homeDirectory) + ".scan-tool"
+       + libstriezel::filesystem::pathDelimiter + "quota-" + hex + ".lease";
+}
+
+const std::string& QuotaLease::fileName() const noexcept
+{
+  return m_FileName;
+}
+
+bool QuotaLease::open()
+{
+  #if defined(__linux__)
+  if (m_Fd >= 0)
+    return true;
+  const auto slash = m_FileName.rfind('/');
+  if ((slash != std::string::npos) && (slash > 0))
+  {
+    const std::string directory = m_FileName.substr(0, slash);
+    if (!libstriezel::filesystem::directory::exists(directory)
+        && !libstriezel::filesystem::directory::createRecursive(directory))
+      return false;
+  }
+  m_Fd = ::open(m_FileName.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR);
+  return m_Fd >= 0;
+  #else
+  return false;
+  #endif
+}
+
+bool QuotaLease::reserve(std::chrono::milliseconds& wait)
+{
+  #if defined(__linux__)
+  if (m_Fd < 0)
+    return false;
+  int locked;
+  do
+  {
+    locked = flock(m_Fd, LOCK_EX);
+  } while ((locked != 0) && (errno == EINTR));
+  if (locked != 0)
+    return false;
+
+  // The file holds the next free slot in milliseconds since the epoch.
+  char buffer[32];
+  const ssize_t length = pread(m_Fd, buffer, sizeof(buffer) - 1, 0);
+  int64_t next = 0;
+  if (length > 0)
+    std::from_chars(buffer, buffer + length, next);
+  const int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+  int64_t slot = next;
+  if ((slot < now) || (slot - now > std::chrono::duration_cast<std::chrono::milliseconds>(cMaxAhead).count()))
+    slot = now;
+
+  const std::string content = std::to_string(slot + m_Interval.count()) + "\n";
+  const bool written = (pwrite(m_Fd, content.data(), content.size(), 0) == static_cast<ssize_t>(content.size()))
+                    && (ftruncate(m_Fd, content.size()) == 0);
+  flock(m_Fd, LOCK_UN);
+  if (!written)
+    return false;
+  wait = std::chrono::milliseconds(slot - now);
+  return true;
+  #else
+  (void) wait;
+  return false;
+  #endif
+}
+
+} // namespace
@@ -0,0 +1,101 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_VT_QUOTALEASE_HPP
+#define SCANTOOL_VT_QUOTALEASE_HPP
+
+#include <chrono>
+#include <string>
+
+namespace scantool::virustotal
+{
+
+/** \brief Shares the rate limit of an API key between processes.
+ *
+ * The lease file holds the time of the next free request slot. Every
+ * request reserves the next free slot while the file is locked and moves
+ * it forward by the interval between two requests. So any number of
+ * processes that use the same lease file split the rate limit exactly,
+ * instead of each one assuming that it has the whole limit on its own.
+ *
+ * Leases are only supported on Linux.
+ */
+class QuotaLease
+{
+  public:
+    /** \brief Constructor.
+     *
+     * \param fileName  path of the lease file
+     * \param interval  minimum time between two requests
+     */
+    QuotaLease(const std::string& fileName, const std::chrono::milliseconds interval);
+
+
+    /** \brief Destructor, closes the lease file.
+     */
+    ~QuotaLease();
+
+
+    QuotaLease(const QuotaLease& other) = delete;
+    QuotaLease& operator=(const QuotaLease& other) = delete;
+
+
+    /** \brief Gets the default path of the lease file for an API key.
+     *
+     * \param apikey  the API key
+     * \return Returns the path of the lease file in the directory
+     *         ~/.scan-tool/, which depends on the API key, but does not
+     *         contain the key itself.
+     */
+    static std::string defaultFileName(const std::string& apikey);
+
+
+    /** \brief Gets the path of the lease file.
+     *
+     * \return Returns the path of the lease file.
+     */
+    const std::string& fileName() const noexcept;
+
+
+    /** \brief Opens the lease file and creates it, if it does not exist.
+     *
+     * \return Returns true, if the file was opened.
+     */
+    bool open();
+
+
+    /** \brief Reserves the next free request slot.
+     *
+     * \param wait  variable that will hold the time until the slot begins
+     * \return Returns true, if a slot was reserved.
+     *         Returns false, if the lease file could not be used.
+     * \remarks The request has to be sent after waiting for the returned
+     *          time, because the slot is gone after that.
+     */
+    bool reserve(std::chrono::milliseconds& wait);
+  private:
+    std::string m_FileName; /**< path of the lease file */
+    std::chrono::milliseconds m_Interval; /**< minimum time between two requests */
+    int m_Fd; /**< descriptor of the lease file, or -1 */
+}; // class
+
+} // namespace
+
+#endif // SCANTOOL_VT_QUOTALEASE_HPP
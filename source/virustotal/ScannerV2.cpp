@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2015, 2016, 2021  Dirk Stolle
+    Copyright (C) 2015, 2016, 2021, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -25,6 +25,7 @@
 #include "../Curly.hpp"
 #include "../../libstriezel/filesystem/directory.hpp"
 #include "../../libstriezel/filesystem/file.hpp"
+#include "../../libstriezel/hash/sha256/sha256.hpp"
 #include "../../third-party/simdjson/simdjson.h"
 
 namespace scantool::virustotal
@@ -32,10 +33,48 @@ namespace scantool::virustotal
 
 ScannerV2::ScannerV2(const std::string& apikey, const bool honourTimeLimits, const bool silent)
 : Scanner(honourTimeLimits, silent),
-  m_apikey(apikey)
+  m_apikey(apikey),
+  m_CacheWriter(nullptr),
+  m_QuotaLease(nullptr)
 {
 }
 
+void ScannerV2::setCacheWriter(CacheWriter* writer) noexcept
+{
+  m_CacheWriter = writer;
+}
+
+void ScannerV2::setQuotaLease(QuotaLease* lease) noexcept
+{
+  m_QuotaLease = lease;
+}
+
+void ScannerV2::waitForRequestSlot(const bool scanRequest)
+{
+  std::chrono::milliseconds duration(0);
+  if (!honoursTimeLimit() || (m_QuotaLease == nullptr) || !m_QuotaLease->reserve(duration))
+  {
+    if (scanRequest)
+      waitForScanLimitExpiration();
+    else
+      waitForHashLookupLimitExpiration();
+    return;
+  }
+  if (duration.count() <= 0)
+    return;
+  if (!silent())
+  {
+    std::clog << "Waiting ";
+    if (duration >= std::chrono::seconds(2))
+      std::clog << std::chrono::duration_cast<std::chrono::seconds>(duration).count()
+                << " seconds for shared time limit to expire..." << std::endl;
+    else
+      std::clog << duration.count()
+                << " millisecond(s) for shared time limit to expire..." << std::endl;
+  } // if not silent
+  sleepFor(duration);
+}
+
 void ScannerV2::setApiKey(const std::string& apikey)
 {
   if (!apikey.empty())
@@ -87,7 +126,15 @@ bool ScannerV2::getReport(const std::string& resource, Report& report, const boo
   #endif // SCAN_TOOL_DEBUG
   std::string response = "";
   const std::string cachedFilePath = CacheManagerV2::getPathForCachedElement(resource, cacheDir);
+  // whether the report was requested from the API instead of the cache
+  bool requested = false;
   if (useCache && !cacheDir.empty() && !cachedFilePath.empty()
+      && (m_CacheWriter != nullptr)
+      && m_CacheWriter->pendingContent(cachedFilePath, response))
+  {
+    // The report has not been written to the cache yet, use queued data.
+  }
+  else if (useCache && !cacheDir.empty() && !cachedFilePath.empty()
       && libstriezel::filesystem::file::exists(cachedFilePath))
   {
     // try to read JSON data from cached file
@@ -114,7 +161,7 @@ bool ScannerV2::getReport(const std::string& resource, Report& report, const boo
   } // if cached JSON file shall be used
   else
   {
-    waitForHashLookupLimitExpiration();
+    waitForRequestSlot(false);
     // send request via cURL
     Curly cURL;
     cURL.setURL("https://www.virustotal.com/vtapi/v2/file/report");
@@ -165,27 +212,9 @@ bool ScannerV2::getReport(const std::string& resource, Report& report, const boo
     /* write JSON data to request cache, if request cache directory is given,
        independent of cache use during previous request
     */
-    if (!cacheDir.empty() && libstriezel::filesystem::directory::exists(cacheDir)
-        && !cachedFilePath.empty())
-    {
-      #ifdef SCAN_TOOL_DEBUG
-      std::cout << "Opening output stream for " << cachedFilePath << "." << std::endl;
-      #endif // SCAN_TOOL_DEBUG
-      std::ofstream cachedJSON(cachedFilePath, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
-      if (!cachedJSON.good())
-      {
-        std::cerr << "Error in ScannerV2::getReport(): JSON data file could not be opened for update!" << std::endl;
-        return false;
-      }
-      cachedJSON.write(response.c_str(), response.size());
-      if (!cachedJSON.good())
-      {
-        cachedJSON.close();
-        std::cerr << "Error in ScannerV2::getReport(): JSON data could not be written to cache!" << std::endl;
-        return false;
-      }
-      cachedJSON.close();
-    } // if request cache is enabled
+    if (!cacheDir.empty() && !cachedFilePath.empty() && !writeToCache(resource, cacheDir, response))
+      return false;
+    requested = true;
   } // else (normal, uncached request)
 
   const bool success = report.fromJsonString(response);
@@ -202,13 +231,62 @@ bool ScannerV2::getReport(const std::string& resource, Report& report, const boo
     } // if
     return false;
   }
+  /* Reports requested by scan ID are not cached under that ID, but finished
+     reports are cached under the hash of the file, so later lookups of the
+     file do not need another request. */
+  if (requested && !cacheDir.empty() && cachedFilePath.empty()
+      && report.successfulRetrieval() && SHA256::isValidHash(report.sha256)
+      && !writeToCache(report.sha256, cacheDir, response))
+    return false;
 
   return success;
 }
 
+bool ScannerV2::writeToCache(const std::string& resource, const std::string& cacheDir,
+                             const std::string& response)
+{
+  if (!libstriezel::filesystem::directory::exists(cacheDir))
+    return true;
+  if (m_CacheWriter != nullptr)
+  {
+    // Writing is done in the background, no need to wait for the disk.
+    if (!m_CacheWriter->enqueue(resource, cacheDir, response))
+    {
+      std::cerr << "Error in ScannerV2::getReport(): JSON data could not be written to cache!" << std::endl;
+      return false;
+    }
+    return true;
+  } // if request cache has a writer
+  // Deeper levels of the cache layout are created on demand.
+  if (!CacheManagerV2::createDirectoryForCachedElement(resource, cacheDir))
+  {
+    std::cerr << "Error in ScannerV2::getReport(): Directory for cached JSON could not be created!" << std::endl;
+    return false;
+  }
+  const std::string cachedFilePath = CacheManagerV2::getPathForCachedElement(resource, cacheDir);
+  #ifdef SCAN_TOOL_DEBUG
+  std::cout << "Opening output stream for " << cachedFilePath << "." << std::endl;
+  #endif // SCAN_TOOL_DEBUG
+  std::ofstream cachedJSON(cachedFilePath, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+  if (!cachedJSON.good())
+  {
+    std::cerr << "Error in ScannerV2::getReport(): JSON data file could not be opened for update!" << std::endl;
+    return false;
+  }
+  cachedJSON.write(response.c_str(), response.size());
+  if (!cachedJSON.good())
+  {
+    cachedJSON.close();
+    std::cerr << "Error in ScannerV2::getReport(): JSON data could not be written to cache!" << std::endl;
+    return false;
+  }
+  cachedJSON.close();
+  return true;
+}
+
 bool ScannerV2::rescan(const std::string& resource, std::string& scan_id)
 {
-  waitForScanLimitExpiration();
+  waitForRequestSlot(true);
   // send request
   Curly cURL;
   cURL.setURL("https://www.virustotal.com/vtapi/v2/file/rescan");
@@ -306,7 +384,7 @@ bool ScannerV2::scan(const std::string& filename, std::string& scan_id)
   if (filename.empty())
     return false;
 
-  waitForScanLimitExpiration();
+  waitForRequestSlot(true);
   // send request
   Curly cURL;
   cURL.setURL("https://www.virustotal.com/vtapi/v2/file/scan");
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2015, 2016  Dirk Stolle
+    Copyright (C) 2015, 2016, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -24,6 +24,8 @@
 #include <string>
 #include <vector>
 #include "../Scanner.hpp"
+#include "CacheWriter.hpp"
+#include "QuotaLease.hpp"
 #include "ReportV2.hpp"
 
 namespace scantool::virustotal
@@ -53,6 +55,24 @@ class ScannerV2: public scantool::Scanner
     void setApiKey(const std::string& apikey);
 
 
+    /** \brief Sets the writer for reports that shall be written to the cache.
+     *
+     * \param writer  the cache writer, or nullptr to write reports directly
+     *                within getReport(); the writer must outlive the scanner
+     */
+    void setCacheWriter(CacheWriter* writer) noexcept;
+
+
+    /** \brief Sets the lease that shares the rate limit of the API key with
+     *         other processes.
+     *
+     * \param lease  the opened quota lease, or nullptr to only consider the
+     *               requests of this scanner; the lease must outlive the
+     *               scanner
+     */
+    void setQuotaLease(QuotaLease* lease) noexcept;
+
+
     /** \brief Gets the duration between consecutive file scan requests, if time limit is respected.
      *
      * \return Returns the minimum interval between two consecutive file scan requests.
@@ -85,7 +105,11 @@ class ScannerV2: public scantool::Scanner
      * \param cacheDir   directory of the report cache (Value has to be set, if @useCache is true.)
      *                   If the @cacheDir is non-empty, the JSON data of the
      *                   the report will be written to the cache directory.
-     *                   Even if @useCache is false.
+     *                   Even if @useCache is false. Finished reports that
+     *                   are retrieved by scan ID are cached under the hash
+     *                   of the file.
+     *                   If a cache writer is set, writing is done by the
+     *                   writer's thread and the function does not wait for it.
      * \return Returns true, if the report could be retrieved.
      *         Returns false, if retrieval failed.
      */
@@ -129,7 +153,31 @@ class ScannerV2: public scantool::Scanner
       */
     virtual int64_t maxScanSize() const noexcept override;
   private:
+    /** \brief Waits until the next request may be sent. With a quota lease
+     *         the slot is reserved in the lease, otherwise only the time
+     *         limit of this scanner is considered.
+     *
+     * \param scanRequest  whether the request is a file scan request
+     */
+    void waitForRequestSlot(const bool scanRequest);
+
+
+    /** \brief Writes the JSON data of a report to the request cache.
+     *
+     * \param resource  SHA256 hash of the file
+     * \param cacheDir  directory of the report cache
+     * \param response  JSON data of the report
+     * \return Returns true, if the data was written or handed to the cache
+     *         writer, or if the cache directory does not exist.
+     *         Returns false, if an error occurred.
+     */
+    bool writeToCache(const std::string& resource, const std::string& cacheDir,
+                      const std::string& response);
+
+
     std::string m_apikey; /**< holds the VirusTotal API key */
+    CacheWriter* m_CacheWriter; /**< writer for the request cache, may be nullptr */
+    QuotaLease* m_QuotaLease; /**< lease that shares the rate limit with other processes, may be nullptr */
 }; // class
 
 } // namespace
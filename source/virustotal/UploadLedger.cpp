@@ -0,0 +1,146 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "UploadLedger.hpp"
+#include <algorithm>
+#include <charconv>
+#include "../../libstriezel/filesystem/directory.hpp"
+
+namespace scantool::virustotal
+{
+
+const std::string UploadLedger::cFileName = "upload-ledger.txt";
+
+UploadLedger::UploadLedger(const std::string& fileName)
+: m_File(fileName),
+  m_Entries(std::unordered_map<std::string, Entry>()),
+  m_Pending(std::string())
+{
+}
+
+std::string UploadLedger::defaultFileName(const std::string& cacheRoot)
+{
+  return libstriezel::filesystem::slashify(cacheRoot) + cFileName;
+}
+
+const std::string& UploadLedger::fileName() const noexcept
+{
+  return m_File.fileName();
+}
+
+bool UploadLedger::isDigest(const std::string& sha256)
+{
+  return (sha256.size() == 64)
+      && (sha256.find_first_not_of("0123456789abcdefABCDEF") == std::string::npos);
+}
+
+bool UploadLedger::load()
+{
+  m_Entries.clear();
+  m_Pending.clear();
+  return m_File.read([this](const std::string& line)
+  {
+    if (line.empty() || (line[0] == '#'))
+      return;
+    // line format: SHA-256 uploaded scan_id
+    if ((line.size() < 68) || (line[64] != ' '))
+      return;
+    const std::string sha256 = line.substr(0, 64);
+    if (!isDigest(sha256))
+      return;
+    const char* first = line.data() + 65;
+    const char* last = line.data() + line.size();
+    int64_t uploaded = 0;
+    const auto result = std::from_chars(first, last, uploaded);
+    if ((result.ec != std::errc()) || (result.ptr == last) || (*result.ptr != ' ')
+        || (result.ptr + 1 == last) || (std::find(result.ptr + 1, last, ' ') != last))
+      return;
+    Entry& entry = m_Entries[sha256];
+    entry.uploaded = static_cast<std::time_t>(uploaded);
+    entry.scan_id.assign(result.ptr + 1, last);
+  });
+}
+
+bool UploadLedger::record(const std::string& sha256, const std::string& scan_id, const std::time_t uploaded)
+{
+  if (!isDigest(sha256) || scan_id.empty()
+      || (scan_id.find_first_of(" \r\n") != std::string::npos))
+    return false;
+  Entry& entry = m_Entries[sha256];
+  entry.uploaded = uploaded;
+  entry.scan_id = scan_id;
+  appendLine(sha256, entry, m_Pending);
+  return true;
+}
+
+bool UploadLedger::find(const std::string& sha256, Entry& entry) const
+{
+  const auto iter = m_Entries.find(sha256);
+  if (iter == m_Entries.end())
+    return false;
+  entry = iter->second;
+  return true;
+}
+
+std::size_t UploadLedger::size() const noexcept
+{
+  return m_Entries.size();
+}
+
+void UploadLedger::appendLine(const std::string& sha256, const Entry& entry, std::string& output)
+{
+  output.append(sha256).append(" ")
+        .append(std::to_string(static_cast<int64_t>(entry.uploaded))).append(" ")
+        .append(entry.scan_id).append("\n");
+}
+
+bool UploadLedger::flush()
+{
+  if (!m_File.append(m_Pending))
+    return false;
+  m_Pending.clear();
+  return true;
+}
+
+bool UploadLedger::compact(const std::time_t expired)
+{
+  // Other processes may have recorded uploads in the meantime.
+  if (!flush() || !load())
+    return false;
+  for (auto iter = m_Entries.begin(); iter != m_Entries.end(); )
+  {
+    if (iter->second.uploaded < expired)
+      iter = m_Entries.erase(iter);
+    else
+      ++iter;
+  }
+  // Rewriting is only worth it, if most of the lines are obsolete.
+  if (!m_File.worthRewriting(m_Entries.size(), 100))
+    return true;
+
+  std::string content = "# scan-tool upload ledger\n";
+  for (const auto& [sha256, entry] : m_Entries)
+  {
+    appendLine(sha256, entry, content);
+  }
+  return m_File.rewrite(content);
+}
+
+} // namespace
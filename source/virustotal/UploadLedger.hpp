@@ -0,0 +1,161 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef SCANTOOL_VT_UPLOADLEDGER_HPP
+#define SCANTOOL_VT_UPLOADLEDGER_HPP
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <unordered_map>
+#include "../filesystem/AppendOnlyFile.hpp"
+
+namespace scantool::virustotal
+{
+
+/** \brief Ledger of the files that were uploaded to VirusTotal.
+ *
+ * Strategies that upload files without asking for a report first consult
+ * the ledger, so that files with the same content are not uploaded again
+ * until the re-upload interval has passed. By default the ledger is kept in
+ * the root directory of the request cache.
+ *
+ * The ledger is a text file where new lines are appended to. Each line
+ * contains the SHA-256 hash of an uploaded file, the time of the upload and
+ * the scan ID, and later lines for the same hash replace earlier ones.
+ */
+class UploadLedger
+{
+  public:
+    /** data of an upload */
+    struct Entry
+    {
+      std::time_t uploaded; /**< time of the upload */
+      std::string scan_id; /**< ID of the scan that was requested by the upload */
+    }; // struct
+
+
+    /// name of the ledger file within the cache root directory
+    static const std::string cFileName;
+
+
+    /** \brief Constructor.
+     *
+     * \param fileName  path of the ledger file
+     */
+    explicit UploadLedger(const std::string& fileName);
+
+
+    /** \brief Gets the default path of the ledger file for a request cache.
+     *
+     * \param cacheRoot  root directory of the request cache
+     * \return Returns the path of the ledger file in the cache root directory.
+     */
+    static std::string defaultFileName(const std::string& cacheRoot);
+
+
+    /** \brief Gets the path of the ledger file.
+     *
+     * \return Returns the path of the ledger file.
+     */
+    const std::string& fileName() const noexcept;
+
+
+    /** \brief Loads the ledger from its file.
+     *
+     * \return Returns true, if the ledger was loaded or did not exist.
+     *         Returns false, if the ledger file could not be read.
+     * \remarks Malformed lines are skipped. An incomplete last line of an
+     *          interrupted write is ignored and removed by the next flush().
+     *          Uploads that were recorded but not written yet are lost.
+     */
+    bool load();
+
+
+    /** \brief Records an upload.
+     *
+     * \param sha256    SHA-256 hash of the uploaded file as hexadecimal string
+     * \param scan_id   ID of the requested scan
+     * \param uploaded  time of the upload
+     * \return Returns true, if the upload was recorded.
+     *         Returns false, if the hash or the scan ID are not valid.
+     * \remarks Call flush() to write the new entry to the file.
+     */
+    bool record(const std::string& sha256, const std::string& scan_id, const std::time_t uploaded);
+
+
+    /** \brief Finds the latest upload of a file.
+     *
+     * \param sha256  SHA-256 hash of the file as hexadecimal string
+     * \param entry   variable that will hold the data of the upload
+     * \return Returns true, if the file was uploaded before.
+     */
+    bool find(const std::string& sha256, Entry& entry) const;
+
+
+    /** \brief Gets the number of files in the ledger.
+     *
+     * \return Returns the number of files in the ledger.
+     */
+    std::size_t size() const noexcept;
+
+
+    /** \brief Appends the recorded uploads to the ledger file.
+     *
+     * \return Returns true, if all uploads were written.
+     */
+    bool flush();
+
+
+    /** \brief Reloads the ledger, so that uploads of other processes are kept,
+     *         drops uploads that are older than the given time and rewrites
+     *         the ledger file, if many of its lines are obsolete.
+     *
+     * \param expired  uploads before this time are dropped
+     * \return Returns true, if the ledger file is compact or was compacted.
+     *         Returns false, if the ledger file could not be rewritten.
+     */
+    bool compact(const std::time_t expired);
+  private:
+    /** \brief Checks whether a string is a SHA-256 hash in hexadecimal form.
+     *
+     * \param sha256  the string
+     * \return Returns true, if the string consists of 64 hexadecimal digits.
+     */
+    static bool isDigest(const std::string& sha256);
+
+
+    /** \brief Appends the line for an entry to a string.
+     *
+     * \param sha256  SHA-256 hash of the file
+     * \param entry   data of the upload
+     * \param output  string that gets the line
+     */
+    static void appendLine(const std::string& sha256, const Entry& entry, std::string& output);
+
+
+    scantool::filesystem::AppendOnlyFile m_File; /**< the ledger file */
+    std::unordered_map<std::string, Entry> m_Entries; /**< latest uploads by SHA-256 hash */
+    std::string m_Pending; /**< lines of uploads that were not written yet */
+}; // class
+
+} // namespace
+
+#endif // SCANTOOL_VT_UPLOADLEDGER_HPP
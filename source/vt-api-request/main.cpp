@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2015, 2016, 2019, 2021  Dirk Stolle
+    Copyright (C) 2015, 2016, 2019, 2021, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -26,6 +26,7 @@
 #include "../Configuration.hpp"
 #include "../Curly.hpp"
 #include "../ReturnCodes.hpp"
+#include "../virustotal/QuotaLease.hpp"
 #include "../virustotal/ScannerV2.hpp"
 
 
@@ -280,6 +281,14 @@ int main(int argc, char ** argv)
   }
 
   scantool::virustotal::ScannerV2 scanVT(key);
+  // Other processes with the same API key share its rate limit.
+  scantool::virustotal::QuotaLease quotaLease(scantool::virustotal::QuotaLease::defaultFileName(key),
+      scanVT.timeBetweenConsecutiveHashLookups());
+  if (quotaLease.open())
+    scanVT.setQuotaLease(&quotaLease);
+  else
+    std::cerr << "Warning: Could not open quota lease file " << quotaLease.fileName()
+              << ", the rate limit is not shared with other processes." << std::endl;
 
   // initial wait to avoid exceeding the rate limit
   if (initial_wait)
@@ -0,0 +1,251 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include "../../../libstriezel/filesystem/directory.hpp"
+#include "../../../libstriezel/filesystem/file.hpp"
+#include "../../../source/scan-tool/Checkpoint.hpp"
+
+using scantool::virustotal::Checkpoint;
+using scantool::virustotal::QueuedScan;
+using scantool::virustotal::QueuedScanMap;
+using scantool::virustotal::ScannerV2;
+
+const std::string infectedHash = "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad";
+
+std::string readFile(const std::string& fileName)
+{
+  std::ifstream stream(fileName, std::ios::in | std::ios::binary);
+  std::ostringstream content;
+  content << stream.rdbuf();
+  return content.str();
+}
+
+std::string::size_type countBlocks(const std::string& content)
+{
+  std::string::size_type count = 0;
+  std::string::size_type pos = 0;
+  while ((pos = content.find("begin ", pos)) != std::string::npos)
+  {
+    if ((pos == 0) || (content[pos - 1] == '\n'))
+      ++count;
+    pos += 6;
+  }
+  return count;
+}
+
+bool testCheckpoint(const std::string& stateFile)
+{
+  const std::string completedFile = Checkpoint::completedFileName(stateFile);
+  // state of an unrelated earlier run
+  {
+    std::ofstream stream(stateFile, std::ios::out | std::ios::binary | std::ios::trunc);
+    stream << "begin 1600000000 1\n# scan-tool summary\nend\n";
+    std::ofstream completed(completedFile, std::ios::out | std::ios::binary | std::ios::trunc);
+    completed << "done /old/file.exe\n";
+  }
+
+  std::map<std::string, std::string> mapFileToHash;
+  std::map<std::string, ScannerV2::Report> mapHashToReport;
+  QueuedScanMap queued_scans;
+  std::vector<std::pair<std::string, int64_t> > largeFiles;
+  {
+    Checkpoint checkpoint(stateFile);
+    checkpoint.markCompleted("/tmp/first.exe");
+    // Names with line breaks cannot be read back and must not be marked.
+    checkpoint.markCompleted("/tmp/broken\nname.exe");
+    if (checkpoint.completed("/tmp/broken\nname.exe") || (checkpoint.completedCount() != 1))
+    {
+      std::cout << "Error: File name with line break was marked as completed!" << std::endl;
+      return false;
+    }
+    if (!checkpoint.save(mapFileToHash, mapHashToReport, queued_scans, largeFiles))
+    {
+      std::cout << "Error: Could not write first checkpoint!" << std::endl;
+      return false;
+    }
+    if ((countBlocks(readFile(stateFile)) != 1)
+        || (readFile(completedFile) != "done /tmp/first.exe\n"))
+    {
+      std::cout << "Error: First checkpoint did not replace the old state file!" << std::endl;
+      return false;
+    }
+
+    checkpoint.markCompleted("/tmp/second.exe");
+    ScannerV2::Report report;
+    report.response_code = 1;
+    report.positives = 5;
+    report.total = 68;
+    report.scan_date = "2023-11-14 22:13:20";
+    mapHashToReport[infectedHash] = report;
+    mapFileToHash["/tmp/second.exe"] = infectedHash;
+    QueuedScan queued;
+    queued.fileName = "/tmp/third.exe";
+    queued.origin = "/tmp/third.exe";
+    queued.size = 4711;
+    queued_scans.emplace("scan-id-1", queued);
+    // Files with the same content share the scan.
+    queued.fileName = "/tmp/copy-of-third.exe";
+    queued.origin = "/tmp/copy-of-third.exe";
+    queued_scans.emplace("scan-id-1", queued);
+    largeFiles.push_back(std::make_pair("/tmp/large.iso", 1234567890));
+    if (!checkpoint.save(mapFileToHash, mapHashToReport, queued_scans, largeFiles))
+    {
+      std::cout << "Error: Could not write second checkpoint!" << std::endl;
+      return false;
+    }
+    if (countBlocks(readFile(stateFile)) != 2)
+    {
+      std::cout << "Error: Second checkpoint was not appended!" << std::endl;
+      return false;
+    }
+  }
+  const std::string completedBefore = readFile(completedFile);
+  // simulate an incomplete last block after an interrupted write
+  {
+    std::ofstream completed(completedFile, std::ios::out | std::ios::binary | std::ios::app);
+    completed << "done /tmp/incomplete.exe\n";
+    std::ofstream stream(stateFile, std::ios::out | std::ios::binary | std::ios::app);
+    stream << "begin 1700000000 3\n# scan-tool summary\nlarge 1 /tmp/incompl";
+  }
+
+  mapFileToHash.clear();
+  mapHashToReport.clear();
+  queued_scans.clear();
+  largeFiles.clear();
+  Checkpoint checkpoint(stateFile);
+  if (!checkpoint.load(mapFileToHash, mapHashToReport, queued_scans, largeFiles))
+  {
+    std::cout << "Error: Could not load state file!" << std::endl;
+    return false;
+  }
+  if (!checkpoint.completed("/tmp/first.exe") || !checkpoint.completed("/tmp/second.exe")
+      || (checkpoint.completedCount() != 2))
+  {
+    std::cout << "Error: Completed files were not loaded!" << std::endl;
+    return false;
+  }
+  if (checkpoint.completed("/old/file.exe"))
+  {
+    std::cout << "Error: Completed file of an unrelated run was loaded!" << std::endl;
+    return false;
+  }
+  if (checkpoint.completed("/tmp/incomplete.exe"))
+  {
+    std::cout << "Error: Completed file of an incomplete block was loaded!" << std::endl;
+    return false;
+  }
+  if (readFile(completedFile) != completedBefore)
+  {
+    std::cout << "Error: Completed file of an incomplete block was not removed!" << std::endl;
+    return false;
+  }
+  if ((mapFileToHash.size() != 1) || (mapFileToHash["/tmp/second.exe"] != infectedHash)
+      || (mapHashToReport.size() != 1) || (mapHashToReport[infectedHash].positives != 5)
+      || (mapHashToReport[infectedHash].total != 68))
+  {
+    std::cout << "Error: Infected files were not loaded!" << std::endl;
+    return false;
+  }
+  std::set<std::string> queuedNames;
+  const auto range = queued_scans.equal_range("scan-id-1");
+  for (auto iter = range.first; iter != range.second; ++iter)
+  {
+    if (iter->second.size == 4711)
+      queuedNames.insert(iter->second.displayName());
+  }
+  if ((queued_scans.size() != 2) || (queuedNames.size() != 2)
+      || (queuedNames.count("/tmp/third.exe") != 1)
+      || (queuedNames.count("/tmp/copy-of-third.exe") != 1))
+  {
+    std::cout << "Error: Queued scans were not loaded!" << std::endl;
+    return false;
+  }
+  if ((largeFiles.size() != 1) || (largeFiles[0].first != "/tmp/large.iso")
+      || (largeFiles[0].second != 1234567890))
+  {
+    std::cout << "Error: Large files were not loaded!" << std::endl;
+    return false;
+  }
+
+  // The first checkpoint after loading rewrites the state file as one block.
+  checkpoint.markCompleted("/tmp/third.exe");
+  queued_scans.clear();
+  if (!checkpoint.save(mapFileToHash, mapHashToReport, queued_scans, largeFiles))
+  {
+    std::cout << "Error: Could not write checkpoint after loading!" << std::endl;
+    return false;
+  }
+  const std::string content = readFile(stateFile);
+  if ((countBlocks(content) != 1) || (content.find("incomplete") != std::string::npos)
+      || (content.compare(content.size() - 4, 4, "end\n") != 0))
+  {
+    std::cout << "Error: State file was not rewritten after loading!" << std::endl;
+    return false;
+  }
+  // Rewriting the state file only appends to the completed files.
+  if (readFile(completedFile) != completedBefore + "done /tmp/third.exe\n")
+  {
+    std::cout << "Error: Completed files were rewritten with the state file!" << std::endl;
+    return false;
+  }
+  Checkpoint reloaded(stateFile);
+  mapFileToHash.clear();
+  mapHashToReport.clear();
+  largeFiles.clear();
+  if (!reloaded.load(mapFileToHash, mapHashToReport, queued_scans, largeFiles)
+      || (reloaded.completedCount() != 3) || !reloaded.completed("/tmp/third.exe")
+      || !queued_scans.empty() || (mapFileToHash.size() != 1) || (largeFiles.size() != 1))
+  {
+    std::cout << "Error: Rewritten state file was not loaded correctly!" << std::endl;
+    return false;
+  }
+  if (!reloaded.remove() || libstriezel::filesystem::file::exists(stateFile)
+      || libstriezel::filesystem::file::exists(completedFile))
+  {
+    std::cout << "Error: State file was not removed!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int main()
+{
+  std::string dir;
+  if (!libstriezel::filesystem::directory::createTemp(dir))
+  {
+    std::cout << "Error: Could not create temporary directory!" << std::endl;
+    return 1;
+  }
+  const std::string stateFile = libstriezel::filesystem::slashify(dir) + "scan.state";
+  const bool success = testCheckpoint(stateFile);
+  libstriezel::filesystem::file::remove(stateFile);
+  libstriezel::filesystem::file::remove(Checkpoint::completedFileName(stateFile));
+  libstriezel::filesystem::directory::remove(dir);
+  if (!success)
+    return 1;
+
+  std::cout << "Checkpoint tests passed." << std::endl;
+  return 0;
+}
@@ -0,0 +1,129 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include "../../../source/virustotal/FreshnessPolicy.hpp"
+
+using scantool::virustotal::FreshnessPolicy;
+using scantool::virustotal::ReportV2;
+
+/* Creates a report with the given number of positives and engines that is the
+   given number of days old. */
+ReportV2 makeReport(const int positives, const int total, const int ageInDays)
+{
+  ReportV2 report;
+  report.response_code = 1;
+  report.positives = positives;
+  report.total = total;
+  report.scan_date_t = std::chrono::system_clock::to_time_t(
+      std::chrono::system_clock::now() - std::chrono::hours(24 * ageInDays));
+  return report;
+}
+
+int main()
+{
+  FreshnessPolicy policy(90, 3);
+
+  // Without special settings all reports use the general maximum age.
+  if (policy.isOutdated(makeReport(0, 60, 80)) || !policy.isOutdated(makeReport(0, 60, 100))
+      || policy.isOutdated(makeReport(2, 60, 80)) || !policy.isOutdated(makeReport(2, 60, 100)))
+  {
+    std::cout << "Error: General maximum age is not applied!" << std::endl;
+    return 1;
+  }
+
+  policy.setMaxAgeClean(365);
+  policy.setMaxAgeMaybe(14);
+
+  // clean reports from many engines get the longer age
+  if ((policy.maxAgeFor(makeReport(0, 60, 0)) != 365)
+      || policy.isOutdated(makeReport(0, 60, 200))
+      || !policy.isOutdated(makeReport(0, 60, 400)))
+  {
+    std::cout << "Error: Maximum age for clean reports is not applied!" << std::endl;
+    return 1;
+  }
+
+  // clean reports from only a few engines use the general age
+  if ((policy.maxAgeFor(makeReport(0, FreshnessPolicy::cMinimumEnginesForClean - 1, 0)) != 90)
+      || !policy.isOutdated(makeReport(0, 10, 200)))
+  {
+    std::cout << "Error: Clean report from few engines does not use general age!" << std::endl;
+    return 1;
+  }
+
+  // "maybe infected" reports get the shorter age
+  if ((policy.maxAgeFor(makeReport(1, 60, 0)) != 14)
+      || (policy.maxAgeFor(makeReport(3, 60, 0)) != 14)
+      || policy.isOutdated(makeReport(3, 60, 10))
+      || !policy.isOutdated(makeReport(3, 60, 20)))
+  {
+    std::cout << "Error: Maximum age for maybe infected reports is not applied!" << std::endl;
+    return 1;
+  }
+
+  // infected reports use the general age
+  if ((policy.maxAgeFor(makeReport(4, 60, 0)) != 90)
+      || policy.isOutdated(makeReport(20, 60, 80)))
+  {
+    std::cout << "Error: Infected report does not use general age!" << std::endl;
+    return 1;
+  }
+
+  // reports without valid scan date are never outdated
+  ReportV2 noDate = makeReport(0, 60, 0);
+  noDate.scan_date_t = static_cast<std::time_t>(-1);
+  if (policy.isOutdated(noDate))
+  {
+    std::cout << "Error: Report without scan date is considered outdated!" << std::endl;
+    return 1;
+  }
+
+  // A long-lived policy uses the time of the check, not its creation time.
+  const FreshnessPolicy longLived(90, 3);
+  const ReportV2 aging = makeReport(0, 60, 80);
+  const auto now = std::chrono::system_clock::now();
+  if (longLived.isOutdated(aging, now)
+      || !longLived.isOutdated(aging, now + std::chrono::hours(24 * 11)))
+  {
+    std::cout << "Error: Policy does not age reports over time!" << std::endl;
+    return 1;
+  }
+
+  // The same holds when the current time is taken by the policy itself.
+  ReportV2 almostOutdated = makeReport(0, 60, 90);
+  almostOutdated.scan_date_t += 2;
+  if (longLived.isOutdated(almostOutdated))
+  {
+    std::cout << "Error: Report is outdated too early!" << std::endl;
+    return 1;
+  }
+  std::this_thread::sleep_for(std::chrono::seconds(3));
+  if (!longLived.isOutdated(almostOutdated))
+  {
+    std::cout << "Error: Policy still uses the time of its creation!" << std::endl;
+    return 1;
+  }
+
+  std::cout << "Freshness policy tests passed." << std::endl;
+  return 0;
+}
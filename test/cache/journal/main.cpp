@@ -0,0 +1,174 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "../../../libstriezel/filesystem/directory.hpp"
+#include "../../../libstriezel/filesystem/file.hpp"
+#include "../../../source/scan-tool/RunJournal.hpp"
+
+using scantool::hash::FileStatus;
+using scantool::virustotal::RunJournal;
+using scantool::virustotal::ScannerV2;
+
+SHA256::MessageDigest digestFromHex(const std::string& hex)
+{
+  SHA256::MessageDigest digest;
+  digest.fromHexString(hex);
+  return digest;
+}
+
+ScannerV2::Report makeReport(const int positives, const int total, const std::time_t scanDate)
+{
+  ScannerV2::Report report;
+  report.response_code = 1;
+  report.positives = positives;
+  report.total = total;
+  report.scan_date_t = scanDate;
+  return report;
+}
+
+bool testJournal(const std::string& journalFile)
+{
+  // time stamps from the year 2020, so that entries are not considered racy
+  const FileStatus status{ 2049, 1234567, 4711, 1600000000123456789, 1600000001987654321 };
+  const SHA256::MessageDigest digest = digestFromHex("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+  const SHA256::MessageDigest otherDigest = digestFromHex("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+  const std::string name = "/tmp/some dir/file name.exe";
+  const std::time_t scanDate = 1700000000;
+
+  {
+    RunJournal journal(journalFile);
+    if (!journal.load())
+    {
+      std::cout << "Error: Loading a missing journal file failed!" << std::endl;
+      return false;
+    }
+    journal.record(name, status, digest, makeReport(0, 70, scanDate));
+    journal.record("/tmp/infected.exe", status, otherDigest, makeReport(5, 68, scanDate));
+    // A report without valid date must not be recorded.
+    journal.record("/tmp/no-date.exe", status, digest, makeReport(0, 70, static_cast<std::time_t>(-1)));
+    // A file that was changed just now must not be recorded.
+    FileStatus recent;
+    if (!FileStatus::get(journalFile + ".new", recent))
+    {
+      std::cout << "Error: Could not get status of new file!" << std::endl;
+      return false;
+    }
+    journal.record(journalFile + ".new", recent, digest, makeReport(0, 70, scanDate));
+    // Replace the verdict of the infected file, like after a rescan.
+    journal.record("/tmp/infected.exe", status, otherDigest, makeReport(7, 69, scanDate + 86400));
+    if (!journal.flush())
+    {
+      std::cout << "Error: Could not write journal file!" << std::endl;
+      return false;
+    }
+  }
+  // simulate an incomplete last line after an interrupted write
+  {
+    std::ofstream stream(journalFile, std::ios::out | std::ios::binary | std::ios::app);
+    stream << "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad 0 70 17";
+  }
+
+  RunJournal journal(journalFile);
+  if (!journal.load())
+  {
+    std::cout << "Error: Could not load journal file!" << std::endl;
+    return false;
+  }
+  RunJournal::Entry entry;
+  if (!journal.lookup(name, status, entry) || (entry.digest != digest)
+      || (entry.positives != 0) || (entry.total != 70) || (entry.scanDate != scanDate))
+  {
+    std::cout << "Error: Journal entry was not found after reload!" << std::endl;
+    return false;
+  }
+  FileStatus changed = status;
+  changed.mtime_ns += 1;
+  if (journal.lookup(name, changed, entry))
+  {
+    std::cout << "Error: Journal entry was used for changed file!" << std::endl;
+    return false;
+  }
+  if (!journal.lookup("/tmp/infected.exe", status, entry) || (entry.positives != 7)
+      || (entry.total != 69) || (entry.scanDate != scanDate + 86400))
+  {
+    std::cout << "Error: Replacing journal entry was not found!" << std::endl;
+    return false;
+  }
+  const ScannerV2::Report report = entry.report();
+  if (!report.successfulRetrieval() || (report.positives != 7) || (report.total != 69)
+      || !report.hasTime_t() || (report.scan_date_t != scanDate + 86400)
+      || (report.sha256 != otherDigest.toHexString()) || (report.scan_date.size() != 19))
+  {
+    std::cout << "Error: Report from journal entry is not correct!" << std::endl;
+    return false;
+  }
+  if (journal.lookup("/tmp/no-date.exe", status, entry))
+  {
+    std::cout << "Error: Report without date was recorded!" << std::endl;
+    return false;
+  }
+  FileStatus recent;
+  if (FileStatus::get(journalFile + ".new", recent) && journal.lookup(journalFile + ".new", recent, entry))
+  {
+    std::cout << "Error: Recently changed file was recorded!" << std::endl;
+    return false;
+  }
+  // New entries must not get lost after the incomplete line.
+  journal.record("/tmp/third.exe", status, otherDigest, makeReport(1, 60, scanDate));
+  if (!journal.compact())
+  {
+    std::cout << "Error: Could not compact journal file!" << std::endl;
+    return false;
+  }
+  RunJournal reloaded(journalFile);
+  if (!reloaded.load() || !reloaded.lookup("/tmp/third.exe", status, entry)
+      || (entry.digest != otherDigest) || (entry.positives != 1))
+  {
+    std::cout << "Error: Entry after incomplete line was not found!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int main()
+{
+  std::string dir;
+  if (!libstriezel::filesystem::directory::createTemp(dir))
+  {
+    std::cout << "Error: Could not create temporary directory!" << std::endl;
+    return 1;
+  }
+  const std::string journalFile = libstriezel::filesystem::slashify(dir) + "scan.journal";
+  {
+    std::ofstream stream(journalFile + ".new", std::ios::out | std::ios::binary | std::ios::trunc);
+  }
+  const bool success = testJournal(journalFile);
+  libstriezel::filesystem::file::remove(journalFile + ".new");
+  libstriezel::filesystem::file::remove(journalFile);
+  libstriezel::filesystem::directory::remove(dir);
+  if (!success)
+    return 1;
+
+  std::cout << "Run journal tests passed." << std::endl;
+  return 0;
+}
@@ -0,0 +1,116 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the test suite for scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../../../libstriezel/filesystem/directory.hpp"
+#include "../../../libstriezel/filesystem/file.hpp"
+#include "../../../source/virustotal/CacheLayout.hpp"
+
+using scantool::virustotal::CacheLayout;
+
+const std::string hash = "ab16da1c2e0a8a5bc57a2d1a6e5d9e2e6fa2a6b7e3bd1f8b4a9c8e3c9d1e2f30";
+
+int main()
+{
+  // default layout
+  const CacheLayout def;
+  if (!def.isDefault() || (def.levels() != 1) || (def.width() != 2)
+      || (def.directoriesPerLevel() != 256))
+  {
+    std::cout << "Error: Default layout has unexpected properties!" << std::endl;
+    return 1;
+  }
+  if (def.relativeDirectory(hash) != "ab")
+  {
+    std::cout << "Error: Relative directory of default layout is "
+              << def.relativeDirectory(hash) << "!" << std::endl;
+    return 1;
+  }
+
+  // parsing of layouts
+  CacheLayout layout;
+  if (!CacheLayout::fromString("2x2", layout) || (layout != CacheLayout(2, 2)))
+  {
+    std::cout << "Error: Could not parse layout 2x2!" << std::endl;
+    return 1;
+  }
+  const std::string expected = std::string("ab")
+      + libstriezel::filesystem::pathDelimiter + "16";
+  if (layout.relativeDirectory(hash) != expected)
+  {
+    std::cout << "Error: Relative directory of 2x2 layout is "
+              << layout.relativeDirectory(hash) << "!" << std::endl;
+    return 1;
+  }
+  const std::vector<std::string> invalid = { "", "x", "2x", "x2", "0x2", "5x1",
+                                             "1x4", "3x3", "axb", "2x2x2" };
+  for (const auto& text : invalid)
+  {
+    if (CacheLayout::fromString(text, layout))
+    {
+      std::cout << "Error: Invalid layout \"" << text << "\" was accepted!"
+                << std::endl;
+      return 1;
+    }
+  }
+
+  // invalid values result in default layout
+  if (!CacheLayout(9, 9).isDefault())
+  {
+    std::cout << "Error: Invalid values did not result in default layout!"
+              << std::endl;
+    return 1;
+  }
+
+  // round trip via descriptor file
+  std::string root;
+  if (!libstriezel::filesystem::directory::createTemp(root))
+  {
+    std::cout << "Error: Could not create temporary directory!" << std::endl;
+    return 1;
+  }
+  if (!CacheLayout::loadFromCacheRoot(root, layout) || !layout.isDefault())
+  {
+    std::cout << "Error: Cache without descriptor does not use default layout!"
+              << std::endl;
+    return 1;
+  }
+  const CacheLayout saved(3, 1);
+  if (!saved.saveToCacheRoot(root))
+  {
+    std::cout << "Error: Could not save layout descriptor!" << std::endl;
+    return 1;
+  }
+  const bool loaded = CacheLayout::loadFromCacheRoot(root, layout);
+  libstriezel::filesystem::file::remove(libstriezel::filesystem::slashify(root)
+                                        + CacheLayout::cDescriptorFileName);
+  libstriezel::filesystem::directory::remove(root);
+  if (!loaded || (layout != saved))
+  {
+    std::cout << "Error: Loaded layout differs from saved layout!" << std::endl;
+    return 1;
+  }
+
+  // Everything seems to be OK.
+  std::cout << "Test for cache layout was passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,151 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "../../../libstriezel/filesystem/directory.hpp"
+#include "../../../libstriezel/filesystem/file.hpp"
+#include "../../../source/virustotal/UploadLedger.hpp"
+
+using scantool::virustotal::UploadLedger;
+
+bool testUploadLedger(const std::string& ledgerFile)
+{
+  const std::string hash = "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855";
+  const std::string otherHash = "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad";
+
+  {
+    UploadLedger ledger(ledgerFile);
+    if (!ledger.load() || (ledger.size() != 0))
+    {
+      std::cout << "Error: Missing ledger file was not loaded as empty ledger!" << std::endl;
+      return false;
+    }
+    if (ledger.record("not a hash", "id", 1700000000) || ledger.record(hash, "with space", 1700000000)
+        || ledger.record(hash, "", 1700000000))
+    {
+      std::cout << "Error: Upload with invalid data was recorded!" << std::endl;
+      return false;
+    }
+    if (!ledger.record(hash, hash + "-1700000000", 1700000000)
+        || !ledger.record(otherHash, otherHash + "-1700000000", 1700000000)
+        || !ledger.flush())
+    {
+      std::cout << "Error: Could not record uploads!" << std::endl;
+      return false;
+    }
+    // A later upload of the same file replaces the earlier one.
+    if (!ledger.record(hash, hash + "-1800000000", 1800000000) || !ledger.flush()
+        || (ledger.size() != 2))
+    {
+      std::cout << "Error: Could not record second upload!" << std::endl;
+      return false;
+    }
+  }
+
+  // An interrupted write leaves an incomplete line that has to be ignored,
+  // even if it looks like a complete line with a shorter scan_id.
+  {
+    std::ofstream stream(ledgerFile, std::ios::out | std::ios::binary | std::ios::app);
+    stream << otherHash << " 1900000000 " << otherHash.substr(0, 20);
+  }
+  {
+    UploadLedger ledger(ledgerFile);
+    UploadLedger::Entry entry;
+    if (!ledger.load() || (ledger.size() != 2) || !ledger.find(hash, entry))
+    {
+      std::cout << "Error: Expected two uploads after reload!" << std::endl;
+      return false;
+    }
+    if ((entry.uploaded != 1800000000) || (entry.scan_id != hash + "-1800000000"))
+    {
+      std::cout << "Error: Latest upload was not restored!" << std::endl;
+      return false;
+    }
+    if (!ledger.find(otherHash, entry) || (entry.uploaded != 1700000000))
+    {
+      std::cout << "Error: Incomplete line replaced an upload!" << std::endl;
+      return false;
+    }
+    // Uploads of other processes survive the compaction, expired ones do not.
+    UploadLedger other(ledgerFile);
+    const std::string thirdHash = std::string(64, 'a');
+    if (!other.load() || !other.record(thirdHash, "third", 1800000001) || !other.flush())
+    {
+      std::cout << "Error: Could not record upload by second instance!" << std::endl;
+      return false;
+    }
+    for (int i = 0; i < 200; ++i)
+    {
+      ledger.record(hash, "scan-" + std::to_string(i), 1800000000 + i);
+    }
+    if (!ledger.compact(1750000000) || (ledger.size() != 2) || ledger.find(otherHash, entry)
+        || !ledger.find(thirdHash, entry) || !ledger.find(hash, entry)
+        || (entry.scan_id != "scan-199"))
+    {
+      std::cout << "Error: Compaction failed or kept the wrong uploads!" << std::endl;
+      return false;
+    }
+  }
+
+  {
+    UploadLedger ledger(ledgerFile);
+    UploadLedger::Entry entry;
+    if (!ledger.load() || (ledger.size() != 2) || !ledger.find(hash, entry)
+        || (entry.uploaded != 1800000199))
+    {
+      std::cout << "Error: Compacted ledger does not contain the uploads!" << std::endl;
+      return false;
+    }
+  }
+  std::ifstream stream(ledgerFile, std::ios::in | std::ios::binary);
+  std::string line;
+  std::size_t lines = 0;
+  while (std::getline(stream, line))
+  {
+    ++lines;
+  }
+  if (lines > 3)
+  {
+    std::cout << "Error: Ledger file was not compacted, it has " << lines << " lines!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int main()
+{
+  std::string dir;
+  if (!libstriezel::filesystem::directory::createTemp(dir))
+  {
+    std::cout << "Error: Could not create temporary directory!" << std::endl;
+    return 1;
+  }
+  const std::string ledgerFile = UploadLedger::defaultFileName(dir);
+  const bool success = testUploadLedger(ledgerFile);
+  libstriezel::filesystem::file::remove(ledgerFile);
+  libstriezel::filesystem::directory::remove(dir);
+  if (!success)
+    return 1;
+
+  std::cout << "Upload ledger tests passed." << std::endl;
+  return 0;
+}
@@ -0,0 +1,213 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "../../../libstriezel/filesystem/directory.hpp"
+#include "../../../libstriezel/filesystem/file.hpp"
+#include "../../../source/virustotal/PendingScans.hpp"
+
+using scantool::virustotal::PendingScans;
+
+PendingScans::Entry makeEntry(const std::string& sha256, const std::string& name)
+{
+  PendingScans::Entry entry;
+  entry.sha256 = sha256;
+  entry.size = 4711;
+  entry.submitted = 1700000000;
+  entry.name = name;
+  return entry;
+}
+
+bool testPendingScans(const std::string& listFile)
+{
+  const std::string hash = "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855";
+  const std::string otherHash = "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad";
+  const std::string scanId = hash + "-1700000000";
+  const std::string otherScanId = otherHash + "-1700000001";
+  const std::string name = "/tmp/some dir/archive.zip!/file name.exe";
+
+  {
+    PendingScans pending(listFile);
+    if (!pending.load() || !pending.empty())
+    {
+      std::cout << "Error: Missing list file was not loaded as empty list!" << std::endl;
+      return false;
+    }
+    if (!pending.add(scanId, makeEntry(hash, name)) || pending.add(scanId, makeEntry(hash, name)))
+    {
+      std::cout << "Error: Scan was not added exactly once!" << std::endl;
+      return false;
+    }
+    if (pending.add("with space", makeEntry(hash, name)) || pending.add("id", makeEntry(hash, "line\nbreak")))
+    {
+      std::cout << "Error: Scan with invalid data was added!" << std::endl;
+      return false;
+    }
+    // Scans without known hash can be kept, too.
+    if (!pending.add(otherScanId, makeEntry("", "other.exe")) || !pending.flush())
+    {
+      std::cout << "Error: Could not write pending scans!" << std::endl;
+      return false;
+    }
+  }
+
+  {
+    PendingScans pending(listFile);
+    if (!pending.load() || (pending.size() != 2))
+    {
+      std::cout << "Error: Expected two pending scans after reload!" << std::endl;
+      return false;
+    }
+    std::string found;
+    if (!pending.find(hash, found) || (found != scanId) || pending.find(otherHash, found))
+    {
+      std::cout << "Error: Scans are not found by their hash!" << std::endl;
+      return false;
+    }
+    const PendingScans::Entry& entry = pending.entries().find(scanId)->second;
+    if ((entry.sha256 != hash) || (entry.size != 4711) || (entry.submitted != 1700000000)
+        || (entry.name != name) || !pending.entries().find(otherScanId)->second.sha256.empty())
+    {
+      std::cout << "Error: Data of the pending scan was not restored!" << std::endl;
+      return false;
+    }
+    pending.resolve(scanId);
+    if (pending.find(hash, found) || !pending.flush())
+    {
+      std::cout << "Error: Resolved scan is still found!" << std::endl;
+      return false;
+    }
+  }
+
+  // An interrupted write leaves an incomplete line that has to be ignored,
+  // even if it looks like a complete line with a shorter name.
+  {
+    std::ofstream stream(listFile, std::ios::out | std::ios::binary | std::ios::app);
+    stream << otherHash << "-1700000002 " << otherHash << " 12 1700000002 /tmp/trunc";
+  }
+  {
+    PendingScans pending(listFile);
+    if (!pending.load() || (pending.size() != 1) || (pending.entries().count(otherScanId) != 1))
+    {
+      std::cout << "Error: Expected only the unresolved scan after reload!" << std::endl;
+      return false;
+    }
+    // Scans of other processes survive the compaction.
+    PendingScans other(listFile);
+    if (!other.load() || !other.add(scanId, makeEntry(hash, name)) || !other.flush())
+    {
+      std::cout << "Error: Could not add scan by second instance!" << std::endl;
+      return false;
+    }
+    for (int i = 0; i < 200; ++i)
+    {
+      const std::string id = "scan-" + std::to_string(i);
+      pending.add(id, makeEntry("", "file.bin"));
+      pending.resolve(id);
+    }
+    if (!pending.compact() || (pending.size() != 2))
+    {
+      std::cout << "Error: Compaction failed or lost scans of another process!" << std::endl;
+      return false;
+    }
+  }
+
+  {
+    PendingScans pending(listFile);
+    std::string found;
+    if (!pending.load() || (pending.size() != 2) || !pending.find(hash, found))
+    {
+      std::cout << "Error: Compacted list does not contain the pending scans!" << std::endl;
+      return false;
+    }
+  }
+  std::ifstream stream(listFile, std::ios::in | std::ios::binary);
+  std::string line;
+  std::size_t lines = 0;
+  while (std::getline(stream, line))
+  {
+    ++lines;
+  }
+  if (lines > 3)
+  {
+    std::cout << "Error: List file was not compacted, it has " << lines << " lines!" << std::endl;
+    return false;
+  }
+
+  // Files with the same content share a scan, but each one is kept.
+  const std::string sharedScanId = "shared-scan";
+  {
+    PendingScans pending(listFile);
+    if (!pending.load() || !pending.add(sharedScanId, makeEntry(otherHash, "first.exe"))
+        || !pending.add(sharedScanId, makeEntry(otherHash, "second.exe"))
+        || pending.add(sharedScanId, makeEntry(otherHash, "second.exe")) || !pending.flush())
+    {
+      std::cout << "Error: Files of a shared scan were not added exactly once!" << std::endl;
+      return false;
+    }
+  }
+  {
+    PendingScans pending(listFile);
+    std::string found;
+    if (!pending.load() || (pending.entries().count(sharedScanId) != 2)
+        || !pending.find(otherHash, found) || (found != sharedScanId))
+    {
+      std::cout << "Error: Expected both files of the shared scan after reload!" << std::endl;
+      return false;
+    }
+    pending.resolve(sharedScanId);
+    if ((pending.entries().count(sharedScanId) != 0) || pending.find(otherHash, found)
+        || !pending.flush())
+    {
+      std::cout << "Error: Resolving a shared scan did not remove all its files!" << std::endl;
+      return false;
+    }
+  }
+  {
+    PendingScans pending(listFile);
+    if (!pending.load() || (pending.entries().count(sharedScanId) != 0) || (pending.size() != 2))
+    {
+      std::cout << "Error: Resolved shared scan is back after reload!" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+int main()
+{
+  std::string dir;
+  if (!libstriezel::filesystem::directory::createTemp(dir))
+  {
+    std::cout << "Error: Could not create temporary directory!" << std::endl;
+    return 1;
+  }
+  const std::string listFile = PendingScans::defaultFileName(dir);
+  const bool success = testPendingScans(listFile);
+  libstriezel::filesystem::file::remove(listFile);
+  libstriezel::filesystem::directory::remove(dir);
+  if (!success)
+    return 1;
+
+  std::cout << "Pending scans tests passed." << std::endl;
+  return 0;
+}
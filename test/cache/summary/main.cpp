@@ -0,0 +1,119 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include "../../../libstriezel/filesystem/directory.hpp"
+#include "../../../libstriezel/filesystem/file.hpp"
+#include "../../../source/scan-tool/summary.hpp"
+
+using namespace scantool::virustotal;
+
+const std::string infectedHash = "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad";
+
+bool testLineBreaks(const std::string& summaryFile)
+{
+  std::map<std::string, std::string> mapFileToHash;
+  std::map<std::string, ScannerV2::Report> mapHashToReport;
+  QueuedScanMap queued_scans;
+  std::vector<std::pair<std::string, int64_t> > largeFiles;
+
+  ScannerV2::Report report;
+  report.response_code = 1;
+  report.positives = 1;
+  report.total = 60;
+  report.scan_date = "2023-11-14 22:13:20";
+  auto engine = std::make_shared<ScannerV2::Report::Engine>();
+  engine->engine = "Engine";
+  engine->detected = true;
+  engine->result = "Trojan\nfile - /forged/by/result.exe";
+  report.scans.push_back(engine);
+  mapHashToReport[infectedHash] = report;
+  mapFileToHash["/tmp/infected.exe"] = infectedHash;
+  // Each of these names would add a file that was never scanned.
+  mapFileToHash["/tmp/evil\nfile - /forged/infected.exe"] = infectedHash;
+  QueuedScan queued;
+  queued.fileName = "/tmp/queued\nlarge 1 /forged/large.iso";
+  queued.origin = queued.fileName;
+  queued.size = 4711;
+  queued_scans.emplace("scan-id-1", queued);
+  largeFiles.push_back(std::make_pair("/tmp/large\r\nqueued id - 1 /forged/queued.exe", 1234567890));
+  largeFiles.push_back(std::make_pair("/tmp/large.iso", 1234567890));
+
+  std::vector<std::string> skipped;
+  formatSummary(mapFileToHash, mapHashToReport, queued_scans, largeFiles, &skipped);
+  if (skipped.size() != 3)
+  {
+    std::cout << "Error: Expected three skipped names, but got " << skipped.size()
+              << "!" << std::endl;
+    return false;
+  }
+
+  if (!saveSummary(summaryFile, mapFileToHash, mapHashToReport, queued_scans, largeFiles))
+  {
+    std::cout << "Error: Could not write summary file!" << std::endl;
+    return false;
+  }
+  std::map<std::string, std::string> loadedFiles;
+  std::map<std::string, ScannerV2::Report> loadedReports;
+  QueuedScanMap loadedQueue;
+  std::vector<std::pair<std::string, int64_t> > loadedLarge;
+  std::ifstream stream(summaryFile, std::ios::in | std::ios::binary);
+  if (!parseSummary(stream, loadedFiles, loadedReports, loadedQueue, loadedLarge))
+  {
+    std::cout << "Error: Could not read summary file!" << std::endl;
+    return false;
+  }
+  if ((loadedFiles.size() != 1) || (loadedFiles.count("/tmp/infected.exe") != 1)
+      || !loadedQueue.empty()
+      || (loadedLarge.size() != 1) || (loadedLarge[0].first != "/tmp/large.iso"))
+  {
+    std::cout << "Error: Summary file contains forged lines!" << std::endl;
+    return false;
+  }
+  if ((loadedReports.size() != 1) || (loadedReports[infectedHash].scans.size() != 1)
+      || (loadedReports[infectedHash].scans[0]->result != "Trojan file - /forged/by/result.exe"))
+  {
+    std::cout << "Error: Line break in the result of an engine was not replaced!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int main()
+{
+  std::string dir;
+  if (!libstriezel::filesystem::directory::createTemp(dir))
+  {
+    std::cout << "Error: Could not create temporary directory!" << std::endl;
+    return 1;
+  }
+  const std::string summaryFile = libstriezel::filesystem::slashify(dir) + "summary.txt";
+  const bool success = testLineBreaks(summaryFile);
+  libstriezel::filesystem::file::remove(summaryFile);
+  libstriezel::filesystem::directory::remove(dir);
+  if (!success)
+    return 1;
+
+  std::cout << "Summary tests passed." << std::endl;
+  return 0;
+}
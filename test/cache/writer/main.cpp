@@ -0,0 +1,120 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the test suite for scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include <iostream>
+#include <string>
+#include "../../../libstriezel/filesystem/directory.hpp"
+#include "../../../libstriezel/filesystem/file.hpp"
+#include "../../../source/virustotal/CacheManagerV2.hpp"
+#include "../../../source/virustotal/CacheWriter.hpp"
+
+using scantool::virustotal::CacheManagerV2;
+using scantool::virustotal::CacheWriter;
+
+const std::string hashOne = "ab16da1c2e0a8a5bc57a2d1a6e5d9e2e6fa2a6b7e3bd1f8b4a9c8e3c9d1e2f30";
+const std::string hashTwo = "cd16da1c2e0a8a5bc57a2d1a6e5d9e2e6fa2a6b7e3bd1f8b4a9c8e3c9d1e2f30";
+
+bool hasContent(const std::string& path, const std::string& expected)
+{
+  std::string content;
+  return libstriezel::filesystem::file::readIntoString(path, content)
+      && (content == expected);
+}
+
+int main()
+{
+  std::string root;
+  if (!libstriezel::filesystem::directory::createTemp(root))
+  {
+    std::cout << "Error: Could not create temporary directory!" << std::endl;
+    return 1;
+  }
+  CacheManagerV2 cacheMgr(root);
+  if (!cacheMgr.createCacheDirectory())
+  {
+    std::cout << "Error: Could not create cache directory!" << std::endl;
+    return 1;
+  }
+  const std::string pathOne = cacheMgr.getPathForCachedElement(hashOne);
+  const std::string pathTwo = cacheMgr.getPathForCachedElement(hashTwo);
+
+  int result = 0;
+  {
+    CacheWriter writer(4, true);
+    cacheMgr.setCacheWriter(&writer);
+    if (!writer.enqueue(hashOne, root, "{\"one\":1}")
+        || !writer.enqueue(hashOne, root, "{\"one\":2}")
+        || !writer.enqueue(hashTwo, root, "{\"two\":1}"))
+    {
+      std::cout << "Error: Could not queue writes!" << std::endl;
+      result = 1;
+    }
+    // A deleted element must not be written later.
+    cacheMgr.deleteCachedElement(hashTwo);
+    writer.finish();
+    cacheMgr.setCacheWriter(nullptr);
+
+    if (!hasContent(pathOne, "{\"one\":2}"))
+    {
+      std::cout << "Error: Cached element does not have the newest content!"
+                << std::endl;
+      result = 1;
+    }
+    if (libstriezel::filesystem::file::exists(pathTwo))
+    {
+      std::cout << "Error: Deleted element was written!" << std::endl;
+      result = 1;
+    }
+    std::string content;
+    if (writer.pendingContent(pathOne, content))
+    {
+      std::cout << "Error: Element is still pending after finish()!" << std::endl;
+      result = 1;
+    }
+    if (writer.failed() != 0)
+    {
+      std::cout << "Error: " << writer.failed() << " writes failed!" << std::endl;
+      result = 1;
+    }
+
+    // Writes after finish() are performed directly.
+    if (!writer.enqueue(hashTwo, root, "{\"two\":2}")
+        || !hasContent(pathTwo, "{\"two\":2}"))
+    {
+      std::cout << "Error: Write after finish() failed!" << std::endl;
+      result = 1;
+    }
+  }
+
+  // clean up
+  libstriezel::filesystem::file::remove(pathOne);
+  libstriezel::filesystem::file::remove(pathTwo);
+  cacheMgr.getLayout().forEachLeafDirectory(root, [](const std::string& dir)
+  {
+    libstriezel::filesystem::directory::remove(dir);
+  });
+  libstriezel::filesystem::file::remove(libstriezel::filesystem::slashify(root)
+      + scantool::virustotal::CacheLayout::cDescriptorFileName);
+  libstriezel::filesystem::directory::remove(root);
+
+  if (result == 0)
+    std::cout << "Test for cache writer was passed!" << std::endl;
+  return result;
+}
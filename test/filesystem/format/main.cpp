@@ -0,0 +1,121 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../../../source/filesystem/FileFormat.hpp"
+
+using namespace scantool::filesystem;
+
+/** \brief Checks the format that is detected for some data.
+ *
+ * \param name      name of the test case
+ * \param data      the start of the file
+ * \param expected  the expected format
+ * \return Returns true, if the expected format was detected.
+ */
+bool check(const std::string& name, const std::vector<uint8_t>& data, const FileFormat expected)
+{
+  const FileFormat detected = sniffFormat(data.data(), data.size());
+  if (detected != expected)
+  {
+    std::cout << "Error: Format of " << name << " is " << static_cast<int>(detected)
+              << " instead of " << static_cast<int>(expected) << "!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/** \brief Creates data that starts with the given magic bytes.
+ *
+ * \param magic   the magic bytes
+ * \param length  number of magic bytes
+ * \param size    total size of the data
+ * \return Returns the magic bytes, followed by zeros up to the total size.
+ */
+std::vector<uint8_t> withMagic(const char* magic, const std::size_t length, const std::size_t size = 1024)
+{
+  std::vector<uint8_t> data(size, 0);
+  std::memcpy(data.data(), magic, length);
+  return data;
+}
+
+/** \brief Creates an old tar header without magic, but with checksum.
+ *
+ * \return Returns the header.
+ */
+std::vector<uint8_t> oldTarHeader()
+{
+  std::vector<uint8_t> header(512, 0);
+  const std::string name = "readme.txt";
+  std::memcpy(header.data(), name.data(), name.size());
+  std::memcpy(header.data() + 100, "0000644", 7);
+  std::memcpy(header.data() + 124, "00000000012", 11);
+  header[156] = '0';
+  unsigned int sum = 8 * ' ';
+  for (std::size_t i = 0; i < header.size(); ++i)
+  {
+    sum += header[i];
+  }
+  const std::string checksum = "0" + std::to_string(sum / 512 % 8) + std::to_string(sum / 64 % 8)
+      + std::to_string(sum / 8 % 8) + std::to_string(sum % 8);
+  // six digits, NUL and space, as written by most tar implementations
+  std::memcpy(header.data() + 148, ("0" + checksum).c_str(), 7);
+  header[155] = ' ';
+  return header;
+}
+
+int main()
+{
+  bool success = check("ZIP", withMagic("PK\x03\x04", 4), FileFormat::Zip)
+      && check("empty ZIP", withMagic("PK\x05\x06", 4, 22), FileFormat::Zip)
+      && check("7-Zip", withMagic("7z\xBC\xAF\x27\x1C", 6), FileFormat::SevenZip)
+      && check("gzip", withMagic("\x1F\x8B\x08", 3, 20), FileFormat::Gzip)
+      && check("XZ", withMagic("\xFD" "7zXZ\x00", 6), FileFormat::Xz)
+      && check("Ar", withMagic("!<arch>\n", 8), FileFormat::Ar)
+      && check("Cabinet", withMagic("MSCF\x00\x00\x00\x00", 8), FileFormat::Cab)
+      && check("InstallShield", withMagic("ISc(", 4), FileFormat::InstallShield)
+      && check("Rar 4", withMagic("Rar!\x1A\x07\x00", 7), FileFormat::Rar)
+      && check("Rar 5", withMagic("Rar!\x1A\x07\x01\x00", 8), FileFormat::Rar)
+      && check("old tar", oldTarHeader(), FileFormat::Tar)
+      && check("zeros", std::vector<uint8_t>(4096, 0), FileFormat::Unknown)
+      && check("empty file", std::vector<uint8_t>(), FileFormat::Unknown)
+      && check("text", withMagic("PK is not enough", 16), FileFormat::Unknown)
+      && check("truncated 7-Zip", withMagic("7z\xBC", 3, 3), FileFormat::Unknown);
+
+  std::vector<uint8_t> ustar(1024, 0);
+  std::memcpy(ustar.data() + 257, "ustar\x00" "00", 8);
+  success = success && check("ustar", ustar, FileFormat::Tar);
+
+  std::vector<uint8_t> iso(cSniffSize, 0);
+  std::memcpy(iso.data() + 32768, "\x01" "CD001", 6);
+  success = success && check("ISO 9660", iso, FileFormat::ISO9660);
+  // The descriptor is not there, if only the first octets are known.
+  iso.resize(32770);
+  success = success && check("truncated ISO 9660", iso, FileFormat::Unknown);
+
+  if (!success)
+    return 1;
+
+  std::cout << "File format tests passed." << std::endl;
+  return 0;
+}
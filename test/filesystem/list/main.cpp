@@ -0,0 +1,240 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+#if defined(__linux__)
+#include <csignal>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+#include "../../../source/filesystem/ListReader.hpp"
+#include "../../../source/filesystem/PathSet.hpp"
+
+using namespace scantool::filesystem;
+
+bool readAll(ListReader& reader, const std::size_t chunkSize, std::vector<std::string>& result)
+{
+  result.clear();
+  std::vector<std::string> files;
+  while (reader.next(files, chunkSize))
+  {
+    if (files.size() > chunkSize)
+    {
+      std::cout << "Error: Got " << files.size() << " files, but only "
+                << chunkSize << " were requested!" << std::endl;
+      return false;
+    }
+    result.insert(result.end(), files.begin(), files.end());
+  }
+  return true;
+}
+
+bool testListReader()
+{
+  const std::vector<std::string> expected = { "/tmp/a.txt", "file with spaces.exe",
+      "line\nbreak", "c" };
+  std::string nulList;
+  for (const auto& name : expected)
+  {
+    nulList += name + std::string(1, '\0');
+    // empty entries are skipped
+    if (name == "line\nbreak")
+      nulList += std::string(1, '\0');
+  }
+  std::istringstream nulStream(nulList);
+  ListReader nulReader(nulStream, '\0');
+  std::vector<std::string> result;
+  if (!readAll(nulReader, 3, result) || (result != expected))
+  {
+    std::cout << "Error: NUL-delimited list was not read correctly!" << std::endl;
+    return false;
+  }
+
+  // last line without line break
+  std::istringstream lineStream("/tmp/a.txt\n\nfile with spaces.exe\nc");
+  ListReader lineReader(lineStream, '\n');
+  if (!readAll(lineReader, 1, result)
+      || (result != std::vector<std::string>{ "/tmp/a.txt", "file with spaces.exe", "c" }))
+  {
+    std::cout << "Error: Line-delimited list was not read correctly!" << std::endl;
+    return false;
+  }
+
+  ListReader missing("/this/file/does/not/exist.txt", '\n');
+  if (missing.isOpen() || missing.next(result, 10))
+  {
+    std::cout << "Error: Missing list file is treated as open!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/// buffer that provides some characters and then fails
+class FailingBuffer: public std::streambuf
+{
+  public:
+    FailingBuffer()
+    : m_Data("first\nsecond\nthi")
+    {
+      setg(&m_Data[0], &m_Data[0], &m_Data[0] + m_Data.size());
+    }
+  protected:
+    virtual int_type underflow() override
+    {
+      throw std::ios_base::failure("read error");
+    }
+  private:
+    std::string m_Data;
+}; // class
+
+bool testReadError()
+{
+  FailingBuffer buffer;
+  std::istream stream(&buffer);
+  ListReader reader(stream, '\n');
+  std::vector<std::string> result;
+  if (!readAll(reader, 10, result)
+      || (result != std::vector<std::string>{ "first", "second" }) || !reader.failed())
+  {
+    std::cout << "Error: Read error was not reported!" << std::endl;
+    return false;
+  }
+  std::istringstream complete("a\nb");
+  ListReader completeReader(complete, '\n');
+  if (!readAll(completeReader, 10, result) || completeReader.failed())
+  {
+    std::cout << "Error: End of list is reported as read error!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+#if defined(__linux__)
+void ignoreSignal(int)
+{
+}
+
+bool testInterruptedStandardInput()
+{
+  // Signal handlers without SA_RESTART interrupt the read from stdin.
+  struct sigaction sa{};
+  sa.sa_handler = ignoreSignal;
+  sigemptyset(&sa.sa_mask);
+  sa.sa_flags = 0;
+  int fds[2];
+  if ((sigaction(SIGUSR1, &sa, nullptr) != 0) || (pipe(fds) != 0))
+  {
+    std::cout << "Error: Could not prepare the signal test!" << std::endl;
+    return false;
+  }
+  const pid_t child = fork();
+  if (child == 0)
+  {
+    close(fds[0]);
+    // The signal arrives in the middle of the third name.
+    const std::string first = "a\nb\nth";
+    const std::string second = "ird\nd\n";
+    if (write(fds[1], first.data(), first.size()) < 0)
+      _exit(1);
+    usleep(300000);
+    kill(getppid(), SIGUSR1);
+    usleep(200000);
+    if (write(fds[1], second.data(), second.size()) < 0)
+      _exit(1);
+    _exit(0);
+  }
+  close(fds[1]);
+  dup2(fds[0], STDIN_FILENO);
+  close(fds[0]);
+  ListReader reader("-", '\n');
+  std::vector<std::string> result;
+  const bool success = readAll(reader, 10, result);
+  waitpid(child, nullptr, 0);
+  if (!success || reader.failed()
+      || (result != std::vector<std::string>{ "a", "b", "third", "d" }))
+  {
+    std::cout << "Error: Signal ended the list from standard input, got "
+              << result.size() << " name(s)!" << std::endl;
+    return false;
+  }
+  return true;
+}
+#endif
+
+bool testPathSet()
+{
+  PathSet set;
+  if ((set.size() != 0) || set.contains("a"))
+  {
+    std::cout << "Error: New set is not empty!" << std::endl;
+    return false;
+  }
+  const unsigned int count = 200000;
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    if (!set.insert("/data/dir" + std::to_string(i % 97) + "/file" + std::to_string(i)))
+    {
+      std::cout << "Error: Path number " << i << " was reported as duplicate!" << std::endl;
+      return false;
+    }
+  }
+  for (unsigned int i = 0; i < count; i += 7)
+  {
+    const std::string path = "/data/dir" + std::to_string(i % 97) + "/file" + std::to_string(i);
+    if (!set.contains(path) || set.insert(path))
+    {
+      std::cout << "Error: Path " << path << " was not found in the set!" << std::endl;
+      return false;
+    }
+  }
+  // empty paths and paths that only differ in length
+  if (!set.insert("") || set.insert("") || !set.insert(std::string(1, '\0'))
+      || !set.insert(std::string(8, '\0')) || !set.insert(std::string(9, '\0'))
+      || set.contains("/data/dir1/file97"))
+  {
+    std::cout << "Error: Special paths are not handled correctly!" << std::endl;
+    return false;
+  }
+  if (set.size() != count + 4)
+  {
+    std::cout << "Error: Set has " << set.size() << " entries instead of "
+              << count + 4 << "!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int main()
+{
+  if (!testListReader() || !testReadError() || !testPathSet())
+    return 1;
+  #if defined(__linux__)
+  if (!testInterruptedStandardInput())
+    return 1;
+  #endif
+
+  std::cout << "File list tests passed." << std::endl;
+  return 0;
+}
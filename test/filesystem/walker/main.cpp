@@ -0,0 +1,272 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+#include "../../../libstriezel/filesystem/directory.hpp"
+#include "../../../libstriezel/filesystem/file.hpp"
+#include "../../../source/filesystem/DirectoryWalker.hpp"
+#include "../../../source/filesystem/Glob.hpp"
+
+using namespace scantool::filesystem;
+
+bool testGlob()
+{
+  struct Case
+  {
+    std::string pattern;
+    std::string path;
+    bool expected;
+  };
+  const std::vector<Case> cases = {
+    { "*.txt", "a.txt", true },
+    { "*.txt", "a.txt.bak", false },
+    { "*.txt", "dir/a.txt", false },
+    { "**/*.txt", "dir/sub/a.txt", true },
+    { "**/*.txt", "a.txt", true },
+    { "dir/**", "dir/sub/a.txt", true },
+    { "dir/**", "other/a.txt", false },
+    { "a?c", "abc", true },
+    { "a?c", "a/c", false },
+    { "a?c", "ac", false },
+    { "[a-c]x", "bx", true },
+    { "[a-c]x", "dx", false },
+    { "[!a-c]x", "bx", false },
+    { "[^a-c]x", "dx", true },
+    { "[]]", "]", true },
+    { "[abc", "[abc", true },
+    { "\\*", "*", true },
+    { "\\*", "a", false },
+    { "*a*b", "xaybzb", true },
+    { "*a*b", "xaybzc", false },
+    { "*", "", true },
+    { "", "", true },
+    { "", "a", false }
+  };
+  for (const auto& c : cases)
+  {
+    if (globMatch(c.pattern, c.path) != c.expected)
+    {
+      std::cout << "Error: Pattern \"" << c.pattern << "\" should "
+                << (c.expected ? "" : "not ") << "match \"" << c.path
+                << "\"!" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool writeFile(const std::string& fileName, const std::size_t size, std::vector<std::string>& created)
+{
+  std::ofstream stream(fileName, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+  stream << std::string(size, 'x');
+  stream.close();
+  if (!stream.good())
+  {
+    std::cout << "Error: Could not write file " << fileName << "!" << std::endl;
+    return false;
+  }
+  created.push_back(fileName);
+  return true;
+}
+
+bool makeDirectory(const std::string& dirName, std::vector<std::string>& created)
+{
+  if (!libstriezel::filesystem::directory::create(dirName))
+  {
+    std::cout << "Error: Could not create directory " << dirName << "!" << std::endl;
+    return false;
+  }
+  created.push_back(dirName);
+  return true;
+}
+
+std::vector<std::string> walk(const std::string& root, const WalkOptions& options)
+{
+  DirectoryWalker walker(options);
+  walker.start({ root });
+  std::vector<std::string> result;
+  std::vector<std::string> files;
+  while (walker.next(files, 100))
+  {
+    result.insert(result.end(), files.begin(), files.end());
+  }
+  for (auto& file : result)
+  {
+    file.erase(0, root.size() + 1);
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+bool check(const std::string& description, const std::vector<std::string>& actual,
+           const std::vector<std::string>& expected)
+{
+  if (actual == expected)
+    return true;
+  std::cout << "Error: Walk " << description << " found " << actual.size()
+            << " file(s) instead of " << expected.size() << ":" << std::endl;
+  for (const auto& file : actual)
+  {
+    std::cout << "  " << file << std::endl;
+  }
+  return false;
+}
+
+bool testWalk(const std::string& root)
+{
+  std::vector<std::string> created;
+  const std::string manyDir = root + "/many";
+  if (!writeFile(root + "/a.txt", 10, created)
+      || !writeFile(root + "/b.exe", 2000, created)
+      || !makeDirectory(root + "/sub", created)
+      || !writeFile(root + "/sub/c.txt", 0, created)
+      || !makeDirectory(root + "/sub/deep", created)
+      || !writeFile(root + "/sub/deep/d.exe", 100, created)
+      || !makeDirectory(root + "/skip", created)
+      || !writeFile(root + "/skip/e.txt", 60, created)
+      || !makeDirectory(manyDir, created))
+    return false;
+  std::vector<std::string> many;
+  for (unsigned int i = 0; i < 3000; ++i)
+  {
+    const std::string name = "f" + std::to_string(10000 + i);
+    if (!writeFile(manyDir + "/" + name, 1, created))
+      return false;
+    many.push_back("many/" + name);
+  }
+  #if !defined(_WIN32)
+  // Symbolic links must not be followed.
+  if (symlink((root + "/sub").c_str(), (root + "/link").c_str()) != 0)
+  {
+    std::cout << "Error: Could not create symbolic link!" << std::endl;
+    return false;
+  }
+  #endif
+
+  WalkOptions options;
+  std::vector<std::string> all = { "a.txt", "b.exe", "skip/e.txt", "sub/c.txt", "sub/deep/d.exe" };
+  all.insert(all.end(), many.begin(), many.end());
+  std::sort(all.begin(), all.end());
+  bool success = check("without filters", walk(root, options), all);
+
+  options.threads = 1;
+  success = success && check("with one thread", walk(root, options), all);
+  options.threads = 0;
+
+  options.exclude = { "many", "skip" };
+  success = success && check("with excluded directories", walk(root, options),
+      { "a.txt", "b.exe", "sub/c.txt", "sub/deep/d.exe" });
+
+  options.include = { "*.exe" };
+  success = success && check("with included names", walk(root, options),
+      { "b.exe", "sub/deep/d.exe" });
+
+  options.include = { "sub/**" };
+  success = success && check("with included paths", walk(root, options),
+      { "sub/c.txt", "sub/deep/d.exe" });
+
+  options.include.clear();
+  options.minSize = 50;
+  success = success && check("with minimum size", walk(root, options),
+      { "b.exe", "sub/deep/d.exe" });
+
+  options.exclude = { "many" };
+  options.minSize = -1;
+  options.maxSize = 60;
+  success = success && check("with maximum size", walk(root, options),
+      { "a.txt", "skip/e.txt", "sub/c.txt" });
+
+  options.exclude.clear();
+  options.maxSize = -1;
+  options.oneFileSystem = true;
+  success = success && check("on one file system", walk(root, options), all);
+
+  // Stopping a walk early must not block.
+  if (success)
+  {
+    DirectoryWalker walker{ WalkOptions() };
+    walker.start({ root });
+    std::vector<std::string> files;
+    if (!walker.next(files, 10) || files.empty() || (files.size() > 10))
+    {
+      std::cout << "Error: Walk did not return up to ten files!" << std::endl;
+      success = false;
+    }
+  }
+
+  #if !defined(_WIN32)
+  unlink((root + "/link").c_str());
+  #endif
+  std::reverse(created.begin(), created.end());
+  for (const auto& name : created)
+  {
+    if (libstriezel::filesystem::directory::exists(name))
+      libstriezel::filesystem::directory::remove(name);
+    else
+      libstriezel::filesystem::file::remove(name);
+  }
+  return success;
+}
+
+bool testMissingDirectory(const std::string& root)
+{
+  DirectoryWalker walker{ WalkOptions() };
+  walker.start({ root + "/does-not-exist" });
+  std::vector<std::string> files;
+  if (walker.next(files, 10))
+  {
+    std::cout << "Error: Walk of missing directory found files!" << std::endl;
+    return false;
+  }
+  if (walker.failedDirectories().size() != 1)
+  {
+    std::cout << "Error: Missing directory was not reported as failed!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int main()
+{
+  if (!testGlob())
+    return 1;
+
+  std::string root;
+  if (!libstriezel::filesystem::directory::createTemp(root))
+  {
+    std::cout << "Error: Could not create temporary directory!" << std::endl;
+    return 1;
+  }
+  root = libstriezel::filesystem::unslashify(root);
+  const bool success = testWalk(root) && testMissingDirectory(root);
+  libstriezel::filesystem::directory::remove(root);
+  if (!success)
+    return 1;
+
+  std::cout << "Directory walker tests passed." << std::endl;
+  return 0;
+}
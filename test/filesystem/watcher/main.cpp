@@ -0,0 +1,184 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../../../libstriezel/filesystem/directory.hpp"
+#include "../../../libstriezel/filesystem/file.hpp"
+#include "../../../source/filesystem/DirectoryWatcher.hpp"
+
+using namespace scantool::filesystem;
+
+bool writeFile(const std::string& fileName, const std::size_t size)
+{
+  std::ofstream stream(fileName, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+  stream << std::string(size, 'x');
+  stream.close();
+  if (!stream.good())
+  {
+    std::cout << "Error: Could not write file " << fileName << "!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+std::vector<std::string> collect(DirectoryWatcher& watcher, const std::string& root)
+{
+  std::vector<std::string> result;
+  std::vector<std::string> files;
+  // Wait until no more files show up for a while.
+  while (watcher.wait(files, 100, std::chrono::milliseconds(500)) && !files.empty())
+  {
+    result.insert(result.end(), files.begin(), files.end());
+  }
+  for (auto& file : result)
+  {
+    file.erase(0, root.size() + 1);
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+bool check(const std::string& description, const std::vector<std::string>& actual,
+           const std::vector<std::string>& expected)
+{
+  if (actual == expected)
+    return true;
+  std::cout << "Error: Watcher " << description << " reported " << actual.size()
+            << " file(s) instead of " << expected.size() << ":" << std::endl;
+  for (const auto& file : actual)
+  {
+    std::cout << "  " << file << std::endl;
+  }
+  return false;
+}
+
+bool testWatch(const std::string& root)
+{
+  if (!writeFile(root + "/existing.txt", 10))
+    return false;
+
+  WalkOptions options;
+  options.exclude = { "*.log" };
+  DirectoryWatcher watcher(options, std::chrono::milliseconds(100));
+  if (!watcher.start({ root }))
+  {
+    std::cout << "Error: Could not start watching " << root << "!" << std::endl;
+    return false;
+  }
+  if (watcher.directoryCount() != 1)
+  {
+    std::cout << "Error: Watcher should watch one directory, but it watches "
+              << watcher.directoryCount() << "!" << std::endl;
+    return false;
+  }
+
+  // Existing files are not reported, excluded files are skipped.
+  if (!writeFile(root + "/a.txt", 20) || !writeFile(root + "/b.log", 20))
+    return false;
+  if (!check("after first write", collect(watcher, root), { "a.txt" }))
+    return false;
+
+  // A file that is written several times is only reported once.
+  if (!writeFile(root + "/existing.txt", 30) || !writeFile(root + "/existing.txt", 40))
+    return false;
+  if (!check("after rewrite", collect(watcher, root), { "existing.txt" }))
+    return false;
+
+  // Files in new subdirectories are reported, too.
+  if (!libstriezel::filesystem::directory::create(root + "/sub"))
+  {
+    std::cout << "Error: Could not create directory " << root << "/sub!" << std::endl;
+    return false;
+  }
+  if (!writeFile(root + "/sub/c.txt", 5))
+    return false;
+  if (!check("after new directory", collect(watcher, root), { "sub/c.txt" }))
+    return false;
+  if (watcher.directoryCount() != 2)
+  {
+    std::cout << "Error: Watcher should watch two directories, but it watches "
+              << watcher.directoryCount() << "!" << std::endl;
+    return false;
+  }
+
+  // Files moved into a watched directory are reported.
+  if (!writeFile(root + "-moved.txt", 5)
+      || !libstriezel::filesystem::file::rename(root + "-moved.txt", root + "/sub/moved.txt"))
+    return false;
+  if (!check("after move", collect(watcher, root), { "sub/moved.txt" }))
+    return false;
+
+  if (watcher.takeEventsLost())
+  {
+    std::cout << "Error: Watcher should not have lost any events!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool testMissingDirectory(const std::string& root)
+{
+  DirectoryWatcher watcher(WalkOptions(), std::chrono::milliseconds(100));
+  if (watcher.start({ root + "/does-not-exist" }))
+  {
+    std::cout << "Error: Watching a missing directory should fail!" << std::endl;
+    return false;
+  }
+  if (watcher.takeFailedDirectories().size() != 1)
+  {
+    std::cout << "Error: Missing directory was not reported as failed!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int main()
+{
+  if (!DirectoryWatcher::supported())
+  {
+    std::cout << "Watching directories is not supported, skipping test." << std::endl;
+    return 0;
+  }
+
+  std::string root;
+  if (!libstriezel::filesystem::directory::createTemp(root))
+  {
+    std::cout << "Error: Could not create temporary directory!" << std::endl;
+    return 1;
+  }
+  root = libstriezel::filesystem::unslashify(root);
+  const bool success = testWatch(root) && testMissingDirectory(root);
+  for (const auto& name : { "/sub/moved.txt", "/sub/c.txt", "/existing.txt", "/a.txt", "/b.log" })
+  {
+    libstriezel::filesystem::file::remove(root + name);
+  }
+  libstriezel::filesystem::directory::remove(root + "/sub");
+  libstriezel::filesystem::directory::remove(root);
+  if (!success)
+    return 1;
+
+  std::cout << "Directory watcher tests passed." << std::endl;
+  return 0;
+}
@@ -0,0 +1,167 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "../../../libstriezel/filesystem/directory.hpp"
+#include "../../../libstriezel/filesystem/file.hpp"
+#include "../../../source/hash/HashCache.hpp"
+
+using namespace scantool::hash;
+
+SHA256::MessageDigest digestFromHex(const std::string& hex)
+{
+  SHA256::MessageDigest digest;
+  digest.fromHexString(hex);
+  return digest;
+}
+
+bool testCache(const std::string& cacheFile)
+{
+  // time stamps from the year 2020, so that entries are not considered racy
+  const FileStatus status{ 2049, 1234567, 4711, 1600000000123456789, 1600000001987654321 };
+  const SHA256::MessageDigest digest = digestFromHex("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+  const SHA256::MessageDigest otherDigest = digestFromHex("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+  const std::string name = "/tmp/some dir/file name.txt";
+
+  {
+    HashCache cache(cacheFile);
+    if (!cache.load())
+    {
+      std::cout << "Error: Loading a missing cache file failed!" << std::endl;
+      return false;
+    }
+    cache.store(name, status, digest);
+    cache.store("/tmp/other.txt", status, otherDigest);
+    // A file that was changed just now must not be cached.
+    FileStatus recent;
+    if (!FileStatus::get(cacheFile + ".new", recent))
+    {
+      std::cout << "Error: Could not get status of new file!" << std::endl;
+      return false;
+    }
+    cache.store(cacheFile + ".new", recent, digest);
+    // Replace the digest of the other file, like after a modification.
+    FileStatus modified = status;
+    modified.mtime_ns += 1;
+    cache.store("/tmp/other.txt", modified, digest);
+    if (!cache.flush())
+    {
+      std::cout << "Error: Could not write cache file!" << std::endl;
+      return false;
+    }
+  }
+  // simulate an incomplete last line after an interrupted write
+  {
+    std::ofstream stream(cacheFile, std::ios::out | std::ios::binary | std::ios::app);
+    stream << "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad 2049 12";
+  }
+
+  HashCache cache(cacheFile);
+  if (!cache.load())
+  {
+    std::cout << "Error: Could not load cache file!" << std::endl;
+    return false;
+  }
+  SHA256::MessageDigest found;
+  if (!cache.lookup(name, status, found) || (found != digest))
+  {
+    std::cout << "Error: Cached digest was not found after reload!" << std::endl;
+    return false;
+  }
+  FileStatus changed = status;
+  changed.size += 1;
+  if (cache.lookup(name, changed, found))
+  {
+    std::cout << "Error: Cached digest was used for changed file size!" << std::endl;
+    return false;
+  }
+  changed = status;
+  changed.inode += 1;
+  if (cache.lookup(name, changed, found))
+  {
+    std::cout << "Error: Cached digest was used for changed inode!" << std::endl;
+    return false;
+  }
+  if (cache.lookup("/tmp/other.txt", status, found))
+  {
+    std::cout << "Error: Replaced cache entry was used!" << std::endl;
+    return false;
+  }
+  FileStatus modified = status;
+  modified.mtime_ns += 1;
+  if (!cache.lookup("/tmp/other.txt", modified, found) || (found != digest))
+  {
+    std::cout << "Error: Replacing cache entry was not found!" << std::endl;
+    return false;
+  }
+  FileStatus recent;
+  if (FileStatus::get(cacheFile + ".new", recent) && cache.lookup(cacheFile + ".new", recent, found))
+  {
+    std::cout << "Error: Recently changed file was cached!" << std::endl;
+    return false;
+  }
+  if ((cache.hits() != 2) || (cache.misses() != 4))
+  {
+    std::cout << "Error: Expected 2 hits and 4 misses, but got "
+              << cache.hits() << " hits and " << cache.misses()
+              << " misses!" << std::endl;
+    return false;
+  }
+  // New entries must not get lost after the incomplete line.
+  cache.store("/tmp/third.txt", status, otherDigest);
+  if (!cache.compact())
+  {
+    std::cout << "Error: Could not compact cache file!" << std::endl;
+    return false;
+  }
+  HashCache reloaded(cacheFile);
+  if (!reloaded.load() || !reloaded.lookup("/tmp/third.txt", status, found)
+      || (found != otherDigest))
+  {
+    std::cout << "Error: Entry after incomplete line was not found!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int main()
+{
+  std::string dir;
+  if (!libstriezel::filesystem::directory::createTemp(dir))
+  {
+    std::cout << "Error: Could not create temporary directory!" << std::endl;
+    return 1;
+  }
+  const std::string cacheFile = libstriezel::filesystem::slashify(dir) + "hashes.cache";
+  {
+    std::ofstream stream(cacheFile + ".new", std::ios::out | std::ios::binary | std::ios::trunc);
+  }
+  const bool success = testCache(cacheFile);
+  libstriezel::filesystem::file::remove(cacheFile + ".new");
+  libstriezel::filesystem::file::remove(cacheFile);
+  libstriezel::filesystem::directory::remove(dir);
+  if (!success)
+    return 1;
+
+  std::cout << "Hash cache tests passed." << std::endl;
+  return 0;
+}
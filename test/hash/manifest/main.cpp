@@ -0,0 +1,116 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "../../../source/hash/Manifest.hpp"
+
+using namespace scantool::hash;
+
+const std::string hashEmpty = "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855";
+const std::string hashAbc = "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad";
+
+bool expectLine(const std::string& line, const std::string& expectedName, const std::string& expectedHash)
+{
+  std::string fileName;
+  SHA256::MessageDigest digest;
+  if (!parseManifestLine(line, fileName, digest))
+  {
+    std::cout << "Error: Could not parse line \"" << line << "\"!" << std::endl;
+    return false;
+  }
+  if ((fileName != expectedName) || (digest.toHexString() != expectedHash))
+  {
+    std::cout << "Error: Line \"" << line << "\" was parsed as file \""
+              << fileName << "\" with hash " << digest.toHexString()
+              << "!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool expectInvalid(const std::string& line)
+{
+  std::string fileName;
+  SHA256::MessageDigest digest;
+  if (parseManifestLine(line, fileName, digest))
+  {
+    std::cout << "Error: Invalid line \"" << line << "\" was accepted!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool testLines()
+{
+  return expectLine(hashEmpty + "  empty.txt", "empty.txt", hashEmpty)
+      && expectLine(hashAbc + " *bin/abc file.bin", "bin/abc file.bin", hashAbc)
+      && expectLine("BA7816BF8F01CFEA414140DE5DAE2223B00361A396177A9CB410FF61F20015AD  upper.txt", "upper.txt", hashAbc)
+      && expectLine("SHA256 (dir/name (1).txt) = " + hashAbc, "dir/name (1).txt", hashAbc)
+      && expectLine("\\" + hashEmpty + "  back\\\\slash\\nnewline", "back\\slash\nnewline", hashEmpty)
+      && expectLine("\\SHA256 (a\\nb) = " + hashEmpty, "a\nb", hashEmpty)
+      && expectInvalid(hashEmpty + "  ")
+      && expectInvalid(hashEmpty + " x.txt")
+      && expectInvalid(hashEmpty.substr(1) + "  short.txt")
+      && expectInvalid("g" + hashEmpty.substr(1) + "  nonhex.txt")
+      && expectInvalid("SHA256 (x.txt) = " + hashEmpty.substr(2))
+      && expectInvalid("\\" + hashEmpty + "  bad\\escape")
+      && expectInvalid("MD5 (x.txt) = d41d8cd98f00b204e9800998ecf8427e");
+}
+
+bool testManifest()
+{
+  std::istringstream valid(hashEmpty + "  a.txt\r\n\n" + hashAbc + "  b.txt\n" + hashEmpty + "  a.txt\n");
+  std::map<std::string, SHA256::MessageDigest> digests;
+  if (!readManifest(valid, "valid", digests) || (digests.size() != 2)
+      || (digests["a.txt"].toHexString() != hashEmpty) || (digests["b.txt"].toHexString() != hashAbc))
+  {
+    std::cout << "Error: Valid manifest was not read correctly!" << std::endl;
+    return false;
+  }
+
+  // same file with different hashes
+  std::istringstream conflict(hashEmpty + "  a.txt\n" + hashAbc + "  a.txt\n");
+  digests.clear();
+  if (readManifest(conflict, "conflict", digests))
+  {
+    std::cout << "Error: Manifest with conflicting hashes was accepted!" << std::endl;
+    return false;
+  }
+
+  std::istringstream invalid(hashEmpty + "  a.txt\nnot a checksum line\n");
+  digests.clear();
+  if (readManifest(invalid, "invalid", digests))
+  {
+    std::cout << "Error: Manifest with invalid line was accepted!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int main()
+{
+  if (!testLines() || !testManifest())
+    return 1;
+
+  std::cout << "Manifest tests passed." << std::endl;
+  return 0;
+}
@@ -0,0 +1,342 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../../../libstriezel/filesystem/directory.hpp"
+#include "../../../libstriezel/filesystem/file.hpp"
+#include "../../../libstriezel/hash/sha256/FileSourceUtility.hpp"
+#include "../../../source/hash/FileReader.hpp"
+#include "../../../source/hash/Sha256.hpp"
+#include "../../../source/hash/Sha256MultiBuffer.hpp"
+
+using namespace scantool::hash;
+
+const std::vector<Sha256Kernel> allKernels = { Sha256Kernel::Scalar, Sha256Kernel::ShaNi, Sha256Kernel::ArmV8 };
+const std::vector<MultiBufferKernel> allMultiBufferKernels = { MultiBufferKernel::None, MultiBufferKernel::Avx2, MultiBufferKernel::Avx512 };
+
+/* Creates messages with different lengths and contents. */
+std::vector<std::string> createMessages(const std::size_t count, const std::size_t maxLength)
+{
+  std::vector<std::string> messages;
+  uint32_t random = 12345;
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    random = random * 1103515245 + 12345;
+    std::string message((random >> 8) % (maxLength + 1), '\0');
+    for (std::size_t j = 0; j < message.size(); ++j)
+    {
+      message[j] = static_cast<char>((i + j * 31) % 256);
+    }
+    messages.push_back(message);
+  }
+  return messages;
+}
+
+std::string digestOf(const Sha256Kernel kernel, const std::string& message, const std::size_t chunkSize)
+{
+  Sha256 sha(kernel);
+  std::size_t offset = 0;
+  while (offset < message.size())
+  {
+    const std::size_t count = std::min(chunkSize, message.size() - offset);
+    sha.update(reinterpret_cast<const uint8_t*>(message.data()) + offset, count);
+    offset += count;
+  }
+  return sha.finish().toHexString();
+}
+
+bool testVectors(const Sha256Kernel kernel)
+{
+  const std::vector<std::pair<std::string, std::string> > vectors = {
+    { "", "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" },
+    { "abc", "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" },
+    { "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+      "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1" },
+    { std::string(1000000, 'a'),
+      "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0" }
+  };
+  for (const auto& [message, expected] : vectors)
+  {
+    for (const std::size_t chunkSize : { 1, 63, 64, 1000, 1000000 })
+    {
+      const std::string digest = digestOf(kernel, message, chunkSize);
+      if (digest != expected)
+      {
+        std::cout << "Error: Kernel " << kernelName(kernel) << " computed "
+                  << digest << " instead of " << expected << " for message of "
+                  << message.size() << " bytes!" << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool testAgainstScalar(const Sha256Kernel kernel)
+{
+  // All lengths around the padding boundaries must give the same result.
+  std::string message;
+  for (unsigned int length = 0; length < 300; ++length)
+  {
+    if (digestOf(kernel, message, 17) != digestOf(Sha256Kernel::Scalar, message, 300))
+    {
+      std::cout << "Error: Kernel " << kernelName(kernel) << " differs from "
+                << "scalar kernel for message of " << length << " bytes!" << std::endl;
+      return false;
+    }
+    message.push_back(static_cast<char>((length * 131) % 256));
+  }
+  return true;
+}
+
+bool testMultiBuffer(const MultiBufferKernel kernel)
+{
+  // Include all lengths around the padding boundaries.
+  std::vector<std::string> messages = createMessages(100, 5000);
+  std::string message;
+  for (unsigned int length = 0; length < 200; ++length)
+  {
+    messages.push_back(message);
+    message.push_back(static_cast<char>((length * 131) % 256));
+  }
+  const std::vector<std::string_view> views(messages.begin(), messages.end());
+  const auto digests = computeFromBuffers(views, kernel);
+  if (digests.size() != messages.size())
+  {
+    std::cout << "Error: Multi-buffer kernel " << kernelName(kernel)
+              << " returned " << digests.size() << " digests instead of "
+              << messages.size() << "!" << std::endl;
+    return false;
+  }
+  for (std::size_t i = 0; i < messages.size(); ++i)
+  {
+    if (digests[i].toHexString() != digestOf(Sha256Kernel::Scalar, messages[i], 1000))
+    {
+      std::cout << "Error: Multi-buffer kernel " << kernelName(kernel)
+                << " computed wrong digest for message " << i << " with "
+                << messages[i].size() << " bytes!" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool testFileGroups()
+{
+  std::string dir;
+  if (!libstriezel::filesystem::directory::createTemp(dir))
+  {
+    std::cout << "Error: Could not create temporary directory!" << std::endl;
+    return false;
+  }
+  // More files than fit into one group of the io_uring reader, with empty,
+  // small, large and missing files.
+  const auto messages = createMessages(150, 70000);
+  std::vector<std::string> fileNames;
+  for (std::size_t i = 0; i < messages.size(); ++i)
+  {
+    const std::string fileName = libstriezel::filesystem::slashify(dir) + "file" + std::to_string(i);
+    if (i % 37 != 5)
+    {
+      std::ofstream stream(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+      stream.write(messages[i].data(), messages[i].size());
+    }
+    fileNames.push_back(fileName);
+  }
+  const auto withRing = computeFromFiles(fileNames, true);
+  setReadMode(ReadMode::NoCache);
+  const auto withRingNoCache = computeFromFiles(fileNames, true);
+  setReadMode(ReadMode::Cached);
+  const auto withoutRing = computeFromFiles(fileNames, false);
+  for (const std::string& fileName : fileNames)
+  {
+    libstriezel::filesystem::file::remove(fileName);
+  }
+  libstriezel::filesystem::directory::remove(dir);
+
+  for (std::size_t i = 0; i < messages.size(); ++i)
+  {
+    const std::string expected = (i % 37 == 5) ? SHA256::MessageDigest().toHexString()
+                               : digestOf(Sha256Kernel::Scalar, messages[i], 1000);
+    if ((withRing[i].toHexString() != expected) || (withRingNoCache[i].toHexString() != expected)
+        || (withoutRing[i].toHexString() != expected))
+    {
+      std::cout << "Error: Group of files got unexpected digest for file "
+                << i << " with " << messages[i].size() << " bytes!" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool testFile()
+{
+  std::string dir;
+  if (!libstriezel::filesystem::directory::createTemp(dir))
+  {
+    std::cout << "Error: Could not create temporary directory!" << std::endl;
+    return false;
+  }
+  const std::string fileName = libstriezel::filesystem::slashify(dir) + "data.bin";
+  {
+    std::ofstream stream(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+    // several chunks of the file reader, with an incomplete last one
+    for (unsigned int i = 0; i < 3 * 1024 * 1024 + 12345; ++i)
+    {
+      stream.put(static_cast<char>((i * 7) % 251));
+    }
+  }
+  const SHA256::MessageDigest expected = SHA256::computeFromFile(fileName);
+  const SHA256::MessageDigest actual = scantool::hash::computeFromFile(fileName);
+  std::vector<SHA256::MessageDigest> modeDigests;
+  for (const ReadMode mode : { ReadMode::NoCache, ReadMode::Direct })
+  {
+    setReadMode(mode);
+    modeDigests.push_back(scantool::hash::computeFromFile(fileName));
+  }
+  setReadMode(ReadMode::Cached);
+  const SHA256::MessageDigest missing = scantool::hash::computeFromFile(fileName + ".missing");
+  // batch with small file, large file and missing file
+  const std::string smallFileName = libstriezel::filesystem::slashify(dir) + "small.bin";
+  {
+    std::ofstream stream(smallFileName, std::ios::out | std::ios::binary | std::ios::trunc);
+    stream << "abc";
+  }
+  const auto batch = computeFromFiles({ smallFileName, fileName, fileName + ".missing", smallFileName });
+  libstriezel::filesystem::file::remove(smallFileName);
+  libstriezel::filesystem::file::remove(fileName);
+  libstriezel::filesystem::directory::remove(dir);
+  if (expected.isNull() || (actual != expected))
+  {
+    std::cout << "Error: Digest of file is " << actual.toHexString()
+              << ", but libstriezel computes " << expected.toHexString()
+              << "!" << std::endl;
+    return false;
+  }
+  for (const SHA256::MessageDigest& digest : modeDigests)
+  {
+    if (digest != expected)
+    {
+      std::cout << "Error: Digest of file with other read mode is "
+                << digest.toHexString() << ", but libstriezel computes "
+                << expected.toHexString() << "!" << std::endl;
+      return false;
+    }
+  }
+  if (!missing.isNull())
+  {
+    std::cout << "Error: Digest of missing file is not null!" << std::endl;
+    return false;
+  }
+  const std::string abc = "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad";
+  if ((batch.size() != 4) || (batch[0].toHexString() != abc) || (batch[1] != expected)
+      || !batch[2].isNull() || (batch[3].toHexString() != abc))
+  {
+    std::cout << "Error: Batch of files got unexpected digests!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+void benchmark(const unsigned int megabytes)
+{
+  const std::string data(megabytes * 1024 * 1024, 'x');
+  for (const Sha256Kernel kernel : allKernels)
+  {
+    if (!kernelAvailable(kernel))
+    {
+      std::cout << kernelName(kernel) << ": not available" << std::endl;
+      continue;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    const std::string digest = digestOf(kernel, data, data.size());
+    const std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+    std::cout << kernelName(kernel) << ": " << megabytes / seconds.count()
+              << " MiB/s (" << digest << ")" << std::endl;
+  }
+
+  // many small messages, as in source trees
+  const std::vector<std::string> messages = createMessages(megabytes * 128, 16 * 1024);
+  const std::vector<std::string_view> views(messages.begin(), messages.end());
+  std::size_t bytes = 0;
+  for (const auto& message : messages)
+  {
+    bytes += message.size();
+  }
+  for (const MultiBufferKernel kernel : allMultiBufferKernels)
+  {
+    if (!kernelAvailable(kernel))
+    {
+      std::cout << "multi-buffer " << kernelName(kernel) << ": not available" << std::endl;
+      continue;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    const auto digests = computeFromBuffers(views, kernel);
+    const std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+    std::cout << "multi-buffer " << kernelName(kernel) << ", " << messages.size()
+              << " messages: " << bytes / 1048576.0 / seconds.count() << " MiB/s ("
+              << digests.back().toHexString() << ")" << std::endl;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  // Run "hash-sha256-test --benchmark [MiB]" to compare the kernels.
+  if ((argc > 1) && (std::string(argv[1]) == "--benchmark"))
+  {
+    const unsigned int megabytes = (argc > 2) ? std::stoul(argv[2]) : 256;
+    benchmark(megabytes);
+    return 0;
+  }
+
+  for (const Sha256Kernel kernel : allKernels)
+  {
+    if (!kernelAvailable(kernel))
+    {
+      std::cout << "Info: Kernel " << kernelName(kernel)
+                << " is not available on this CPU." << std::endl;
+      continue;
+    }
+    if (!testVectors(kernel) || !testAgainstScalar(kernel))
+      return 1;
+  }
+  for (const MultiBufferKernel kernel : allMultiBufferKernels)
+  {
+    if (!kernelAvailable(kernel))
+    {
+      std::cout << "Info: Multi-buffer kernel " << kernelName(kernel)
+                << " is not available on this CPU." << std::endl;
+      continue;
+    }
+    if (!testMultiBuffer(kernel))
+      return 1;
+  }
+  if (!testFile() || !testFileGroups())
+    return 1;
+
+  std::cout << "SHA-256 tests passed, best kernel is "
+            << kernelName(bestKernel()) << ", best multi-buffer kernel is "
+            << kernelName(bestMultiBufferKernel()) << "." << std::endl;
+  return 0;
+}
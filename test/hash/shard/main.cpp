@@ -0,0 +1,147 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../../../source/hash/Shard.hpp"
+
+using namespace scantool::hash;
+
+bool testParsing()
+{
+  Shard shard;
+  if (!shard.all() || (shard.toString() != "1/1"))
+  {
+    std::cout << "Error: Default shard should contain all files!" << std::endl;
+    return false;
+  }
+  if (!Shard::fromString("3/4", shard) || shard.all() || (shard.toString() != "3/4"))
+  {
+    std::cout << "Error: Shard 3/4 was not parsed correctly!" << std::endl;
+    return false;
+  }
+  const std::vector<std::string> invalid = {
+    "", "/", "1/", "/4", "0/4", "5/4", "1/0", "-1/4", "1/-4", "a/4", "1/4x",
+    " 1/4", "1 /4", "1/2/3", "1/65537", "99999999999/99999999999"
+  };
+  for (const auto& text : invalid)
+  {
+    if (Shard::fromString(text, shard))
+    {
+      std::cout << "Error: Invalid shard \"" << text << "\" was accepted!" << std::endl;
+      return false;
+    }
+  }
+  // Invalid text must not change the shard.
+  if (shard.toString() != "3/4")
+  {
+    std::cout << "Error: Invalid shard text changed the shard!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool testPartition()
+{
+  const unsigned int count = 5;
+  std::vector<Shard> shards(count);
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    if (!Shard::fromString(std::to_string(i + 1) + "/" + std::to_string(count), shards[i]))
+    {
+      std::cout << "Error: Could not parse shard " << i + 1 << "!" << std::endl;
+      return false;
+    }
+  }
+
+  const std::string hexDigits = "0123456789abcdef";
+  std::vector<unsigned int> digestCounts(count, 0);
+  std::vector<unsigned int> pathCounts(count, 0);
+  for (unsigned int n = 0; n < 1000; ++n)
+  {
+    // pseudo-random digests and similar paths
+    std::string digest;
+    unsigned int value = n * 2654435761u;
+    for (unsigned int k = 0; k < 64; ++k)
+    {
+      digest.push_back(hexDigits[(value >> 24) % 16]);
+      value = value * 1103515245u + 12345u;
+    }
+    const std::string path = "/data/files/file" + std::to_string(n) + ".exe";
+
+    unsigned int digestMatches = 0;
+    unsigned int pathMatches = 0;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+      if (shards[i].containsDigest(digest))
+      {
+        ++digestMatches;
+        ++digestCounts[i];
+      }
+      if (shards[i].containsPath(path))
+      {
+        ++pathMatches;
+        ++pathCounts[i];
+      }
+    }
+    if ((digestMatches != 1) || (pathMatches != 1))
+    {
+      std::cout << "Error: File " << path << " with digest " << digest
+                << " is not in exactly one shard!" << std::endl;
+      return false;
+    }
+    if (!Shard().containsDigest(digest) || !Shard().containsPath(path))
+    {
+      std::cout << "Error: Shard 1/1 does not contain all files!" << std::endl;
+      return false;
+    }
+  } // for n
+
+  // Each shard should get a fair part of the work.
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    if ((digestCounts[i] < 150) || (digestCounts[i] > 250)
+        || (pathCounts[i] < 150) || (pathCounts[i] > 250))
+    {
+      std::cout << "Error: Shard " << shards[i].toString() << " got "
+                << digestCounts[i] << " digests and " << pathCounts[i]
+                << " paths of 1000, which is too uneven!" << std::endl;
+      return false;
+    }
+  }
+
+  // Invalid digests go to the first shard.
+  if (!shards[0].containsDigest("xyz") || shards[1].containsDigest("xyz"))
+  {
+    std::cout << "Error: Invalid digest does not belong to the first shard!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int main()
+{
+  if (!testParsing() || !testPartition())
+    return 1;
+
+  std::cout << "Shard tests passed." << std::endl;
+  return 0;
+}
@@ -0,0 +1,153 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "../../../libstriezel/filesystem/directory.hpp"
+#include "../../../libstriezel/filesystem/file.hpp"
+#include "../../../source/virustotal/QuotaLease.hpp"
+
+using namespace scantool::virustotal;
+
+/* Waits are measured against the clock, so allow some slack for slow
+   test machines. */
+bool near(const std::chrono::milliseconds actual, const std::chrono::milliseconds expected)
+{
+  return (actual >= expected - std::chrono::milliseconds(250))
+      && (actual <= expected + std::chrono::milliseconds(50));
+}
+
+bool testDefaultFileName()
+{
+  const std::string first = QuotaLease::defaultFileName(std::string(64, 'a'));
+  const std::string second = QuotaLease::defaultFileName(std::string(64, 'b'));
+  if (first.empty() || second.empty())
+  {
+    std::cout << "Error: Default lease file name is empty!" << std::endl;
+    return false;
+  }
+  if (first != QuotaLease::defaultFileName(std::string(64, 'a')))
+  {
+    std::cout << "Error: Default lease file name is not deterministic!" << std::endl;
+    return false;
+  }
+  if (first == second)
+  {
+    std::cout << "Error: Different keys get the same lease file!" << std::endl;
+    return false;
+  }
+  if (first.find(std::string(64, 'a')) != std::string::npos)
+  {
+    std::cout << "Error: Lease file name contains the API key!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool testSharedSlots(const std::string& fileName)
+{
+  const std::chrono::milliseconds interval(1000);
+  // Two leases on the same file act like two processes.
+  QuotaLease first(fileName, interval);
+  QuotaLease second(fileName, interval);
+  if (!first.open() || !second.open())
+  {
+    std::cout << "Error: Could not open lease file " << fileName << "!" << std::endl;
+    return false;
+  }
+
+  std::chrono::milliseconds wait(-1);
+  if (!first.reserve(wait) || !near(wait, std::chrono::milliseconds(0)))
+  {
+    std::cout << "Error: First slot should start now, but wait is "
+              << wait.count() << " ms!" << std::endl;
+    return false;
+  }
+  if (!second.reserve(wait) || !near(wait, interval))
+  {
+    std::cout << "Error: Second slot should start after one interval, but wait is "
+              << wait.count() << " ms!" << std::endl;
+    return false;
+  }
+  if (!first.reserve(wait) || !near(wait, 2 * interval))
+  {
+    std::cout << "Error: Third slot should start after two intervals, but wait is "
+              << wait.count() << " ms!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool testGarbage(const std::string& fileName)
+{
+  {
+    std::ofstream stream(fileName, std::ios::out | std::ios::trunc);
+    stream << "not a time";
+  }
+  QuotaLease lease(fileName, std::chrono::milliseconds(1000));
+  std::chrono::milliseconds wait(-1);
+  if (!lease.open() || !lease.reserve(wait) || !near(wait, std::chrono::milliseconds(0)))
+  {
+    std::cout << "Error: Lease file with garbage should give a slot that starts now!"
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int main()
+{
+  if (!testDefaultFileName())
+    return 1;
+
+  std::string root;
+  if (!libstriezel::filesystem::directory::createTemp(root))
+  {
+    std::cout << "Error: Could not create temporary directory!" << std::endl;
+    return 1;
+  }
+  root = libstriezel::filesystem::unslashify(root);
+  // The lease has to create missing directories on its own.
+  const std::string fileName = root + "/sub/quota.lease";
+  const std::string garbageName = root + "/garbage.lease";
+  QuotaLease probe(fileName, std::chrono::milliseconds(1000));
+  std::chrono::milliseconds wait(0);
+  if (!probe.open() || !probe.reserve(wait))
+  {
+    std::cout << "Quota leases are not supported, skipping lease tests." << std::endl;
+    libstriezel::filesystem::file::remove(fileName);
+    libstriezel::filesystem::directory::remove(root + "/sub");
+    libstriezel::filesystem::directory::remove(root);
+    return 0;
+  }
+  libstriezel::filesystem::file::remove(fileName);
+  const bool success = testSharedSlots(fileName) && testGarbage(garbageName);
+  libstriezel::filesystem::file::remove(fileName);
+  libstriezel::filesystem::file::remove(garbageName);
+  libstriezel::filesystem::directory::remove(root + "/sub");
+  libstriezel::filesystem::directory::remove(root);
+  if (!success)
+    return 1;
+
+  std::cout << "Quota lease tests passed." << std::endl;
+  return 0;
+}
@@ -0,0 +1,229 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "../../../libstriezel/filesystem/directory.hpp"
+#include "../../../libstriezel/filesystem/file.hpp"
+#include "../../../source/scan-tool/UploadOutbox.hpp"
+
+using scantool::virustotal::UploadOutbox;
+
+bool testUploadOutbox(const std::string& outboxFile)
+{
+  // Names of files that do not exist are kept as they are.
+  const std::string first = "/does/not/exist/first file.exe";
+  const std::string second = "/does/not/exist/second.zip";
+  const std::string third = "/does/not/exist/third.bin";
+
+  {
+    UploadOutbox producer(outboxFile);
+    std::string name;
+    if (!producer.load() || !producer.empty() || producer.next(name))
+    {
+      std::cout << "Error: Missing outbox file was not loaded as empty outbox!" << std::endl;
+      return false;
+    }
+    if (producer.add("line\nbreak") || producer.add(""))
+    {
+      std::cout << "Error: File with invalid name was added!" << std::endl;
+      return false;
+    }
+    if (!producer.add(first) || !producer.add(second) || !producer.add(first)
+        || (producer.size() != 2) || !producer.flush())
+    {
+      std::cout << "Error: Could not put files into the outbox!" << std::endl;
+      return false;
+    }
+  }
+
+  // The drainer gets the files in the order of their addition.
+  UploadOutbox drainer(outboxFile);
+  std::string name;
+  if (!drainer.load() || (drainer.size() != 2) || !drainer.next(name) || (name != first))
+  {
+    std::cout << "Error: Expected the first file after reload!" << std::endl;
+    return false;
+  }
+  drainer.done(name);
+  if (!drainer.flush() || !drainer.next(name) || (name != second))
+  {
+    std::cout << "Error: Expected the second file after the first one is done!" << std::endl;
+    return false;
+  }
+
+  // Files of another producer and an interrupted write of a third one.
+  {
+    UploadOutbox producer(outboxFile);
+    if (!producer.load() || (producer.size() != 1) || !producer.add(third) || !producer.flush())
+    {
+      std::cout << "Error: Could not put file into the outbox by second producer!" << std::endl;
+      return false;
+    }
+    std::ofstream stream(outboxFile, std::ios::out | std::ios::binary | std::ios::app);
+    stream << "+ /does/not/ex";
+  }
+  {
+    UploadOutbox other(outboxFile);
+    if (!other.load() || (other.size() != 2))
+    {
+      std::cout << "Error: Incomplete line was not ignored!" << std::endl;
+      return false;
+    }
+  }
+  // Writers remove the incomplete line, so it does not add a truncated name.
+  {
+    UploadOutbox producer(outboxFile);
+    producer.add(first);
+    if (!producer.flush())
+    {
+      std::cout << "Error: Could not write after incomplete line!" << std::endl;
+      return false;
+    }
+  }
+  if (!drainer.load() || (drainer.size() != 3) || !drainer.next(name) || (name != second))
+  {
+    std::cout << "Error: Expected three files with the second one first!" << std::endl;
+    return false;
+  }
+
+  // Compaction keeps the queued files and their order.
+  drainer.done(second);
+  for (int i = 0; i < 200; ++i)
+  {
+    const std::string temporary = "/does/not/exist/" + std::to_string(i);
+    drainer.add(temporary);
+    drainer.done(temporary);
+  }
+  if (!drainer.compact() || (drainer.size() != 2) || !drainer.next(name) || (name != third))
+  {
+    std::cout << "Error: Compaction failed or lost queued files!" << std::endl;
+    return false;
+  }
+  {
+    UploadOutbox other(outboxFile);
+    if (!other.load() || (other.size() != 2) || !other.next(name) || (name != third))
+    {
+      std::cout << "Error: Compacted outbox does not contain the queued files!" << std::endl;
+      return false;
+    }
+  }
+  std::ifstream stream(outboxFile, std::ios::in | std::ios::binary);
+  std::string line;
+  std::size_t lines = 0;
+  while (std::getline(stream, line))
+  {
+    ++lines;
+  }
+  if (lines > 3)
+  {
+    std::cout << "Error: Outbox file was not compacted, it has " << lines << " lines!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool testFailedUploads(const std::string& outboxFile)
+{
+  const std::string first = "/does/not/exist/failing.exe";
+  const std::string second = "/does/not/exist/working.exe";
+  libstriezel::filesystem::file::remove(outboxFile);
+
+  UploadOutbox drainer(outboxFile);
+  std::string name;
+  if (!drainer.load() || !drainer.add(first) || !drainer.add(second) || !drainer.flush())
+  {
+    std::cout << "Error: Could not put files into the outbox for failed uploads!" << std::endl;
+    return false;
+  }
+  // A failed upload moves the file behind the others.
+  if (!drainer.next(name) || (name != first) || !drainer.failed(name)
+      || !drainer.next(name) || (name != second) || (drainer.size() != 2))
+  {
+    std::cout << "Error: File with failed upload was not moved to the end!" << std::endl;
+    return false;
+  }
+  drainer.done(second);
+  if (!drainer.flush())
+  {
+    std::cout << "Error: Could not write failed upload!" << std::endl;
+    return false;
+  }
+  // Failures are kept in the outbox file.
+  {
+    UploadOutbox other(outboxFile);
+    if (!other.load() || (other.size() != 1) || !other.next(name) || (name != first)
+        || !other.failed(name) || other.failed(name) || !other.empty()
+        || (other.parked() != 1) || other.next(name) || !other.flush())
+    {
+      std::cout << "Error: File was not parked after " << UploadOutbox::cMaximumAttempts
+                << " failed uploads!" << std::endl;
+      return false;
+    }
+  }
+  // Parked files survive compaction, but are not uploaded.
+  for (int i = 0; i < 200; ++i)
+  {
+    const std::string temporary = "/does/not/exist/" + std::to_string(i);
+    drainer.add(temporary);
+    drainer.done(temporary);
+  }
+  if (!drainer.compact() || !drainer.empty() || (drainer.parked() != 1))
+  {
+    std::cout << "Error: Compaction lost the parked file!" << std::endl;
+    return false;
+  }
+  // Adding a parked file again gives it new attempts.
+  {
+    UploadOutbox producer(outboxFile);
+    if (!producer.load() || (producer.parked() != 1) || !producer.add(first) || !producer.flush())
+    {
+      std::cout << "Error: Could not add parked file again!" << std::endl;
+      return false;
+    }
+  }
+  if (!drainer.load() || (drainer.parked() != 0) || !drainer.next(name) || (name != first)
+      || !drainer.failed(name))
+  {
+    std::cout << "Error: File that was added again is still parked!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int main()
+{
+  std::string dir;
+  if (!libstriezel::filesystem::directory::createTemp(dir))
+  {
+    std::cout << "Error: Could not create temporary directory!" << std::endl;
+    return 1;
+  }
+  const std::string outboxFile = libstriezel::filesystem::slashify(dir) + "outbox.txt";
+  const bool success = testUploadOutbox(outboxFile) && testFailedUploads(outboxFile);
+  libstriezel::filesystem::file::remove(outboxFile);
+  libstriezel::filesystem::directory::remove(dir);
+  if (!success)
+    return 1;
+
+  std::cout << "Upload outbox tests passed." << std::endl;
+  return 0;
+}
@@ -0,0 +1,166 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../../../source/scan-tool/PollScheduler.hpp"
+
+using namespace scantool::virustotal;
+using std::chrono::seconds;
+
+bool testAddAndRemove()
+{
+  PollScheduler polls;
+  const auto start = std::chrono::steady_clock::now();
+  if (!polls.empty() || (polls.nextPoll() != std::chrono::steady_clock::time_point::max()))
+  {
+    std::cout << "Error: New scheduler is not empty!" << std::endl;
+    return false;
+  }
+  if (!polls.add("a", start + seconds(60)) || polls.add("a", start) || (polls.size() != 1))
+  {
+    std::cout << "Error: Scan was not added exactly once!" << std::endl;
+    return false;
+  }
+  if ((polls.nextPoll() < start + seconds(45)) || (polls.nextPoll() > start + seconds(60)))
+  {
+    std::cout << "Error: Time of the next poll is wrong!" << std::endl;
+    return false;
+  }
+  std::string scan_id;
+  if (polls.next(start + seconds(59), scan_id))
+  {
+    std::cout << "Error: Scan was polled before its due time!" << std::endl;
+    return false;
+  }
+  polls.remove("a");
+  if (!polls.empty() || polls.contains("a") || polls.next(start + seconds(100), scan_id))
+  {
+    std::cout << "Error: Removed scan is still scheduled!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool testBackoff()
+{
+  PollScheduler polls(seconds(60), seconds(900));
+  const auto start = std::chrono::steady_clock::now();
+  polls.add("a", start + seconds(60));
+  // Walk through time in steps of one second and record the polls.
+  std::vector<int> pollTimes;
+  std::string scan_id;
+  for (int t = 0; t <= 3000; ++t)
+  {
+    const auto now = start + seconds(t);
+    while (polls.next(now, scan_id))
+    {
+      if (scan_id != "a")
+      {
+        std::cout << "Error: Unknown scan ID " << scan_id << " was returned!" << std::endl;
+        return false;
+      }
+      pollTimes.push_back(t);
+      polls.postpone(scan_id, now);
+    }
+  }
+  const std::vector<int> delays = { 60, 120, 240, 480, 900, 900 };
+  if (pollTimes.size() < delays.size() + 1)
+  {
+    std::cout << "Error: Expected at least " << delays.size() + 1 << " polls, but got "
+              << pollTimes.size() << "!" << std::endl;
+    return false;
+  }
+  if ((pollTimes[0] < 45) || (pollTimes[0] > 60))
+  {
+    std::cout << "Error: First poll happened after " << pollTimes[0] << " seconds!" << std::endl;
+    return false;
+  }
+  for (std::size_t i = 0; i < delays.size(); ++i)
+  {
+    const int delay = pollTimes[i + 1] - pollTimes[i];
+    if ((delay < delays[i] - 15) || (delay > delays[i] + 15))
+    {
+      std::cout << "Error: Delay before poll " << i + 2 << " is " << delay
+                << " seconds, but it should be " << delays[i] << " seconds!" << std::endl;
+      return false;
+    }
+  }
+  if (polls.attempts("a") != pollTimes.size())
+  {
+    std::cout << "Error: Number of attempts is " << polls.attempts("a")
+              << " instead of " << pollTimes.size() << "!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool testOrderAndPause()
+{
+  PollScheduler polls;
+  const auto start = std::chrono::steady_clock::now();
+  // The last one is more than one turn of the wheel ahead.
+  polls.add("late", start + seconds(2000));
+  polls.add("second", start + seconds(300));
+  polls.add("first", start + seconds(100));
+  std::string scan_id;
+  if (!polls.next(start + seconds(400), scan_id) || (scan_id != "first"))
+  {
+    std::cout << "Error: Expected scan ID first, but got " << scan_id << "!" << std::endl;
+    return false;
+  }
+  if (!polls.next(start + seconds(400), scan_id) || (scan_id != "second"))
+  {
+    std::cout << "Error: Expected scan ID second, but got " << scan_id << "!" << std::endl;
+    return false;
+  }
+  // Scans that are polled right now are not handed out twice.
+  if (polls.next(start + seconds(1980), scan_id))
+  {
+    std::cout << "Error: Scan " << scan_id << " was returned too early!" << std::endl;
+    return false;
+  }
+  polls.remove("first");
+  polls.postpone("second", start + seconds(1980));
+  // A long pause skips several turns of the wheel.
+  std::vector<std::string> ids;
+  while (polls.next(start + seconds(10000), scan_id))
+  {
+    ids.push_back(scan_id);
+  }
+  if ((ids.size() != 2) || (ids[0] == ids[1]) || ((ids[0] != "late") && (ids[1] != "late")))
+  {
+    std::cout << "Error: Expected scans late and second after the pause, but got "
+              << ids.size() << " scan(s)!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int main()
+{
+  if (!testAddAndRemove() || !testBackoff() || !testOrderAndPause())
+    return 1;
+
+  std::cout << "Poll scheduler tests passed." << std::endl;
+  return 0;
+}
@@ -0,0 +1,105 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include <chrono>
+#include <iostream>
+#include "../../../source/Scanner.hpp"
+
+/* Scanner with a long time limit between requests, like the public API of
+   VirusTotal has. */
+class SlowScanner: public scantool::Scanner
+{
+  public:
+    std::chrono::milliseconds timeBetweenConsecutiveScanRequests() const override
+    {
+      return std::chrono::seconds(15);
+    }
+
+    std::chrono::milliseconds timeBetweenConsecutiveHashLookups() const override
+    {
+      return std::chrono::milliseconds(2500);
+    }
+
+    int64_t maxScanSize() const noexcept override
+    {
+      return 1024;
+    }
+};
+
+// thrown by the wait handler to end the wait, like std::exit() would
+struct Termination
+{
+};
+
+int main()
+{
+  SlowScanner scanner;
+  scanner.silence(true);
+
+  // The handler is called repeatedly during a wait of several seconds.
+  int calls = 0;
+  scanner.setWaitHandler([&calls]() { ++calls; });
+  scanner.hashLookupWasNow();
+  auto start = std::chrono::steady_clock::now();
+  scanner.waitForHashLookupLimitExpiration();
+  auto waited = std::chrono::steady_clock::now() - start;
+  if ((calls < 3) || (waited < std::chrono::milliseconds(2400)))
+  {
+    std::cout << "Error: Wait handler was called " << calls << " time(s) during "
+              << "the wait for the hash lookup limit!" << std::endl;
+    return 1;
+  }
+
+  // A handler that terminates ends a long wait after at most one second.
+  scanner.setWaitHandler([]() { throw Termination(); });
+  scanner.scanRequestWasNow();
+  start = std::chrono::steady_clock::now();
+  try
+  {
+    scanner.waitForScanLimitExpiration();
+    std::cout << "Error: Wait for the scan limit was not ended by the handler!" << std::endl;
+    return 1;
+  }
+  catch (const Termination&)
+  {
+  }
+  waited = std::chrono::steady_clock::now() - start;
+  if (waited > std::chrono::milliseconds(1500))
+  {
+    std::cout << "Error: Handler was called after "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(waited).count()
+              << " ms, but it should be called at least once per second!" << std::endl;
+    return 1;
+  }
+
+  // Without a handler the wait is not interrupted.
+  scanner.setWaitHandler(nullptr);
+  scanner.hashLookupWasNow();
+  start = std::chrono::steady_clock::now();
+  scanner.waitForHashLookupLimitExpiration();
+  if (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(2400))
+  {
+    std::cout << "Error: Wait without handler ended too early!" << std::endl;
+    return 1;
+  }
+
+  std::cout << "Wait tests passed." << std::endl;
+  return 0;
+}
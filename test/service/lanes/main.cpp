@@ -0,0 +1,281 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../../../libstriezel/filesystem/directory.hpp"
+#include "../../../source/scan-tool/ScanService.hpp"
+#include "../../../source/scan-tool/ServiceClient.hpp"
+
+using namespace scantool::virustotal;
+
+bool testProtocol()
+{
+  const std::string hash = std::string(64, 'a');
+  ServiceRequest request;
+  if (!ServiceRequest::parse("bulk scan /tmp/some file.exe", request)
+      || (request.lane != Lane::Bulk) || (request.command != ServiceRequest::Command::Scan)
+      || (request.argument != "/tmp/some file.exe"))
+  {
+    std::cout << "Error: Scan request was not parsed correctly!" << std::endl;
+    return false;
+  }
+  if (!ServiceRequest::parse(request.toLine(), request) || (request.argument != "/tmp/some file.exe"))
+  {
+    std::cout << "Error: Formatted request cannot be parsed!" << std::endl;
+    return false;
+  }
+  const std::vector<std::string> invalid = {
+    "", "interactive", "interactive scan", "interactive scan ", "urgent scan /tmp/a",
+    "bulk delete /tmp/a", "bulk lookup not-a-hash", "bulk  scan /tmp/a"
+  };
+  for (const auto& line : invalid)
+  {
+    if (ServiceRequest::parse(line, request))
+    {
+      std::cout << "Error: Invalid request \"" << line << "\" was accepted!" << std::endl;
+      return false;
+    }
+  }
+
+  ServiceReply reply;
+  reply.status = ServiceReply::Status::Report;
+  reply.digest = hash;
+  reply.positives = 2;
+  reply.total = 70;
+  reply.argument = "/tmp/a b";
+  ServiceReply parsed;
+  if (!ServiceReply::parse(reply.toLine(), parsed) || (parsed.status != ServiceReply::Status::Report)
+      || (parsed.digest != hash) || (parsed.positives != 2) || (parsed.total != 70)
+      || (parsed.argument != "/tmp/a b"))
+  {
+    std::cout << "Error: Report reply was not parsed correctly!" << std::endl;
+    return false;
+  }
+  reply.status = ServiceReply::Status::Queued;
+  reply.scanId = hash + "-1234567890";
+  if (!ServiceReply::parse(reply.toLine(), parsed) || (parsed.status != ServiceReply::Status::Queued)
+      || (parsed.scanId != reply.scanId) || (parsed.argument != "/tmp/a b"))
+  {
+    std::cout << "Error: Queued reply was not parsed correctly!" << std::endl;
+    return false;
+  }
+  reply = ServiceReply();
+  reply.reason = "too-large";
+  reply.argument = "/tmp/a b";
+  if (!ServiceReply::parse(reply.toLine(), parsed) || (parsed.status != ServiceReply::Status::Error)
+      || (parsed.reason != "too-large") || (parsed.argument != "/tmp/a b"))
+  {
+    std::cout << "Error: Error reply was not parsed correctly!" << std::endl;
+    return false;
+  }
+  if (ServiceReply::parse("report " + hash + " x 70 /tmp/a", parsed)
+      || ServiceReply::parse("fine " + hash + " /tmp/a", parsed))
+  {
+    std::cout << "Error: Invalid reply was accepted!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool testLanes(const std::string& socketPath)
+{
+  const std::string cached = std::string(64, 'c');
+  bool rateLimited = true;
+  std::vector<std::string> handled;
+  const auto resolve = [&](ServiceRequest& request, ServiceReply& reply) -> bool
+  {
+    request.digest = request.argument;
+    if (request.argument != cached)
+      return false;
+    reply.status = ServiceReply::Status::Report;
+    reply.digest = cached;
+    return true;
+  };
+  const auto handle = [&](const ServiceRequest& request) -> ServiceReply
+  {
+    handled.push_back(request.argument);
+    ServiceReply reply;
+    reply.status = ServiceReply::Status::Unknown;
+    reply.digest = request.digest;
+    return reply;
+  };
+  const auto delay = [&]() -> std::chrono::milliseconds
+  {
+    return std::chrono::milliseconds(rateLimited ? 60000 : 0);
+  };
+
+  ScanService service(socketPath, resolve, handle, delay);
+  if (!service.start())
+  {
+    std::cout << "Error: Could not start service on " << socketPath << "!" << std::endl;
+    return false;
+  }
+  ScanService second(socketPath, resolve, handle, delay);
+  if (second.start())
+  {
+    std::cout << "Error: Second service could use the same socket!" << std::endl;
+    return false;
+  }
+
+  ServiceClient client;
+  if (!client.connect(socketPath))
+  {
+    std::cout << "Error: Could not connect to " << socketPath << "!" << std::endl;
+    return false;
+  }
+  const std::vector<std::pair<Lane, std::string> > requests = {
+    { Lane::Bulk, std::string(64, '1') },
+    { Lane::Bulk, std::string(64, '2') },
+    { Lane::Interactive, cached },
+    { Lane::Interactive, std::string(64, '3') }
+  };
+  for (const auto& [lane, hash] : requests)
+  {
+    ServiceRequest request;
+    request.lane = lane;
+    request.command = ServiceRequest::Command::Lookup;
+    request.argument = hash;
+    if (!client.send(request))
+    {
+      std::cout << "Error: Could not send request!" << std::endl;
+      return false;
+    }
+  }
+  client.finish();
+
+  // While the rate limit is active, only the cached request is answered.
+  for (unsigned int i = 0; (i < 50) && (service.waitingRequests(Lane::Bulk) + service.waitingRequests(Lane::Interactive) < 3); ++i)
+  {
+    service.serve(std::chrono::milliseconds(10));
+  }
+  if ((service.waitingRequests(Lane::Bulk) != 2) || (service.waitingRequests(Lane::Interactive) != 1)
+      || !handled.empty())
+  {
+    std::cout << "Error: Requests were not queued in their lanes!" << std::endl;
+    return false;
+  }
+  ServiceReply reply;
+  if (!client.receive(reply) || (reply.status != ServiceReply::Status::Report) || (reply.argument != cached))
+  {
+    std::cout << "Error: Cached request was not answered right away!" << std::endl;
+    return false;
+  }
+
+  // Interactive requests go first, even if they arrived later.
+  rateLimited = false;
+  for (unsigned int i = 0; (i < 50) && (handled.size() < 3); ++i)
+  {
+    service.serve(std::chrono::milliseconds(10));
+  }
+  const std::vector<std::string> expected = { requests[3].second, requests[0].second, requests[1].second };
+  if (handled != expected)
+  {
+    std::cout << "Error: Requests were handled in the wrong order!" << std::endl;
+    return false;
+  }
+  for (const auto& hash : expected)
+  {
+    if (!client.receive(reply) || (reply.status != ServiceReply::Status::Unknown) || (reply.argument != hash))
+    {
+      std::cout << "Error: Did not get reply for " << hash << "!" << std::endl;
+      return false;
+    }
+  }
+
+  // The client is done after it got all replies.
+  service.serve(std::chrono::milliseconds(10));
+  if (service.clientCount() != 0)
+  {
+    std::cout << "Error: Finished client is still connected!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool testErrorReply(const std::string& socketPath)
+{
+  ScanService service(socketPath,
+      [](ServiceRequest&, ServiceReply&) { return false; },
+      [](const ServiceRequest&) { return ServiceReply(); },
+      []() { return std::chrono::milliseconds(0); });
+  if (!service.start())
+  {
+    std::cout << "Error: Could not start another service on " << socketPath << "!" << std::endl;
+    return false;
+  }
+  ServiceClient client;
+  ServiceRequest request;
+  request.argument = "bad\nline";
+  if (!client.connect(socketPath) || client.send(request))
+  {
+    std::cout << "Error: Request with line feed was sent!" << std::endl;
+    return false;
+  }
+  request.argument = "/tmp/file";
+  request.lane = Lane::Bulk;
+  if (!client.send(request) || !client.finish())
+  {
+    std::cout << "Error: Could not send request!" << std::endl;
+    return false;
+  }
+  // Without rate limit the request is handled right away.
+  for (unsigned int i = 0; i < 5; ++i)
+  {
+    service.serve(std::chrono::milliseconds(10));
+  }
+  ServiceReply reply;
+  if (!client.receive(reply) || (reply.status != ServiceReply::Status::Error)
+      || (reply.reason != "unspecified") || (reply.argument != "/tmp/file"))
+  {
+    std::cout << "Error: Did not get error reply!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int main()
+{
+  if (!testProtocol())
+    return 1;
+  if (!ScanService::supported())
+  {
+    std::cout << "Scan service is not supported, skipping socket tests." << std::endl;
+    return 0;
+  }
+
+  std::string root;
+  if (!libstriezel::filesystem::directory::createTemp(root))
+  {
+    std::cout << "Error: Could not create temporary directory!" << std::endl;
+    return 1;
+  }
+  root = libstriezel::filesystem::unslashify(root);
+  const std::string socketPath = root + "/service.sock";
+  const bool success = testLanes(socketPath) && testErrorReply(socketPath);
+  libstriezel::filesystem::directory::remove(root);
+  if (!success)
+    return 1;
+
+  std::cout << "Scan service tests passed." << std::endl;
+  return 0;
+}
@@ -0,0 +1,146 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of scan-tool.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include <iostream>
+#include <string>
+#include "../../../source/scan-tool/QueuedScan.hpp"
+#include "../../../source/scan-tool/ScanStrategy.hpp"
+
+using namespace scantool::virustotal;
+
+/// strategy that only exposes the creation of queued scan records
+class NamingStrategy: public ScanStrategy
+{
+  public:
+    virtual int scan(ScannerV2&, const std::string&,
+              CacheManagerV2&, const std::string&, const bool,
+              const bool, const int, const int,
+              const std::chrono::time_point<std::chrono::system_clock>,
+              std::map<std::string, ScannerV2::Report>&,
+              std::map<std::string, std::string>&,
+              QueuedScanMap&,
+              std::chrono::time_point<std::chrono::steady_clock>&,
+              std::vector<std::pair<std::string, int64_t> >&,
+              std::set<std::string>::size_type&,
+              std::set<std::string>::size_type&) override
+    {
+      return 0;
+    }
+
+    using ScanStrategy::queuedScan;
+}; // class
+
+bool testDisplayName()
+{
+  QueuedScan record;
+  record.fileName = "/tmp/plain.exe";
+  if (record.displayName() != "/tmp/plain.exe")
+  {
+    std::cout << "Error: Record without origin is not named after the file, but "
+              << record.displayName() << "!" << std::endl;
+    return false;
+  }
+  record.origin = "plain.exe";
+  if (record.displayName() != "plain.exe")
+  {
+    std::cout << "Error: Plain file is not named after its origin, but "
+              << record.displayName() << "!" << std::endl;
+    return false;
+  }
+  record.origin = "data.zip";
+  record.archivePath = "inner.zip!/dir/file.exe";
+  if (record.displayName() != "data.zip!/inner.zip!/dir/file.exe")
+  {
+    std::cout << "Error: Archive entry is named " << record.displayName() << "!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool testPlainFile()
+{
+  NamingStrategy strategy;
+  const std::string hash = "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855";
+  const QueuedScan record = strategy.queuedScan("/data/file.exe", hash, 4711);
+  if ((record.fileName != "/data/file.exe") || (record.origin != "/data/file.exe")
+      || !record.archivePath.empty() || (record.sha256 != hash) || (record.size != 4711)
+      || record.extracted)
+  {
+    std::cout << "Error: Record of a plain file is wrong!" << std::endl;
+    return false;
+  }
+  if (record.displayName() != "/data/file.exe")
+  {
+    std::cout << "Error: Plain file is named " << record.displayName() << "!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool testNestedArchives()
+{
+  NamingStrategy strategy;
+  // outer.zip contains inner.zip, which was extracted to a temporary file
+  // and contains the scanned file.
+  strategy.enterArchiveEntry("/data/outer.zip", "inner.zip");
+  strategy.enterArchiveEntry("/tmp/extract-1/inner.zip", "dir/file.exe");
+  QueuedScan record = strategy.queuedScan("/tmp/extract-2/dir/file.exe", "", -1);
+  if ((record.fileName != "/tmp/extract-2/dir/file.exe") || (record.origin != "/data/outer.zip")
+      || (record.archivePath != "inner.zip!/dir/file.exe"))
+  {
+    std::cout << "Error: Record of a nested archive entry is wrong, origin is "
+              << record.origin << ", path is " << record.archivePath << "!" << std::endl;
+    return false;
+  }
+  if (record.displayName() != "/data/outer.zip!/inner.zip!/dir/file.exe")
+  {
+    std::cout << "Error: Nested archive entry is named " << record.displayName() << "!" << std::endl;
+    return false;
+  }
+
+  // The inner archive itself is an entry of the outer archive.
+  strategy.leaveArchiveEntry();
+  record = strategy.queuedScan("/tmp/extract-1/inner.zip", "", -1);
+  if (record.displayName() != "/data/outer.zip!/inner.zip")
+  {
+    std::cout << "Error: Archive entry is named " << record.displayName() << "!" << std::endl;
+    return false;
+  }
+
+  // After the outer archive is done, files are plain files again.
+  strategy.leaveArchiveEntry();
+  strategy.leaveArchiveEntry();
+  record = strategy.queuedScan("/data/outer.zip", "", -1);
+  if ((record.displayName() != "/data/outer.zip") || !record.archivePath.empty())
+  {
+    std::cout << "Error: Outer archive is named " << record.displayName() << "!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int main()
+{
+  if (!testDisplayName() || !testPlainFile() || !testNestedArchives())
+    return 1;
+
+  std::cout << "Queued scan naming tests passed." << std::endl;
+  return 0;
+}